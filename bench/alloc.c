@@ -0,0 +1,267 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: alloc.c
+ *
+ * Allocator benchmark: load and close a generated config with malloc,
+ * with a pool allocator that keeps freed blocks on per-size free lists,
+ * and with a bump allocator that frees nothing until it is reset.
+ *
+ * Usage: alloc [sections] [options] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_SECTIONS    2000
+#define DEFAULT_OPTIONS     20
+#define DEFAULT_ROUNDS      20
+
+#define HEADER      16              /* Size header before each block */
+#define CLASS_SIZE  16              /* Pool size classes are multiples */
+#define CLASSES     32              /* Blocks up to 512 bytes are pooled */
+#define SLAB_SIZE   (256 * 1024)    /* Pool and bump memory come in slabs */
+
+/* Memory obtained in slabs, freed all at once */
+typedef struct slab {
+    struct slab *next;
+    size_t used, size;
+    char data[];
+} slab;
+
+/* Pool: small blocks are recycled through free lists, by size class */
+typedef struct pool {
+    slab *slabs;
+    void *free[CLASSES];
+} pool;
+
+/* Bump: blocks are carved from the current slab, and never freed */
+typedef struct bump {
+    slab *slabs;
+} bump;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void *slab_carve(slab **slabs, size_t size);
+static void slab_release(slab **slabs);
+
+static void *pool_alloc(void *ctx, size_t size);
+static void *pool_realloc(void *ctx, void *ptr, size_t size);
+static void pool_free(void *ctx, void *ptr);
+
+static void *bump_alloc(void *ctx, size_t size);
+static void *bump_realloc(void *ctx, void *ptr, size_t size);
+static void bump_free(void *ctx, void *ptr);
+
+static void reset(const vc_allocator *alloc);
+static void run(const char *name, char *path, const vc_allocator *alloc, int rounds);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int sections = argc > 1 ? atoi(argv[1]) : DEFAULT_SECTIONS;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    pool p;
+    bump b;
+    vc_allocator pool_allocator = {pool_alloc, pool_realloc, pool_free, &p};
+    vc_allocator bump_allocator = {bump_alloc, bump_realloc, bump_free, &b};
+    FILE *f;
+    int fd, i, j;
+
+    if (sections <= 0 || options <= 0 || rounds <= 0 ||
+        (fd = mkstemp(path)) < 0 || !(f = fdopen(fd, "w"))) {
+        printf("Usage: %s [sections] [options per section] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sections; i++) {
+        fprintf(f, "[s%d]\n", i);
+        for (j = 0; j < options; j++) {
+            switch (j % 3) {
+                case 0: fprintf(f, "opt%d = %d\n", j, i + j); break;
+                case 1: fprintf(f, "opt%d = \"value %d.%d\"\n", j, i, j); break;
+                default: fprintf(f, "opt%d = [%d, %d, %d]\n", j, i, j, i + j); break;
+            }
+        }
+        fprintf(f, "[/s%d]\n", i);
+    }
+    fclose(f);
+
+    printf("%d sections, %d options each, %d rounds\n", sections, options, rounds);
+    printf("            load        close\n");
+
+    bzero(&p, sizeof(p));
+    bzero(&b, sizeof(b));
+    run("malloc", path, 0, rounds);
+    run("pool", path, &pool_allocator, rounds);
+    run("bump", path, &bump_allocator, rounds);
+
+    unlink(path);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Take size bytes from the newest slab, starting a new one if needed */
+static void *slab_carve(slab **slabs, size_t size) {
+    slab *s = *slabs;
+    void *ptr;
+
+    size = (size + 15) & ~(size_t)15;
+    if (!s || s->used + size > s->size) {
+        size_t cap = size > SLAB_SIZE ? size : SLAB_SIZE;
+        if (!(s = (slab *)malloc(sizeof(slab) + cap))) return 0;
+        s->next = *slabs;
+        s->used = 0;
+        s->size = cap;
+        *slabs = s;
+    }
+    ptr = s->data + s->used;
+    s->used += size;
+    return ptr;
+}
+
+static void slab_release(slab **slabs) {
+    slab *s, *next;
+
+    for (s = *slabs; s; s = next) {
+        next = s->next;
+        free(s);
+    }
+    *slabs = 0;
+}
+
+/* Blocks carry their size in a header, so frees and reallocs can find
+ * their class. */
+static void *pool_alloc(void *ctx, size_t size) {
+    pool *p = (pool *)ctx;
+    size_t class = (size + CLASS_SIZE - 1) / CLASS_SIZE;
+    size_t *block;
+
+    if (class < CLASSES && p->free[class]) {
+        block = (size_t *)p->free[class];
+        p->free[class] = *(void **)block;
+    } else if (class < CLASSES) {
+        block = (size_t *)slab_carve(&(p->slabs), HEADER + class * CLASS_SIZE);
+    } else {
+        block = (size_t *)malloc(HEADER + size);
+    }
+    if (!block) return 0;
+    block[0] = size;
+    return (char *)block + HEADER;
+}
+
+static void *pool_realloc(void *ctx, void *ptr, size_t size) {
+    size_t old = ptr ? *(size_t *)((char *)ptr - HEADER) : 0;
+    void *grown;
+
+    if (ptr && (old + CLASS_SIZE - 1) / CLASS_SIZE == (size + CLASS_SIZE - 1) / CLASS_SIZE) {
+        *(size_t *)((char *)ptr - HEADER) = size;
+        return ptr;
+    }
+    if (!(grown = pool_alloc(ctx, size))) return 0;
+    if (ptr) {
+        memcpy(grown, ptr, old < size ? old : size);
+        pool_free(ctx, ptr);
+    }
+    return grown;
+}
+
+static void pool_free(void *ctx, void *ptr) {
+    pool *p = (pool *)ctx;
+    void *block = (char *)ptr - HEADER;
+    size_t class = (*(size_t *)block + CLASS_SIZE - 1) / CLASS_SIZE;
+
+    if (class < CLASSES) {
+        *(void **)block = p->free[class];
+        p->free[class] = block;
+    } else {
+        free(block);
+    }
+}
+
+static void *bump_alloc(void *ctx, size_t size) {
+    size_t *block = (size_t *)slab_carve(&(((bump *)ctx)->slabs), HEADER + size);
+
+    if (!block) return 0;
+    block[0] = size;
+    return (char *)block + HEADER;
+}
+
+static void *bump_realloc(void *ctx, void *ptr, size_t size) {
+    size_t old = ptr ? *(size_t *)((char *)ptr - HEADER) : 0;
+    void *grown;
+
+    if (ptr && size <= old) return ptr;
+    if (!(grown = bump_alloc(ctx, size))) return 0;
+    if (ptr) memcpy(grown, ptr, old);
+    return grown;
+}
+
+static void bump_free(void *ctx, void *ptr) {
+    (void)ctx;
+    (void)ptr;
+}
+
+/* Give back every slab once the config using them is closed */
+static void reset(const vc_allocator *alloc) {
+    if (!alloc) return;
+    if (alloc->free == pool_free) {
+        pool *p = (pool *)alloc->ctx;
+        bzero(p->free, sizeof(p->free));
+        slab_release(&(p->slabs));
+    } else {
+        slab_release(&(((bump *)alloc->ctx)->slabs));
+    }
+}
+
+/* Load and close the config, and report the average of each.  Close
+ * includes resetting the allocator. */
+static void run(const char *name, char *path, const vc_allocator *alloc, int rounds) {
+    vc_params params = {path, 0, 0, 0, alloc};
+    double load = 0, close = 0, start;
+    vconfig *vcfg;
+    int r;
+
+    for (r = 0; r < rounds; r++) {
+        start = now();
+        vcfg = vconfig_open(&params);
+        load += now() - start;
+        if (!vcfg) {
+            printf("%s: load failed\n", name);
+            return;
+        }
+
+        start = now();
+        vconfig_close(vcfg);
+        reset(alloc);
+        close += now() - start;
+    }
+    printf("%-8s %9.2f ms %9.2f ms\n", name, load * 1e3 / rounds, close * 1e3 / rounds);
+}
@@ -0,0 +1,152 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: async.c
+ *
+ * Async loading benchmark: load N generated config files with
+ * vconfig_open_many, which blocks the caller until every file is loaded,
+ * then with vconfig_open_many_async, timing how long the caller is held
+ * up and how long until the last callback.
+ *
+ * Usage: async [files] [options per file]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_FILES   800
+#define DEFAULT_OPTIONS 200
+
+static const char *modes[] = {
+    #define XX(name) #name,
+    VC_ASYNC_MODES(XX)
+    #undef XX
+};
+
+/* Callback counts, for the main thread to wait on */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static size_t completed, failed;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void write_config(char *path, int tenant, int options);
+static void loaded(const char *path, vc_sect *conf, const vc_load_error *error, void *ctx);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int nfiles = argc > 1 ? atoi(argv[1]) : DEFAULT_FILES;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    char dir[] = "/tmp/vc-bench-XXXXXX";
+    char **paths;
+    vconfig **confs;
+    vc_load_error *errors;
+    double start, batch, stall, total;
+    size_t queued;
+    int i;
+
+    if (nfiles <= 0 || options <= 0 || !mkdtemp(dir)) {
+        printf("Usage: %s [files] [options per file]\n", argv[0]);
+        return 1;
+    }
+
+    paths = (char **)calloc(nfiles, sizeof(char *));
+    confs = (vconfig **)calloc(nfiles, sizeof(vconfig *));
+    errors = (vc_load_error *)calloc(nfiles, sizeof(vc_load_error));
+    for (i = 0; i < nfiles; i++) {
+        paths[i] = (char *)malloc(64);
+        snprintf(paths[i], 64, "%s/tenant-%d.cfg", dir, i);
+        write_config(paths[i], i, options);
+    }
+
+    /* Blocking batch */
+    start = now();
+    vconfig_open_many(paths, nfiles, 0, confs, errors);
+    batch = now() - start;
+    for (i = 0; i < nfiles; i++) vconfig_close(confs[i]);
+
+    /* The first load sets up the ring and workers; keep that out of it */
+    vconfig_open_many_async(paths, 1, 0, loaded, 0);
+    pthread_mutex_lock(&lock);
+    while (completed < 1) pthread_cond_wait(&cond, &lock);
+    completed = 0;
+    pthread_mutex_unlock(&lock);
+
+    /* Queued, with the caller free as soon as the call returns */
+    start = now();
+    queued = vconfig_open_many_async(paths, nfiles, 0, loaded, 0);
+    stall = now() - start;
+    pthread_mutex_lock(&lock);
+    while (completed < queued) pthread_cond_wait(&cond, &lock);
+    pthread_mutex_unlock(&lock);
+    total = now() - start;
+
+    printf("%d files, %d options each, read with %s\n", nfiles, options, modes[vc_async_get_mode()]);
+    printf("vconfig_open_many:        %8.3f ms blocked\n", batch * 1e3);
+    printf("vconfig_open_many_async:  %8.3f ms blocked, %8.3f ms to the last callback (%zu failed)\n",
+        stall * 1e3, total * 1e3, failed);
+
+    for (i = 0; i < nfiles; i++) {
+        unlink(paths[i]);
+        free(paths[i]);
+    }
+    rmdir(dir);
+    free(paths);
+    free(confs);
+    free(errors);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* A tenant config: a few top-level options and sections of options */
+static void write_config(char *path, int tenant, int options) {
+    FILE *f = fopen(path, "w");
+    int i;
+
+    if (!f) return;
+    fprintf(f, "tenant = \"tenant-%d\"\nenabled = true\n", tenant);
+    for (i = 0; i < options; i++) {
+        if (i % 20 == 0) fprintf(f, "[backend%d]\n", i / 20);
+        fprintf(f, "option%d = %d\nname%d = \"value %d for tenant %d\"\n", i, i * tenant, i, i, tenant);
+        if (i % 20 == 19 || i == options - 1) fprintf(f, "[/backend%d]\n", i / 20);
+    }
+    fclose(f);
+}
+
+static void loaded(const char *path, vc_sect *conf, const vc_load_error *error, void *ctx) {
+    (void)path;
+    (void)error;
+    (void)ctx;
+    if (conf) vconfig_close(conf);
+    pthread_mutex_lock(&lock);
+    if (!conf) failed++;
+    completed++;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+}
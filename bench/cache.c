@@ -0,0 +1,139 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: cache.c
+ *
+ * Lookup cache benchmark: a request path reading the same hot options,
+ * by string literal, from a config of many sections.  Times rounds of
+ * those lookups in a plain config, one with VC_PARAM_PATH_INDEX, and one
+ * with VC_PARAM_LOOKUP_CACHE, and reports the cache's hit rate.
+ *
+ * Usage: cache [sections] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_SECTIONS    100
+#define DEFAULT_ROUNDS      100000
+#define OPTIONS             10      /* Options per section */
+
+/* The hot paths, as a request handler would spell them */
+static char *hot[] = {
+    "sect0.opt0", "sect0.opt1", "sect0.str2", "sect1.opt4", "sect1.str5",
+    "sect7.opt6", "sect12.opt8", "sect12.str9", "sect3.inner.opt0",
+    "sect3.inner.str1", "sect5.inner.opt2", "sect9.inner.opt3",
+    "sect20.inner.str3", "sect40.inner.opt4", "sect41.inner.leaf.opt0",
+    "sect42.inner.leaf.str1", "sect43.inner.leaf.opt2", "sect44.opt0",
+    "sect45.str1", "sect46.inner.leaf.opt3"
+};
+#define NHOT (sizeof(hot) / sizeof(hot[0]))
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static char *build(int sections, size_t *length);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int sections = argc > 1 ? atoi(argv[1]) : DEFAULT_SECTIONS;
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    static const int modes[3] = {0, VC_PARAM_PATH_INDEX, VC_PARAM_LOOKUP_CACHE};
+    static const char *names[3] = {"walk", "path index", "cache"};
+    double times[3], start;
+    long long sums[3] = {0, 0, 0};
+    vc_cache_stats stats;
+    size_t length, i;
+    char *data;
+    int m, r;
+
+    if (sections < 50 || rounds <= 0) {
+        printf("Usage: %s [sections (at least 50)] [rounds]\n", argv[0]);
+        return 1;
+    }
+    if (!(data = build(sections, &length))) return 1;
+
+    for (m = 0; m < 3; m++) {
+        vc_params p = {0, 0, modes[m], 0, 0};
+        vconfig *vcfg = vconfig_parse_buffer(data, length, &p);
+        if (!vcfg) return 1;
+
+        vconfig_cache_reset();
+        start = now();
+        for (r = 0; r < rounds; r++) {
+            for (i = 0; i < NHOT; i++) {
+                if (strstr(hot[i], ".str")) {
+                    char *s = vconfig_getstr(vcfg, hot[i]);
+                    if (s) sums[m] += s[0];
+                } else {
+                    int *v = vconfig_getint(vcfg, hot[i]);
+                    if (v) sums[m] += *v;
+                }
+            }
+        }
+        times[m] = now() - start;
+        vconfig_close(vcfg);
+    }
+    vconfig_cache_stats(&stats);
+    free(data);
+    if (sums[0] != sums[1] || sums[0] != sums[2]) printf("Sums differ\n");
+
+    printf("%d sections, %zu hot paths, %d rounds\n", sections, NHOT, rounds);
+    for (m = 0; m < 3; m++) {
+        printf("%-12s %6.1f ns per lookup (%.1fx)\n", names[m],
+               times[m] * 1e9 / rounds / NHOT, times[0] / times[m]);
+    }
+    printf("cache: %llu hits, %llu misses, %llu evictions (%.4f%% hits)\n",
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+           (unsigned long long)stats.evictions,
+           100.0 * stats.hits / (stats.hits + stats.misses));
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Sections of numbers and strings, each holding a nested section with
+ * one more level below it */
+static char *build(int sections, size_t *length) {
+    char *data = (char *)malloc((size_t)sections * OPTIONS * 3 * 40 + 1);
+    const char *names[3] = {"", "inner", "leaf"};
+    int i, j, d;
+
+    if (!data) return 0;
+    *length = 0;
+    for (i = 0; i < sections; i++) {
+        *length += sprintf(data + *length, "[sect%d]\n", i);
+        for (d = 0; d < 3; d++) {
+            if (d) *length += sprintf(data + *length, "[%s]\n", names[d]);
+            for (j = 0; j < OPTIONS; j++) {
+                if (j % 2) *length += sprintf(data + *length, "str%d = \"v%d\"\n", j, i + j);
+                else *length += sprintf(data + *length, "opt%d = %d\n", j, i * j + d);
+            }
+        }
+        *length += sprintf(data + *length, "[/leaf]\n[/inner]\n[/sect%d]\n", i);
+    }
+    return data;
+}
@@ -0,0 +1,115 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: cxx.cpp
+ *
+ * C++ wrapper benchmark: look the same options up through the C calls
+ * and through vc::Config, by path string and by pre-hashed path, to show
+ * what the wrapper costs over the calls it makes.
+ *
+ * Usage: cxx [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string_view>
+#include <unistd.h>
+
+#include "vconfig.hpp"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_ROUNDS  2000000
+
+using namespace std::literals;
+
+static const char config[] =
+    "name = \"bench\"\n"
+    "[server]\n"
+    "    port = 8080\n"
+    "    [limits]\n"
+    "        conns = 1024\n"
+    "    [/limits]\n"
+    "[/server]\n";
+
+/* Paths hashed ahead of time: by hand for the C calls, as vconfig-gen
+ * would emit them, and by vc::Path for the wrapper */
+static const vc_key conns_segs[] = {
+    {"server", 6, 0},
+    {"limits", 6, 0},
+    {"conns", 5, 0},
+};
+static vc_keypath conns_c = {{"server.limits.conns", 19, 0}, 0, 3};
+static constexpr vc::Path conns_cxx{"server.limits.conns"};
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void report(const char *name, double c, double cxx);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+    vc_key segs[3] = {conns_segs[0], conns_segs[1], conns_segs[2]};
+    double start, c, cxx;
+    long sum = 0;
+    int r, i;
+
+    if (rounds <= 0) {
+        printf("Usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    vc::Config conf = vc::Config::parse(config);
+    if (!conf) return 1;
+
+    for (i = 0; i < 3; i++) segs[i].hash = hashn_djb2((unsigned char *)segs[i].key, segs[i].length);
+    conns_c.path.hash = hashn_djb2((unsigned char *)conns_c.path.key, conns_c.path.length);
+    conns_c.segs = segs;
+
+    printf("%d rounds\n", rounds);
+
+    start = now();
+    for (r = 0; r < rounds; r++) sum += *vconfig_getint(conf.handle(), (char *)"server.limits.conns");
+    c = now() - start;
+    start = now();
+    for (r = 0; r < rounds; r++) sum += *conf.get<int>("server.limits.conns"sv);
+    cxx = now() - start;
+    report("path strings", c * 1e9 / rounds, cxx * 1e9 / rounds);
+
+    start = now();
+    for (r = 0; r < rounds; r++) sum += *(int *)vconfig_getval_key(conf.handle(), &conns_c, VC_INTEGER);
+    c = now() - start;
+    start = now();
+    for (r = 0; r < rounds; r++) sum += *conf.get<int>(conns_cxx);
+    cxx = now() - start;
+    report("pre-hashed", c * 1e9 / rounds, cxx * 1e9 / rounds);
+
+    /* Keep the lookups from being optimized away */
+    return sum == 4 * 1024L * rounds ? 0 : 1;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double c, double cxx) {
+    printf("%-13s C %6.1f ns/lookup, C++ %6.1f ns/lookup (%+.1f%%)\n",
+           name, c, cxx, (cxx - c) * 100 / c);
+}
@@ -0,0 +1,158 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: diff.c
+ *
+ * Diff benchmark: parse a large nested config and a copy with one value
+ * changed, then find the change with vconfig_diff, and by comparing every
+ * option of the two, as a reload had to without content hashes.
+ *
+ * Usage: diff [sections] [options] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_SECTIONS    20000
+#define DEFAULT_OPTIONS     20
+#define DEFAULT_ROUNDS      100
+#define GROUP_SIZE          64
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static char *generate(int sections, int options, int changed, size_t *length);
+static long compare(vc_sect *a, vc_sect *b);
+static int count_change(const char *path, vc_diff_change change, vc_opt *before, vc_opt *after, void *ctx);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int sections = argc > 1 ? atoi(argv[1]) : DEFAULT_SECTIONS;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    double start, parse, hashed = 0, full = 0;
+    size_t length[2];
+    char *data[2];
+    vconfig *conf[2];
+    long changes = 0, differ = 0;
+    int r;
+
+    if (sections <= 0 || options <= 0 || rounds <= 0) {
+        printf("Usage: %s [sections] [options per section] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    data[0] = generate(sections, options, -1, &(length[0]));
+    data[1] = generate(sections, options, sections / 2, &(length[1]));
+    if (!data[0] || !data[1]) return 1;
+
+    start = now();
+    conf[0] = vconfig_parse_buffer(data[0], length[0], 0);
+    parse = now() - start;
+    conf[1] = vconfig_parse_buffer(data[1], length[1], 0);
+    if (!conf[0] || !conf[1]) return 1;
+
+    for (r = 0; r < rounds; r++) {
+        start = now();
+        changes = vconfig_diff(conf[0], conf[1], count_change, 0);
+        hashed += now() - start;
+    }
+    for (r = 0; r < (rounds + 9) / 10; r++) {
+        start = now();
+        differ = compare(conf[0], conf[1]);
+        full += now() - start;
+    }
+
+    printf("%d sections, %d options each, %zu bytes, parsed in %.2f ms\n",
+        sections, options, length[0], parse * 1e3);
+    printf("vconfig_diff:    %10.3f ms (%ld changes)\n", hashed * 1e3 / rounds, changes);
+    printf("compare all:     %10.3f ms (%ld changes, %.0fx)\n", full * 1e3 / ((rounds + 9) / 10), differ,
+        (full / ((rounds + 9) / 10)) / (hashed / rounds));
+
+    vconfig_close(conf[0]);
+    vconfig_close(conf[1]);
+    free(data[0]);
+    free(data[1]);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Sections two deep, in groups of GROUP_SIZE.  Section changed, if any,
+ * gets a different first option. */
+static char *generate(int sections, int options, int changed, size_t *length) {
+    size_t cap = (size_t)sections * (options + 4) * 48, n = 0;
+    char *data = (char *)malloc(cap);
+    int i, j;
+
+    if (!data) return 0;
+    for (i = 0; i < sections; i++) {
+        if (i % GROUP_SIZE == 0) n += sprintf(data + n, "[group%d]\n", i / GROUP_SIZE);
+        n += sprintf(data + n, "[s%d]\n", i);
+        for (j = 0; j < options; j++) {
+            if (j % 2) n += sprintf(data + n, "opt%d = \"value %d.%d\"\n", j, i, j);
+            else n += sprintf(data + n, "opt%d = %d\n", j, i + j + (i == changed && !j));
+        }
+        n += sprintf(data + n, "[/s%d]\n", i);
+        if (i % GROUP_SIZE == GROUP_SIZE - 1 || i == sections - 1) {
+            n += sprintf(data + n, "[/group%d]\n", i / GROUP_SIZE);
+        }
+    }
+    *length = n;
+    return data;
+}
+
+/* Compare every option of a with b's, without looking at hashes */
+static long compare(vc_sect *a, vc_sect *b) {
+    long differ = 0;
+    index_node *in;
+    fasthash_node *node, *match;
+
+    for (in = a->ht->index_list; in; in = in->next) {
+        for (node = a->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data, *other;
+            if (!(match = fasthash_lookup(b->ht, node->key))) {
+                differ++;
+                continue;
+            }
+            other = (vc_opt *)match->data;
+            if (opt->type != other->type) differ++;
+            else if (opt->type == VC_SECTION) differ += compare((vc_sect *)opt->value, (vc_sect *)other->value);
+            else if (opt->type == VC_INTEGER) differ += *((int *)opt->value) != *((int *)other->value);
+            else if (opt->type == VC_STRING) differ += strcmp((char *)opt->value, (char *)other->value) != 0;
+        }
+    }
+    return differ;
+}
+
+static int count_change(const char *path, vc_diff_change change, vc_opt *before, vc_opt *after, void *ctx) {
+    (void)path;
+    (void)change;
+    (void)before;
+    (void)after;
+    (void)ctx;
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: hashflood.c
+ *
+ * Hash-flooding benchmark.  djb2 maps "az" and "bY" to the same value,
+ * so keys built from n such blocks make 2^n keys of identical hash.  A
+ * config with these keys is parsed and every key looked up, with djb2
+ * and with seeded hashing, beside a config with ordinary keys.
+ *
+ * Usage: hashflood [blocks]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_BLOCKS 13
+#define MAX_BLOCKS     20
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void make_key(char *key, long i, int blocks, int flood);
+static void run(char *label, int blocks, int flood, int flags);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int blocks = argc > 1 ? atoi(argv[1]) : DEFAULT_BLOCKS;
+
+    if (blocks <= 0 || blocks > MAX_BLOCKS) {
+        printf("Usage: %s [blocks, up to %d]\n", argv[0], MAX_BLOCKS);
+        return 1;
+    }
+
+    printf("%ld keys of %d characters\n", 1L << blocks, blocks * 2);
+    printf("%-22s %12s %14s %10s\n", "", "parse (ms)", "lookup (ns)", "chain");
+    run("ordinary keys, djb2", blocks, 0, 0);
+    run("ordinary keys, seeded", blocks, 0, VC_PARAM_SEEDED_HASH);
+    run("flood keys, djb2", blocks, 1, 0);
+    run("flood keys, seeded", blocks, 1, VC_PARAM_SEEDED_HASH);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Key i: each bit picks one of two blocks.  Flood blocks collide under
+ * djb2; ordinary ones don't. */
+static void make_key(char *key, long i, int blocks, int flood) {
+    int b;
+    for (b = 0; b < blocks; b++) {
+        memcpy(key + 2 * b, (i >> b) & 1 ? (flood ? "bY" : "kq") : "az", 2);
+    }
+    key[2 * blocks] = '\0';
+}
+
+static void run(char *label, int blocks, int flood, int flags) {
+    long nkeys = 1L << blocks, i;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    char key[MAX_BLOCKS * 2 + 8] = "flood.";
+    vc_params params = {path, 0, flags, 0, 0};
+    double start, parse, lookup;
+    uint32_t longest = 0, b;
+    vconfig *vcfg, *sect;
+    FILE *f;
+    int fd;
+
+    if ((fd = mkstemp(path)) < 0 || !(f = fdopen(fd, "w"))) return;
+    fprintf(f, "[flood]\n");
+    for (i = 0; i < nkeys; i++) {
+        make_key(key + 6, i, blocks, flood);
+        fprintf(f, "%s = %ld\n", key + 6, i);
+    }
+    fprintf(f, "[/flood]\n");
+    fclose(f);
+
+    start = now();
+    vcfg = vconfig_open(&params);
+    parse = now() - start;
+    unlink(path);
+    if (!vcfg) return;
+
+    start = now();
+    for (i = 0; i < nkeys; i++) {
+        make_key(key + 6, i, blocks, flood);
+        if (!vconfig_getint(vcfg, key)) printf("%s: missing\n", key);
+    }
+    lookup = now() - start;
+
+    /* Longest chain of the section's table */
+    sect = vconfig_getsect(vcfg, "flood");
+    for (b = 0; sect && b < sect->ht->size; b++) {
+        fasthash_node *node;
+        uint32_t n = 0;
+        for (node = sect->ht->entries[b]; node; node = node->next) n++;
+        if (n > longest) longest = n;
+    }
+
+    printf("%-22s %12.2f %14.1f %10u\n", label, parse * 1e3, lookup * 1e9 / nkeys, longest);
+    vconfig_close(vcfg);
+}
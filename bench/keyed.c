@@ -0,0 +1,156 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: keyed.c
+ *
+ * Lookup benchmark: look up every option of a nested config by its
+ * option path string, then by a path hashed ahead of time, as the
+ * accessors generated by vconfig-gen do.
+ *
+ * Usage: keyed [depth] [options per section] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_DEPTH   4
+#define DEFAULT_OPTIONS 64
+#define DEFAULT_ROUNDS  500
+#define MAX_LEVELS      15
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static vc_keypath *keypath(char *path);
+static double run(char *path, int flags, char **keys, vc_keypath **kps, int nkeys, int rounds);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int depth = argc > 1 ? atoi(argv[1]) : DEFAULT_DEPTH;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    char prefix[MAX_LEVELS * 8 + 1] = "";
+    char **keys;
+    vc_keypath **kps;
+    double walk[2], keyed[2];
+    FILE *f;
+    int fd, d, i, flags, nkeys = 0;
+
+    if (depth <= 0 || depth > MAX_LEVELS || options <= 0 || rounds <= 0 ||
+        (fd = mkstemp(path)) < 0 || !(f = fdopen(fd, "w"))) {
+        printf("Usage: %s [depth, up to %d] [options per section] [rounds]\n", argv[0], MAX_LEVELS);
+        return 1;
+    }
+
+    /* A chain of nested sections, with options at every level */
+    keys = (char **)calloc(depth * options, sizeof(char *));
+    kps = (vc_keypath **)calloc(depth * options, sizeof(vc_keypath *));
+    for (d = 0; d < depth; d++) {
+        for (i = 0; i < options; i++) {
+            fprintf(f, "opt%d = %d\n", i, d * options + i);
+            keys[nkeys] = (char *)malloc(strlen(prefix) + 16);
+            sprintf(keys[nkeys], "%sopt%d", prefix, i);
+            kps[nkeys] = keypath(keys[nkeys]);
+            nkeys++;
+        }
+        fprintf(f, "[level%d]\n", d);
+        sprintf(prefix + strlen(prefix), "level%d.", d);
+    }
+    for (d = depth - 1; d >= 0; d--) fprintf(f, "[/level%d]\n", d);
+    fclose(f);
+
+    for (flags = 0; flags < 2; flags++) {
+        walk[flags] = run(path, flags ? VC_PARAM_PATH_INDEX : 0, keys, 0, nkeys, rounds);
+        keyed[flags] = run(path, flags ? VC_PARAM_PATH_INDEX : 0, keys, kps, nkeys, rounds);
+    }
+    unlink(path);
+
+    printf("%d levels, %d options each, %d rounds\n", depth, options, rounds);
+    printf("walking sections, path strings:   %8.1f ns/lookup\n", walk[0]);
+    printf("walking sections, pre-hashed:     %8.1f ns/lookup (%.2fx)\n", keyed[0], walk[0] / keyed[0]);
+    printf("full-path index, path strings:    %8.1f ns/lookup\n", walk[1]);
+    printf("full-path index, pre-hashed:      %8.1f ns/lookup (%.2fx)\n", keyed[1], walk[1] / keyed[1]);
+
+    for (i = 0; i < nkeys; i++) {
+        free(keys[i]);
+        free(kps[i]);
+    }
+    free(keys);
+    free(kps);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Hash a path ahead of time, as vconfig-gen does.  The segments are
+ * stored after the path, and point into it. */
+static vc_keypath *keypath(char *path) {
+    vc_keypath *kp = (vc_keypath *)malloc(sizeof(vc_keypath) + (MAX_LEVELS + 1) * sizeof(vc_key));
+    vc_key *segs = (vc_key *)(kp + 1);
+    char *seg, *end;
+    uint32_t n = 0;
+
+    for (seg = path; seg; seg = *end ? end + 1 : 0, n++) {
+        for (end = seg; *end && *end != '.'; end++);
+        segs[n].key = seg;
+        segs[n].length = end - seg;
+        segs[n].hash = hashn_djb2((unsigned char *)seg, end - seg);
+    }
+    kp->path.key = path;
+    kp->path.length = strlen(path);
+    kp->path.hash = hashn_djb2((unsigned char *)path, strlen(path));
+    kp->segs = segs;
+    kp->nsegs = n;
+    return kp;
+}
+
+/* Average time of a lookup, in nanoseconds */
+static double run(char *path, int flags, char **keys, vc_keypath **kps, int nkeys, int rounds) {
+    vc_params params = {path, 0, flags, 0, 0};
+    vconfig *vcfg = vconfig_open(&params);
+    double start, elapsed;
+    vc_stats stats;
+    int r, i;
+
+    if (!vcfg) return 0;
+
+    /* The index is built on the first lookup; leave that out */
+    vconfig_stats(vcfg, &stats);
+
+    start = now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < nkeys; i++) {
+            int *v = kps ? (int *)vconfig_getval_key(vcfg, kps[i], VC_INTEGER) : vconfig_getint(vcfg, keys[i]);
+            if (!v) printf("%s: missing\n", keys[i]);
+        }
+    }
+    elapsed = now() - start;
+
+    vconfig_close(vcfg);
+    return elapsed * 1e9 / ((double)rounds * nkeys);
+}
@@ -0,0 +1,120 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: open-many.c
+ *
+ * Startup benchmark: load N generated config files with a loop of
+ * vconfig_open_simple, then with vconfig_open_many.
+ *
+ * Usage: open-many [files] [options per file] [threads]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+#include "vcthread.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_FILES   800
+#define DEFAULT_OPTIONS 200
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void write_config(char *path, int tenant, int options);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int nfiles = argc > 1 ? atoi(argv[1]) : DEFAULT_FILES;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    vc_batch_params opts = {0, 0, argc > 3 ? atoi(argv[3]) : 0, 0};
+    char dir[] = "/tmp/vc-bench-XXXXXX";
+    char **paths;
+    vconfig **confs;
+    vc_load_error *errors;
+    double start, serial, batch;
+    size_t loaded;
+    int i;
+
+    if (nfiles <= 0 || options <= 0 || !mkdtemp(dir)) {
+        printf("Usage: %s [files] [options per file] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    paths = (char **)calloc(nfiles, sizeof(char *));
+    confs = (vconfig **)calloc(nfiles, sizeof(vconfig *));
+    errors = (vc_load_error *)calloc(nfiles, sizeof(vc_load_error));
+    for (i = 0; i < nfiles; i++) {
+        paths[i] = (char *)malloc(64);
+        snprintf(paths[i], 64, "%s/tenant-%d.cfg", dir, i);
+        write_config(paths[i], i, options);
+    }
+
+    /* One file at a time */
+    start = now();
+    for (i = 0; i < nfiles; i++) confs[i] = vconfig_open_simple(paths[i]);
+    serial = now() - start;
+    for (i = 0; i < nfiles; i++) vconfig_close(confs[i]);
+
+    /* All at once */
+    start = now();
+    loaded = vconfig_open_many(paths, nfiles, &opts, confs, errors);
+    batch = now() - start;
+    for (i = 0; i < nfiles; i++) {
+        if (!confs[i]) printf("%s: %s\n", paths[i], errors[i].msg);
+        else vconfig_close(confs[i]);
+    }
+
+    printf("%d files, %d options each, %d CPUs\n", nfiles, options, vc_cpu_count());
+    printf("vconfig_open_simple loop: %8.2f ms\n", serial * 1e3);
+    printf("vconfig_open_many:        %8.2f ms (%zu loaded, %.2fx)\n",
+        batch * 1e3, loaded, serial / batch);
+
+    for (i = 0; i < nfiles; i++) {
+        unlink(paths[i]);
+        free(paths[i]);
+    }
+    rmdir(dir);
+    free(paths);
+    free(confs);
+    free(errors);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* A tenant config: a few top-level options and sections of options */
+static void write_config(char *path, int tenant, int options) {
+    FILE *f = fopen(path, "w");
+    int i;
+
+    if (!f) return;
+    fprintf(f, "tenant = \"tenant-%d\"\nenabled = true\n", tenant);
+    for (i = 0; i < options; i++) {
+        if (i % 20 == 0) fprintf(f, "[backend%d]\n", i / 20);
+        fprintf(f, "option%d = %d\nname%d = \"value %d for tenant %d\"\n", i, i * tenant, i, i, tenant);
+        if (i % 20 == 19 || i == options - 1) fprintf(f, "[/backend%d]\n", i / 20);
+    }
+    fclose(f);
+}
@@ -0,0 +1,120 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: pathindex.c
+ *
+ * Lookup benchmark: look up options at every depth of a nested config,
+ * walking the sections, then with the full-path index.
+ *
+ * Usage: pathindex [depth] [options per section] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_DEPTH   12
+#define DEFAULT_OPTIONS 64
+#define DEFAULT_ROUNDS  200
+#define MAX_LEVELS       15
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static double run(char *path, int flags, char **keys, int nkeys, int rounds);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int depth = argc > 1 ? atoi(argv[1]) : DEFAULT_DEPTH;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    char prefix[MAX_LEVELS * 8 + 1] = "";
+    char **keys;
+    double walk, indexed;
+    FILE *f;
+    int fd, d, i, nkeys = 0;
+
+    if (depth <= 0 || depth > MAX_LEVELS || options <= 0 || rounds <= 0 ||
+        (fd = mkstemp(path)) < 0 || !(f = fdopen(fd, "w"))) {
+        printf("Usage: %s [depth, up to %d] [options per section] [rounds]\n", argv[0], MAX_LEVELS);
+        return 1;
+    }
+
+    /* A chain of nested sections, with options at every level */
+    keys = (char **)calloc(depth * options, sizeof(char *));
+    for (d = 0; d < depth; d++) {
+        for (i = 0; i < options; i++) {
+            fprintf(f, "opt%d = %d\n", i, d * options + i);
+            keys[nkeys] = (char *)malloc(strlen(prefix) + 16);
+            sprintf(keys[nkeys++], "%sopt%d", prefix, i);
+        }
+        fprintf(f, "[level%d]\n", d);
+        sprintf(prefix + strlen(prefix), "level%d.", d);
+    }
+    for (d = depth - 1; d >= 0; d--) fprintf(f, "[/level%d]\n", d);
+    fclose(f);
+
+    walk = run(path, 0, keys, nkeys, rounds);
+    indexed = run(path, VC_PARAM_PATH_INDEX, keys, nkeys, rounds);
+    unlink(path);
+
+    printf("%d levels, %d options each, %d rounds\n", depth, options, rounds);
+    printf("walking sections: %8.1f ns/lookup\n", walk);
+    printf("full-path index:  %8.1f ns/lookup (%.2fx)\n", indexed, walk / indexed);
+
+    for (i = 0; i < nkeys; i++) free(keys[i]);
+    free(keys);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Average time of a lookup, in nanoseconds */
+static double run(char *path, int flags, char **keys, int nkeys, int rounds) {
+    vc_params params = {path, 0, flags, 0, 0};
+    vconfig *vcfg = vconfig_open(&params);
+    double start, elapsed;
+    vc_stats stats;
+    int r, i;
+
+    if (!vcfg) return 0;
+
+    /* The index is built on the first lookup; leave that out */
+    vconfig_stats(vcfg, &stats);
+    if (flags) printf("index: %zu paths, %zu bytes\n", stats.index_entries, stats.index_bytes);
+
+    start = now();
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < nkeys; i++) {
+            if (!vconfig_getint(vcfg, keys[i])) printf("%s: missing\n", keys[i]);
+        }
+    }
+    elapsed = now() - start;
+
+    vconfig_close(vcfg);
+    return elapsed * 1e9 / ((double)rounds * nkeys);
+}
@@ -0,0 +1,122 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: query.c
+ *
+ * Query benchmark: match a key prefix in a large section, and a name
+ * under every one of many sections, with and without VC_PARAM_KEY_INDEX.
+ *
+ * Usage: query [keys] [matches] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_KEYS    100000
+#define DEFAULT_MATCHES 16
+#define DEFAULT_ROUNDS  200
+#define UPSTREAMS       1000
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static int count(const char *path, vc_type type, void *value, void *ctx);
+static double run(char *path, int flags, char *pattern, long expect, int rounds);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYS;
+    int matches = argc > 2 ? atoi(argv[2]) : DEFAULT_MATCHES;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    double scan[2], upstream[2];
+    FILE *f;
+    int fd, i, flags;
+
+    if (keys <= 0 || matches < 0 || matches > keys || rounds <= 0 ||
+        (fd = mkstemp(path)) < 0 || !(f = fdopen(fd, "w"))) {
+        printf("Usage: %s [keys] [matches, up to keys] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    /* A large flat section, a few of whose keys share a prefix, and many
+     * small sections with a port each */
+    fprintf(f, "[features]\n");
+    for (i = 0; i < keys; i++) fprintf(f, "%s%d = %d\n", i < matches ? "beta_" : "opt", i, i);
+    fprintf(f, "[/features]\n[upstreams]\n");
+    for (i = 0; i < UPSTREAMS; i++) fprintf(f, "[u%d]\nport = %d\nhost = \"h%d\"\n[/u%d]\n", i, i, i, i);
+    fprintf(f, "[/upstreams]\n");
+    fclose(f);
+
+    for (flags = 0; flags < 2; flags++) {
+        scan[flags] = run(path, flags ? VC_PARAM_KEY_INDEX : 0, "features.beta_*", matches, rounds);
+        upstream[flags] = run(path, flags ? VC_PARAM_KEY_INDEX : 0, "upstreams.*.port", UPSTREAMS, rounds);
+    }
+    unlink(path);
+
+    printf("%d keys, %d matching, %d rounds\n", keys, matches, rounds);
+    printf("features.beta_*, hash table scan:  %10.1f us/query\n", scan[0]);
+    printf("features.beta_*, sorted keys:      %10.1f us/query (%.0fx)\n", scan[1], scan[0] / scan[1]);
+    printf("upstreams.*.port, hash table scan: %10.1f us/query\n", upstream[0]);
+    printf("upstreams.*.port, sorted keys:     %10.1f us/query (%.2fx)\n", upstream[1], upstream[0] / upstream[1]);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int count(const char *path, vc_type type, void *value, void *ctx) {
+    (void)path;
+    (void)type;
+    (void)value;
+    (*(long *)ctx)++;
+    return 0;
+}
+
+/* Average time of a query, in microseconds */
+static double run(char *path, int flags, char *pattern, long expect, int rounds) {
+    vc_params params = {path, 0, flags, 0, 0};
+    vconfig *vcfg = vconfig_open(&params);
+    double start, elapsed;
+    long n;
+    int r;
+
+    if (!vcfg) return 0;
+
+    /* Keys are sorted by the first query; leave that out */
+    vconfig_query(vcfg, pattern, 0, 0);
+
+    start = now();
+    for (r = 0; r < rounds; r++) {
+        n = 0;
+        if (vconfig_query(vcfg, pattern, count, &n) != expect || n != expect) {
+            printf("%s: %ld matches, expected %ld\n", pattern, n, expect);
+        }
+    }
+    elapsed = now() - start;
+
+    vconfig_close(vcfg);
+    return elapsed * 1e6 / rounds;
+}
@@ -0,0 +1,118 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: share.c
+ *
+ * Shared section benchmark: load many tenant configs that differ in a
+ * few options of their own but repeat the same common sections, with
+ * and without VC_PARAM_SHARE_SECTIONS, and compare the load time and
+ * the heap held by the loaded configs.
+ *
+ * Usage: share [tenants] [common sections] [options]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_TENANTS     10000
+#define DEFAULT_SECTIONS    8
+#define DEFAULT_OPTIONS     10
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static char *build(int tenant, int sections, int options, size_t *length);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int tenants = argc > 1 ? atoi(argv[1]) : DEFAULT_TENANTS;
+    int sections = argc > 2 ? atoi(argv[2]) : DEFAULT_SECTIONS;
+    int options = argc > 3 ? atoi(argv[3]) : DEFAULT_OPTIONS;
+    static const int modes[2] = {0, VC_PARAM_SHARE_SECTIONS};
+    double load[2], start;
+    size_t heap[2], before, length;
+    vconfig **confs;
+    char *data;
+    int i, m;
+
+    if (tenants <= 0 || sections <= 0 || options <= 0) {
+        printf("Usage: %s [tenants] [common sections] [options per section]\n", argv[0]);
+        return 1;
+    }
+
+    confs = (vconfig **)malloc(sizeof(vconfig *) * tenants);
+    if (!confs) return 1;
+
+    for (m = 0; m < 2; m++) {
+        vc_params p = {0, 0, modes[m], 0, 0};
+
+        before = mallinfo2().uordblks;
+        load[m] = 0;
+        for (i = 0; i < tenants; i++) {
+            if (!(data = build(i, sections, options, &length))) return 1;
+            start = now();
+            confs[i] = vconfig_parse_buffer(data, length, &p);
+            load[m] += now() - start;
+            free(data);
+            if (!confs[i]) return 1;
+        }
+        heap[m] = mallinfo2().uordblks - before;
+        if (m) printf("%zu distinct shared sections\n", vc_share_count());
+        for (i = 0; i < tenants; i++) vconfig_close(confs[i]);
+    }
+    free(confs);
+
+    printf("%d tenants, %d common sections of %d options\n", tenants, sections, options);
+    printf("              load         heap\n");
+    printf("private  %7.1f ms %9.1f MB\n", load[0] * 1e3, heap[0] / 1048576.0);
+    printf("shared   %7.1f ms %9.1f MB (%.1fx less)\n", load[1] * 1e3, heap[1] / 1048576.0,
+           (double)heap[0] / heap[1]);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* A tenant's own options, then the common sections, each with a nested
+ * section of its own */
+static char *build(int tenant, int sections, int options, size_t *length) {
+    size_t cap = (size_t)(sections + 1) * (options + 6) * 64;
+    char *data = (char *)malloc(cap);
+    int i, j;
+
+    if (!data) return 0;
+    *length = sprintf(data, "tenant = %d\nname = \"tenant-%d\"\n", tenant, tenant);
+    for (i = 0; i < sections; i++) {
+        *length += sprintf(data + *length, "[common%d]\n", i);
+        for (j = 0; j < options; j++) {
+            if (j % 2) *length += sprintf(data + *length, "opt%d = \"value %d.%d\"\n", j, i, j);
+            else *length += sprintf(data + *length, "opt%d = %d\n", j, i + j);
+        }
+        *length += sprintf(data + *length, "[limits]\ntimeout = 30s\nmax_body = 1MiB\n[/limits]\n");
+        *length += sprintf(data + *length, "[/common%d]\n", i);
+    }
+    return data;
+}
@@ -0,0 +1,153 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: tape.c
+ *
+ * Tape benchmark: parse a large nested config into sections and into a
+ * tape, walk every option of each summing the integers and string
+ * lengths, and free them.
+ *
+ * Usage: tape [sections] [options] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_SECTIONS    5000
+#define DEFAULT_OPTIONS     20
+#define DEFAULT_ROUNDS      10
+#define GROUP_SIZE          64
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static long long walk_sect(vc_sect *sect);
+static long long walk_tape(vc_tape *tape);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int sections = argc > 1 ? atoi(argv[1]) : DEFAULT_SECTIONS;
+    int options = argc > 2 ? atoi(argv[2]) : DEFAULT_OPTIONS;
+    int rounds = argc > 3 ? atoi(argv[3]) : DEFAULT_ROUNDS;
+    double parse[2] = {0, 0}, walk[2] = {0, 0}, teardown[2] = {0, 0}, start;
+    long long sums[2];
+    size_t length = 0, cap;
+    char *data;
+    int i, j, r;
+
+    if (sections <= 0 || options <= 0 || rounds <= 0) {
+        printf("Usage: %s [sections] [options per section] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    /* Sections two deep, in groups of GROUP_SIZE, with integers and
+     * strings alternating */
+    cap = (size_t)sections * (options + 4) * 48;
+    data = (char *)malloc(cap);
+    if (!data) return 1;
+    for (i = 0; i < sections; i++) {
+        if (i % GROUP_SIZE == 0) length += sprintf(data + length, "[group%d]\n", i / GROUP_SIZE);
+        length += sprintf(data + length, "[s%d]\n", i);
+        for (j = 0; j < options; j++) {
+            if (j % 2) length += sprintf(data + length, "opt%d = \"value %d.%d\"\n", j, i, j);
+            else length += sprintf(data + length, "opt%d = %d\n", j, i + j);
+        }
+        length += sprintf(data + length, "[/s%d]\n", i);
+        if (i % GROUP_SIZE == GROUP_SIZE - 1 || i == sections - 1) {
+            length += sprintf(data + length, "[/group%d]\n", i / GROUP_SIZE);
+        }
+    }
+
+    for (r = 0; r < rounds; r++) {
+        vconfig *vcfg;
+        vc_tape *tape;
+
+        start = now();
+        vcfg = vconfig_parse_buffer(data, length, 0);
+        parse[0] += now() - start;
+        start = now();
+        sums[0] = walk_sect(vcfg);
+        walk[0] += now() - start;
+        start = now();
+        vconfig_close(vcfg);
+        teardown[0] += now() - start;
+
+        start = now();
+        tape = vconfig_tape_parse(data, length, 0);
+        parse[1] += now() - start;
+        start = now();
+        sums[1] = walk_tape(tape);
+        walk[1] += now() - start;
+        start = now();
+        vconfig_tape_free(tape);
+        teardown[1] += now() - start;
+
+        if (sums[0] != sums[1]) printf("Walks differ: %lld, %lld\n", sums[0], sums[1]);
+    }
+    free(data);
+
+    printf("%d sections, %d options each, %zu bytes, %d rounds\n", sections, options, length, rounds);
+    printf("           sections      tape\n");
+    printf("parse    %9.2f ms %9.2f ms (%.1fx)\n", parse[0] * 1e3 / rounds, parse[1] * 1e3 / rounds, parse[0] / parse[1]);
+    printf("walk     %9.2f ms %9.2f ms (%.1fx)\n", walk[0] * 1e3 / rounds, walk[1] * 1e3 / rounds, walk[0] / walk[1]);
+    printf("free     %9.2f ms %9.2f ms (%.1fx)\n", teardown[0] * 1e3 / rounds, teardown[1] * 1e3 / rounds, teardown[0] / teardown[1]);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Visit every option through the hash tables, as vcwrite does */
+static long long walk_sect(vc_sect *sect) {
+    long long sum = 0;
+    index_node *in;
+    fasthash_node *node;
+
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            switch (opt->type) {
+                case VC_INTEGER: sum += *((int *)opt->value); break;
+                case VC_STRING:  sum += strlen((char *)opt->value); break;
+                case VC_SECTION: sum += walk_sect((vc_sect *)opt->value); break;
+                default: break;
+            }
+        }
+    }
+    return sum;
+}
+
+/* The same, in tape order */
+static long long walk_tape(vc_tape *tape) {
+    long long sum = 0;
+    size_t i;
+
+    for (i = 0; i < tape->length; i++) {
+        vc_tape_entry *e = &(tape->entries[i]);
+        if (e->type == VC_TAPE_INTEGER) sum += e->v.i;
+        else if (e->type == VC_TAPE_STRING) sum += e->length;
+    }
+    return sum;
+}
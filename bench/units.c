@@ -0,0 +1,132 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: units.c
+ *
+ * Unit benchmark: the same durations and sizes held as typed values, and
+ * as strings that the reader converts on every use, as code did before
+ * configs knew about units.  Times the parse of each config, and then
+ * rounds of reading every value.
+ *
+ * Usage: units [options] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_OPTIONS     10000
+#define DEFAULT_ROUNDS      100
+
+static const char *values[] = {"30s", "2h30m", "1.5ms", "250us", "512MiB", "4KB", "1.5GiB", "100B"};
+#define NVALUES (sizeof(values) / sizeof(values[0]))
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static char *build(int options, int quoted, size_t *length);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int options = argc > 1 ? atoi(argv[1]) : DEFAULT_OPTIONS;
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    double parse[2], read[2] = {0, 0}, start;
+    long long sums[2] = {0, 0};
+    vconfig *vcfg[2];
+    char **paths;
+    size_t length;
+    char *data;
+    int i, k, r;
+
+    if (options <= 0 || rounds <= 0) {
+        printf("Usage: %s [options] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    paths = (char **)malloc(sizeof(char *) * options);
+    if (!paths) return 1;
+    for (i = 0; i < options; i++) {
+        paths[i] = (char *)malloc(16);
+        if (!paths[i]) return 1;
+        sprintf(paths[i], "opt%d", i);
+    }
+
+    /* Typed values, then the same as strings */
+    for (k = 0; k < 2; k++) {
+        data = build(options, k, &length);
+        if (!data) return 1;
+        start = now();
+        vcfg[k] = vconfig_parse_buffer(data, length, 0);
+        parse[k] = now() - start;
+        free(data);
+        if (!vcfg[k]) return 1;
+    }
+
+    for (r = 0; r < rounds; r++) {
+        start = now();
+        for (i = 0; i < options; i++) {
+            int64_t *v = (i % NVALUES) < 4 ? vconfig_getduration_ns(vcfg[0], paths[i])
+                                            : vconfig_getbytes(vcfg[0], paths[i]);
+            if (v) sums[0] += *v;
+        }
+        read[0] += now() - start;
+
+        start = now();
+        for (i = 0; i < options; i++) {
+            char *str = vconfig_getstr(vcfg[1], paths[i]);
+            vc_unit_value v;
+            if (str && vc_unit_parse(str, strlen(str), &v)) sums[1] += v.i;
+        }
+        read[1] += now() - start;
+    }
+    if (sums[0] != sums[1]) printf("Sums differ: %lld, %lld\n", sums[0], sums[1]);
+
+    printf("%d options, %d rounds\n", options, rounds);
+    printf("               typed    strings\n");
+    printf("parse     %7.2f ms %7.2f ms\n", parse[0] * 1e3, parse[1] * 1e3);
+    printf("read      %7.1f ns %7.1f ns per value (%.1fx)\n",
+           read[0] * 1e9 / rounds / options, read[1] * 1e9 / rounds / options, read[1] / read[0]);
+
+    for (k = 0; k < 2; k++) vconfig_close(vcfg[k]);
+    for (i = 0; i < options; i++) free(paths[i]);
+    free(paths);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* One option per value, cycling through durations and sizes */
+static char *build(int options, int quoted, size_t *length) {
+    char *data = (char *)malloc((size_t)options * 32);
+    const char *q = quoted ? "\"" : "";
+    int i;
+
+    if (!data) return 0;
+    *length = 0;
+    for (i = 0; i < options; i++) {
+        *length += sprintf(data + *length, "opt%d = %s%s%s\n", i, q, values[i % NVALUES], q);
+    }
+    return data;
+}
@@ -0,0 +1,166 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: utf8.c
+ *
+ * UTF-8 benchmark: check a buffer of mixed text with each implementation
+ * of vc_utf8_check_impl, against copying it with memcpy, then parse a
+ * config of long string values with and without VC_PARAM_VALIDATE_UTF8.
+ *
+ * Usage: utf8 [megabytes] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vconfig.h"
+#include "vcutf8.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_MEGABYTES   16
+#define DEFAULT_ROUNDS      20
+#define VALUE_LENGTH        200
+
+static const char *impls[] = {
+    #define XX(name) #name,
+    VC_UTF8_IMPLS(XX)
+    #undef XX
+};
+
+/* Text to repeat: mostly ASCII, with two, three and four byte forms */
+static const char *words[] = {
+    "config", "value", "server", "caf\xc3\xa9", "na\xc3\xafve", "\xe2\x82\xac" "42",
+    "\xe6\x97\xa5\xe6\x9c\xac", "\xf0\x9f\x98\x80", "timeout", "upstream"
+};
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static size_t fill(char *data, size_t length);
+static char *generate(size_t size, size_t *length);
+static double parse(char *data, size_t length, int flags, int rounds);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int megabytes = argc > 1 ? atoi(argv[1]) : DEFAULT_MEGABYTES;
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    size_t size, length, valid = 0;
+    double start, copy, check, plain, validated;
+    char *text, *dst, *conf;
+    int i, r;
+
+    if (megabytes <= 0 || rounds <= 0) {
+        printf("Usage: %s [megabytes] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    size = (size_t)megabytes << 20;
+    text = (char *)malloc(size);
+    dst = (char *)malloc(size);
+    if (!text || !dst) return 1;
+    size = fill(text, size);
+
+    start = now();
+    for (r = 0; r < rounds; r++) memcpy(dst, text, size);
+    copy = now() - start;
+    printf("%d MB of text, best implementation %s\n", megabytes, impls[vc_utf8_get_impl()]);
+    printf("memcpy:  %8.2f GB/s\n", (double)size * rounds / copy / 1e9);
+
+    for (i = 0; i <= (int)vc_utf8_get_impl(); i++) {
+        start = now();
+        for (r = 0; r < rounds; r++) valid += vc_utf8_check_impl(text, size, (vc_utf8_impl)i) == size;
+        check = now() - start;
+        printf("%-8s %8.2f GB/s\n", impls[i], (double)size * rounds / check / 1e9);
+    }
+    if (valid != (size_t)rounds * (vc_utf8_get_impl() + 1)) printf("Text failed to validate\n");
+
+    /* Parsing, where the strings are checked as they're scanned */
+    conf = generate(size, &length);
+    if (!conf) return 1;
+    plain = parse(conf, length, 0, rounds);
+    validated = parse(conf, length, VC_PARAM_VALIDATE_UTF8, rounds);
+    printf("parse:           %8.2f ms\n", plain * 1e3);
+    printf("parse, checked:  %8.2f ms (%+.1f%%)\n", validated * 1e3, (validated / plain - 1) * 100);
+
+    free(text);
+    free(dst);
+    free(conf);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Fill with words separated by spaces, stopping before one would be cut
+ * off.  Returns the length filled. */
+static size_t fill(char *data, size_t length) {
+    size_t n = 0, w;
+    unsigned i;
+
+    for (i = 0; ; i = i * 1103515245 + 12345) {
+        const char *word = words[(i >> 16) % (sizeof(words) / sizeof(words[0]))];
+        w = strlen(word);
+        if (n + w + 1 > length) break;
+        memcpy(data + n, word, w);
+        data[n + w] = ' ';
+        n += w + 1;
+    }
+    return n;
+}
+
+/* Options with string values of about VALUE_LENGTH bytes, in sections of
+ * a hundred, totalling about size bytes */
+static char *generate(size_t size, size_t *length) {
+    char *data = (char *)malloc(size + 4096);
+    size_t n = 0;
+    int i;
+
+    if (!data) return 0;
+    for (i = 0; n + VALUE_LENGTH + 64 < size; i++) {
+        if (i % 100 == 0) n += sprintf(data + n, "[s%d]\n", i / 100);
+        n += sprintf(data + n, "opt%d = \"", i);
+        n += fill(data + n, VALUE_LENGTH);
+        n += sprintf(data + n, "\"\n");
+        if (i % 100 == 99) n += sprintf(data + n, "[/s%d]\n", i / 100);
+    }
+    if (i % 100) n += sprintf(data + n, "[/s%d]\n", (i - 1) / 100);
+    *length = n;
+    return data;
+}
+
+/* Best time of rounds */
+static double parse(char *data, size_t length, int flags, int rounds) {
+    vc_params p = {"utf8.cfg", 0, flags, 0, 0};
+    double best = 0, start, t;
+    vconfig *conf;
+    int r;
+
+    for (r = 0; r < rounds; r++) {
+        start = now();
+        conf = vconfig_parse_buffer(data, length, &p);
+        t = now() - start;
+        if (!conf) return 0;
+        vconfig_close(conf);
+        if (!r || t < best) best = t;
+    }
+    return best;
+}
@@ -0,0 +1,112 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: write.c
+ *
+ * Serializer benchmark: write a generated config repeatedly to /dev/null
+ * with vconfig_write, and to memory with vconfig_write_buffer.
+ *
+ * Usage: write [options] [rounds]
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_OPTIONS 100000
+#define DEFAULT_ROUNDS  20
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static double now(void);
+static void write_config(char *path, int options);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    int options = argc > 1 ? atoi(argv[1]) : DEFAULT_OPTIONS;
+    int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    char path[] = "/tmp/vc-bench-XXXXXX";
+    double start, direct, buffered;
+    size_t length = 0;
+    vconfig *vcfg;
+    int fd, i;
+
+    if (options <= 0 || rounds <= 0 || (fd = mkstemp(path)) < 0) {
+        printf("Usage: %s [options] [rounds]\n", argv[0]);
+        return 1;
+    }
+    close(fd);
+    write_config(path, options);
+    vcfg = vconfig_open_simple(path);
+    unlink(path);
+    if (!vcfg) return 1;
+
+    /* To a file descriptor */
+    fd = open("/dev/null", O_WRONLY);
+    start = now();
+    for (i = 0; i < rounds; i++) {
+        if (!vconfig_write(vcfg, fd, NULL)) perror("vconfig_write");
+    }
+    direct = now() - start;
+    close(fd);
+
+    /* To memory */
+    start = now();
+    for (i = 0; i < rounds; i++) free(vconfig_write_buffer(vcfg, NULL, &length));
+    buffered = now() - start;
+
+    printf("%d options, %zu bytes, %d rounds\n", options, length, rounds);
+    printf("vconfig_write:        %8.2f ms/round (%8.1f MB/s)\n",
+        direct * 1e3 / rounds, length * rounds / direct / 1e6);
+    printf("vconfig_write_buffer: %8.2f ms/round (%8.1f MB/s)\n",
+        buffered * 1e3 / rounds, length * rounds / buffered / 1e6);
+
+    vconfig_close(vcfg);
+    return 0;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Sections of mixed options, with the odd long string */
+static void write_config(char *path, int options) {
+    FILE *f = fopen(path, "w");
+    int i;
+
+    if (!f) return;
+    for (i = 0; i < options; i++) {
+        if (i % 50 == 0) fprintf(f, "[group%d]\n", i / 50);
+        switch (i % 5) {
+        case 0: fprintf(f, "count%d = %d\n", i, i * 7); break;
+        case 1: fprintf(f, "ratio%d = %d.%d\n", i, i, i % 97); break;
+        case 2: fprintf(f, "name%d = \"backend-%d.example.com\"\n", i, i); break;
+        case 3: fprintf(f, "ports%d = [%d, %d, %d]\n", i, i, i + 1, i + 2); break;
+        default:
+            fprintf(f, "banner%d = \"%0*d\"\n", i, 600, i);
+        }
+        if (i % 50 == 49 || i == options - 1) fprintf(f, "[/group%d]\n", i / 50);
+    }
+    fclose(f);
+}
@@ -0,0 +1,161 @@
+/*
+ * Generated by vconfig-gen from tests/gen.cfg.  Do not edit.
+ *
+ * Each accessor returns its option's value, or NULL if the config it
+ * is given lacks the option or holds another type there.
+ */
+
+#ifndef __VCGEN_GT_H
+#define __VCGEN_GT_H
+
+#include "vconfig.h"
+
+/* cache */
+static const vc_key gt_cache_segs_[] = {
+    {"cache", 5, 0x0f355db9u},
+};
+static const vc_keypath gt_cache_path_ = {
+    {"cache", 5, 0x0f355db9u}, gt_cache_segs_, 1
+};
+static inline int64_t *gt_cache(vconfig *vcfg) {
+    return (int64_t *)vconfig_getval_key(vcfg, &gt_cache_path_, VC_SIZE);
+}
+
+/* debug */
+static const vc_key gt_debug_segs_[] = {
+    {"debug", 5, 0x0f49a52cu},
+};
+static const vc_keypath gt_debug_path_ = {
+    {"debug", 5, 0x0f49a52cu}, gt_debug_segs_, 1
+};
+static inline int *gt_debug(vconfig *vcfg) {
+    return (int *)vconfig_getval_key(vcfg, &gt_debug_path_, VC_BOOLEAN);
+}
+
+/* load */
+static const vc_key gt_load_segs_[] = {
+    {"load", 4, 0x7c9a2d85u},
+};
+static const vc_keypath gt_load_path_ = {
+    {"load", 4, 0x7c9a2d85u}, gt_load_segs_, 1
+};
+static inline double *gt_load(vconfig *vcfg) {
+    return (double *)vconfig_getval_key(vcfg, &gt_load_path_, VC_RATIO);
+}
+
+/* name */
+static const vc_key gt_name_segs_[] = {
+    {"name", 4, 0x7c9b0c46u},
+};
+static const vc_keypath gt_name_path_ = {
+    {"name", 4, 0x7c9b0c46u}, gt_name_segs_, 1
+};
+static inline char *gt_name(vconfig *vcfg) {
+    return (char *)vconfig_getval_key(vcfg, &gt_name_path_, VC_STRING);
+}
+
+/* port */
+static const vc_key gt_port_segs_[] = {
+    {"port", 4, 0x7c9c614au},
+};
+static const vc_keypath gt_port_path_ = {
+    {"port", 4, 0x7c9c614au}, gt_port_segs_, 1
+};
+static inline int *gt_port(vconfig *vcfg) {
+    return (int *)vconfig_getval_key(vcfg, &gt_port_path_, VC_INTEGER);
+}
+
+/* ports */
+static const vc_key gt_ports_segs_[] = {
+    {"ports", 5, 0x10288afdu},
+};
+static const vc_keypath gt_ports_path_ = {
+    {"ports", 5, 0x10288afdu}, gt_ports_segs_, 1
+};
+static inline vc_array *gt_ports(vconfig *vcfg) {
+    return (vc_array *)vconfig_getval_key(vcfg, &gt_ports_path_, VC_ARRAY);
+}
+
+/* server */
+static const vc_key gt_server_segs_[] = {
+    {"server", 6, 0x1b84769cu},
+};
+static const vc_keypath gt_server_path_ = {
+    {"server", 6, 0x1b84769cu}, gt_server_segs_, 1
+};
+static inline vconfig *gt_server(vconfig *vcfg) {
+    return (vconfig *)vconfig_getval_key(vcfg, &gt_server_path_, VC_SECTION);
+}
+
+/* server.host-name */
+static const vc_key gt_server_host_name_segs_[] = {
+    {"server", 6, 0x1b84769cu},
+    {"host-name", 9, 0x5ba1bfb1u},
+};
+static const vc_keypath gt_server_host_name_path_ = {
+    {"server.host-name", 16, 0x73f9b296u}, gt_server_host_name_segs_, 2
+};
+static inline char *gt_server_host_name(vconfig *vcfg) {
+    return (char *)vconfig_getval_key(vcfg, &gt_server_host_name_path_, VC_STRING);
+}
+
+/* server.port */
+static const vc_key gt_server_port_segs_[] = {
+    {"server", 6, 0x1b84769cu},
+    {"port", 4, 0x7c9c614au},
+};
+static const vc_keypath gt_server_port_path_ = {
+    {"server.port", 11, 0x9e22b10fu}, gt_server_port_segs_, 2
+};
+static inline int *gt_server_port(vconfig *vcfg) {
+    return (int *)vconfig_getval_key(vcfg, &gt_server_port_path_, VC_INTEGER);
+}
+
+/* server.tls */
+static const vc_key gt_server_tls_segs_[] = {
+    {"server", 6, 0x1b84769cu},
+    {"tls", 3, 0x0b88aeb8u},
+};
+static const vc_keypath gt_server_tls_path_ = {
+    {"server.tls", 10, 0x9ff199ddu}, gt_server_tls_segs_, 2
+};
+static inline vconfig *gt_server_tls(vconfig *vcfg) {
+    return (vconfig *)vconfig_getval_key(vcfg, &gt_server_tls_path_, VC_SECTION);
+}
+
+/* server.tls.level */
+static const vc_key gt_server_tls_level_segs_[] = {
+    {"server", 6, 0x1b84769cu},
+    {"tls", 3, 0x0b88aeb8u},
+    {"level", 5, 0x0fdabc3du},
+};
+static const vc_keypath gt_server_tls_level_path_ = {
+    {"server.tls.level", 16, 0x862fd4a3u}, gt_server_tls_level_segs_, 3
+};
+static inline int *gt_server_tls_level(vconfig *vcfg) {
+    return (int *)vconfig_getval_key(vcfg, &gt_server_tls_level_path_, VC_INTEGER);
+}
+
+/* timeout */
+static const vc_key gt_timeout_segs_[] = {
+    {"timeout", 7, 0xe1fe87ccu},
+};
+static const vc_keypath gt_timeout_path_ = {
+    {"timeout", 7, 0xe1fe87ccu}, gt_timeout_segs_, 1
+};
+static inline int64_t *gt_timeout(vconfig *vcfg) {
+    return (int64_t *)vconfig_getval_key(vcfg, &gt_timeout_path_, VC_DURATION);
+}
+
+/* weight */
+static const vc_key gt_weight_segs_[] = {
+    {"weight", 6, 0x24d3ea4du},
+};
+static const vc_keypath gt_weight_path_ = {
+    {"weight", 6, 0x24d3ea4du}, gt_weight_segs_, 1
+};
+static inline double *gt_weight(vconfig *vcfg) {
+    return (double *)vconfig_getval_key(vcfg, &gt_weight_path_, VC_FLOAT);
+}
+
+#endif /* #ifndef __VCGEN_GT_H */
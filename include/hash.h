@@ -6,6 +6,11 @@
  * 
  * Hash table implementation for configuration parser.  This relies 
  * on the excellent hash function djb2 by Dan Bernstein.
+ *
+ * djb2 is unseeded, so anyone who supplies keys can make them all
+ * collide.  Tables and pools created with FH_KEYED hash with SipHash-1-3
+ * under a random seed of their own instead, for keys that can't be
+ * trusted.
  */
  
 #ifndef __HASH_H
@@ -14,12 +19,18 @@
 /**********************************************************************/
 /**** Begin Includes **************************************************/
 /**********************************************************************/
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "vcalloc.h"
+
 #define FH_NO_COLLISIONS 1
 #define FH_NO_INDEXING 2
+#define FH_KEYED 4          /* Seeded SipHash-1-3 instead of djb2 */
+
+#define FH_LOAD_FACTOR 2    /* Entries per bucket before a table grows */
 
 /**********************************************************************/
 /**** Begin Type Definitions ******************************************/
@@ -33,8 +44,8 @@ typedef struct index_node {
 } index_node;
 
 /* This handle is used when destroying the FastHash table; it is called
- * once for every node in the table. */
-typedef void (*fasthash_destructor)(void *data);
+ * once for every node in the table, with the table's allocator. */
+typedef void (*fasthash_destructor)(void *data, const vc_allocator *alloc);
 
 /* The FastHash table node provides basic linked-list functionality for
  * collision handling, and stores a copy of the key so comparisons can
@@ -45,17 +56,56 @@ typedef struct fasthash_node {
     struct fasthash_node *next; /* Next fasthash node (for collisions) */
 } fasthash_node;
 
+/* Interned string.  Each distinct string is stored once per pool, along
+ * with its hash, so tables sharing the pool can compare keys by pointer
+ * and never rehash them. */
+typedef struct fasthash_string {
+    uint32_t hash;                  /* djb2 hash of the string */
+    uint32_t length;                /* Length, excluding terminator */
+    uint32_t refs;                  /* Times interned, less times released */
+    struct fasthash_string *next;   /* Next string in bucket */
+    char str[];                     /* String bytes */
+} fasthash_string;
+
+/* FastHash string pool.  A hash set over string bytes.  Strings released
+ * as often as they were interned stay until the pool fills, when they
+ * are freed before it grows, so the pool follows the strings in use
+ * rather than every string ever interned. */
+typedef struct fasthash_pool {
+    uint32_t opts;                  /* FH_KEYED, or zero */
+    uint32_t size;                  /* Number of buckets */
+    uint32_t count;                 /* Number of distinct strings */
+    uint64_t seed[2];               /* SipHash key, if FH_KEYED */
+    fasthash_string **entries;      /* Buckets */
+    
+    size_t bytes;                   /* Bytes of string data stored */
+    size_t saved;                   /* Bytes saved by deduplication, over
+                                     * every string ever interned */
+    const vc_allocator *alloc;      /* Allocator (NULL: malloc) */
+} fasthash_pool;
+
+/* Get the interned string header for a pooled key */
+#define FH_STRING(key) \
+    ((fasthash_string *)((char *)(key) - offsetof(fasthash_string, str)))
+
 /* FastHash table definition.  Asside from options and size parameters,
  * the table stores nodes in a malloc'd array, and keeps a linked-list
- * of indices used in the table for table destruction. */
+ * of indices used in the table for table destruction.  Tables that allow
+ * collisions and are indexed double in size as they fill up. */
 typedef struct fasthash_table {
     uint32_t opts;                  /* FastHash table options */
     uint32_t size;                  /* Size of hash table */
+    uint32_t count;                 /* Number of entries */
+    uint64_t seed[2];               /* SipHash key, if FH_KEYED */
     
     fasthash_node **entries;        /* Entries of hash table */
     index_node *index_list;         /* List of entries in the table */
     
     fasthash_destructor destruct;   /* Node data destructor handle */
+    fasthash_pool *pool;            /* Key pool; NULL if keys are copied.
+                                     * Keys are hashed by the pool. */
+    const vc_allocator *alloc;      /* Allocator for the table, its nodes
+                                     * and copied keys (NULL: malloc) */
 } fasthash_table;
 /**********************************************************************/
 /**** Begin Definitions/Static Declarations ***************************/
@@ -68,24 +118,58 @@ typedef struct fasthash_table {
 
 /* FastHash Table Functions */
 /** Create/Destroy **/
-fasthash_table *fasthash_init(uint32_t size, uint32_t opts, fasthash_destructor destruct);
+fasthash_table *fasthash_init(uint32_t size, uint32_t opts, fasthash_destructor destruct, fasthash_pool *pool, const vc_allocator *alloc);
 fasthash_table *fasthash_cleanup(fasthash_table *);
 
+/** Destructor that frees each entry with the table's allocator **/
+void fasthash_free_data(void *data, const vc_allocator *alloc);
+
 /** Insert **/
 uint32_t fasthash_insert(fasthash_table *fh_table, char *key, void *entry);
 uint32_t fasthash_insertn(fasthash_table *fh_table, char *key, size_t length, void *entry);
 
+/** Replace.  Like insert, but an existing node for the key takes the
+ ** new entry, and its previous data is returned in *old (NULL if the
+ ** key was new), without being destroyed. **/
+uint32_t fasthash_replace(fasthash_table *fh_table, char *key, void *entry, void **old);
+uint32_t fasthash_replacen(fasthash_table *fh_table, char *key, size_t length, void *entry, void **old);
+
 /** Force Insert **/
 uint32_t fasthash_force_insert(fasthash_table *fh_table, char *key, void *entry);
 uint32_t fasthash_force_insertn(fasthash_table *fh_table, char *key, size_t length, void *entry);
 
+/** Remove.  Returns the node's data, without destroying it. **/
+void *fasthash_remove(fasthash_table *fh_table, char *key);
+void *fasthash_removen(fasthash_table *fh_table, char *key, size_t length);
+
 /** Lookup **/
 fasthash_node *fasthash_lookup(fasthash_table *fh_table, char *key);
 fasthash_node *fasthash_lookupn(fasthash_table *fh_table, char *key, size_t length);
 
+/** Lookup, given the djb2 hash of the key, as computed ahead of time.
+ ** Keyed tables and pools ignore it, and hash the key themselves. **/
+fasthash_node *fasthash_lookup_hashed(fasthash_table *fh_table, char *key, size_t length, uint32_t hash);
+
+/* FastHash String Pool Functions */
+fasthash_pool *fasthash_pool_init(uint32_t size, uint32_t opts, const vc_allocator *alloc);
+fasthash_pool *fasthash_pool_cleanup(fasthash_pool *pool);
+
+/** Intern a string, returning the pooled copy **/
+char *fasthash_intern(fasthash_pool *pool, char *str, size_t length);
+
+/** Release a pooled string, once for each time it was interned.  Tables
+ ** release their keys as nodes are removed. **/
+void fasthash_release(char *str);
+
+/** Find the pooled copy of a string without adding it **/
+char *fasthash_pool_find(fasthash_pool *pool, char *str, size_t length);
+
 /* Hash Functions */
 /** djb2 hash implementation **/
 uint32_t hash_djb2(unsigned char *str);
 uint32_t hashn_djb2(unsigned char *str, size_t length);
 
+/** SipHash-1-3 with a 128-bit key **/
+uint64_t hash_siphash13(const uint64_t key[2], const unsigned char *data, size_t length);
+
 #endif /* #ifndef HASH_H */
@@ -0,0 +1,74 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcalloc.h
+ *
+ * Allocators.  A config's memory (its sections, options, values, keys,
+ * indexes and edit logs, and the parser's working memory) comes from the
+ * allocator given in vc_params, so it can be put in an arena or a pool,
+ * or counted.  A NULL allocator is malloc, realloc and free.
+ *
+ * The allocator is referenced, not copied, and must outlive every config
+ * opened with it.  Its functions may be called from any thread that
+ * parses, edits or closes one of those configs, and from the threads of
+ * a batch open.
+ *
+ * Some memory still comes from malloc: what the caller frees itself, such
+ * as the buffer from vconfig_write_buffer; what configs share, such as
+ * the include cache, shared sections and shared-memory images; views and
+ * the configs
+ * vconfig_flatten makes; and lists that a lookup or query frees before
+ * it returns.
+ */
+
+#ifndef __VCALLOC_H
+#define __VCALLOC_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Allocator.  The functions behave as malloc, realloc and free, and are
+ * passed ctx first.  free is never called with NULL. */
+typedef struct vc_allocator {
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;                  /* User context */
+} vc_allocator;
+
+/**********************************************************************/
+/**** Begin Definitions/Static Declarations ***************************/
+/**********************************************************************/
+
+static inline void *vc_malloc(const vc_allocator *a, size_t size) {
+    return a ? a->alloc(a->ctx, size) : malloc(size);
+}
+
+static inline void *vc_realloc(const vc_allocator *a, void *ptr, size_t size) {
+    return a ? a->realloc(a->ctx, ptr, size) : realloc(ptr, size);
+}
+
+static inline void vc_free(const vc_allocator *a, void *ptr) {
+    if (!a) free(ptr);
+    else if (ptr) a->free(a->ctx, ptr);
+}
+
+static inline char *vc_strndup(const vc_allocator *a, const char *str, size_t length) {
+    char *copy = (char *)vc_malloc(a, length + 1);
+    if (copy) {
+        memcpy(copy, str, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+#endif /* #ifndef __VCALLOC_H */
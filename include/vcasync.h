@@ -0,0 +1,73 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcasync.h
+ *
+ * Asynchronous loading, for event loops that can't block on a slow
+ * filesystem.  Loads are queued and the call returns at once; a process-
+ * wide I/O thread opens, stats and reads each file through an io_uring,
+ * submitting the steps of many files together, and the contents are
+ * parsed on a worker pool, which then calls back with the config.
+ *
+ * Where io_uring is unavailable (old kernels, or seccomp policies that
+ * forbid it), or the library is built with VC_NO_IO_URING, each file is
+ * instead read with blocking calls on a worker.  A file whose read fails
+ * in the ring with EINVAL or EOPNOTSUPP, as on kernels without the
+ * operation, is retried the same way, and if the ring itself fails, every
+ * load from then on is.
+ *
+ * Callbacks run on a worker thread, never the one that queued the load,
+ * and must hand the config over to the loop themselves.  Errors are
+ * recorded, as for a batch open, and passed to the callback rather than
+ * printed; params->errors is not used.  Included files are loaded by the
+ * parse, on the worker, as for vc_parse_file.
+ */
+
+#ifndef __VCASYNC_H
+#define __VCASYNC_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Called once per load, with the path queued and the config, or NULL
+ * and the first error if it failed to load.  The config belongs to the
+ * callback; the path and error are only valid during the call. */
+typedef void (*vc_async_cb)(const char *path, vc_sect *conf, const vc_load_error *error, void *ctx);
+
+#define VC_ASYNC_MODES(XX)          \
+    XX(NONE)                        \
+    XX(URING)                       \
+    XX(THREADS)
+
+/* How files are read */
+typedef enum {
+    #define XX(name) VC_ASYNC_##name,
+    VC_ASYNC_MODES(XX)
+    #undef XX
+} vc_async_mode;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Queue a load of params->file.  The path and the directive list are
+ * copied; the allocator, as for any config, must outlive the config.
+ * Returns zero if the load couldn't be queued, in which case cb is never
+ * called. */
+int vc_async_open(vc_params *params, vc_async_cb cb, void *ctx);
+
+/* Queue loads of many files at once, sharing the rest of the
+ * parameters.  Returns the number queued; cb is called for each. */
+size_t vc_async_open_many(char **paths, size_t n, vc_batch_params *opts, vc_async_cb cb, void *ctx);
+
+/* How files are being read: VC_ASYNC_NONE before the first load */
+vc_async_mode vc_async_get_mode(void);
+
+#endif /* #ifndef __VCASYNC_H */
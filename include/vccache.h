@@ -0,0 +1,63 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vccache.h
+ *
+ * Per-thread lookup cache.  Code that reads the same few option paths on
+ * every request, by string literals, pays for scanning and hashing each
+ * segment every time.  Configs opened with VC_PARAM_LOOKUP_CACHE have
+ * the vconfig_get* lookups go through a small cache of each thread's,
+ * which maps the section and the address of the path string to the
+ * option found, or to its absence.  The cache is two-way set associative,
+ * as with twenty or so hot paths, a direct-mapped one of this size nearly
+ * always has two of them evicting each other.
+ *
+ * Entries are keyed on the config's generation (see vcedit.h), which
+ * every applied edit changes, and which no other config ever has, so an
+ * edit, or a reload into a new config, leaves stale entries unmatched.
+ * Each entry keeps a copy of its path, which a hit must compare equal,
+ * so a buffer reused for another path is never mistaken for the first.
+ * Paths longer than VC_CACHE_PATH are looked up as usual.
+ *
+ * Entries are never freed or flushed; a thread that stops looking up
+ * just leaves its cache behind, at about 10KB.
+ */
+
+#ifndef __VCCACHE_H
+#define __VCCACHE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_CACHE_SIZE   128     /* Entries per thread, a power of two */
+#define VC_CACHE_WAYS   2       /* Entries a path may be held in */
+#define VC_CACHE_PATH   48      /* Longest path cached, with terminator */
+
+/* Counters of the calling thread's cache, for sizing it */
+typedef struct vc_cache_stats {
+    uint64_t hits;              /* Lookups answered by the cache */
+    uint64_t misses;            /* Lookups that walked the sections */
+    uint64_t evictions;         /* Misses that replaced another path */
+} vc_cache_stats;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Get an option as vc_getopt does, through the calling thread's cache */
+vc_opt *vc_cache_getopt(vc_sect *sect, char *optpath);
+
+/* Get the calling thread's counters */
+void vc_cache_stats_get(vc_cache_stats *stats);
+
+/* Empty the calling thread's cache and zero its counters */
+void vc_cache_reset(void);
+
+#endif /* #ifndef __VCCACHE_H */
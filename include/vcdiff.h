@@ -0,0 +1,82 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcdiff.h
+ *
+ * Content hashes and diffs.  Every section of a parsed config carries a
+ * 128-bit hash of what it holds: its own options, by name, type and
+ * value, in no particular order, the hashes of its subsections, and the
+ * hashes of the files it includes, in include order.  Two sections with
+ * the same hash hold the same options, so a diff of two configs skips
+ * every pair of sections whose hashes match, and its cost follows the
+ * sections on the paths to what changed, not the size of the configs.
+ *
+ * A section is hashed when the parser closes it, unless it waits on an
+ * included file, in which case it is hashed once the include is loaded.
+ * Edits rehash the sections they touch, and those above them, before
+ * releasing the write lock (see vcedit.h).
+ *
+ * The hash is quick rather than cryptographic: it tells apart configs
+ * that differ by accident, but configs built to collide could hide a
+ * change from a diff.
+ */
+
+#ifndef __VCDIFF_H
+#define __VCDIFF_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_DIFF_CHANGES(XX)         \
+    XX(ADDED)                       \
+    XX(REMOVED)                     \
+    XX(MODIFIED)
+
+/* Kinds of change between two configs */
+typedef enum {
+    #define XX(name) VC_DIFF_##name,
+    VC_DIFF_CHANGES(XX)
+    #undef XX
+} vc_diff_change;
+
+/* Called for each change, with its full path (relative to the sections
+ * diffed), and the option before and after it.  before is NULL for an
+ * added option, and after for a removed one.  A section added or removed
+ * is reported once, not option by option.  The path is only valid
+ * during the call.  A nonzero return ends the diff. */
+typedef int (*vc_diff_cb)(const char *path, vc_diff_change change,
+                          vc_opt *before, vc_opt *after, void *ctx);
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Report every option that differs between two parsed configs, or two
+ * sections, as lookups see them, so includes and shadowing apply.  Floats
+ * are compared bit for bit.  Returns the number of changes reported, or
+ * -1 if either is an image or memory ran out. */
+long vc_diff(vc_sect *before, vc_sect *after, vc_diff_cb cb, void *ctx);
+
+/* Hash a section the parser has just closed, unless it, or a section
+ * below it, includes files, which may still be loading. */
+void vc_hash_close(vc_sect *sect);
+
+/* Hash a section and every section below it that needs it.  Files it
+ * includes must have been loaded and hashed. */
+void vc_hash_sect(vc_sect *sect);
+
+/* Mark a section as changed, and the sections above it */
+void vc_hash_drop(vc_sect *sect);
+
+/* Whether two options, other than sections, hold the same value.  Floats
+ * are compared bit for bit. */
+int vc_diff_equal(vc_opt *a, vc_opt *b);
+
+#endif /* #ifndef __VCDIFF_H */
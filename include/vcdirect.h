@@ -7,19 +7,79 @@
  * Directive creation and handling.  Think of directives as user-defined
  * functions within a configuration file, yet the definition is in C.
  * 
- * A splay tree or a trie indexed by hashing the string should provide
- * quick access and not slow down configuration parsing. For now, I just
- * use a list.
+ * The directive list is hashed once when a config is opened, so checking
+ * whether an identifier is a directive costs a single table probe, no
+ * matter how many directives are registered.
  * 
  * Arguments are passed into a directive function as a vc_list; while this
  * is a bit uncomfortable, rest assured, vconfig typechecks for you, so
  * all you have to do is pull the arguments out of the list into variables
- * that you wish to use.
+ * that you wish to use.  The list and its values live on the parser's
+ * stack, and are only valid for the duration of the call.
+ * 
+ * Format characters:
+ *      i - Integer (int)
+ *      f - Float (double); integers are accepted and converted
+ *      b - Boolean (int, 1 or 0)
+ *      s - String (char *)
+ * 
+ * A directive call is a statement of its own, ended by a newline,
+ * semicolon or comment; missing or extra arguments are an error.  A
+ * directive returns a negative value to indicate failure, which stops
+ * parsing of the config.
  */
 
 #ifndef __VCDIRECT_H
 #define __VCDIRECT_H
 
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
 #include "vctype.h"
 
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Maximum number of arguments, given the size of the format string */
+#define VC_DIRECTIVE_MAXARGS 15
+
+/* Bytes available for copies of string arguments, when strings can't
+ * be referenced in place. */
+#define VC_DIRECTIVE_STRBUF 4096
+
+/* Declare a directive entry within a vc_directive array.  Arrays are
+ * terminated with an entry whose name is NULL. */
+#define VC_DIRECTIVE(name, flags, format)                               \
+    {#name, flags, format, VC_DIRECTIVE_##name##_fn__}
+
+/* Define a directive handler.  Handlers needn't use the section, nor
+ * take arguments. */
+#define VC_DEF_DIRECTIVE(name)                                          \
+    int VC_DIRECTIVE_##name##_fn__(vc_sect *sect __attribute__((unused)), \
+                                   vc_list *__dir_args __attribute__((unused)))
+
+/* Pull the next argument out of the argument list */
+#define VC_GETARG_INT() *((int *)__dir_args->value); __dir_args = __dir_args->next
+#define VC_GETARG_FLOAT() *((double *)__dir_args->value); __dir_args = __dir_args->next
+#define VC_GETARG_STR() ((char *)__dir_args->value); __dir_args = __dir_args->next
+#define VC_GETARG_BOOL() VC_GETARG_INT()
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Build/destroy the lookup table for a NULL-terminated directive list */
+fasthash_table *vc_directive_table_create(vc_directive *directives, const vc_allocator *alloc);
+void vc_directive_table_destroy(fasthash_table *table);
+
+/* Find the directive with the given name, or NULL if there is none */
+vc_directive *vc_directive_lookup(fasthash_table *table, char *name, size_t length);
+
+/* Copy a NULL-terminated directive list, names and all, for a parse that
+ * may outlast the caller's list.  Returns NULL if dirs is NULL or memory
+ * runs out.  The copy must be freed with the allocator it was made with. */
+vc_directive *vc_directives_copy(vc_directive *dirs, const vc_allocator *alloc);
+void vc_directives_free(vc_directive *dirs, const vc_allocator *alloc);
+
 #endif /* #ifndef __VCDIRECT_H */
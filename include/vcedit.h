@@ -0,0 +1,121 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcedit.h
+ *
+ * Config edits.  Options can be set, deleted, and sections created, in a
+ * parsed config.  Missing sections along an option path are created, as
+ * with "mkdir -p"; a path running through an option that isn't a section
+ * is an error.  Edits only touch the config itself, never the files it
+ * includes, so setting an included option shadows it.  For the same
+ * reason, edits relative to a section that isn't the config's own, such
+ * as a shared section or one of an included file, as lookups return
+ * them, are refused: they would show in every config holding it.
+ *
+ * Setting an option that already exists updates it in place: its table
+ * node and container are kept, and numbers are overwritten where they
+ * are stored.  String values are copied into the config, and freed when
+ * replaced, even in configs that intern values, as the intern pool never
+ * frees a string.
+ *
+ * A transaction stages any number of edits and applies them together.
+ * Edits are applied under the config's write lock, so readers that hold
+ * the read lock (vc_read_begin/vc_read_end) see either none of a
+ * transaction or all of it.  If any edit fails, those already applied are
+ * undone, and the config is left as it was.  Values returned by lookups
+ * may be changed or freed by edits, so they are only stable while the
+ * read lock is held.  Writers are preferred, so a stream of readers can't
+ * hold edits off, and read sections must not nest.
+ *
+ * Sections shared with other configs (see vcshare.h) are copied into the
+ * config before an edit reaches into them, and only released once the
+ * transaction has been applied.
+ */
+
+#ifndef __VCEDIT_H
+#define __VCEDIT_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_EDIT_OPS(XX)             \
+    XX(SET)                         \
+    XX(DELETE)                      \
+    XX(MKSECT)
+
+/* Edit operations */
+typedef enum {
+    #define XX(name) VC_EDIT_##name,
+    VC_EDIT_OPS(XX)
+    #undef XX
+} vc_edit_op;
+
+/* A staged edit.  The option path, and a string value, are stored after
+ * the structure. */
+typedef struct vc_edit {
+    vc_edit_op op;              /* Operation */
+    vc_type type;               /* Value type, for VC_EDIT_SET */
+    union {
+        int i;                  /* VC_BOOLEAN, VC_INTEGER */
+        int64_t l;              /* VC_DURATION, VC_SIZE */
+        double f;               /* VC_FLOAT, VC_RATIO */
+        char *s;                /* VC_STRING */
+    } v;
+    struct vc_edit *next;       /* Next edit, in order of staging */
+    char path[];                /* Option path */
+} vc_edit;
+
+/* Transaction definition */
+typedef struct vc_txn {
+    vc_sect *sect;              /* Section that paths are relative to */
+    vc_edit *edits;             /* Staged edits */
+    vc_edit **tail;             /* Where the next edit is linked */
+    int error;                  /* Set if an edit couldn't be staged */
+} vc_txn;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Single edits, each applied as a transaction of its own.  value points
+ * to an int (VC_BOOLEAN, VC_INTEGER), an int64_t (VC_DURATION, VC_SIZE)
+ * or a double (VC_FLOAT, VC_RATIO), or is the string (VC_STRING), which
+ * is copied.  Return zero on failure. */
+int vc_set(vc_sect *sect, char *optpath, vc_type type, void *value);
+int vc_delete(vc_sect *sect, char *optpath);
+vc_sect *vc_mkdir_sect(vc_sect *sect, char *optpath);
+
+/* Transactions.  Staging copies the path and value.  vc_txn_commit
+ * applies the edits, in order, and returns zero if they couldn't all be
+ * applied.  Both commit and abort free the transaction. */
+vc_txn *vc_txn_begin(vc_sect *sect);
+int vc_txn_set(vc_txn *txn, char *optpath, vc_type type, void *value);
+int vc_txn_delete(vc_txn *txn, char *optpath);
+int vc_txn_mkdir_sect(vc_txn *txn, char *optpath);
+int vc_txn_commit(vc_txn *txn);
+void vc_txn_abort(vc_txn *txn);
+
+/* Initialize the lock of a new config */
+void vc_lock_init(vc_root *root);
+
+/* Hold the config's read lock, so edits wait until vc_read_end */
+void vc_read_begin(vc_sect *sect);
+void vc_read_end(vc_sect *sect);
+
+/* Generation of the config, which changes with every transaction
+ * applied to it.  No two configs, nor two states of one, ever have the
+ * same generation, so one identifies a config's contents for as long as
+ * the process runs (see vccache.h). */
+uint64_t vc_generation(vc_sect *sect);
+
+/* A generation that no config has had, for a new config or state */
+uint64_t vc_generation_new(void);
+
+#endif /* #ifndef __VCEDIT_H */
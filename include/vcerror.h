@@ -40,7 +40,19 @@ struct vc_parser;
     XX(SECT_MISMATCH,   O_FILE, 4, "Syntax error: Expected end of section for '%.*s', not '%.*s'.")     \
     XX(NONZERO_DEPTH,   O_FILE, 1, "Syntax error: End of file encountered with %d sections unended.")   \
     XX(DEPTH_UNDERFLOW, O_FILE, 0, "Syntax error: End of section found when already at root section.")  \
-    XX(DEPTH_OVERFLOW,  O_FILE, 1, "Syntax error: Exceeded maximum section depth %d. Use fewer subsections.")    
+    XX(DEPTH_OVERFLOW,  O_FILE, 1, "Syntax error: Exceeded maximum section depth %d. Use fewer subsections.")    \
+    XX(NO_MEMORY,       O_FILE, 0, "Error: Out of memory.")                                              \
+    XX(ARRAY_TYPE,      O_FILE, 0, "Syntax error: Array elements must be all numbers or all strings.")   \
+    XX(DIRECTIVE_FORMAT, O_FILE, 2, "Error: Invalid format character '%c' for directive '%s'.")          \
+    XX(DIRECTIVE_ARGS,  O_FILE, 2, "Error: Bad arguments to directive '%s': %s.")                     \
+    XX(DIRECTIVE_FAILED, O_FILE, 2, "Error: Directive '%s' failed (%d).")                               \
+    XX(INCLUDE_FILE,    O_FILE, 1, "Include error: Unable to include '%s'.")                            \
+    XX(INCLUDE_FAILED,  0,      1, "Include error: Included file '%s' failed to load.")                 \
+    XX(INCLUDE_CYCLE,   0,      1, "Include error: Include cycle through '%s'.")                       \
+    XX(RULE,            0,      1, "Parse failure in rule: '%s'")                                        \
+    XX(IMAGE,           0,      2, "Image error: %s: %s")                                               \
+    XX(INVALID_UTF8,    O_FILE, 1, "Syntax error: Invalid UTF-8 in string at byte %zu of the file.")   \
+    XX(NUMBER_RANGE,    O_FILE, 2, "Syntax error: Number '%.*s' is out of range.")
 
 typedef enum {
     #define XX(type, flags, nargs, string) VC_ERROR_##type,
@@ -54,6 +66,25 @@ typedef struct vc_error {
     char *msg;
 } vc_error;
 
+/* Maximum length of a formatted error message */
+#define VC_ERROR_MSG_SIZE 256
+
+/* Error sink.  When one is given, errors are passed to its handler as
+ * formatted messages (without a trailing newline) instead of being
+ * printed to stderr. */
+typedef void (*vc_error_fn)(void *ctx, vc_error_type err, const char *msg);
+
+typedef struct vc_errsink {
+    vc_error_fn fn;             /* Error handler */
+    void *ctx;                  /* Context passed to the handler */
+} vc_errsink;
+
+/* First error reported while loading a file */
+typedef struct vc_load_error {
+    vc_error_type type;         /* VC_ERROR_SUCCESS if none */
+    char msg[VC_ERROR_MSG_SIZE];
+} vc_load_error;
+
 /**********************************************************************/
 /**** Begin Definitions/Static Declarations ***************************/
 /**********************************************************************/
@@ -62,6 +93,15 @@ void vc_print_error(vc_error_type err, struct vc_parser *parser, ...);
 /**********************************************************************/
 /**** Begin Function Prototypes ***************************************/
 /**********************************************************************/
-/* NONE */
+
+/* Report an error to a sink (stderr if NULL).  The parser is only needed
+ * for errors that include the file and line. */
+void vc_report_error(vc_errsink *sink, vc_error_type err, struct vc_parser *parser, ...);
+
+/* Pass an already formatted message to a sink (stderr if NULL) */
+void vc_emit_error(vc_errsink *sink, vc_error_type err, const char *msg);
+
+/* Sink handler that records the first error into a vc_load_error */
+void vc_error_record(void *ctx, vc_error_type err, const char *msg);
 
 #endif /* #ifndef __VCERROR_H */
@@ -0,0 +1,148 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcimage.h
+ *
+ * Shared-memory config images.  A publisher lays out a parsed config as
+ * a relocatable image (every reference is an offset from the start of
+ * the image) in a POSIX shared memory segment.  Any number of processes
+ * can map the image read-only and query it through the usual getters,
+ * so a host holds one copy of the config no matter how many processes
+ * use it.
+ *
+ * A publisher named "/name" owns two kinds of segments:
+ *      /name           Control segment, holding the current generation.
+ *      /name.<gen>     The image for each generation.
+ *
+ * Publishing writes a new image segment, then bumps the generation and
+ * wakes any process waiting on it (a shared futex on the generation
+ * word).  The previous image is unlinked, but stays valid for processes
+ * that still have it mapped.
+ *
+ * Closing a publisher leaves the control segment and the current image,
+ * so processes can still attach, and a publisher reopened on the name
+ * carries on from the same generation.  vc_image_unlink removes both,
+ * once the name is no longer wanted.
+ *
+ * Within an image, each section's options are sorted by key, and looked
+ * up with a binary search.  Included files are merged into the image,
+ * with the same precedence as lookups on the parsed config.
+ */
+
+#ifndef __VCIMAGE_H
+#define __VCIMAGE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_IMAGE_MAGIC   0x47464356     /* "VCFG" */
+#define VC_IMAGE_VERSION 1
+
+/* Control segment, shared by every generation */
+typedef struct vc_image_control {
+    uint32_t magic;                 /* VC_IMAGE_MAGIC */
+    uint32_t generation;            /* Current generation (futex word);
+                                     * zero until the first publish */
+} vc_image_control;
+
+/* Image header, at offset zero */
+typedef struct vc_image_header {
+    uint32_t magic;                 /* VC_IMAGE_MAGIC */
+    uint32_t version;               /* VC_IMAGE_VERSION */
+    uint32_t generation;            /* Generation this image was published as */
+    uint32_t nsects;                /* Number of sections; zero is the root */
+    uint64_t nopts;                 /* Number of non-section options */
+    uint64_t size;                  /* Size of the image, in bytes */
+    uint64_t sects;                 /* Offset of the section table */
+} vc_image_header;
+
+/* Section table entry */
+typedef struct vc_image_sect {
+    uint64_t entries;               /* Offset of the sorted option table */
+    uint64_t nentries;              /* Number of options */
+} vc_image_sect;
+
+/* Option.  Integers and booleans are stored as an int at the start of
+ * the value, so getters can return a pointer straight into the image. */
+typedef struct vc_image_entry {
+    uint64_t key;                   /* Offset of the NUL-terminated key */
+    uint32_t keylen;                /* Key length */
+    uint32_t type;                  /* vc_type */
+    union {
+        int i;                      /* VC_INTEGER, VC_BOOLEAN */
+        int64_t l;                  /* VC_DURATION, VC_SIZE */
+        double f;                   /* VC_FLOAT, VC_RATIO */
+        uint64_t off;               /* VC_STRING, VC_ARRAY: offset of value
+                                     * VC_SECTION: section index */
+    } v;
+} vc_image_entry;
+
+/* Array.  Elements follow the header: int64_t, double, or for strings,
+ * uint64_t offsets of NUL-terminated strings. */
+typedef struct vc_image_array {
+    uint32_t type;                  /* Element type (VC_ERROR if empty) */
+    uint32_t reserved;
+    uint64_t length;                /* Number of elements */
+} vc_image_array;
+
+/* A process's mapping of an image.  Each image section gets a small
+ * section handle, so images can be used wherever a vconfig is. */
+typedef struct vc_image {
+    char *base;                     /* Mapped image */
+    size_t size;                    /* Mapped size */
+    vc_sect *handles;               /* One handle per image section */
+    vc_image_control *control;      /* Mapped control segment */
+} vc_image;
+
+/* Publisher state */
+typedef struct vc_publisher {
+    char *name;                     /* Control segment name */
+    vc_image_control *control;      /* Mapped control segment */
+    uint32_t generation;            /* Last generation published */
+} vc_publisher;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Publisher.  Names follow shm_open rules ("/name"). */
+vc_publisher *vc_publisher_open(char *name);
+int vc_publish(vc_publisher *pub, vc_sect *sect);
+void vc_publisher_close(vc_publisher *pub);
+
+/* Remove a publisher's control segment and current image, as for any
+ * segment, once no publisher has the name open.  Returns nonzero if the
+ * control segment existed. */
+int vc_image_unlink(char *name);
+
+/* Map the current image of a publisher, read-only.  Returns the root
+ * section handle, or NULL if nothing has been published. */
+vc_sect *vc_image_attach(char *name);
+void vc_image_detach(vc_sect *sect);
+
+/* Wait for a newer generation than the attached one.  A negative timeout
+ * waits forever.  Returns nonzero if a newer generation is available. */
+int vc_image_wait(vc_sect *sect, int timeout_ms);
+
+/* Look up an option in an image.  Returns a pointer to the value (a
+ * section handle for sections, a vc_image_array for arrays) and sets
+ * type, or returns NULL. */
+void *vc_image_getval(vc_sect *sect, char *optpath, vc_type *type);
+void *vc_image_getvaln(vc_sect *sect, char *optpath, size_t length, vc_type *type);
+
+/* Find the options of an image section whose keys start with prefix.
+ * Returns the first, in key order, and sets count. */
+vc_image_entry *vc_image_range(vc_sect *sect, const char *prefix, size_t length, size_t *count);
+
+/* Value of an option, as vc_image_getval returns it */
+void *vc_image_value(vc_sect *sect, vc_image_entry *entry, vc_type *type);
+
+#endif /* #ifndef __VCIMAGE_H */
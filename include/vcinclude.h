@@ -0,0 +1,97 @@
+/* 
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcinclude.h
+ * 
+ * Include handling for VConfig.  An include statement pulls the options
+ * of another file (or of every file matching a glob pattern) into the
+ * current section:
+ * 
+ *      include "tls/defaults.cfg"
+ *      include "upstream-*.cfg"
+ * 
+ * Relative paths are relative to the including file.  Included files are
+ * parsed as separate configs ("fragments") on a worker pool while the
+ * including file continues to be parsed.  Fragments are kept in a
+ * process-wide cache keyed by device, inode, modification time and size,
+ * so a fragment included by many configs is parsed once and its tree is
+ * shared, read-only, between all of them.  Options of the including
+ * section take precedence over included ones, and earlier includes take
+ * precedence over later ones.
+ * 
+ * Before a config finishes loading, the include graph reachable from it
+ * is checked for cycles, which are reported as errors.
+ */
+
+#ifndef __VCINCLUDE_H
+#define __VCINCLUDE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Fragment states */
+#define VC_FRAG_LOADING 0   /* Queued or being parsed */
+#define VC_FRAG_READY   1   /* Parsed successfully */
+#define VC_FRAG_FAILED  2   /* Failed to parse, or part of a cycle */
+
+/* Cached, parsed included file */
+typedef struct vc_fragment {
+    char *path;                     /* Path the fragment was loaded from */
+    char *key;                      /* Cache key */
+    vc_sect *sect;                  /* Parsed fragment (once ready) */
+    int state;                      /* VC_FRAG_* state */
+    int refs;                       /* Number of include references */
+    
+    struct vc_fragment **deps;      /* Fragments included by this one */
+    size_t ndeps;                   /* Number of dependencies */
+    
+    vc_params params;               /* Parameters used to parse it */
+    vc_directive *dirs;             /* Copy of the directives it is parsed
+                                     * with, as the caller's may not last */
+    fasthash_table *directives;     /* Hashed dirs */
+    
+    /* A fragment is shared, so its errors are kept and reported to each
+     * config that includes it. */
+    vc_errsink errsink;             /* Records into error */
+    vc_load_error error;            /* First error while parsing */
+} vc_fragment;
+
+/* Include reference held by a section.  Each file a statement matches
+ * gets one; the first also keeps the statement's path, as written, which
+ * is stored after the structure. */
+typedef struct vc_include {
+    vc_fragment *frag;              /* Included fragment */
+    char *spelling;                 /* Path as written, or NULL for later
+                                     * matches of the same statement */
+    struct vc_include *next;        /* Next include, in include order */
+} vc_include;
+
+struct vc_parser;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Handle an include statement, for the current section of the parser.
+ * Returns zero on error. */
+int vc_include_add(struct vc_parser *parser, char *pattern);
+
+/* Wait for every fragment reachable from a parsed root config, and check
+ * for failures and cycles.  Returns zero on error. */
+int vc_include_finish(struct vc_parser *parser);
+
+/* Record the dependencies found while parsing a fragment, and publish
+ * the parse result to anyone waiting on it. */
+void vc_fragment_complete(vc_fragment *frag, vc_sect *sect, struct vc_parser *parser);
+
+/* Drop a reference to a fragment, freeing it with the last reference */
+void vc_fragment_release(vc_fragment *frag);
+
+#endif /* #ifndef __VCINCLUDE_H */
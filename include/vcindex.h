@@ -0,0 +1,39 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcindex.h
+ *
+ * Full-path index.  A config opened with VC_PARAM_PATH_INDEX keeps one
+ * table from every dotted option path ("a.b.c.d") to its option, so a
+ * lookup from the root is a single hash and probe, however deep the
+ * path.  The index resolves includes and shadowing exactly as walking the
+ * sections does.
+ *
+ * The index is built on the first lookup, and dropped by any edit that
+ * adds or removes options (see vcedit.h), to be built again on the next.
+ */
+
+#ifndef __VCINDEX_H
+#define __VCINDEX_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Get the index of a config, building it if needed.  Returns NULL if it
+ * couldn't be built, in which case lookups walk the sections. */
+fasthash_table *vc_index_get(vc_root *root);
+
+/* Drop the index.  Called with the config's write lock held. */
+void vc_index_drop(vc_root *root);
+
+/* Add the size of the index to the statistics */
+void vc_index_stats(vc_root *root, vc_stats *stats);
+
+#endif /* #ifndef __VCINDEX_H */
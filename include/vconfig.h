@@ -62,11 +62,28 @@
 #ifndef __VCONFIG_H
 #define __VCONFIG_H
 
+/* The library is C; C++ callers get C linkage for all of it, and may
+ * prefer the wrapper in vconfig.hpp. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**********************************************************************/
 /**** Begin Includes **************************************************/
 /**********************************************************************/
 #include "vctype.h"     /* For types */
 #include "vcparse.h"    /* For parse methods */
+#include "vcimage.h"    /* For shared-memory images */
+#include "vcview.h"     /* For layered views */
+#include "vcwrite.h"    /* For writing configs */
+#include "vcedit.h"     /* For edits and transactions */
+#include "vcquery.h"    /* For path queries */
+#include "vctape.h"     /* For tapes */
+#include "vcdiff.h"     /* For diffs */
+#include "vcasync.h"    /* For asynchronous loads */
+#include "vcunit.h"     /* For durations, sizes and ratios */
+#include "vcshare.h"    /* For shared sections */
+#include "vccache.h"    /* For the lookup cache */
 
 /**********************************************************************/
 /**** Begin Type Definitions ******************************************/
@@ -82,11 +99,133 @@
 /**** Begin Function Prototypes ***************************************/
 /**********************************************************************/
 
-/* Open/Close */
+/* Open/Close.  Files named by include statements are loaded before
+ * vconfig_open returns, and are shared between configs that include them. */
 vconfig *vconfig_open(vc_params *params);
 vconfig *vconfig_open_simple(char *file);
+
+/* Parse a config held in memory, such as a field of a larger message or
+ * a read-only section of the binary.  The data needn't be NUL-terminated,
+ * and is only read, never retained.  params may be NULL; see
+ * vc_parse_buffer for how params->file is used. */
+vconfig *vconfig_parse_buffer(const char *data, size_t length, vc_params *params);
 vconfig *vconfig_close(vconfig *vcfg);
 
+/* Open many files in parallel.  handles[i] receives the config for
+ * paths[i], or NULL if it failed to load, in which case errors[i] holds
+ * the first error.  If errors is NULL, errors are printed to stderr.
+ * Returns the number of files loaded. */
+size_t vconfig_open_many(char **paths, size_t n, vc_batch_params *opts,
+                         vconfig **handles, vc_load_error *errors);
+
+/* Open files without blocking (see vcasync.h).  Loads are queued and the
+ * call returns at once; cb is called on a worker thread with each config,
+ * or NULL and the error.  Reads go through io_uring where the kernel has
+ * it.  opts may be NULL for the defaults.  Return the number queued. */
+int vconfig_open_async(vc_params *params, vc_async_cb cb, void *ctx);
+size_t vconfig_open_many_async(char **paths, size_t n, vc_batch_params *opts,
+                               vc_async_cb cb, void *ctx);
+
+/* Shared-memory publication (see vcimage.h).  A publisher lays out a
+ * parsed config in shared memory; other processes attach to it and use
+ * the getters on it as on any config, except that vconfig_getopt and
+ * vconfig_getarray return NULL, and string arrays are not available.
+ * vconfig_wait_update waits up to timeout_ms (forever if negative) for
+ * a newer version, which is then attached separately.  The last version
+ * published stays after the publisher closes, until vconfig_unpublish
+ * removes it. */
+vc_publisher *vconfig_publisher_open(char *name);
+int vconfig_publish(vc_publisher *pub, vconfig *vcfg);
+void vconfig_publisher_close(vc_publisher *pub);
+int vconfig_unpublish(char *name);
+vconfig *vconfig_attach(char *name);
+int vconfig_wait_update(vconfig *vcfg, int timeout_ms);
+
+/* Layered views (see vcview.h).  Lookups try the most recently pushed
+ * layer first, then fall through.  Layers are not copied, and must
+ * outlive the view.  vconfig_flatten merges the layers into a new
+ * config, which is closed with vconfig_close. */
+vc_view *vconfig_view_create(void);
+void vconfig_view_destroy(vc_view *view);
+int vconfig_layer_push(vc_view *view, vconfig *vcfg);
+vconfig *vconfig_layer_pop(vc_view *view);
+vconfig *vconfig_flatten(vc_view *view);
+
+/* Lookups through a view, as the vconfig_get* functions */
+vc_opt *vconfig_view_getopt(vc_view *view, char *optpath);
+void *vconfig_view_getval(vc_view *view, char *optpath);
+int *vconfig_view_getbool(vc_view *view, char *optpath);
+int *vconfig_view_getint(vc_view *view, char *optpath);
+char *vconfig_view_getstr(vc_view *view, char *optpath);
+
+/* Write a config in the vconfig text format (see vcwrite.h), to a file
+ * descriptor or to a new buffer which the caller frees.  opts may be
+ * NULL for the defaults.  Images can't be written. */
+int vconfig_write(vconfig *vcfg, int fd, vc_write_opts *opts);
+char *vconfig_write_buffer(vconfig *vcfg, vc_write_opts *opts, size_t *length);
+
+/* Edits (see vcedit.h).  Setters create missing sections along the
+ * path, and update existing options in place.  All return zero on
+ * failure.  While a config may be edited, other threads wrap lookups,
+ * and their use of the values returned, in vconfig_read_begin/end. */
+int vconfig_set_bool(vconfig *vcfg, char *optpath, int value);
+int vconfig_set_int(vconfig *vcfg, char *optpath, int value);
+int vconfig_set_float(vconfig *vcfg, char *optpath, double value);
+int vconfig_set_duration_ns(vconfig *vcfg, char *optpath, int64_t ns);
+int vconfig_set_bytes(vconfig *vcfg, char *optpath, int64_t bytes);
+int vconfig_set_ratio(vconfig *vcfg, char *optpath, double ratio);
+int vconfig_set_str(vconfig *vcfg, char *optpath, char *value);
+int vconfig_delete(vconfig *vcfg, char *optpath);
+vconfig *vconfig_mkdir_sect(vconfig *vcfg, char *optpath);
+void vconfig_read_begin(vconfig *vcfg);
+void vconfig_read_end(vconfig *vcfg);
+
+/* Transactions stage edits, and apply them all at once on commit, or
+ * none of them if any fails.  Commit and abort free the transaction. */
+vc_txn *vconfig_txn_begin(vconfig *vcfg);
+int vconfig_txn_set_bool(vc_txn *txn, char *optpath, int value);
+int vconfig_txn_set_int(vc_txn *txn, char *optpath, int value);
+int vconfig_txn_set_float(vc_txn *txn, char *optpath, double value);
+int vconfig_txn_set_duration_ns(vc_txn *txn, char *optpath, int64_t ns);
+int vconfig_txn_set_bytes(vc_txn *txn, char *optpath, int64_t bytes);
+int vconfig_txn_set_ratio(vc_txn *txn, char *optpath, double ratio);
+int vconfig_txn_set_str(vc_txn *txn, char *optpath, char *value);
+int vconfig_txn_delete(vc_txn *txn, char *optpath);
+int vconfig_txn_mkdir_sect(vc_txn *txn, char *optpath);
+int vconfig_txn_commit(vc_txn *txn);
+void vconfig_txn_abort(vc_txn *txn);
+
+/* Get memory/size statistics for a config or section. */
+void vconfig_stats(vconfig *vcfg, vc_stats *stats);
+
+/* Visit every option whose path matches pattern (see vcquery.h), such as
+ * "upstreams.*.port" or "features.beta_*".  cb may return nonzero to
+ * stop.  Returns the number of matches visited, or -1 on error. */
+long vconfig_query(vconfig *vcfg, const char *pattern, vc_query_cb cb, void *ctx);
+
+/* Tapes (see vctape.h).  A config parsed into one flat array, for code
+ * that walks every option once, such as validation or conversion,
+ * rather than looking options up.  Include statements are recorded but
+ * not loaded.  params may be NULL for vconfig_tape_parse. */
+vc_tape *vconfig_tape_open(vc_params *params);
+vc_tape *vconfig_tape_parse(const char *data, size_t length, vc_params *params);
+void vconfig_tape_free(vc_tape *tape);
+
+/* Diff two configs (see vcdiff.h), such as before and after a reload.
+ * cb is called for each option added, removed or modified, and may
+ * return nonzero to stop.  Sections whose contents hash the same are
+ * skipped, so the cost follows what changed.  Returns the number of
+ * changes reported, or -1 on error. */
+long vconfig_diff(vconfig *before, vconfig *after, vc_diff_cb cb, void *ctx);
+
+/* Lookup cache (see vccache.h).  In configs opened with
+ * VC_PARAM_LOOKUP_CACHE, vconfig_getopt, vconfig_getval and the typed
+ * getters remember what each path string found, per thread, until the
+ * config is edited.  vconfig_cache_stats gets the calling thread's hits
+ * and misses, and vconfig_cache_reset empties its cache. */
+void vconfig_cache_stats(vc_cache_stats *stats);
+void vconfig_cache_reset(void);
+
 /* Get option. Returns a generic container struct. */
 vc_opt *vconfig_getopt(vconfig *vcfg, char *opt);
 
@@ -110,7 +249,42 @@ int *vconfig_getint(vconfig *vcfg, char *optpath);
  * not an integer, NULL is returned. */
 char *vconfig_getstr(vconfig *vcfg, char *optpath);
 
+/* Get a duration in nanoseconds, a size in bytes, or a ratio (0.5 for
+ * 50%), as parsed from values such as 30s, 512MiB and 50% (see
+ * vcunit.h).  If the option path does not exist, or the value is not
+ * of that type, NULL is returned. */
+int64_t *vconfig_getduration_ns(vconfig *vcfg, char *optpath);
+int64_t *vconfig_getbytes(vconfig *vcfg, char *optpath);
+double *vconfig_getratio(vconfig *vcfg, char *optpath);
+
+/* Get an array.  Returns the packed array container, or NULL if the
+ * option path does not exist or the value is not an array. */
+vc_array *vconfig_getarray(vconfig *vcfg, char *optpath);
+
+/* Get the elements of an integer, float or string array.  The number of
+ * elements is stored in *length.  If the option path does not exist, or
+ * the value is not an array of that type, NULL is returned.  Empty
+ * arrays match every element type. */
+int64_t *vconfig_getintarray(vconfig *vcfg, char *optpath, size_t *length);
+double *vconfig_getfloatarray(vconfig *vcfg, char *optpath, size_t *length);
+char **vconfig_getstrarray(vconfig *vcfg, char *optpath, size_t *length);
+
 /* Get a config subsection. If the option path does not exist, or the
  * value is not an integer, NULL is returned. */
 vconfig *vconfig_getsect(vconfig *vcfg, char *optpath);
+
+/* Get a value by an option path of the given length, which needn't be
+ * NUL-terminated.  If the option path does not exist, or the value is
+ * not of the given type, NULL is returned. */
+void *vconfig_getvaln(vconfig *vcfg, const char *optpath, size_t length, vc_type type);
+
+/* Get a value by an option path hashed ahead of time, as the accessors
+ * generated by vconfig-gen do.  If the option path does not exist, or the
+ * value is not of the given type, NULL is returned. */
+void *vconfig_getval_key(vconfig *vcfg, const vc_keypath *kp, vc_type type);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* #ifndef __VCONFIG_H */
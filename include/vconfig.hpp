@@ -0,0 +1,301 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vconfig.hpp
+ *
+ * Header-only C++17 wrapper.  vc::Config owns a parsed config, and closes
+ * it when destroyed; it can be moved but not copied.  vc::Section is a
+ * non-owning view of a config or one of its sections.  Both look values
+ * up with get<T>, which returns std::optional<T>, empty if the option is
+ * missing or of another type.  T is one of:
+ *
+ *      bool, int, double       BOOLEAN, INTEGER, FLOAT
+ *      std::string_view        STRING; refers to the config's copy
+ *      vc::Section             SECTION
+ *      const vc_array *        ARRAY
+ *      std::chrono::nanoseconds DURATION
+ *      vc::Bytes               SIZE
+ *      vc::Ratio               RATIO; 0.5 for 50%
+ *
+ * Option paths are std::string_views, which needn't be NUL-terminated and
+ * are never copied, or vc::Path literals, whose segments are hashed at
+ * compile time:
+ *
+ *      static constexpr vc::Path port{"server.port"};
+ *      int p = conf.get<int>(port).value_or(80);
+ *
+ * Iterating a section visits the options it holds itself, in no
+ * particular order, but not those of the files it includes.
+ */
+
+#ifndef __VCONFIG_HPP
+#define __VCONFIG_HPP
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "vconfig.h"
+
+namespace vc {
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* djb2, as hashn_djb2 computes it */
+constexpr uint32_t djb2(const char *str, size_t length) {
+    uint32_t hash = 5381;
+    for (size_t i = 0; i < length && str[i]; i++) {
+        hash = hash * 33 + (unsigned char)str[i];
+    }
+    return hash;
+}
+
+/* Option path literal, with its keys hashed at compile time, like those
+ * emitted by vconfig-gen.  The literal must outlive the path. */
+template <size_t N>
+class Path {
+public:
+    constexpr Path(const char (&path)[N]) :
+        path_{path, N - 1, djb2(path, N - 1)}, segs_{}, nsegs_(0) {
+        size_t start = 0;
+        for (size_t i = 0; i < N; i++) {
+            if (i == N - 1 || path[i] == '.') {
+                segs_[nsegs_].key = path + start;
+                segs_[nsegs_].length = (uint32_t)(i - start);
+                segs_[nsegs_].hash = djb2(path + start, i - start);
+                nsegs_++;
+                start = i + 1;
+            }
+        }
+    }
+
+    constexpr vc_keypath keypath() const noexcept { return vc_keypath{path_, segs_, nsegs_}; }
+    constexpr std::string_view str() const noexcept { return {path_.key, path_.length}; }
+
+private:
+    vc_key path_;
+    vc_key segs_[N / 2 + 1];
+    uint32_t nsegs_;
+};
+
+/* Values of SIZE and RATIO options, typed apart from int and double */
+struct Bytes {
+    int64_t count;
+};
+
+struct Ratio {
+    double value;
+};
+
+namespace detail {
+    template <typename T> struct value;
+}
+
+/* A single option, as visited when iterating a section */
+class Option {
+public:
+    Option(const char *key, vc_opt *opt) noexcept : key_(key), opt_(opt) {}
+
+    std::string_view key() const noexcept { return key_; }
+    vc_type type() const noexcept { return opt_->type; }
+    vc_opt *handle() const noexcept { return opt_; }
+
+    template <typename T>
+    std::optional<T> get() const {
+        if (opt_->type != detail::value<T>::type) return std::nullopt;
+        return detail::value<T>::from(opt_->value);
+    }
+
+private:
+    const char *key_;
+    vc_opt *opt_;
+};
+
+/* Non-owning view of a config, or a section of one */
+class Section {
+public:
+    class iterator;
+
+    explicit Section(vc_sect *sect = nullptr) noexcept : sect_(sect) {}
+
+    vc_sect *handle() const noexcept { return sect_; }
+    explicit operator bool() const noexcept { return sect_ != nullptr; }
+
+    template <typename T>
+    std::optional<T> get(std::string_view path) const {
+        void *v = sect_ ? vconfig_getvaln(sect_, path.data(), path.size(), detail::value<T>::type) : nullptr;
+        if (!v) return std::nullopt;
+        return detail::value<T>::from(v);
+    }
+
+    template <typename T, size_t N>
+    std::optional<T> get(const Path<N> &path) const {
+        vc_keypath kp = path.keypath();
+        void *v = sect_ ? vconfig_getval_key(sect_, &kp, detail::value<T>::type) : nullptr;
+        if (!v) return std::nullopt;
+        return detail::value<T>::from(v);
+    }
+
+    /* Section at a path, or an empty one, with nothing to iterate, if
+     * there is none.  Unlike *get<Section>(path), it can be the range of
+     * a for loop. */
+    Section section(std::string_view path) const {
+        return get<Section>(path).value_or(Section());
+    }
+
+    inline iterator begin() const noexcept;
+    inline iterator end() const noexcept;
+
+protected:
+    vc_sect *sect_;
+};
+
+/* Forward iterator over the options of a section's own table */
+class Section::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Option;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Option;
+
+    iterator() noexcept : ht_(nullptr), in_(nullptr), node_(nullptr) {}
+    explicit iterator(fasthash_table *ht) noexcept : ht_(ht), in_(ht ? ht->index_list : nullptr), node_(nullptr) {
+        settle();
+    }
+
+    Option operator*() const noexcept { return Option(node_->key, (vc_opt *)node_->data); }
+    iterator &operator++() noexcept {
+        node_ = node_->next;
+        if (!node_) {
+            in_ = in_->next;
+            settle();
+        }
+        return *this;
+    }
+    iterator operator++(int) noexcept {
+        iterator prev = *this;
+        ++*this;
+        return prev;
+    }
+    bool operator==(const iterator &o) const noexcept { return node_ == o.node_; }
+    bool operator!=(const iterator &o) const noexcept { return node_ != o.node_; }
+
+private:
+    /* Move to the first node of the current bucket, skipping buckets
+     * that options were deleted from. */
+    void settle() noexcept {
+        for (; in_; in_ = in_->next) {
+            if ((node_ = ht_->entries[in_->index])) return;
+        }
+        node_ = nullptr;
+    }
+
+    fasthash_table *ht_;
+    index_node *in_;
+    fasthash_node *node_;
+};
+
+/* Images have no tables, so nothing to iterate */
+inline Section::iterator Section::begin() const noexcept {
+    return iterator(sect_ ? sect_->ht : nullptr);
+}
+inline Section::iterator Section::end() const noexcept {
+    return iterator();
+}
+
+/* Owning handle of a parsed config */
+class Config : public Section {
+public:
+    Config() noexcept : Section() {}
+    explicit Config(vconfig *vcfg) noexcept : Section(vcfg) {}
+    ~Config() { if (sect_) vconfig_close(sect_); }
+
+    Config(const Config &) = delete;
+    Config &operator=(const Config &) = delete;
+    Config(Config &&o) noexcept : Section(o.release()) {}
+    Config &operator=(Config &&o) noexcept {
+        if (this != &o) {
+            if (sect_) vconfig_close(sect_);
+            sect_ = o.release();
+        }
+        return *this;
+    }
+
+    /* Open a file, with VC_PARAM_* flags.  Empty on failure. */
+    static Config open(const char *file, int flags = 0, vc_directive *directives = nullptr) {
+        vc_params p = {const_cast<char *>(file), directives, flags, nullptr, nullptr};
+        return Config(vconfig_open(&p));
+    }
+    static Config open(const std::string &file, int flags = 0, vc_directive *directives = nullptr) {
+        return open(file.c_str(), flags, directives);
+    }
+
+    /* Parse a config held in memory (see vconfig_parse_buffer) */
+    static Config parse(std::string_view text, int flags = 0, vc_directive *directives = nullptr) {
+        vc_params p = {nullptr, directives, flags, nullptr, nullptr};
+        return Config(vconfig_parse_buffer(text.data(), text.size(), &p));
+    }
+
+    /* Give up ownership, leaving the handle empty */
+    vconfig *release() noexcept {
+        return std::exchange(sect_, nullptr);
+    }
+};
+
+/**********************************************************************/
+/**** Begin Value Conversions *****************************************/
+/**********************************************************************/
+namespace detail {
+    template <> struct value<bool> {
+        static constexpr vc_type type = VC_BOOLEAN;
+        static bool from(void *v) noexcept { return *(int *)v != 0; }
+    };
+    template <> struct value<int> {
+        static constexpr vc_type type = VC_INTEGER;
+        static int from(void *v) noexcept { return *(int *)v; }
+    };
+    template <> struct value<double> {
+        static constexpr vc_type type = VC_FLOAT;
+        static double from(void *v) noexcept { return *(double *)v; }
+    };
+    template <> struct value<std::string_view> {
+        static constexpr vc_type type = VC_STRING;
+        static std::string_view from(void *v) noexcept { return std::string_view((char *)v); }
+    };
+    template <> struct value<Section> {
+        static constexpr vc_type type = VC_SECTION;
+        static Section from(void *v) noexcept { return Section((vc_sect *)v); }
+    };
+    template <> struct value<const vc_array *> {
+        static constexpr vc_type type = VC_ARRAY;
+        static const vc_array *from(void *v) noexcept { return (const vc_array *)v; }
+    };
+    template <> struct value<std::chrono::nanoseconds> {
+        static constexpr vc_type type = VC_DURATION;
+        static std::chrono::nanoseconds from(void *v) noexcept { return std::chrono::nanoseconds(*(int64_t *)v); }
+    };
+    template <> struct value<Bytes> {
+        static constexpr vc_type type = VC_SIZE;
+        static Bytes from(void *v) noexcept { return Bytes{*(int64_t *)v}; }
+    };
+    template <> struct value<Ratio> {
+        static constexpr vc_type type = VC_RATIO;
+        static Ratio from(void *v) noexcept { return Ratio{*(double *)v}; }
+    };
+}
+
+} /* namespace vc */
+
+#endif /* #ifndef __VCONFIG_HPP */
@@ -16,27 +16,36 @@
  *       | "u" | "v" | "w" | "x" | "y" | "z" ;
  * alpha = upper | lower ;
  * numeric = "0" | "1" | "2" | "3" | "4" | "5" | "6" | "7" | "8" | "9" ;
+ * hex = numeric | "A" | "B" | "C" | "D" | "E" | "F"
+ *     | "a" | "b" | "c" | "d" | "e" | "f" ;
  * 
  * newline = "\n" ;
  * whitespace = { " " | "\t" } ;
  * eol = { whitespace } , newline ;
  *
- * cfg = { newline | whitespace | comment | section | assignment } ;
+ * cfg = { newline | whitespace | comment | section | assignment | directive | include } ;
  * 
  * comment = "#" , { any-char - newline } , newline ;
  * section = section-header , cfg , section-footer ;
  * assignment = identifier , whitespace , "=" , whitespace , value , eol ;
+ * include = "include" , whitespace , string , eol ;
+ * directive = identifier , { whitespace , ( string | integer | float | boolean ) } , eol ;
  * 
  * section-header = "[" , { whitespace } , section-name , { whitespace }, "]" , eol ;
  * section-footer = "[" , { whitespace } , "/" , section-name , { whitespace } , "]" , eol ;
  * section-name = identifier , { whitespace , identifier } ;
  * 
  * identifier = alpha, { alpha | numeric | "-" | "_" | "/" | "\" } ;
- * value = { string | integer | float | boolean } ;
+ * value = { string | integer | float | boolean | array } ;
  * 
- * string = sstring | dstring ;
- * sstring = "'" , { any-char - "'" } , "'" ;
- * dstring = '"' , { any-char - '"' } , '"' ;
+ * string = literal , { { whitespace | newline } , literal } ;
+ * literal = sstring | dstring ;
+ * sstring = "'" , { schar | escape } , "'" ;
+ * dstring = '"' , { dchar | escape } , '"' ;
+ * schar = any-char - ( "'" | "\" | newline ) ;
+ * dchar = any-char - ( '"' | "\" | newline ) ;
+ * escape = "\" , ( "n" | "t" | "r" | "\" | "'" | '"'
+ *        | "x" , hex , hex | "u" , hex , hex , hex , hex ) ;
  * 
  * integer = [ "-" ] , numeric, { numeric } ;
  * 
@@ -44,6 +53,9 @@
  * 
  * boolean = true | false ;
  * 
+ * array = "[" , { eol } , [ element , { { eol } , "," , { eol } , element } ] , { eol } , [ "," ] , { eol } , "]" ;
+ * element = string | integer | float ;
+ * 
  * true = yes | ( ( "T" | "t" ) , [ ( "R" | "r" ) , ( "U" | "u" ) , ( "E" | "e" ) ] ) ;
  * yes = ( "Y" | "y" ) , [ ( "E" | "e" ) , ( "S" | "s" ) ] ;
  * 
@@ -70,6 +82,7 @@
     XX(INVALID)      /* Invalid token   */      \
     XX(NEWLINE)      /* New Line (\n)   */      \
     XX(SEMICOLON)    /* Semicolon (;)   */      \
+    XX(COMMA)        /* Comma (,)       */      \
     XX(LBRACKET)     /* L. Bracket ([)  */      \
     XX(RBRACKET)     /* R. Bracket (])  */      \
     XX(COMMENT)      /* Comment         */      \
@@ -80,7 +93,10 @@
     XX(BOOLEAN)      /* Boolean Value   */      \
     XX(INTEGER)      /* Numerical Value */      \
     XX(FLOAT)        /* Floating Point  */      \
-    XX(STRING)       /* String Value    */      
+    XX(STRING)       /* String Value    */      \
+    XX(DURATION)     /* Duration (30s)  */      \
+    XX(SIZE)         /* Size (512MiB)   */      \
+    XX(RATIO)        /* Ratio (50%)     */
 
 typedef enum {
     #define XX(name) VC_TOKEN_##name,
@@ -88,8 +104,13 @@ typedef enum {
     #undef XX
 } vc_token_type;
 
+/* Token flags */
+#define VC_TOKEN_F_DECODE 0x01  /* String has escapes or adjacent literals */
+#define VC_TOKEN_F_BORROW 0x02  /* String may be referenced in place */
+
 typedef struct vc_token {
     vc_token_type type;
+    int flags;
     char *position;
     size_t length;
 } vc_token;
@@ -103,9 +124,14 @@ typedef struct vc_sect_token {
 typedef struct vc_parser {
     char *file;    /* Name/path of file */
     char *ptr;  /* Location within the file */
+    char *end;  /* End of the data; scanning never reads past it */
+    char *start;    /* Start of the data, for byte offsets in errors */
 
     int line;   /* Current line within the file */
     int depth;  /* Current depth in the section stack. */
+    int owns;   /* Nonzero if the buffer is writable and handed over to
+                 * the config, so strings can be referenced in place.
+                 * Otherwise, the buffer is only ever read. */
     
     /* Most recently read token */
     vc_token token;
@@ -113,8 +139,18 @@ typedef struct vc_parser {
     /* Section stack - keeps track of which section you're currently in */
     vc_sect_token sects[MAX_DEPTH + 1];
     
-    /* Directives */
-    vc_directive *directives;
+    /* Directives, hashed by name */
+    fasthash_table *directives;
+    
+    /* Tape being built, instead of sections (see vctape.h) */
+    struct vc_tape_builder *tape;
+    
+    /* Includes */
+    vc_params *params;              /* Parameters for included files */
+    struct vc_fragment *frag;       /* Fragment being parsed, if any */
+    struct vc_fragment **deps;      /* Fragments included so far */
+    size_t ndeps;                   /* Number of fragments included */
+    size_t capdeps;                 /* Capacity of deps */
 } vc_parser;
 
 /**********************************************************************/
@@ -125,7 +161,34 @@ typedef struct vc_parser {
 /**********************************************************************/
 /**** Begin Function Prototypes ***************************************/
 /**********************************************************************/
+struct vc_fragment;
+struct vc_tape;
+
 vc_sect *vc_parse_file(vc_params *params);
-vc_sect *vc_parse_stream(char *buffer, vc_parser *parser);
+
+/* Parse params->file, whose contents have already been read into buffer.
+ * The buffer must come from params->allocator, with a byte to spare past
+ * length, and belongs to the config, or is freed, once this returns. */
+vc_sect *vc_parse_loaded(vc_params *params, char *buffer, size_t length);
+
+/* Parse a batch of files on a worker pool.  Returns the number parsed. */
+size_t vc_parse_files(char **paths, size_t n, vc_batch_params *opts,
+                      vc_sect **confs, vc_load_error *errors);
+
+/* Parse a config held in memory.  The data needn't be NUL-terminated,
+ * and is neither written nor retained, so it may be read-only.  If
+ * params->file is set, it names the config in errors, and relative
+ * includes are found next to it; nothing is opened by that name. */
+vc_sect *vc_parse_buffer(const char *data, size_t length, vc_params *params);
+
+vc_sect *vc_parse_stream(char *buffer, size_t length, vc_parser *parser);
+
+/* Parse into a tape (see vctape.h), from memory as vc_parse_buffer does,
+ * or from params->file.  Returns NULL on error. */
+struct vc_tape *vc_parse_tape(const char *data, size_t length, vc_params *params);
+struct vc_tape *vc_parse_tape_file(vc_params *params);
+
+/* Parse an included file, and publish the result to the fragment */
+void vc_parse_fragment(struct vc_fragment *frag);
 
 #endif /* #ifndef __VCPARSE_H */
@@ -0,0 +1,67 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcquery.h
+ *
+ * Path queries.  A query is an option path whose segments may be
+ * patterns:
+ *
+ *      upstreams.*.port        "port" of every section in "upstreams"
+ *      features.beta_*         every option of "features" whose name
+ *                              starts with "beta_"
+ *
+ * A segment of "*" matches any name, and a segment ending in '*' matches
+ * the names that start with what precedes it; other segments match
+ * themselves.  Every path that matches is visited once, with the option
+ * vc_getopt would find for it, so included files and shadowing are
+ * handled as by lookups.
+ *
+ * Matching a prefix means scanning a section's whole table, unless the
+ * config was opened with VC_PARAM_KEY_INDEX.  Each section then keeps its
+ * keys sorted, and a prefix costs a binary search plus the matches.  The
+ * sorted keys are built the first time a section is queried, and dropped
+ * by any edit that adds or removes options (see vcedit.h).  Images keep
+ * their sections sorted anyway, so are always searched.
+ */
+
+#ifndef __VCQUERY_H
+#define __VCQUERY_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Called for each match, with its full path (relative to the section
+ * queried) and its value, as vc_sect_getval returns it.  The path is only
+ * valid during the call.  A nonzero return ends the query. */
+typedef int (*vc_query_cb)(const char *path, vc_type type, void *value, void *ctx);
+
+/* Sorted keys of a section */
+typedef struct vc_keys {
+    fasthash_node **nodes;      /* Table nodes, sorted by key */
+    size_t length;              /* Number of keys */
+} vc_keys;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Visit every option matching pattern, from a parsed config or an image.
+ * Returns the number of matches visited, or -1 if the pattern is empty
+ * or memory ran out. */
+long vc_query(vc_sect *sect, const char *pattern, vc_query_cb cb, void *ctx);
+
+/* Drop the sorted keys of a section and every section below it.  Called
+ * with the config's write lock held. */
+void vc_keys_drop(vc_sect *sect);
+
+/* Add the size of a section's sorted keys to the statistics */
+void vc_keys_stats(vc_sect *sect, vc_stats *stats);
+
+#endif /* #ifndef __VCQUERY_H */
@@ -0,0 +1,54 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcshare.h
+ *
+ * Shared sections.  Configs opened with VC_PARAM_SHARE_SECTIONS hand
+ * each section, as the parser closes it, to a store kept for the whole
+ * process.  If the store already holds a section with the same contents,
+ * the config takes a reference to that one and frees its own; otherwise
+ * its section is copied into the store for later configs to find.  Many
+ * configs that repeat the same sections then hold one copy of each.
+ *
+ * Sections are matched by their content hash (see vcdiff.h), and then
+ * compared option by option, so a collision can't merge different
+ * sections.  Subsections are shared before the section holding them, so
+ * those compare by pointer.  Sections waiting on an included file, and
+ * those holding one, stay with their config.
+ *
+ * A shared section has no single parent, and never changes while it is
+ * shared.  An edit that reaches into one copies it back into the config
+ * first (see vcedit.h).  The last reference to go frees it, keys and
+ * all: each shared section holds its own copy of its keys, rather than
+ * interning them where other threads could be adding to it.
+ */
+
+#ifndef __VCSHARE_H
+#define __VCSHARE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Share a section the parser has just closed, which parent holds under
+ * name.  On success the parent's option refers to the shared section,
+ * and sect is freed; otherwise sect stays as it was. */
+void vc_share_close(vc_sect *parent, const char *name, size_t length, vc_sect *sect);
+
+/* Drop a reference to a shared section, freeing it with the last */
+void vc_share_release(vc_sect *sect);
+
+/* Copy a shared section into a config, as a section of its own under
+ * parent, to be edited.  Its subsections stay shared. */
+vc_sect *vc_share_copy(vc_sect *parent, vc_sect *sect);
+
+/* Number of distinct sections in the store */
+size_t vc_share_count(void);
+
+#endif /* #ifndef __VCSHARE_H */
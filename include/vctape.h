@@ -0,0 +1,150 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vctape.h
+ *
+ * Tapes.  Instead of a tree of hash tables, a config can be parsed into
+ * a tape: one array of fixed-size entries in the order they appear in
+ * the file, with the keys and strings in a buffer beside it.  A tape is a
+ * single allocation, so walking it touches memory in order and freeing it
+ * is a single free.  For
+ *
+ *      port = 80
+ *      [server]
+ *          hosts = ["a", "b"]
+ *      [/server]
+ *
+ * the tape is
+ *
+ *      0   SECTION  next=11     (the root)
+ *      1   KEY      "port"
+ *      2   INTEGER  80
+ *      3   KEY      "server"
+ *      4   SECTION  next=10
+ *      5   KEY      "hosts"
+ *      6   ARRAY    length=2, next=9
+ *      7   STRING   "a"
+ *      8   STRING   "b"
+ *      9   END      next=4
+ *      10  END      next=0
+ *
+ * that is, every option is a KEY followed by its value, a SECTION or
+ * ARRAY entry holds the index just past its contents, so a subtree can be
+ * skipped in one step, and an END holds the index of its SECTION.  The
+ * root is entry 0, and its END the last entry.
+ *
+ * The tape records the file as written: an option defined twice appears
+ * twice (lookups, like the hash tree, take the last definition), include
+ * statements are INCLUDE entries rather than loaded, and directives are
+ * called with a NULL section.
+ */
+
+#ifndef __VCTAPE_H
+#define __VCTAPE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include "vcparse.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_TAPE_TYPES(XX)                                               \
+    XX(SECTION)     /* Section; v.next is the index past its END */     \
+    XX(END)         /* End of section; v.next is its SECTION */         \
+    XX(KEY)         /* Name of the option that follows */               \
+    XX(BOOLEAN)     /* v.i is 0 or 1 */                                 \
+    XX(INTEGER)     /* v.i */                                           \
+    XX(FLOAT)       /* v.f */                                           \
+    XX(STRING)      /* v.off, length */                                 \
+    XX(ARRAY)       /* length elements follow; v.next is past them */   \
+    XX(INCLUDE)     /* Include statement; v.off, length: the pattern */ \
+    XX(DURATION)    /* v.i, in nanoseconds */                           \
+    XX(SIZE)        /* v.i, in bytes */                                 \
+    XX(RATIO)       /* v.f, 0.5 for 50% */
+
+typedef enum {
+    #define XX(name) VC_TAPE_##name,
+    VC_TAPE_TYPES(XX)
+    #undef XX
+} vc_tape_type;
+
+/* Tape entry */
+typedef struct vc_tape_entry {
+    uint32_t type;              /* vc_tape_type */
+    uint32_t length;            /* KEY, STRING, INCLUDE: bytes
+                                 * ARRAY: number of elements */
+    union {
+        int64_t i;              /* BOOLEAN, INTEGER, DURATION, SIZE */
+        double f;               /* FLOAT, RATIO */
+        uint64_t off;           /* KEY, STRING, INCLUDE: offset of the
+                                 * NUL-terminated bytes in strings */
+        uint64_t next;          /* SECTION, ARRAY, END: see above */
+    } v;
+} vc_tape_entry;
+
+/* Parsed tape.  The entries and strings follow this header, in the same
+ * allocation. */
+typedef struct vc_tape {
+    vc_tape_entry *entries;     /* Entries, from the root SECTION */
+    size_t length;              /* Number of entries */
+    char *strings;              /* Keys and string values */
+    size_t size;                /* Bytes of strings */
+    const vc_allocator *alloc;  /* Allocator it was parsed with */
+} vc_tape;
+
+/* Tape being built by the parser */
+typedef struct vc_tape_builder {
+    vc_tape_entry *entries;
+    size_t length, cap;
+    char *strings;
+    size_t size, capstrings;
+    size_t open[MAX_DEPTH + 1]; /* SECTION entries not yet ended */
+    int depth;
+    const vc_allocator *alloc;
+} vc_tape_builder;
+
+/**********************************************************************/
+/**** Begin Definitions/Static Declarations ***************************/
+/**********************************************************************/
+
+/* Bytes of a KEY, STRING or INCLUDE entry */
+#define VC_TAPE_STR(tape, e) ((tape)->strings + (e)->v.off)
+
+/* Index just past the value at index i, skipping any subtree */
+#define VC_TAPE_NEXT(tape, i)                                           \
+    (((tape)->entries[i].type == VC_TAPE_SECTION ||                     \
+      (tape)->entries[i].type == VC_TAPE_ARRAY) ?                       \
+     (size_t)(tape)->entries[i].v.next : (size_t)(i) + 1)
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Tapes are parsed by vc_parse_tape and vc_parse_tape_file (see
+ * vcparse.h), and freed with a single free. */
+void vc_tape_free(vc_tape *tape);
+
+/* Find an option by path, below the SECTION at index sect (0 for the
+ * root).  Returns the index of its value, or 0 if there is none. */
+size_t vc_tape_lookup(const vc_tape *tape, size_t sect, const char *optpath);
+
+/* Building, for the parser.  Each returns zero if memory runs out or
+ * the value is of a type the tape can't hold. */
+int vc_tape_init(vc_tape_builder *b, const vc_allocator *alloc);
+int vc_tape_add(vc_tape_builder *b, const char *key, size_t keylen, vc_token *token);
+int vc_tape_add_array(vc_tape_builder *b, const char *key, size_t keylen, vc_token *tokens, size_t count);
+int vc_tape_begin(vc_tape_builder *b, const char *key, size_t keylen);
+int vc_tape_end(vc_tape_builder *b);
+int vc_tape_include(vc_tape_builder *b, const char *pattern, size_t length);
+
+/* Close the root and pack the tape into one allocation.  The builder is
+ * emptied either way; vc_tape_discard frees a tape never finished. */
+vc_tape *vc_tape_finish(vc_tape_builder *b);
+void vc_tape_discard(vc_tape_builder *b);
+
+#endif /* #ifndef __VCTAPE_H */
@@ -0,0 +1,71 @@
+/* 
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcthread.h
+ * 
+ * Worker thread pool for VConfig.  Jobs are run in FIFO order by a fixed
+ * number of threads.  A thread waiting on the results of jobs can help
+ * run queued jobs, so jobs may safely wait on other jobs.
+ */
+
+#ifndef __VCTHREAD_H
+#define __VCTHREAD_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <pthread.h>
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Job handler */
+typedef void (*vc_job_fn)(void *arg);
+
+/* Queued job */
+typedef struct vc_job {
+    vc_job_fn fn;               /* Handler */
+    void *arg;                  /* Argument passed to handler */
+    struct vc_job *next;        /* Next job in queue */
+} vc_job;
+
+/* Thread pool definition */
+typedef struct vc_threadpool {
+    pthread_mutex_t lock;       /* Protects the queue */
+    pthread_cond_t ready;       /* Signalled when jobs are queued */
+    pthread_cond_t idle;        /* Signalled when all jobs are done */
+    
+    vc_job *head;               /* Next job to run */
+    vc_job *tail;               /* Last job queued */
+    int pending;                /* Jobs queued or running */
+    int stop;                   /* Set when shutting down */
+    
+    int nthreads;               /* Number of worker threads */
+    pthread_t *threads;         /* Worker threads */
+} vc_threadpool;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Create/destroy a pool.  A thread count of zero uses one thread per
+ * online CPU.  Destroying the pool runs any jobs still queued. */
+vc_threadpool *vc_threadpool_create(int nthreads);
+void vc_threadpool_destroy(vc_threadpool *pool);
+
+/* Queue a job.  Returns zero on failure. */
+int vc_threadpool_submit(vc_threadpool *pool, vc_job_fn fn, void *arg);
+
+/* Run one queued job on the calling thread, if there is one.  Returns
+ * nonzero if a job was run. */
+int vc_threadpool_run_one(vc_threadpool *pool);
+
+/* Wait until every queued job has finished, helping run them. */
+void vc_threadpool_wait(vc_threadpool *pool);
+
+/* Number of online CPUs, at least one */
+int vc_cpu_count(void);
+
+#endif /* #ifndef __VCTHREAD_H */
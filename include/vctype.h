@@ -14,8 +14,9 @@
 /**********************************************************************/
 /**** Begin Includes **************************************************/
 /**********************************************************************/
+#include <pthread.h>
 #include "hash.h"
-#include "vcdirect.h"
+#include "vcerror.h"
 
 /**********************************************************************/
 /**** Begin Type Definitions ******************************************/
@@ -27,7 +28,11 @@
     XX(INTEGER)                     \
     XX(FLOAT)                       \
     XX(STRING)                      \
-    XX(SECTION)
+    XX(SECTION)                     \
+    XX(ARRAY)                       \
+    XX(DURATION)                    \
+    XX(SIZE)                        \
+    XX(RATIO)
 
 /* VConfig Option Type Enum */
 typedef enum {
@@ -36,23 +41,102 @@ typedef enum {
     #undef XX
 } vc_type;
 
+/* VConfig Option flags */
+#define VC_OPT_BORROWED 0x01    /* Value points into the source buffer */
+#define VC_OPT_POOLED   0x02    /* Value is interned; set with BORROWED */
+
 /* Container for VConfig Options */
 typedef struct vc_opt {
     vc_type type;
+    int flags;
     void *value;
 } vc_opt;
 
 /* Container for list-style VConfig options, compatible with vc_opt */
 typedef struct vc_list {
     vc_type type;
+    int flags;
     void *value;
     struct vc_list *next;
 } vc_list;
 
+/* Container for array VConfig options.  Elements are homogeneous and
+ * packed into a single allocation directly following this header:
+ *   - VC_INTEGER: int64_t[length]
+ *   - VC_FLOAT:   double[length]
+ *   - VC_STRING:  char *[length] table, followed by the string bytes.
+ * An empty array has an element type of VC_ERROR. */
+typedef struct vc_array {
+    vc_type type;       /* Element type */
+    size_t length;      /* Number of elements */
+    union {
+        int64_t *ints;
+        double *floats;
+        char **strs;
+        void *data;
+    } v;
+} vc_array;
+
+/* VConfig root flags */
+#define VC_ROOT_INTERN_VALUES 0x01  /* Intern string values, not just keys */
+#define VC_ROOT_SEEDED_HASH   0x02  /* Hash keys with a random seed */
+#define VC_ROOT_PATH_INDEX    0x04  /* Look up whole paths in an index */
+#define VC_ROOT_KEY_INDEX     0x08  /* Keep sections' keys sorted, for
+                                     * queries (see vcquery.h) */
+#define VC_ROOT_SHARE_SECTIONS 0x10 /* Share sections with other configs
+                                     * (see vcshare.h) */
+#define VC_ROOT_LOOKUP_CACHE  0x20  /* Look up through the per-thread cache
+                                     * (see vccache.h) */
+#define VC_ROOT_FRAGMENT      0x40  /* An included file, which every config
+                                     * including it shares (see vcinclude.h) */
+#define VC_ROOT_COPY_KEYS     0x80  /* No pool: each table copies its keys,
+                                     * so lookups never touch shared state
+                                     * (see vcshare.h) */
+
+/* Per-config state, shared by every section in a tree */
+typedef struct vc_root {
+    struct vc_sect *sect;    /* Root section, which owns this state */
+    int flags;               /* VC_ROOT_* flags */
+    const vc_allocator *alloc; /* Allocator for everything in the config
+                              * (NULL: malloc; see vcalloc.h) */
+    char *source;            /* Source buffer, which borrowed string values
+                              * point into */
+    fasthash_pool *pool;     /* Intern pool for keys and string values;
+                              * NULL with VC_ROOT_COPY_KEYS */
+    struct vc_image *image;  /* Shared-memory image, if this config is
+                              * one (see vcimage.h) */
+    pthread_rwlock_t lock;   /* Held for writing while edits are applied
+                              * (see vcedit.h) */
+    uint64_t generation;     /* Bumped by every applied edit */
+    fasthash_table *index;   /* Full path -> option, once built (see
+                              * vcindex.h) */
+    pthread_mutex_t index_lock; /* Serializes building the index */
+} vc_root;
+
+struct vc_include;
+struct vc_image;
+struct vc_keys;
+
+/* 128-bit content hash (see vcdiff.h) */
+typedef struct vc_hash {
+    uint64_t lo, hi;
+} vc_hash;
+
 /* VConfig Section type definition */
 typedef struct vc_sect {
-    /* TBD - Do I need anything else in here? */
     fasthash_table *ht;      /* Hash table to store vc_opt values */
+    vc_root *root;           /* State of the config this section is in */
+    struct vc_sect *parent;  /* Section holding this one; NULL for a root */
+    struct vc_include *includes; /* Included files, searched on a miss */
+    struct vc_keys *keys;    /* Keys in sorted order, once queried with
+                              * VC_ROOT_KEY_INDEX (see vcquery.h) */
+    vc_hash hash;            /* Hash of the section's contents, valid
+                              * while hashed is set (see vcdiff.h) */
+    int hashed;
+    int shared;              /* Held by the shared-section store, and
+                              * referenced rather than owned (see vcshare.h) */
+    uint32_t refs;           /* References to a shared section */
+    struct vc_sect *next;    /* Next shared section in its store bucket */
 } vc_sect;
 typedef vc_sect vconfig;
 
@@ -66,38 +150,143 @@ typedef struct vc_directive {
     vc_dirfunc func;    /* Function handler */
 } vc_directive;
 
+/* VConfig open flags */
+#define VC_PARAM_INTERN_VALUES 0x01 /* Intern string values as well as keys */
+#define VC_PARAM_SEEDED_HASH   0x02 /* Hash keys with SipHash-1-3 under a
+                                     * random seed, so keys from untrusted
+                                     * sources can't be made to collide */
+#define VC_PARAM_PATH_INDEX    0x04 /* Index whole option paths, so a
+                                     * lookup is a single probe */
+#define VC_PARAM_KEY_INDEX     0x08 /* Keep each section's keys sorted, so
+                                     * a query scans only the matches */
+#define VC_PARAM_VALIDATE_UTF8 0x10 /* Reject string values that aren't
+                                     * valid UTF-8, escapes included */
+#define VC_PARAM_SHARE_SECTIONS 0x20 /* Share sections with identical
+                                     * ones of other configs */
+#define VC_PARAM_LOOKUP_CACHE  0x40 /* Cache lookups of the same path
+                                     * strings in each thread */
+
 typedef struct vc_params {
     char *file;                 /* Name of file to open */
     vc_directive *directives;   /* Directives list to use */
+    int flags;                  /* VC_PARAM_* flags */
+    vc_errsink *errors;         /* Where to report errors (NULL: stderr) */
+    const vc_allocator *allocator; /* Memory for the config (NULL: malloc;
+                                 * see vcalloc.h) */
 } vc_params;
 
+/* Parameters shared by every file of a batch open */
+typedef struct vc_batch_params {
+    vc_directive *directives;   /* Directives list to use */
+    int flags;                  /* VC_PARAM_* flags */
+    int threads;                /* Worker threads (0: one per CPU) */
+    const vc_allocator *allocator; /* Memory for every config (NULL: malloc) */
+} vc_batch_params;
+
+/* Memory/size statistics for a config */
+typedef struct vc_stats {
+    size_t sections;            /* Number of sections, including root */
+    size_t options;             /* Number of non-section options */
+    size_t intern_strings;      /* Distinct strings in the intern pool */
+    size_t intern_bytes;        /* Bytes of string data in the pool */
+    size_t intern_saved;        /* Bytes saved by interning duplicates */
+    size_t index_entries;       /* Paths in the full-path index */
+    size_t index_bytes;         /* Memory used by the full-path index */
+    size_t keys_bytes;          /* Memory used by sorted section keys */
+    size_t shared_sections;     /* Sections held in the shared store */
+} vc_stats;
+
+/* An option path with its keys hashed ahead of time, as emitted by
+ * vconfig-gen.  Hashes are djb2; configs with seeded hashes rehash the
+ * keys at lookup. */
+typedef struct vc_key {
+    const char *key;            /* Key, or whole option path */
+    uint32_t length;            /* Length of key */
+    uint32_t hash;              /* djb2 hash of key */
+} vc_key;
+
+typedef struct vc_keypath {
+    vc_key path;                /* Whole path, for the full-path index */
+    const vc_key *segs;         /* Path segments, outermost first */
+    uint32_t nsegs;             /* Number of segments */
+} vc_keypath;
+
 struct vc_token;
 /**********************************************************************/
 /**** Begin Definitions/Static Declarations ***************************/
 /**********************************************************************/
-/* NONE */
+
+/* Allocator of the config a section belongs to */
+#define VC_SECT_ALLOC(sect) ((sect)->root ? (sect)->root->alloc : 0)
 
 /**********************************************************************/
 /**** Begin Function Prototypes ***************************************/
 /**********************************************************************/
-vc_sect *vc_root_sect(void);
-vc_sect *vc_sect_create(void);
+vc_sect *vc_root_sect(int flags, const vc_allocator *alloc);
+vc_sect *vc_sect_create(vc_root *root, vc_sect *parent);
+
+/* As vc_sect_create, with a table of the given number of buckets */
+vc_sect *vc_sect_create_sized(vc_root *root, vc_sect *parent, uint32_t size);
 void vc_sect_destroy(vc_sect *sect);
 
+/* Gather statistics for a section and everything below it */
+void vc_sect_stats(vc_sect *sect, vc_stats *stats);
+
 
-/* Add a new VConfig option value within a VConfig section */
+/* Add a new VConfig option value within a VConfig section.  An option
+ * already of that name is replaced and destroyed. */
 vc_opt *vc_addopt(vc_sect *sect, char *name, struct vc_token *token);
 vc_opt *vc_addoptn(vc_sect *sect, char *name, size_t length, struct vc_token *token);
 
+/* Add a new VConfig array value built from a list of value tokens */
+vc_opt *vc_addarrayn(vc_sect *sect, char *name, size_t length, struct vc_token *tokens, size_t count);
+
 /* Get VConfig option, within the container. */
 vc_opt *vc_getopt(vc_sect *sect, char *optpath);
 
+/* As vc_getopt, for an option path of the given length, which needn't
+ * be NUL-terminated. */
+vc_opt *vc_getoptn(vc_sect *sect, char *optpath, size_t length);
+
+/* Get an option by walking the sections, without the full-path index */
+vc_opt *vc_getopt_walk(vc_sect *sect, char *optpath);
+vc_opt *vc_getopt_walkn(vc_sect *sect, char *optpath, size_t length);
+
+/* Get an option by a pre-hashed path.  Finds the same option as
+ * vc_getopt would for the whole path. */
+vc_opt *vc_getopt_key(vc_sect *sect, const vc_keypath *kp);
+
 /* Get VConfig option value.  You must know the type ahead of time for
  * this one. */
 void *vc_getval(vc_sect *sect, char *optpath);
 
-vc_opt *vc_opt_create(struct vc_token *token);
-void vc_opt_destroy(void *opt);
+/* Get an option value and its type, from a parsed config or an image */
+void *vc_sect_getval(vc_sect *sect, char *optpath, vc_type *type);
+void *vc_sect_getvaln(vc_sect *sect, char *optpath, size_t length, vc_type *type);
+void *vc_sect_getval_key(vc_sect *sect, const vc_keypath *kp, vc_type *type);
+
+/* Append a section, then everything it includes, in lookup order */
+int vc_sect_sources(vc_sect *sect, vc_sect ***srcs, size_t *n, size_t *cap);
+
+vc_opt *vc_opt_create(vc_sect *sect, struct vc_token *token);
+void vc_opt_destroy(void *opt, const vc_allocator *alloc);
+
+/* Copy an option other than a section, for use within sect */
+vc_opt *vc_opt_copy(vc_sect *sect, vc_opt *opt);
+
+vc_array *vc_array_create(struct vc_token *tokens, size_t count, const vc_allocator *alloc);
+vc_array *vc_array_copy(vc_array *arr, const vc_allocator *alloc);
+void vc_array_destroy(vc_array *arr, const vc_allocator *alloc);
+
+/* Convert a numeric token.  Returns zero if it is longer than any
+ * number we convert, or out of range. */
+int vc_token_int(struct vc_token *token, int64_t *value);
+int vc_token_float(struct vc_token *token, double *value);
+
+/* Decode a raw string token (escapes and adjacent literals) into dst.
+ * dst may equal src, as the decoded string is never longer.  Returns
+ * the decoded length. */
+size_t vc_string_decode(char *dst, const char *src, size_t length);
 
 
 #endif /* #ifndef __VCTYPE_H */
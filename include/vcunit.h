@@ -0,0 +1,56 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcunit.h
+ *
+ * Values with units, parsed once at load rather than by every consumer:
+ *
+ *      VC_DURATION     30s, 2h30m, 1.5ms, -10m
+ *                      One or more numbers, each with a unit: ns, us, ms,
+ *                      s, m, h or d.  Stored as int64_t nanoseconds.
+ *      VC_SIZE         512MiB, 4KB, 1.5GiB, 100B
+ *                      A number and a unit: B, kB (or KB), MB, GB, TB, PB
+ *                      in powers of 1000, or KiB, MiB, GiB, TiB, PiB in
+ *                      powers of 1024.  Stored as int64_t bytes.
+ *      VC_RATIO        50%, 12.5%
+ *                      A number and a percent sign.  Stored as a double,
+ *                      0.5 for 50%.
+ *
+ * Numbers may have a fraction; whatever falls below a nanosecond or a
+ * byte is dropped.  Values past the range of int64_t are not accepted.
+ */
+
+#ifndef __VCUNIT_H
+#define __VCUNIT_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Parsed value */
+typedef union vc_unit_value {
+    int64_t i;                  /* VC_DURATION, VC_SIZE */
+    double f;                   /* VC_RATIO */
+} vc_unit_value;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Parse a value with a unit, of the given length.  Returns its type, or
+ * VC_ERROR if it isn't one. */
+vc_type vc_unit_parse(const char *str, size_t length, vc_unit_value *value);
+
+/* Write a value of a unit type as it would be parsed back, with the
+ * largest unit that keeps it exact, as snprintf does.  value points to
+ * an int64_t or a double, as stored in a vc_opt. */
+int vc_unit_format(char *buf, size_t size, vc_type type, const void *value);
+
+#endif /* #ifndef __VCUNIT_H */
@@ -0,0 +1,54 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcutf8.h
+ *
+ * UTF-8 validation, for string values parsed with VC_PARAM_VALIDATE_UTF8.
+ * Blocks of input are checked with the lookup algorithm of Keiser and
+ * Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte", using
+ * AVX2 or SSE4.1 where the CPU has them, chosen at run time, and a byte
+ * at a time otherwise.  Overlong forms, surrogates and code points past
+ * U+10FFFF are rejected, as are sequences cut short by the end.
+ */
+
+#ifndef __VCUTF8_H
+#define __VCUTF8_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <stddef.h>
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_UTF8_IMPLS(XX)           \
+    XX(SCALAR)                      \
+    XX(SSE41)                       \
+    XX(AVX2)
+
+/* How validation is done */
+typedef enum {
+    #define XX(name) VC_UTF8_##name,
+    VC_UTF8_IMPLS(XX)
+    #undef XX
+} vc_utf8_impl;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Check that data is valid UTF-8.  Returns length if it is, and otherwise
+ * the offset of the first byte of the first invalid sequence. */
+size_t vc_utf8_check(const char *data, size_t length);
+
+/* The same, done a given way.  An implementation the CPU lacks falls back
+ * to the best one it has. */
+size_t vc_utf8_check_impl(const char *data, size_t length, vc_utf8_impl impl);
+
+/* Best implementation for this CPU */
+vc_utf8_impl vc_utf8_get_impl(void);
+
+#endif /* #ifndef __VCUTF8_H */
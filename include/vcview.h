@@ -0,0 +1,70 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcview.h
+ *
+ * Layered views.  A view stacks configs (defaults, site, host, overrides,
+ * ...) without copying them: a lookup tries the top layer first, and
+ * falls through to the layers below.  The layers remain owned by the
+ * caller, and must outlive the view.
+ *
+ * For each section path looked up, the view remembers which layers do
+ * not have that section at all, so misses in upper layers aren't probed
+ * again.  Pushing or popping a layer forgets this, as does an edit to any
+ * layer (see vcedit.h).  A mask is only kept if no layer was edited while
+ * it was worked out, and at most VC_VIEW_MAX_MISSES are kept; paths
+ * beyond those are probed in every layer.  Lookups may run in parallel,
+ * sharing the view's lock, but not alongside a push or pop.
+ */
+
+#ifndef __VCVIEW_H
+#define __VCVIEW_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <pthread.h>
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_VIEW_MAX_LAYERS 64
+#define VC_VIEW_MAX_MISSES 1024     /* Section paths whose misses are kept */
+
+/* View definition */
+typedef struct vc_view {
+    vc_sect *layers[VC_VIEW_MAX_LAYERS];    /* Layers, bottom first */
+    int nlayers;                            /* Number of layers */
+
+    fasthash_table *misses;     /* Section path -> mask of layers that
+                                 * don't have the section */
+    uint64_t gens[VC_VIEW_MAX_LAYERS];  /* Layer generations misses are
+                                         * valid for */
+    pthread_rwlock_t lock;      /* Protects misses and gens; held shared
+                                 * to read them */
+} vc_view;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+vc_view *vc_view_create(void);
+void vc_view_destroy(vc_view *view);
+
+/* Push a layer on top, or pop the top layer.  Push returns zero if the
+ * view is full. */
+int vc_view_push(vc_view *view, vc_sect *sect);
+vc_sect *vc_view_pop(vc_view *view);
+
+/* Look up an option through the layers */
+vc_opt *vc_view_getopt(vc_view *view, char *optpath);
+void *vc_view_getval(vc_view *view, char *optpath, vc_type *type);
+
+/* Merge the layers into a new, independent config.  Image layers can't
+ * be flattened. */
+vc_sect *vc_view_flatten(vc_view *view);
+
+#endif /* #ifndef __VCVIEW_H */
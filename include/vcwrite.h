@@ -0,0 +1,54 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcwrite.h
+ *
+ * Config writer.  Emits a parsed config in the vconfig text format, which
+ * parses back to the same config.  Options of each section are written
+ * in sorted order, before its subsections, so output is deterministic.
+ * Includes are written as include statements, rather than inlined, with
+ * their paths as they were written, so a relative path is still relative
+ * to the directory the output is read from.  A config holding a float
+ * or ratio that is infinite or NaN, which the format can't express,
+ * fails to write, with errno set to EDOM.
+ *
+ * Output is assembled in a large buffer and written with writev; long
+ * strings that need no escaping are written straight from the config.
+ */
+
+#ifndef __VCWRITE_H
+#define __VCWRITE_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include "vctype.h"
+
+/**********************************************************************/
+/**** Begin Type Definitions ******************************************/
+/**********************************************************************/
+
+#define VC_WRITE_BUFSIZE  (256 * 1024)  /* Output buffer size */
+#define VC_WRITE_IOVMAX   64            /* Buffered segments per writev */
+#define VC_WRITE_DIRECT   512           /* Shortest string written in place */
+#define VC_WRITE_INDENT   4             /* Default indent per section */
+
+/* Writer options */
+typedef struct vc_write_opts {
+    int indent;                 /* Spaces per section level */
+} vc_write_opts;
+
+/**********************************************************************/
+/**** Begin Function Prototypes ***************************************/
+/**********************************************************************/
+
+/* Write a config to a file descriptor.  Returns zero on error, with
+ * errno set. */
+int vc_write(vc_sect *sect, int fd, vc_write_opts *opts);
+
+/* Write a config to a new NUL-terminated buffer, which the caller frees.
+ * Returns NULL on error, with errno set. */
+char *vc_write_buffer(vc_sect *sect, vc_write_opts *opts, size_t *length);
+
+#endif /* #ifndef __VCWRITE_H */
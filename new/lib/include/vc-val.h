@@ -16,18 +16,34 @@
  * Type definition for VCVAL
  * 
  **********************************************************************/
- 
+
+/* A value is 24 bytes.  The last byte is its tag: the TYPE_* in the low
+ * bits, and for a string stored inside the value, its length plus one
+ * above them.  Strings of up to VAL_SSO_MAX bytes fill the rest, with
+ * their terminator, so only longer strings need an allocation of their
+ * own; those keep their length beside the pointer. */
+#define VAL_SIZE        24
+#define VAL_SSO_MAX     (VAL_SIZE - 2)
+
+#define VAL_TYPE_MASK   0x07
+#define VAL_LEN_SHIFT   3       /* Inline length plus one; zero if none */
+
 struct vcfg_value;
 typedef struct vcfg_value VCVAL;
 
 struct vcfg_value {
-    VCINT flags;    /* Determines type */
     union {
+        VCBOOL  _bool;      /* Boolean value */
         VCINT   _int;       /* Integer value */
         VCFLOAT _float;     /* Floating point */
         VCCHAR  _char;      /* Character */
-        VCSTR   _str;       /* String */
-        
+        struct {
+            VCSTR str;      /* String, if longer than VAL_SSO_MAX */
+            VCCNT length;   /* Its length, without the terminator */
+        } _heap;
+        VCCHAR  _sso[VAL_SSO_MAX + 1];  /* Short string, NUL-terminated */
+        VCBYTE  _raw[VAL_SIZE];         /* Last byte is the tag */
+
         #ifdef VCGRP_IMPL        
         VCGRP  _grp;        /* Group of values. Not defined yet. */
         #endif /* #ifdef GRP_IMPL */
@@ -39,11 +55,16 @@ struct vcfg_value {
  * Macros for accessing VCVAL values
  * 
  **********************************************************************/
- 
+
+#define VAL_TAG(v)      ((v)->data._raw[VAL_SIZE - 1])
+#define VAL_TYPE(v)     (VAL_TAG(v) & VAL_TYPE_MASK)
+#define VAL_INLINE(v)   (VAL_TAG(v) >> VAL_LEN_SHIFT)
+#define VAL_BOOL(v)     ((v)->data._bool)
 #define VAL_INT(v)      ((v)->data._int)
 #define VAL_FLOAT(v)    ((v)->data._float)
 #define VAL_CHAR(v)     ((v)->data._char)
-#define VAL_STR(v)      ((v)->data._str)
+#define VAL_STR(v)      (VAL_INLINE(v) ? (v)->data._sso : (v)->data._heap.str)
+#define VAL_STRLEN(v)   (VAL_INLINE(v) ? (VCCNT)(VAL_INLINE(v) - 1) : (v)->data._heap.length)
 
 #ifdef VCGRP_IMPL
 #define VAL_GRP(v)      ((v)->data._grp)
@@ -53,9 +74,33 @@ struct vcfg_value {
  * 
  * Allocating a new VCVAL.
  * 
+ * val points to a value of the given type, except for TYPE_VCSTR, where
+ * it is the string itself, which is copied.  A NULL val gives the zero
+ * value of the type (false, 0, 0.0, '\0' or "").
+ * 
  **********************************************************************/
 
 extern VCVAL *new_VCVAL(VCINT type, VCREF val);
 extern void   del_VCVAL(VCVAL *val);
 
+/* Construct/destroy a value in place, e.g. within an array of values.
+ * init_VCVAL returns zero if the type is unknown or memory runs out. */
+extern int    init_VCVAL(VCVAL *val, VCINT type, VCREF data);
+extern int    init_VCVAL_strn(VCVAL *val, const VCCHAR *str, VCCNT length);
+extern void   fini_VCVAL(VCVAL *val);
+
+/***********************************************************************
+ * 
+ * Allocation statistics, when built with VCVAL_STATS.
+ * 
+ **********************************************************************/
+
+#ifdef VCVAL_STATS
+struct vcval_stats {
+    VCCNT allocs;   /* Allocations made for values and strings */
+    VCCNT frees;    /* Allocations freed */
+};
+extern struct vcval_stats vcval_stats;
+#endif /* #ifdef VCVAL_STATS */
+
 #endif /* #ifndef VC_VAL_H */
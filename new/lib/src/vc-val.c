@@ -15,17 +15,95 @@
 #include "vc-val.h"
 
 
-#define NEW(type) (type *)malloc(sizeof(type))
-#define FREE(val) 
+#ifdef VCVAL_STATS
+struct vcval_stats vcval_stats;
+#define COUNT(field) (vcval_stats.field++)
+#else
+#define COUNT(field)
+#endif /* #ifdef VCVAL_STATS */
 
+#define NEW(type) (type *)val_alloc(sizeof(type))
+#define FREE(val) val_free(val)
+
+
+static void *val_alloc(size_t size) {
+    void *p = malloc(size);
+    if (p) COUNT(allocs);
+    return p;
+}
+
+static void val_free(void *p) {
+    if (p) COUNT(frees);
+    free(p);
+}
 
 VCVAL *new_VCVAL(VCINT type, VCREF val) {
     VCVAL *newval = NEW(VCVAL);
     if (!newval) return NULL;
 
+    if (!init_VCVAL(newval, type, val)) {
+        FREE(newval);
+        return NULL;
+    }
     return newval;
 }
 
 void del_VCVAL(VCVAL *val) {
-    free(val);
+    if (!val) return;
+    fini_VCVAL(val);
+    FREE(val);
+}
+
+int init_VCVAL(VCVAL *val, VCINT type, VCREF data) {
+    memset(val, 0, sizeof(VCVAL));
+    VAL_TAG(val) = (VCBYTE)type;
+
+    switch (type) {
+        case TYPE_VCBOOL:
+            VAL_BOOL(val) = data ? *(VCBOOL *)data : 0;
+        break;
+        case TYPE_VCINT:
+            VAL_INT(val) = data ? *(VCINT *)data : 0;
+        break;
+        case TYPE_VCFLOAT:
+            VAL_FLOAT(val) = data ? *(VCFLOAT *)data : 0.0;
+        break;
+        case TYPE_VCCHAR:
+            VAL_CHAR(val) = data ? *(VCCHAR *)data : '\0';
+        break;
+        case TYPE_VCSTR:
+            return init_VCVAL_strn(val, (VCCHAR *)data, data ? strlen((char *)data) : 0);
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+int init_VCVAL_strn(VCVAL *val, const VCCHAR *str, VCCNT length) {
+    VCCHAR *dst;
+
+    /* Short strings live in the value, tagged with their length; only
+     * longer ones are allocated */
+    if (length <= VAL_SSO_MAX) {
+        dst = val->data._sso;
+        VAL_TAG(val) = (VCBYTE)(TYPE_VCSTR | ((length + 1) << VAL_LEN_SHIFT));
+    } else {
+        dst = (VCCHAR *)val_alloc(length + 1);
+        if (!dst) return 0;
+        val->data._heap.str = dst;
+        val->data._heap.length = length;
+        VAL_TAG(val) = TYPE_VCSTR;
+    }
+
+    if (length) memcpy(dst, str, length);
+    dst[length] = '\0';
+    return 1;
+}
+
+void fini_VCVAL(VCVAL *val) {
+    if (VAL_TYPE(val) == TYPE_VCSTR && !VAL_INLINE(val)) {
+        FREE(val->data._heap.str);
+    }
+    memset(val, 0, sizeof(VCVAL));
+    VAL_TAG(val) = TYPE_VCINT;
 }
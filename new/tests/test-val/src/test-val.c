@@ -8,27 +8,134 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #include "vc-common.h"
 #include "vc-val.h"
 
+#define BENCH_ITERS 1000000
+
 #define DO_TEST(TESTNAME, _TEST_)       \
     printf("Testing %s:\n", TESTNAME);  \
     _TEST_(VCBOOL)                      \
     _TEST_(VCINT)                       \
     _TEST_(VCFLOAT)                     \
     _TEST_(VCCHAR)                      \
-    _TEST_(VCSTR)                       \
+    _TEST_(VCSTR)
+
+#define RESULT(name, ok) {                      \
+    printf("\t%s\t Result: [%s]\n",             \
+            name, (ok) ? "PASS" : "FAIL");      \
+    if (!(ok)) failures++;                      \
+}
+
 #define TEST_ALLOC(type) {                  \
     VCVAL *val;                             \
     val = new_VCVAL(TYPE_##type, 0);        \
     printf("\tType: %s\t Result: [%s]\n",   \
             #type, val ? "PASS" : "FAIL");  \
+    if (!val) failures++;                   \
     del_VCVAL(val);                         \
 }
 
+static int failures;
+
+/* Construct a string value, and check its contents and storage */
+static void test_str(const char *name, const char *str, int inline_expected) {
+    VCCNT allocs = vcval_stats.allocs;
+    VCVAL *val = new_VCVAL(TYPE_VCSTR, (VCREF)str);
+    int ok = val && VAL_TYPE(val) == TYPE_VCSTR &&
+             VAL_STRLEN(val) == strlen(str) && !strcmp(VAL_STR(val), str) &&
+             VAL_STR(val) != str &&
+             !!VAL_INLINE(val) == inline_expected &&
+             vcval_stats.allocs - allocs == (inline_expected ? 1 : 2);
+    RESULT(name, ok);
+    del_VCVAL(val);
+}
+
+static void test_values(void) {
+    VCBOOL b = 1;
+    VCINT i = -42;
+    VCFLOAT f = 3.25;
+    VCCHAR c = 'x';
+    VCVAL *val;
+    VCVAL local;
+
+    printf("Testing VCVAL values:\n");
+    val = new_VCVAL(TYPE_VCBOOL, &b);
+    RESULT("VCBOOL", val && VAL_TYPE(val) == TYPE_VCBOOL && VAL_BOOL(val) == 1);
+    del_VCVAL(val);
+    val = new_VCVAL(TYPE_VCINT, &i);
+    RESULT("VCINT", val && VAL_TYPE(val) == TYPE_VCINT && VAL_INT(val) == -42);
+    del_VCVAL(val);
+    val = new_VCVAL(TYPE_VCFLOAT, &f);
+    RESULT("VCFLOAT", val && VAL_TYPE(val) == TYPE_VCFLOAT && VAL_FLOAT(val) == 3.25);
+    del_VCVAL(val);
+    val = new_VCVAL(TYPE_VCCHAR, &c);
+    RESULT("VCCHAR", val && VAL_TYPE(val) == TYPE_VCCHAR && VAL_CHAR(val) == 'x');
+    del_VCVAL(val);
+    val = new_VCVAL(TYPE_VCSTR, 0);
+    RESULT("VCSTR(0)", val && VAL_STRLEN(val) == 0 && !strcmp(VAL_STR(val), ""));
+    del_VCVAL(val);
+    RESULT("Unknown", !new_VCVAL(TYPE_VCSTR + 1, 0));
+    RESULT("Size", sizeof(VCVAL) == VAL_SIZE && VAL_SIZE == 24);
+
+    printf("Testing VCVAL strings:\n");
+    test_str("Empty", "", 1);
+    test_str("Short", "web01", 1);
+    test_str("Config-sized", "/etc/ssl/server.pem", 1);
+    test_str("Longest inline", "0123456789012345678901", 1);
+    test_str("Shortest heap", "01234567890123456789012", 0);
+    test_str("Long", "/var/lib/vconfig/servers/default/listen.cfg", 0);
+
+    /* Lengths are explicit, so the source needn't be terminated */
+    init_VCVAL_strn(&local, "hostname=web01", 8);
+    RESULT("Length-delimited", !strcmp(VAL_STR(&local), "hostname") && VAL_STRLEN(&local) == 8 &&
+                               VAL_TYPE(&local) == TYPE_VCSTR);
+    fini_VCVAL(&local);
+    RESULT("Cleared", VAL_TYPE(&local) == TYPE_VCINT && !VAL_INLINE(&local));
+    RESULT("Balanced", vcval_stats.allocs == vcval_stats.frees);
+}
+
+/* Construct and destroy BENCH_ITERS values of a string */
+static void bench_str(const char *name, const char *str) {
+    VCCNT a0, a1, a2;
+    struct timespec t0, t1, t2;
+    VCVAL local;
+    double heap, inplace;
+    int n;
+
+    a0 = vcval_stats.allocs;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (n = 0; n < BENCH_ITERS; n++) {
+        del_VCVAL(new_VCVAL(TYPE_VCSTR, (VCREF)str));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    a1 = vcval_stats.allocs;
+    for (n = 0; n < BENCH_ITERS; n++) {
+        init_VCVAL(&local, TYPE_VCSTR, (VCREF)str);
+        fini_VCVAL(&local);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    a2 = vcval_stats.allocs;
+
+    heap = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / BENCH_ITERS;
+    inplace = ((t2.tv_sec - t1.tv_sec) * 1e9 + (t2.tv_nsec - t1.tv_nsec)) / BENCH_ITERS;
+    printf("\t%-6s (%2zu bytes): new/del %6.1f ns, %.0f allocs; init/fini %6.1f ns, %.0f allocs\n",
+            name, strlen(str), heap, (double)(a1 - a0) / BENCH_ITERS,
+            inplace, (double)(a2 - a1) / BENCH_ITERS);
+}
 
 int main(int argc, char **argv) {
     DO_TEST("VCVAL Allocation", TEST_ALLOC);
-    return 0;
+    test_values();
+
+    printf("Benchmarking VCVAL strings (%d iterations):\n", BENCH_ITERS);
+    bench_str("Short", "web01");
+    bench_str("Path", "/etc/ssl/server.pem");
+    bench_str("Long", "/var/lib/vconfig/servers/default/listen.cfg");
+
+    printf("%s\n", failures ? "FAILED" : "All tests passed.");
+    return failures ? 1 : 0;
 }
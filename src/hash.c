@@ -13,19 +13,44 @@
 /**********************************************************************/
 #include "hash.h"
 #include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
 
 /**********************************************************************/
 /**** Macro Definitions ***********************************************/
 /**********************************************************************/
-/* NONE */
+#define ROTL64(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3) do {                           \
+    v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+    v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                    \
+    v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                    \
+    v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+} while (0)
 
 /**********************************************************************/
 /**** Static Function Prototypes **************************************/
 /**********************************************************************/
-uint32_t fasthash_insert_impl(fasthash_table *fh_table, char *key, void *entry);
+uint32_t fasthash_insert_impl(fasthash_table *fh_table, char *key, size_t length, void *entry, void **old);
+
+fasthash_node *fasthash_node_construct(fasthash_table *fh_table, char *key, void *entry, fasthash_node *next);
+fasthash_node *fasthash_node_destroy(fasthash_table *fh_table, fasthash_node *node);
+
+static int fasthash_pool_grow(fasthash_pool *pool);
+static void fasthash_pool_sweep(fasthash_pool *pool);
+static int fasthash_grow(fasthash_table *fh_table);
+static uint32_t fasthash_node_hash(fasthash_table *fh_table, fasthash_node *node);
+
+/* Hash a key as a table or pool with the given options and seed does */
+static uint32_t fasthash_hashn(uint32_t opts, const uint64_t *seed, char *key, size_t length);
+
+/* Pick a random seed for a keyed table or pool */
+static void fasthash_seed(uint64_t seed[2]);
 
-fasthash_node *fasthash_node_construct(char *key, void *entry, fasthash_node *next);
-fasthash_node *fasthash_node_destroy(fasthash_node *node, fasthash_destructor destruct);
+/* Lookups, given the hash of the key */
+static fasthash_node *fasthash_lookup_impl(fasthash_table *fh_table, char *key, size_t length, uint32_t hash);
+static char *fasthash_pool_find_impl(fasthash_pool *pool, char *str, size_t length, uint32_t hash);
 
 /**********************************************************************/
 /**** Function Definitions ********************************************/
@@ -37,22 +62,25 @@ fasthash_node *fasthash_node_destroy(fasthash_node *node, fasthash_destructor de
 
 /* FastHash Table Functions */
 /** FastHash Table Initialization **/
-fasthash_table *fasthash_init(uint32_t size, uint32_t opts, fasthash_destructor destruct) {
+fasthash_table *fasthash_init(uint32_t size, uint32_t opts, fasthash_destructor destruct, fasthash_pool *pool, const vc_allocator *alloc) {
     fasthash_table *fh_table;
     
     if (!size) return 0;
     
     /* Allocate memory for the table structure */
-    fh_table = (fasthash_table *)malloc(sizeof(fasthash_table));
+    fh_table = (fasthash_table *)vc_malloc(alloc, sizeof(fasthash_table));
     if (!fh_table) return 0;    /* Malloc error */
     
     bzero(fh_table, sizeof(fasthash_table));
     fh_table->size = size;
     fh_table->opts = opts;
     fh_table->destruct = destruct;
+    fh_table->pool = pool;
+    fh_table->alloc = alloc;
+    if (opts & FH_KEYED) fasthash_seed(fh_table->seed);
     
     /* Allocate memory for the actual entry table */
-    fh_table->entries = malloc(sizeof(fasthash_node *) * size);
+    fh_table->entries = vc_malloc(alloc, sizeof(fasthash_node *) * size);
     if (!fh_table->entries) goto err1;
     
     bzero(fh_table->entries, sizeof(fasthash_node *) * size);
@@ -60,7 +88,7 @@ fasthash_table *fasthash_init(uint32_t size, uint32_t opts, fasthash_destructor
     return fh_table;
 
 err1:
-    free(fh_table);
+    vc_free(alloc, fh_table);
     return 0;
 }
 
@@ -73,49 +101,55 @@ fasthash_table *fasthash_cleanup(fasthash_table *fh_table) {
         if (fh_table->opts & FH_NO_INDEXING) {
             for (i = 0; i < fh_table->size; i++) {
                 if (!fh_table->entries[i]) continue;
-                fasthash_node_destroy(fh_table->entries[i], fh_table->destruct);
+                fasthash_node_destroy(fh_table, fh_table->entries[i]);
             }
         } else {
             index_node *temp = fh_table->index_list, *temp2;
             while (temp) {
                 temp2 = temp->next;
                 i = temp->index;
-                fasthash_node_destroy(fh_table->entries[i], fh_table->destruct);
-                free(temp);
+                fasthash_node_destroy(fh_table, fh_table->entries[i]);
+                vc_free(fh_table->alloc, temp);
                 temp = temp2;
             }
         }
-        free(fh_table->entries);
+        vc_free(fh_table->alloc, fh_table->entries);
     }
     
-    free(fh_table);
+    vc_free(fh_table->alloc, fh_table);
     
     return 0;
 }
 
+/** Destructor for data allocated by the table's allocator **/
+void fasthash_free_data(void *data, const vc_allocator *alloc) {
+    vc_free(alloc, data);
+}
+
 /** Insert **/
 uint32_t fasthash_insert(fasthash_table *fh_table, char *key, void *entry) {
-    return fasthash_insert_impl(fh_table, key, entry);
+    if (!fh_table) return 0;
+    return fasthash_insert_impl(fh_table, key, strlen(key), entry, 0);
 }
 uint32_t fasthash_insertn(fasthash_table *fh_table, char *key, size_t length, void *entry) {
-    uint32_t retval;
-    char *key_sz;
-    
     if (!fh_table) return 0;
-    
-    key_sz = malloc((length + 1) * sizeof(char));
-    strncpy(key_sz, key, length);
-    key_sz[length] = 0;
-    
-    retval = fasthash_insert_impl(fh_table, key_sz, entry);
-    free(key_sz);
-    return retval;
+    return fasthash_insert_impl(fh_table, key, length, entry, 0);
+}
+
+/** Replace **/
+uint32_t fasthash_replace(fasthash_table *fh_table, char *key, void *entry, void **old) {
+    if (!fh_table) return 0;
+    return fasthash_insert_impl(fh_table, key, strlen(key), entry, old);
+}
+uint32_t fasthash_replacen(fasthash_table *fh_table, char *key, size_t length, void *entry, void **old) {
+    if (!fh_table) return 0;
+    return fasthash_insert_impl(fh_table, key, length, entry, old);
 }
 
 /** Force Insert **/
 uint32_t fasthash_force_insert(fasthash_table *fh_table, char *key, void *entry) {
     if (!fh_table) return 0;
-    uint32_t index = hash_djb2((unsigned char *)key) % fh_table->size;
+    uint32_t index = fasthash_hashn(fh_table->opts, fh_table->seed, key, strlen(key)) % fh_table->size;
     
     fh_table->entries[index] = entry;
     
@@ -124,35 +158,173 @@ uint32_t fasthash_force_insert(fasthash_table *fh_table, char *key, void *entry)
 
 uint32_t fasthash_force_insertn(fasthash_table *fh_table, char *key, size_t length, void *entry) {
     if (!fh_table) return 0;
-    uint32_t index = hashn_djb2((unsigned char *)key, length) % fh_table->size;
+    uint32_t index = fasthash_hashn(fh_table->opts, fh_table->seed, key, length) % fh_table->size;
     
     fh_table->entries[index] = entry;
     
     return index;
 }
 
+/** Remove **/
+void *fasthash_remove(fasthash_table *fh_table, char *key) {
+    if (!fh_table) return 0;
+    return fasthash_removen(fh_table, key, strlen(key));
+}
+void *fasthash_removen(fasthash_table *fh_table, char *key, size_t length) {
+    fasthash_node *node, **link;
+    uint32_t index;
+    void *data;
+    
+    node = fasthash_lookupn(fh_table, key, length);
+    if (!node) return 0;
+    
+    /* Unlink the node from its bucket */
+    index = (fh_table->pool ? FH_STRING(node->key)->hash :
+             fasthash_hashn(fh_table->opts, fh_table->seed, key, length)) % fh_table->size;
+    for (link = &(fh_table->entries[index]); *link != node; link = &((*link)->next));
+    *link = node->next;
+    
+    /* Drop the bucket from the index once it is empty, so it isn't
+     * indexed twice if it is used again. */
+    if (!fh_table->entries[index] && !(fh_table->opts & FH_NO_INDEXING)) {
+        index_node **in = &(fh_table->index_list), *temp;
+        while (*in && (*in)->index != index) in = &((*in)->next);
+        if (*in) {
+            temp = *in;
+            *in = temp->next;
+            vc_free(fh_table->alloc, temp);
+        }
+    }
+    
+    data = node->data;
+    if (fh_table->pool) fasthash_release(node->key);
+    else vc_free(fh_table->alloc, node->key);
+    vc_free(fh_table->alloc, node);
+    fh_table->count--;
+    return data;
+}
+
 /** Lookup **/
 fasthash_node *fasthash_lookup(fasthash_table *fh_table, char *key) {
     if (!fh_table) return 0;
-    uint32_t index = hash_djb2((unsigned char *)key) % fh_table->size;
-    fasthash_node *node = fh_table->entries[index];
+    return fasthash_lookupn(fh_table, key, strlen(key));
+}
+fasthash_node *fasthash_lookupn(fasthash_table *fh_table, char *key, size_t length) {
+    if (!fh_table) return 0;
     
-    while (node && (strcmp(key, node->key))) {
-        node = node->next;
+    /* Pooled keys are hashed as the pool hashes them */
+    if (fh_table->pool) {
+        fasthash_pool *pool = fh_table->pool;
+        return fasthash_lookup_impl(fh_table, key, length, fasthash_hashn(pool->opts, pool->seed, key, length));
     }
-    return node;
+    return fasthash_lookup_impl(fh_table, key, length, fasthash_hashn(fh_table->opts, fh_table->seed, key, length));
 }
-fasthash_node *fasthash_lookupn(fasthash_table *fh_table, char *key, size_t length) {
+
+fasthash_node *fasthash_lookup_hashed(fasthash_table *fh_table, char *key, size_t length, uint32_t hash) {
     if (!fh_table) return 0;
-    uint32_t index = hashn_djb2((unsigned char *)key, length) % fh_table->size;
-    fasthash_node *node = fh_table->entries[index];
     
-    while (node && (length != strlen(node->key) || strncmp(key, node->key, length))) {
-        node = node->next;
+    /* Keyed hashes can't be known ahead of time */
+    if ((fh_table->opts & FH_KEYED) || (fh_table->pool && (fh_table->pool->opts & FH_KEYED))) {
+        return fasthash_lookupn(fh_table, key, length);
     }
-    return node;
+    return fasthash_lookup_impl(fh_table, key, length, hash);
 }
 
+/* FastHash String Pool Functions */
+/** String Pool Initialization **/
+fasthash_pool *fasthash_pool_init(uint32_t size, uint32_t opts, const vc_allocator *alloc) {
+    fasthash_pool *pool;
+    
+    if (!size) return 0;
+    
+    pool = (fasthash_pool *)vc_malloc(alloc, sizeof(fasthash_pool));
+    if (!pool) return 0;
+    
+    bzero(pool, sizeof(fasthash_pool));
+    pool->size = size;
+    pool->alloc = alloc;
+    pool->opts = opts & FH_KEYED;
+    if (pool->opts) fasthash_seed(pool->seed);
+    
+    pool->entries = vc_malloc(alloc, sizeof(fasthash_string *) * size);
+    if (!pool->entries) goto err1;
+    
+    bzero(pool->entries, sizeof(fasthash_string *) * size);
+    
+    return pool;
+    
+err1:
+    vc_free(alloc, pool);
+    return 0;
+}
+
+/** String Pool Cleanup **/
+fasthash_pool *fasthash_pool_cleanup(fasthash_pool *pool) {
+    fasthash_string *str, *next;
+    uint32_t i;
+    if (!pool) return 0;
+    
+    for (i = 0; i < pool->size; i++) {
+        for (str = pool->entries[i]; str; str = next) {
+            next = str->next;
+            vc_free(pool->alloc, str);
+        }
+    }
+    
+    vc_free(pool->alloc, pool->entries);
+    vc_free(pool->alloc, pool);
+    return 0;
+}
+
+/** Intern **/
+char *fasthash_intern(fasthash_pool *pool, char *str, size_t length) {
+    uint32_t hash;
+    fasthash_string *entry;
+    
+    if (!pool) return 0;
+    hash = fasthash_hashn(pool->opts, pool->seed, str, length);
+    
+    for (entry = pool->entries[hash % pool->size]; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->length == length && !memcmp(entry->str, str, length)) {
+            if (entry->refs++) pool->saved += length + 1;
+            return entry->str;
+        }
+    }
+    
+    /* Keep chains short once the pool is full: first by dropping strings
+     * no longer used, then by growing if most are. */
+    if (pool->count >= pool->size) {
+        fasthash_pool_sweep(pool);
+        if (pool->count > pool->size / 2) fasthash_pool_grow(pool);
+    }
+    
+    entry = (fasthash_string *)vc_malloc(pool->alloc, sizeof(fasthash_string) + length + 1);
+    if (!entry) return 0;
+    
+    entry->hash = hash;
+    entry->length = (uint32_t)length;
+    entry->refs = 1;
+    memcpy(entry->str, str, length);
+    entry->str[length] = '\0';
+    
+    entry->next = pool->entries[hash % pool->size];
+    pool->entries[hash % pool->size] = entry;
+    pool->count++;
+    pool->bytes += length + 1;
+    
+    return entry->str;
+}
+
+/** Release **/
+void fasthash_release(char *str) {
+    if (str && FH_STRING(str)->refs) FH_STRING(str)->refs--;
+}
+
+/** Find **/
+char *fasthash_pool_find(fasthash_pool *pool, char *str, size_t length) {
+    if (!pool) return 0;
+    return fasthash_pool_find_impl(pool, str, length, fasthash_hashn(pool->opts, pool->seed, str, length));
+}
 
 /* Hash Functions */
 /** djb2 hash implementation **/
@@ -171,10 +343,12 @@ uint32_t hash_djb2(unsigned char *str) {
 /** djb2 hash implementation, length-restricted **/
 uint32_t hashn_djb2(unsigned char *str, size_t length) {
     uint32_t hash = 5381;       /* Initial hash */
-    size_t len = 0;             /* Number of chars counted so far */
+    unsigned char *end = str + length;
     int c;                      /* Storage for char */
     
-    while ((c = *str++) && (len++ < length)) {
+    /* Never read past the given length, as the string may not be
+     * terminated immediately after it. */
+    while (str < end && (c = *str++)) {
         /* hash = hash * 33 + c */
         hash = ((hash << 5) + hash) + c; 
     }
@@ -182,55 +356,283 @@ uint32_t hashn_djb2(unsigned char *str, size_t length) {
     return hash;
 }
 
+/** SipHash-1-3: one compression round per word, three to finalize **/
+uint64_t hash_siphash13(const uint64_t key[2], const unsigned char *data, size_t length) {
+    uint64_t v0 = key[0] ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = key[1] ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = key[0] ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = key[1] ^ 0x7465646279746573ULL;
+    const unsigned char *end = data + (length & ~(size_t)7);
+    uint64_t m, last = (uint64_t)length << 56;
+    int i;
+    
+    for (; data < end; data += 8) {
+        for (m = 0, i = 7; i >= 0; i--) m = (m << 8) | data[i];
+        v3 ^= m;
+        SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+    
+    /* Remaining bytes, little-endian, under the length byte */
+    for (i = (int)(length & 7) - 1; i >= 0; i--) last |= (uint64_t)data[i] << (8 * i);
+    v3 ^= last;
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= last;
+    
+    v2 ^= 0xff;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
 /**********************************************************************/
 /******** Static Function Definitions *********************************/
 /**********************************************************************/
 
-fasthash_node *fasthash_node_construct(char *key, void *entry, fasthash_node *next) {
-    fasthash_node *node = (fasthash_node *)malloc(sizeof(fasthash_node));
-    node->key = strdup(key);
+fasthash_node *fasthash_node_construct(fasthash_table *fh_table, char *key, void *entry, fasthash_node *next) {
+    fasthash_node *node = (fasthash_node *)vc_malloc(fh_table->alloc, sizeof(fasthash_node));
+    if (!node) return 0;
+    node->key = key;
     node->data = entry;
     node->next = next;
     
     return node;
 }
 
-fasthash_node *fasthash_node_destroy(fasthash_node *node, fasthash_destructor destruct) {
+fasthash_node *fasthash_node_destroy(fasthash_table *fh_table, fasthash_node *node) {
     fasthash_node *temp;
     while (node) {
         temp = node->next;
-        if (destruct) {
-            destruct(node->data);
+        if (fh_table->destruct) {
+            fh_table->destruct(node->data, fh_table->alloc);
         }
         
-        free(node->key);
-        free(node);
+        /* Pooled keys belong to the pool */
+        if (fh_table->pool) fasthash_release(node->key);
+        else vc_free(fh_table->alloc, node->key);
+        vc_free(fh_table->alloc, node);
         node = temp;
     }
     return 0;
 }
 
-uint32_t fasthash_insert_impl(fasthash_table *fh_table, char *key, void *entry) {
-    if (!fh_table) return 0;    
-    uint32_t index = hash_djb2((unsigned char *)key) % fh_table->size;
-    fasthash_node *node = fh_table->entries[index];
+uint32_t fasthash_insert_impl(fasthash_table *fh_table, char *key, size_t length, void *entry, void **old) {
+    uint32_t index;
+    fasthash_node *node;
+    char *node_key;
+    
+    /* Pooled keys carry their hash; otherwise the key is copied. */
+    if (fh_table->pool) {
+        node_key = fasthash_intern(fh_table->pool, key, length);
+        if (!node_key) return fh_table->size + 1;
+        index = FH_STRING(node_key)->hash % fh_table->size;
+    } else {
+        index = fasthash_hashn(fh_table->opts, fh_table->seed, key, length) % fh_table->size;
+        node_key = 0;
+    }
+    node = fh_table->entries[index];
+    
+    /* Replacing: an existing node just takes the new data */
+    if (old) {
+        fasthash_node *match = node;
+        while (match && (node_key ? match->key != node_key :
+               (length != strlen(match->key) || strncmp(key, match->key, length)))) {
+            match = match->next;
+        }
+        *old = match ? match->data : 0;
+        if (match) {
+            match->data = entry;
+            fasthash_release(node_key);
+            return index;
+        }
+    }
 
     if (node) {
         /* If we aren't allowing collisions, return out of range */
         if (fh_table->opts & FH_NO_COLLISIONS) {
+            fasthash_release(node_key);
             return fh_table->size + 1;
         }
     } else if (!(fh_table->opts & FH_NO_INDEXING)) {
         /* Build index node if we are indexing */
-        index_node *in = (index_node *)malloc(sizeof(index_node));
+        index_node *in = (index_node *)vc_malloc(fh_table->alloc, sizeof(index_node));
+        if (!in) {
+            fasthash_release(node_key);
+            return fh_table->size + 1;
+        }
         in->index = index;
         in->next = fh_table->index_list;
         fh_table->index_list = in;
     }
     
-    node = fasthash_node_construct(key, entry, node);
-    //printf("Node \"%s\" = %p\n", key, entry);
+    if (!node_key) {
+        node_key = vc_strndup(fh_table->alloc, key, length);
+        if (!node_key) return fh_table->size + 1;
+    }
+    
+    node = fasthash_node_construct(fh_table, node_key, entry, node);
+    if (!node) {
+        if (fh_table->pool) fasthash_release(node_key);
+        else vc_free(fh_table->alloc, node_key);
+        return fh_table->size + 1;
+    }
     fh_table->entries[index] = node;
+    fh_table->count++;
+    
+    /* Keep chains short.  The node stays put if the table can't grow. */
+    if (fh_table->count > fh_table->size * FH_LOAD_FACTOR &&
+        !(fh_table->opts & (FH_NO_COLLISIONS | FH_NO_INDEXING)) && fasthash_grow(fh_table)) {
+        index = fasthash_node_hash(fh_table, node) % fh_table->size;
+    }
     
     return index;   /* We don't need to add an additional index */    
 }
+
+static int fasthash_grow(fasthash_table *fh_table) {
+    uint32_t size = fh_table->size * 2, index;
+    fasthash_node **entries, *node, *next;
+    index_node *in, *list = 0, *temp;
+    
+    entries = vc_malloc(fh_table->alloc, sizeof(fasthash_node *) * size);
+    if (!entries) return 0;
+    bzero(entries, sizeof(fasthash_node *) * size);
+    
+    /* Index the new buckets first, so that running out of memory leaves
+     * the table as it was.  Buckets are marked used with any node. */
+    for (in = fh_table->index_list; in; in = in->next) {
+        for (node = fh_table->entries[in->index]; node; node = node->next) {
+            index = fasthash_node_hash(fh_table, node) % size;
+            if (entries[index]) continue;
+            
+            temp = (index_node *)vc_malloc(fh_table->alloc, sizeof(index_node));
+            if (!temp) {
+                for (; list; list = temp) {
+                    temp = list->next;
+                    vc_free(fh_table->alloc, list);
+                }
+                vc_free(fh_table->alloc, entries);
+                return 0;
+            }
+            temp->index = index;
+            temp->next = list;
+            list = temp;
+            entries[index] = node;
+        }
+    }
+    bzero(entries, sizeof(fasthash_node *) * size);
+    
+    for (in = fh_table->index_list; in; in = temp) {
+        for (node = fh_table->entries[in->index]; node; node = next) {
+            index = fasthash_node_hash(fh_table, node) % size;
+            next = node->next;
+            node->next = entries[index];
+            entries[index] = node;
+        }
+        temp = in->next;
+        vc_free(fh_table->alloc, in);
+    }
+    
+    vc_free(fh_table->alloc, fh_table->entries);
+    fh_table->entries = entries;
+    fh_table->index_list = list;
+    fh_table->size = size;
+    return 1;
+}
+
+static fasthash_node *fasthash_lookup_impl(fasthash_table *fh_table, char *key, size_t length, uint32_t hash) {
+    fasthash_node *node;
+    
+    /* With a key pool, a key missing from the pool can't be in the
+     * table, and otherwise keys compare by pointer. */
+    if (fh_table->pool) {
+        char *pooled = fasthash_pool_find_impl(fh_table->pool, key, length, hash);
+        if (!pooled) return 0;
+        
+        node = fh_table->entries[hash % fh_table->size];
+        while (node && node->key != pooled) {
+            node = node->next;
+        }
+        return node;
+    }
+    
+    node = fh_table->entries[hash % fh_table->size];
+    while (node && (length != strlen(node->key) || strncmp(key, node->key, length))) {
+        node = node->next;
+    }
+    return node;
+}
+
+static char *fasthash_pool_find_impl(fasthash_pool *pool, char *str, size_t length, uint32_t hash) {
+    fasthash_string *entry;
+    
+    for (entry = pool->entries[hash % pool->size]; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->length == length && !memcmp(entry->str, str, length)) {
+            return entry->str;
+        }
+    }
+    return 0;
+}
+
+static uint32_t fasthash_node_hash(fasthash_table *fh_table, fasthash_node *node) {
+    if (fh_table->pool) return FH_STRING(node->key)->hash;
+    return fasthash_hashn(fh_table->opts, fh_table->seed, node->key, strlen(node->key));
+}
+
+static uint32_t fasthash_hashn(uint32_t opts, const uint64_t *seed, char *key, size_t length) {
+    if (opts & FH_KEYED) return (uint32_t)hash_siphash13(seed, (unsigned char *)key, length);
+    return hashn_djb2((unsigned char *)key, length);
+}
+
+static void fasthash_seed(uint64_t seed[2]) {
+    struct timespec ts;
+    
+    if (getrandom(seed, sizeof(uint64_t) * 2, GRND_NONBLOCK) == sizeof(uint64_t) * 2) return;
+    
+    /* No entropy yet, early in boot: not secret, but still varies */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    seed[0] = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ (uint64_t)(uintptr_t)seed;
+    seed[1] = ((uint64_t)getpid() << 32) ^ (uint64_t)(uintptr_t)&ts ^ (uint64_t)time(0);
+}
+
+static int fasthash_pool_grow(fasthash_pool *pool) {
+    uint32_t i, size = pool->size * 2;
+    fasthash_string **entries, *entry, *next;
+    
+    entries = vc_malloc(pool->alloc, sizeof(fasthash_string *) * size);
+    if (!entries) return 0;
+    bzero(entries, sizeof(fasthash_string *) * size);
+    
+    /* Rehash using the stored hashes */
+    for (i = 0; i < pool->size; i++) {
+        for (entry = pool->entries[i]; entry; entry = next) {
+            next = entry->next;
+            entry->next = entries[entry->hash % size];
+            entries[entry->hash % size] = entry;
+        }
+    }
+    
+    vc_free(pool->alloc, pool->entries);
+    pool->entries = entries;
+    pool->size = size;
+    return 1;
+}
+
+/* Free the strings nobody holds any more */
+static void fasthash_pool_sweep(fasthash_pool *pool) {
+    fasthash_string **link, *entry;
+    uint32_t i;
+    
+    for (i = 0; i < pool->size; i++) {
+        for (link = &(pool->entries[i]); (entry = *link);) {
+            if (entry->refs) {
+                link = &(entry->next);
+                continue;
+            }
+            *link = entry->next;
+            pool->count--;
+            pool->bytes -= entry->length + 1;
+            vc_free(pool->alloc, entry);
+        }
+    }
+}
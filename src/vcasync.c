@@ -0,0 +1,629 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcasync.c
+ *
+ * Asynchronous loading.  The I/O thread owns an io_uring, set up with raw
+ * system calls, and moves each load through open, statx and read, with
+ * one step of each load in the ring at a time.  Loads are queued by any
+ * thread, which then wakes the I/O thread through an eventfd that it
+ * always has a read pending on.  Finished reads are parsed on a worker
+ * pool, which also does the blocking reads when there is no ring.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#define _GNU_SOURCE     /* For statx */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifndef VC_NO_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "vcasync.h"
+#include "vcdirect.h"
+#include "vcparse.h"
+#include "vcerror.h"
+#include "vcthread.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define RING_ENTRIES    256         /* Submission queue entries */
+#define READ_MAX        (1 << 30)   /* Largest single read */
+
+/* Steps of a load in the ring */
+typedef enum {
+    STEP_OPEN,
+    STEP_STAT,
+    STEP_READ
+} vc_async_step_t;
+
+/* Load in progress */
+typedef struct vc_async_load {
+    vc_params params;           /* Parameters, with file set to path */
+    char *path;                 /* Copy of the path queued */
+    vc_directive *dirs;         /* Copy of the directives queued with */
+    vc_async_cb cb;
+    void *ctx;
+    vc_errsink sink;            /* Records into error */
+    vc_load_error error;        /* First error */
+
+    vc_async_step_t step;       /* Step in the ring */
+    int fd;                     /* Open file, or -1 */
+#ifndef VC_NO_IO_URING
+    struct statx stx;           /* Filled in by STEP_STAT */
+#endif
+    char *buffer;               /* Contents, from params.allocator */
+    size_t size;                /* Size of the file */
+    size_t length;              /* Bytes read so far */
+    int err;                    /* errno of a failed step, or zero */
+    struct vc_async_load *next; /* Next load queued */
+} vc_async_load;
+
+#ifndef VC_NO_IO_URING
+/* Mapped io_uring.  Nothing polls the submission queue, so the kernel
+ * only reads entries during io_uring_enter. */
+typedef struct vc_ring {
+    int fd;
+    unsigned entries;           /* Submission queue entries */
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_map, *cq_map;      /* Ring mappings; the same if single */
+    size_t sq_size, cq_size;
+} vc_ring;
+#endif
+
+/* Process-wide loader */
+typedef struct vc_async_loader {
+    vc_async_mode mode;
+    vc_threadpool *pool;        /* Parses, and reads without a ring */
+#ifndef VC_NO_IO_URING
+    vc_ring ring;
+    int wake;                   /* eventfd, read by the I/O thread */
+    uint64_t wakebuf;           /* Where the pending read goes */
+    unsigned inflight;          /* Loads with a step in the ring */
+    pthread_t thread;           /* I/O thread */
+#endif
+    vc_async_load *head;        /* Loads queued for the I/O thread */
+    vc_async_load **tail;
+} vc_async_loader;
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+
+/* Created on first use, and kept for the life of the process */
+static pthread_mutex_t loader_lock = PTHREAD_MUTEX_INITIALIZER;
+static vc_async_loader *loader;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static vc_async_load *vc_async_load_create(char *path, vc_directive *directives, int flags,
+                                           const vc_allocator *alloc, vc_async_cb cb, void *ctx);
+static void vc_async_load_free(vc_async_load *load);
+static size_t vc_async_submit(vc_async_load *loads);
+static vc_async_loader *vc_async_loader_get(void);
+
+/* Workers */
+static void vc_async_blocking(void *arg);
+static void vc_async_parse(void *arg);
+
+#ifndef VC_NO_IO_URING
+/* I/O thread */
+static void *vc_async_run(void *arg);
+static void vc_async_take(vc_async_loader *l);
+static int vc_async_step(vc_async_loader *l, vc_async_load *load, vc_async_step_t step);
+static void vc_async_complete(vc_async_loader *l, vc_async_load *load, int res);
+static void vc_async_done(vc_async_loader *l, vc_async_load *load, vc_job_fn fn);
+static int vc_async_arm(vc_async_loader *l);
+static void vc_async_abandon(vc_async_loader *l);
+
+/* Ring */
+static int vc_ring_init(vc_ring *ring, unsigned entries);
+static void vc_ring_free(vc_ring *ring);
+static struct io_uring_sqe *vc_ring_sqe(vc_ring *ring);
+static int vc_ring_enter(vc_ring *ring, unsigned wait);
+#endif
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+int vc_async_open(vc_params *params, vc_async_cb cb, void *ctx) {
+    vc_async_load *load;
+
+    if (!params || !params->file || !cb) return 0;
+    load = vc_async_load_create(params->file, params->directives, params->flags, params->allocator, cb, ctx);
+    return load && vc_async_submit(load) == 1;
+}
+
+/* Loads are linked up first, so they reach the I/O thread together */
+size_t vc_async_open_many(char **paths, size_t n, vc_batch_params *opts, vc_async_cb cb, void *ctx) {
+    vc_async_load *loads = 0, **tail = &loads;
+    size_t i;
+
+    if (!opts || !cb) return 0;
+    for (i = 0; i < n; i++) {
+        vc_async_load *load = vc_async_load_create(paths[i], opts->directives, opts->flags, opts->allocator, cb, ctx);
+        if (!load) continue;
+        *tail = load;
+        tail = &(load->next);
+    }
+    return loads ? vc_async_submit(loads) : 0;
+}
+
+vc_async_mode vc_async_get_mode(void) {
+    vc_async_mode mode;
+
+    pthread_mutex_lock(&loader_lock);
+    mode = loader ? loader->mode : VC_ASYNC_NONE;
+    pthread_mutex_unlock(&loader_lock);
+    return mode;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static vc_async_load *vc_async_load_create(char *path, vc_directive *directives, int flags,
+                                           const vc_allocator *alloc, vc_async_cb cb, void *ctx) {
+    vc_async_load *load = (vc_async_load *)vc_malloc(alloc, sizeof(vc_async_load));
+
+    if (!load) return 0;
+    bzero(load, sizeof(vc_async_load));
+    load->path = vc_strndup(alloc, path, strlen(path));
+    load->dirs = vc_directives_copy(directives, alloc);
+    if (!load->path || (directives && !load->dirs)) {
+        vc_directives_free(load->dirs, alloc);
+        vc_free(alloc, load->path);
+        vc_free(alloc, load);
+        return 0;
+    }
+    load->params.file = load->path;
+    load->params.directives = load->dirs;
+    load->params.flags = flags;
+    load->params.errors = &(load->sink);
+    load->params.allocator = alloc;
+    load->cb = cb;
+    load->ctx = ctx;
+    load->sink.fn = vc_error_record;
+    load->sink.ctx = &(load->error);
+    load->error.type = VC_ERROR_SUCCESS;
+    load->fd = -1;
+    return load;
+}
+
+static void vc_async_load_free(vc_async_load *load) {
+    const vc_allocator *alloc = load->params.allocator;
+
+    if (load->fd >= 0) close(load->fd);
+    vc_free(alloc, load->buffer);
+    vc_free(alloc, load->path);
+    vc_directives_free(load->dirs, alloc);
+    vc_free(alloc, load);
+}
+
+/* Hand a list of loads to the I/O thread, or to the workers without a
+ * ring.  Returns the number queued; the rest are freed. */
+static size_t vc_async_submit(vc_async_load *loads) {
+    vc_async_loader *l = vc_async_loader_get();
+    vc_async_load *load, *next;
+    size_t n = 0;
+
+#ifndef VC_NO_IO_URING
+    /* The mode is checked under the lock, as the I/O thread may give up
+     * on the ring, and take what is queued to the workers, at any time */
+    if (l) pthread_mutex_lock(&loader_lock);
+    if (l && l->mode == VC_ASYNC_URING) {
+        uint64_t one = 1;
+
+        *(l->tail) = loads;
+        for (load = loads; load; load = load->next) {
+            l->tail = &(load->next);
+            n++;
+        }
+        pthread_mutex_unlock(&loader_lock);
+
+        /* An eventfd write doesn't block until the count nears overflow */
+        if (write(l->wake, &one, sizeof(one)) < 0) {}
+        return n;
+    }
+    if (l) pthread_mutex_unlock(&loader_lock);
+#endif
+
+    for (load = loads; load; load = next) {
+        next = load->next;
+        load->next = 0;
+        if (l && vc_threadpool_submit(l->pool, vc_async_blocking, load)) n++;
+        else vc_async_load_free(load);
+    }
+    return n;
+}
+
+/* Get the loader, setting it up on first use */
+static vc_async_loader *vc_async_loader_get(void) {
+    vc_async_loader *l;
+
+    pthread_mutex_lock(&loader_lock);
+    if (loader) {
+        l = loader;
+        pthread_mutex_unlock(&loader_lock);
+        return l;
+    }
+
+    l = (vc_async_loader *)malloc(sizeof(vc_async_loader));
+    if (!l || !(l->pool = vc_threadpool_create(0))) {
+        free(l);
+        pthread_mutex_unlock(&loader_lock);
+        return 0;
+    }
+    l->head = 0;
+    l->tail = &(l->head);
+    l->mode = VC_ASYNC_THREADS;
+
+#ifndef VC_NO_IO_URING
+    /* Any part of the ring missing leaves the workers to it */
+    l->inflight = 0;
+    l->wake = -1;
+    if (vc_ring_init(&(l->ring), RING_ENTRIES) && (l->wake = eventfd(0, EFD_CLOEXEC)) >= 0 &&
+        vc_async_arm(l) && !pthread_create(&(l->thread), 0, vc_async_run, l)) {
+        pthread_detach(l->thread);
+        l->mode = VC_ASYNC_URING;
+    } else {
+        if (l->wake >= 0) close(l->wake);
+        vc_ring_free(&(l->ring));
+    }
+#endif
+
+    loader = l;
+    pthread_mutex_unlock(&loader_lock);
+    return l;
+}
+
+/* Read a file with blocking calls, on a worker.  A load the ring gave up
+ * on starts again from the beginning. */
+static void vc_async_blocking(void *arg) {
+    vc_async_load *load = (vc_async_load *)arg;
+    const vc_allocator *alloc = load->params.allocator;
+    struct stat st;
+    ssize_t n;
+
+    if (load->fd >= 0) close(load->fd);
+    vc_free(alloc, load->buffer);
+    load->buffer = 0;
+    load->length = 0;
+    load->err = 0;
+
+    if ((load->fd = open(load->path, O_RDONLY | O_CLOEXEC)) < 0 || fstat(load->fd, &st)) {
+        load->err = errno;
+    } else if (!(load->buffer = (char *)vc_malloc(alloc, (size_t)st.st_size + 1))) {
+        load->err = ENOMEM;
+    } else {
+        /* Reads stop early at the end of a file that has shrunk since it
+         * was stat'd */
+        load->size = (size_t)st.st_size;
+        while (load->length < load->size) {
+            n = read(load->fd, load->buffer + load->length, load->size - load->length);
+            if (n > 0) {
+                load->length += (size_t)n;
+            } else if (!n) {
+                break;
+            } else if (errno != EINTR) {
+                load->err = errno;
+                break;
+            }
+        }
+    }
+    vc_async_parse(load);
+}
+
+/* Parse what was read, on a worker, and hand the config over */
+static void vc_async_parse(void *arg) {
+    vc_async_load *load = (vc_async_load *)arg;
+    vc_sect *conf = 0;
+
+    if (load->fd >= 0) close(load->fd);
+    load->fd = -1;
+
+    if (load->err == ENOMEM) {
+        vc_report_error(&(load->sink), VC_ERROR_NO_MEMORY, 0);
+    } else if (load->err) {
+        vc_report_error(&(load->sink), VC_ERROR_FILE, 0, load->path);
+    } else {
+        conf = vc_parse_loaded(&(load->params), load->buffer, load->length);
+        load->buffer = 0;
+    }
+
+    load->cb(load->path, conf, &(load->error), load->ctx);
+    vc_async_load_free(load);
+}
+
+#ifndef VC_NO_IO_URING
+static void *vc_async_run(void *arg) {
+    vc_async_loader *l = (vc_async_loader *)arg;
+    struct io_uring_cqe *cqe;
+    unsigned head;
+
+    for (;;) {
+        vc_async_take(l);
+        if (vc_ring_enter(&(l->ring), 1) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            vc_async_abandon(l);
+            return 0;
+        }
+
+        head = *(l->ring.cq_head);
+        while (head != __atomic_load_n(l->ring.cq_tail, __ATOMIC_ACQUIRE)) {
+            cqe = &(l->ring.cqes[head & *(l->ring.cq_mask)]);
+            if (cqe->user_data) vc_async_complete(l, (vc_async_load *)(uintptr_t)cqe->user_data, cqe->res);
+            else vc_async_arm(l);
+            __atomic_store_n(l->ring.cq_head, ++head, __ATOMIC_RELEASE);
+        }
+    }
+    return 0;
+}
+
+/* Start queued loads.  Each load has one step in the ring at a time, and
+ * the eventfd read one more, so steps never outnumber the entries. */
+static void vc_async_take(vc_async_loader *l) {
+    vc_async_load *load;
+
+    pthread_mutex_lock(&loader_lock);
+    while (l->head && l->inflight + 1 < l->ring.entries) {
+        load = l->head;
+        l->head = load->next;
+        if (!l->head) l->tail = &(l->head);
+        load->next = 0;
+
+        l->inflight++;
+        if (!vc_async_step(l, load, STEP_OPEN)) vc_async_done(l, load, vc_async_blocking);
+    }
+    pthread_mutex_unlock(&loader_lock);
+}
+
+/* Put the next step of a load in the ring.  Returns zero if it's full. */
+static int vc_async_step(vc_async_loader *l, vc_async_load *load, vc_async_step_t step) {
+    struct io_uring_sqe *sqe = vc_ring_sqe(&(l->ring));
+    size_t left;
+
+    if (!sqe) return 0;
+    switch (step) {
+        case STEP_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uintptr_t)load->path;
+            sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        break;
+        case STEP_STAT:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = load->fd;
+            sqe->addr = (uintptr_t)"";
+            sqe->statx_flags = AT_EMPTY_PATH;
+            sqe->len = STATX_SIZE;
+            sqe->off = (uintptr_t)&(load->stx);
+        break;
+        case STEP_READ:
+            left = load->size - load->length;
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = load->fd;
+            sqe->addr = (uintptr_t)(load->buffer + load->length);
+            sqe->len = left < READ_MAX ? (unsigned)left : READ_MAX;
+            sqe->off = load->length;
+        break;
+    }
+    sqe->user_data = (uintptr_t)load;
+    load->step = step;
+    return 1;
+}
+
+/* Move a load on from the step just completed */
+static void vc_async_complete(vc_async_loader *l, vc_async_load *load, int res) {
+    if (res < 0) {
+        /* A kernel without the operation: read it the old way */
+        if (res == -EINVAL || res == -EOPNOTSUPP) {
+            vc_async_done(l, load, vc_async_blocking);
+            return;
+        }
+        load->err = -res;
+        vc_async_done(l, load, vc_async_parse);
+        return;
+    }
+
+    switch (load->step) {
+        case STEP_OPEN:
+            load->fd = res;
+            if (vc_async_step(l, load, STEP_STAT)) return;
+        break;
+        case STEP_STAT:
+            load->size = (size_t)load->stx.stx_size;
+            load->buffer = (char *)vc_malloc(load->params.allocator, load->size + 1);
+            if (!load->buffer) {
+                load->err = ENOMEM;
+                vc_async_done(l, load, vc_async_parse);
+                return;
+            }
+            if (!load->size || vc_async_step(l, load, STEP_READ)) {
+                if (load->size) return;
+                vc_async_done(l, load, vc_async_parse);
+                return;
+            }
+        break;
+        case STEP_READ:
+            /* Short reads continue where they left off, until the end of
+             * the file, which may have shrunk since it was stat'd */
+            load->length += (size_t)res;
+            if (!res || load->length == load->size) {
+                vc_async_done(l, load, vc_async_parse);
+                return;
+            }
+            if (vc_async_step(l, load, STEP_READ)) return;
+        break;
+    }
+
+    /* The ring was full */
+    vc_async_done(l, load, vc_async_blocking);
+}
+
+/* Take a load out of the ring, and pass it to a worker */
+static void vc_async_done(vc_async_loader *l, vc_async_load *load, vc_job_fn fn) {
+    l->inflight--;
+    if (!vc_threadpool_submit(l->pool, fn, load)) fn(load);
+}
+
+/* Keep a read pending on the eventfd, so queueing a load wakes the
+ * thread from io_uring_enter */
+static int vc_async_arm(vc_async_loader *l) {
+    struct io_uring_sqe *sqe = vc_ring_sqe(&(l->ring));
+
+    if (!sqe) return 0;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = l->wake;
+    sqe->addr = (uintptr_t)&(l->wakebuf);
+    sqe->len = sizeof(l->wakebuf);
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = 0;
+    return 1;
+}
+
+/* The ring can't be entered any more, so loads go to the workers from
+ * now on.  Those queued, and those whose next step the kernel never took,
+ * go at once; the rest once their step completes, as the kernel may still
+ * write into them until then.  The ring is left as it is. */
+static void vc_async_abandon(vc_async_loader *l) {
+    struct io_uring_cqe *cqe;
+    vc_async_load *load, *next;
+    unsigned head, tail;
+
+    pthread_mutex_lock(&loader_lock);
+    l->mode = VC_ASYNC_THREADS;
+    load = l->head;
+    l->head = 0;
+    l->tail = &(l->head);
+    pthread_mutex_unlock(&loader_lock);
+    for (; load; load = next) {
+        next = load->next;
+        load->next = 0;
+        if (!vc_threadpool_submit(l->pool, vc_async_blocking, load)) vc_async_blocking(load);
+    }
+
+    head = __atomic_load_n(l->ring.sq_head, __ATOMIC_ACQUIRE);
+    for (tail = *(l->ring.sq_tail); head != tail; head++) {
+        struct io_uring_sqe *sqe = &(l->ring.sqes[l->ring.sq_array[head & *(l->ring.sq_mask)]]);
+        if (sqe->user_data) vc_async_done(l, (vc_async_load *)(uintptr_t)sqe->user_data, vc_async_blocking);
+    }
+
+    while (l->inflight) {
+        head = *(l->ring.cq_head);
+        if (head == __atomic_load_n(l->ring.cq_tail, __ATOMIC_ACQUIRE)) {
+            usleep(1000);
+            continue;
+        }
+        cqe = &(l->ring.cqes[head & *(l->ring.cq_mask)]);
+        if ((load = (vc_async_load *)(uintptr_t)cqe->user_data)) {
+            if (load->step == STEP_OPEN && cqe->res >= 0) load->fd = cqe->res;
+            vc_async_done(l, load, vc_async_blocking);
+        }
+        __atomic_store_n(l->ring.cq_head, head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static int vc_ring_init(vc_ring *ring, unsigned entries) {
+    struct io_uring_params p;
+    char *sq, *cq;
+
+    bzero(ring, sizeof(vc_ring));
+    bzero(&p, sizeof(p));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (ring->fd < 0) return 0;
+
+    ring->entries = p.sq_entries;
+    ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) && ring->cq_size > ring->sq_size) {
+        ring->sq_size = ring->cq_size;
+    }
+
+    ring->sq_map = mmap(0, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED) goto err;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_map = ring->sq_map;
+    } else {
+        ring->cq_map = mmap(0, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED) goto err;
+    }
+    ring->sqes = (struct io_uring_sqe *)mmap(0, p.sq_entries * sizeof(struct io_uring_sqe),
+                                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             ring->fd, IORING_OFF_SQES);
+    if ((void *)ring->sqes == MAP_FAILED) goto err;
+
+    sq = (char *)ring->sq_map;
+    cq = (char *)ring->cq_map;
+    ring->sq_head = (unsigned *)(sq + p.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + p.sq_off.array);
+    ring->cq_head = (unsigned *)(cq + p.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return 1;
+
+err:
+    vc_ring_free(ring);
+    return 0;
+}
+
+static void vc_ring_free(vc_ring *ring) {
+    if (ring->sqes && (void *)ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->entries * sizeof(struct io_uring_sqe));
+    }
+    if (ring->cq_map && ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map) {
+        munmap(ring->cq_map, ring->cq_size);
+    }
+    if (ring->sq_map && ring->sq_map != MAP_FAILED) munmap(ring->sq_map, ring->sq_size);
+    if (ring->fd >= 0) close(ring->fd);
+    bzero(ring, sizeof(vc_ring));
+    ring->fd = -1;
+}
+
+/* Claim the next submission entry, cleared.  It goes to the kernel with
+ * the next io_uring_enter. */
+static struct io_uring_sqe *vc_ring_sqe(vc_ring *ring) {
+    unsigned tail = *(ring->sq_tail), index;
+    struct io_uring_sqe *sqe;
+
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->entries) return 0;
+    index = tail & *(ring->sq_mask);
+    sqe = &(ring->sqes[index]);
+    bzero(sqe, sizeof(struct io_uring_sqe));
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+/* Submit every entry claimed, and wait for at least wait completions */
+static int vc_ring_enter(vc_ring *ring, unsigned wait) {
+    unsigned pending = *(ring->sq_tail) - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    return (int)syscall(__NR_io_uring_enter, ring->fd, pending, wait, IORING_ENTER_GETEVENTS, 0, 0);
+}
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vccache.c
+ *
+ * Per-thread lookup cache.  The set is chosen from the addresses of the
+ * section and the path alone, so a hit reads the path once, to compare
+ * it, and hashes nothing.  A new path goes in the first way of its set,
+ * moving the one there to the second.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+#include "vccache.h"
+#include "vcedit.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define SET_BITS    6       /* log2(VC_CACHE_SIZE / VC_CACHE_WAYS) */
+
+#if VC_CACHE_SIZE != (VC_CACHE_WAYS << SET_BITS)
+#error "SET_BITS must match VC_CACHE_SIZE"
+#endif
+
+/* Entry matches a lookup of path from sect, ignoring the generation */
+#define ENTRY_FOR(entry, s, p) ((entry)->sect == (s) && (entry)->key == (p) && !strcmp((entry)->path, (p)))
+
+typedef struct vc_cache_entry {
+    vc_sect *sect;              /* Section looked up from; NULL if empty */
+    const char *key;            /* Address of the path looked up */
+    uint64_t generation;        /* Generation of the config at the time */
+    vc_opt *opt;                /* Option found, or NULL */
+    char path[VC_CACHE_PATH];   /* Copy of the path */
+} vc_cache_entry;
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+static __thread vc_cache_entry cache[VC_CACHE_SIZE];
+static __thread vc_cache_stats counters;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static vc_cache_entry *vc_cache_set(vc_sect *sect, const char *optpath);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+vc_opt *vc_cache_getopt(vc_sect *sect, char *optpath) {
+    vc_cache_entry *set = vc_cache_set(sect, optpath), *entry = 0;
+    uint64_t generation = vc_generation(sect);
+    vc_opt *opt;
+    int way;
+
+    for (way = 0; way < VC_CACHE_WAYS; way++) {
+        if (!ENTRY_FOR(&(set[way]), sect, optpath)) continue;
+        if (set[way].generation == generation) {
+            counters.hits++;
+            return set[way].opt;
+        }
+        entry = &(set[way]);    /* Stale; refreshed where it is */
+        break;
+    }
+
+    counters.misses++;
+    opt = vc_getopt(sect, optpath);
+    if (!entry) {
+        if (strlen(optpath) >= VC_CACHE_PATH) return opt;
+        if (set[VC_CACHE_WAYS - 1].sect) counters.evictions++;
+        memmove(&(set[1]), &(set[0]), sizeof(vc_cache_entry) * (VC_CACHE_WAYS - 1));
+        entry = &(set[0]);
+        entry->sect = sect;
+        entry->key = optpath;
+        strcpy(entry->path, optpath);
+    }
+    entry->generation = generation;
+    entry->opt = opt;
+    return opt;
+}
+
+void vc_cache_stats_get(vc_cache_stats *stats) {
+    *stats = counters;
+}
+
+void vc_cache_reset(void) {
+    memset(cache, 0, sizeof(cache));
+    memset(&counters, 0, sizeof(counters));
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Fibonacci hash of both addresses.  Their low bits are alignment, and
+ * the multiply carries the rest into the top bits, which are taken. */
+static vc_cache_entry *vc_cache_set(vc_sect *sect, const char *optpath) {
+    uint64_t key = (uint64_t)(uintptr_t)optpath ^ ((uint64_t)(uintptr_t)sect << 17);
+    return &(cache[((key * 0x9e3779b97f4a7c15ULL) >> (64 - SET_BITS)) * VC_CACHE_WAYS]);
+}
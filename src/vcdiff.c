@@ -0,0 +1,397 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcdiff.c
+ *
+ * Content hashes and diffs.  An option hashes to a 128-bit value from its
+ * name, type and value, and a section's hash mixes the sum of its
+ * options' hashes, so the order they were added in doesn't matter, with
+ * those of the files it includes, whose order does.
+ *
+ * Through includes, a section is the merge of every section reached by
+ * the same path, in lookup order, as for queries (see vcquery.c), so a
+ * diff compares two lists of sources at each level.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcdiff.h"
+#include "vcinclude.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define HASH_LO     0x243f6a8885a308d3ULL   /* Initial lanes */
+#define HASH_HI     0x13198a2e03707344ULL
+#define MUL_LO      0x9e3779b97f4a7c15ULL   /* Lane multipliers */
+#define MUL_HI      0xc2b2ae3d27d4eb4fULL
+
+/* Diff in progress */
+typedef struct vc_diff_state {
+    vc_diff_cb cb;
+    void *ctx;
+
+    char *path;                 /* Path of the current change */
+    size_t cap;
+
+    long changes;               /* Changes reported so far */
+    int stop;                   /* Callback asked to stop */
+    int failed;                 /* Memory ran out */
+} vc_diff_state;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+/* Hashing */
+static int vc_hash_compute(vc_sect *sect, int recurse);
+static void vc_hash_opt(vc_hash *sum, const char *key, size_t length, vc_opt *opt);
+static inline void vc_hash_word(vc_hash *h, uint64_t word);
+static void vc_hash_bytes(vc_hash *h, const char *data, size_t length);
+static vc_hash vc_hash_finish(vc_hash h);
+static inline uint64_t vc_hash_fmix(uint64_t x);
+
+/* Diffing */
+static void vc_diff_sects(vc_diff_state *d, vc_sect **a, size_t na, vc_sect **b, size_t nb, size_t plen);
+static int vc_diff_skip(vc_sect **a, size_t na, vc_sect **b, size_t nb);
+static vc_opt *vc_diff_find(vc_sect **srcs, size_t nsrcs, char *key);
+static int vc_diff_children(vc_sect **srcs, size_t nsrcs, char *key, vc_sect ***list, size_t *n, size_t *cap);
+static size_t vc_diff_path(vc_diff_state *d, size_t plen, const char *key);
+static void vc_diff_emit(vc_diff_state *d, size_t plen, const char *key, vc_diff_change change,
+                         vc_opt *before, vc_opt *after);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+long vc_diff(vc_sect *before, vc_sect *after, vc_diff_cb cb, void *ctx) {
+    vc_diff_state d;
+    vc_sect **a = 0, **b = 0;
+    size_t na = 0, capa = 0, nb = 0, capb = 0;
+
+    /* Images keep no options to compare */
+    if (!before || !after || !before->ht || !after->ht) return -1;
+
+    bzero(&d, sizeof(d));
+    d.cb = cb;
+    d.ctx = ctx;
+    if (vc_sect_sources(before, &a, &na, &capa) && vc_sect_sources(after, &b, &nb, &capb)) {
+        vc_diff_sects(&d, a, na, b, nb, 0);
+    } else {
+        d.failed = 1;
+    }
+
+    free(a);
+    free(b);
+    free(d.path);
+    return d.failed ? -1 : d.changes;
+}
+
+void vc_hash_close(vc_sect *sect) {
+    if (sect && sect->ht && !sect->includes) vc_hash_compute(sect, 0);
+}
+
+void vc_hash_sect(vc_sect *sect) {
+    if (sect && sect->ht && !sect->hashed) vc_hash_compute(sect, 1);
+}
+
+/* Sections above a changed one change with it, so a section still
+ * hashed only has hashed sections below it. */
+void vc_hash_drop(vc_sect *sect) {
+    for (; sect && sect->hashed; sect = sect->parent) sect->hashed = 0;
+}
+
+int vc_diff_equal(vc_opt *a, vc_opt *b) {
+    vc_array *x, *y;
+    size_t i;
+
+    if (a->type != b->type) return 0;
+    switch (a->type) {
+        case VC_BOOLEAN:
+        case VC_INTEGER:
+            return *((int *)a->value) == *((int *)b->value);
+        case VC_FLOAT:
+        case VC_DURATION:
+        case VC_SIZE:
+        case VC_RATIO:
+            return !memcmp(a->value, b->value, sizeof(double));
+        case VC_STRING:
+            return a->value == b->value || !strcmp((char *)a->value, (char *)b->value);
+        case VC_ARRAY:
+            x = (vc_array *)a->value;
+            y = (vc_array *)b->value;
+            if (x->type != y->type || x->length != y->length) return 0;
+            if (x->type != VC_STRING) return !memcmp(x->v.data, y->v.data, x->length * sizeof(int64_t));
+            for (i = 0; i < x->length; i++) {
+                if (strcmp(x->v.strs[i], y->v.strs[i])) return 0;
+            }
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Hash a section from its options.  Subsections not yet hashed are
+ * hashed first if recurse is set, and otherwise leave the section as it
+ * is.  Returns whether the section was hashed. */
+static int vc_hash_compute(vc_sect *sect, int recurse) {
+    vc_hash sum = {0, 0}, h = {HASH_LO, HASH_HI};
+    index_node *in;
+    fasthash_node *node;
+    vc_include *inc;
+
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            size_t length;
+
+            if (opt->type == VC_SECTION && !((vc_sect *)opt->value)->hashed) {
+                if (!recurse) return 0;
+                vc_hash_sect((vc_sect *)opt->value);
+            }
+            length = sect->ht->pool ? FH_STRING(node->key)->length : strlen(node->key);
+            vc_hash_opt(&sum, node->key, length, opt);
+        }
+    }
+
+    vc_hash_word(&h, sum.lo);
+    vc_hash_word(&h, sum.hi);
+    vc_hash_word(&h, sect->ht->count);
+    for (inc = sect->includes; inc; inc = inc->next) {
+        vc_sect *frag = inc->frag->sect;
+        vc_hash_word(&h, frag ? frag->hash.lo : 0);
+        vc_hash_word(&h, frag ? frag->hash.hi : 0);
+    }
+    sect->hash = vc_hash_finish(h);
+    sect->hashed = 1;
+    return 1;
+}
+
+/* Add the hash of an option to a section's sum */
+static void vc_hash_opt(vc_hash *sum, const char *key, size_t length, vc_opt *opt) {
+    vc_hash h = {HASH_LO, HASH_HI};
+    uint64_t bits;
+    size_t i;
+
+    vc_hash_bytes(&h, key, length);
+    vc_hash_word(&h, opt->type);
+    switch (opt->type) {
+        case VC_BOOLEAN:
+        case VC_INTEGER:
+            vc_hash_word(&h, (uint64_t)*((int *)opt->value));
+        break;
+        case VC_FLOAT:
+        case VC_DURATION:
+        case VC_SIZE:
+        case VC_RATIO:
+            memcpy(&bits, opt->value, sizeof(bits));
+            vc_hash_word(&h, bits);
+        break;
+        case VC_STRING:
+            vc_hash_bytes(&h, (char *)opt->value, strlen((char *)opt->value));
+        break;
+        case VC_SECTION:
+            vc_hash_word(&h, ((vc_sect *)opt->value)->hash.lo);
+            vc_hash_word(&h, ((vc_sect *)opt->value)->hash.hi);
+        break;
+        case VC_ARRAY: {
+            vc_array *arr = (vc_array *)opt->value;
+            vc_hash_word(&h, arr->type);
+            vc_hash_word(&h, arr->length);
+            for (i = 0; i < arr->length; i++) {
+                if (arr->type == VC_STRING) {
+                    vc_hash_bytes(&h, arr->v.strs[i], strlen(arr->v.strs[i]));
+                } else {
+                    memcpy(&bits, (char *)arr->v.data + i * sizeof(bits), sizeof(bits));
+                    vc_hash_word(&h, bits);
+                }
+            }
+        } break;
+        default:
+        break;
+    }
+
+    h = vc_hash_finish(h);
+    sum->lo += h.lo;
+    sum->hi += h.hi;
+}
+
+/* Absorb a word into both lanes, each with its own multiplier */
+static inline void vc_hash_word(vc_hash *h, uint64_t word) {
+    h->lo = (h->lo ^ word) * MUL_LO;
+    h->lo ^= h->lo >> 29;
+    h->hi = (h->hi ^ ((word << 32) | (word >> 32))) * MUL_HI;
+    h->hi ^= h->hi >> 31;
+}
+
+/* Absorb bytes a word at a time, then the tail with the length */
+static void vc_hash_bytes(vc_hash *h, const char *data, size_t length) {
+    uint64_t word;
+    size_t i;
+
+    for (i = 0; i + sizeof(word) <= length; i += sizeof(word)) {
+        memcpy(&word, data + i, sizeof(word));
+        vc_hash_word(h, word);
+    }
+    word = 0;
+    memcpy(&word, data + i, length - i);
+    vc_hash_word(h, word ^ ((uint64_t)length << 56));
+}
+
+static vc_hash vc_hash_finish(vc_hash h) {
+    vc_hash out;
+    out.lo = vc_hash_fmix(h.lo ^ ((h.hi << 17) | (h.hi >> 47)));
+    out.hi = vc_hash_fmix(h.hi + out.lo);
+    return out;
+}
+
+/* MurmurHash3's 64-bit finalizer */
+static inline uint64_t vc_hash_fmix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/* Diff the merged sources of two sections, reached by the path of
+ * length plen.  A name is compared as the first source holding it has
+ * it; sections of that name are diffed as the merge of every source's. */
+static void vc_diff_sects(vc_diff_state *d, vc_sect **a, size_t na, vc_sect **b, size_t nb, size_t plen) {
+    fasthash_table *seen = 0;
+    fasthash_node *node;
+    index_node *in;
+    size_t i;
+    int pass;
+
+    if (vc_diff_skip(a, na, b, nb)) return;
+
+    /* Names before, then names only after.  With a single source, every
+     * name is distinct. */
+    for (pass = 0; pass < 2 && !d->stop && !d->failed; pass++) {
+        vc_sect **srcs = pass ? b : a, **other = pass ? a : b;
+        size_t nsrcs = pass ? nb : na, nother = pass ? na : nb;
+
+        if (nsrcs > 1 && !(seen = fasthash_init(64, 0, 0, 0, 0))) {
+            d->failed = 1;
+            return;
+        }
+        for (i = 0; i < nsrcs && !d->stop && !d->failed; i++) {
+            for (in = srcs[i]->ht->index_list; in && !d->stop && !d->failed; in = in->next) {
+                for (node = srcs[i]->ht->entries[in->index]; node && !d->stop && !d->failed; node = node->next) {
+                    vc_opt *opt = (vc_opt *)node->data, *match;
+
+                    if (seen) {
+                        if (fasthash_lookup(seen, node->key)) continue;
+                        if (fasthash_insert(seen, node->key, opt) >= seen->size) {
+                            d->failed = 1;
+                            break;
+                        }
+                    }
+
+                    match = vc_diff_find(other, nother, node->key);
+                    if (pass) {
+                        if (!match) vc_diff_emit(d, plen, node->key, VC_DIFF_ADDED, 0, opt);
+                    } else if (!match) {
+                        vc_diff_emit(d, plen, node->key, VC_DIFF_REMOVED, opt, 0);
+                    } else if (opt->type == VC_SECTION && match->type == VC_SECTION) {
+                        vc_sect **ca = 0, **cb = 0, *x = (vc_sect *)opt->value, *y = (vc_sect *)match->value;
+                        size_t nca = 0, capa = 0, ncb = 0, capb = 0, length;
+
+                        /* Alone on both sides, a section's hash covers
+                         * everything the merge would */
+                        if (na == 1 && nb == 1 && vc_diff_skip(&x, 1, &y, 1)) continue;
+                        if (vc_diff_children(a, na, node->key, &ca, &nca, &capa) &&
+                            vc_diff_children(b, nb, node->key, &cb, &ncb, &capb)) {
+                            length = vc_diff_path(d, plen, node->key);
+                            if (!d->failed) vc_diff_sects(d, ca, nca, cb, ncb, length);
+                        } else {
+                            d->failed = 1;
+                        }
+                        free(ca);
+                        free(cb);
+                    } else if (!vc_diff_equal(opt, match)) {
+                        vc_diff_emit(d, plen, node->key, VC_DIFF_MODIFIED, opt, match);
+                    }
+                }
+            }
+        }
+        seen = fasthash_cleanup(seen);
+    }
+}
+
+/* Lists of sources match if each pair of sections hashes the same */
+static int vc_diff_skip(vc_sect **a, size_t na, vc_sect **b, size_t nb) {
+    size_t i;
+
+    if (na != nb) return 0;
+    for (i = 0; i < na; i++) {
+        if (!a[i]->hashed || !b[i]->hashed ||
+            a[i]->hash.lo != b[i]->hash.lo || a[i]->hash.hi != b[i]->hash.hi) return 0;
+    }
+    return 1;
+}
+
+/* Option of the first source holding a name */
+static vc_opt *vc_diff_find(vc_sect **srcs, size_t nsrcs, char *key) {
+    fasthash_node *node;
+    size_t i;
+
+    for (i = 0; i < nsrcs; i++) {
+        if ((node = fasthash_lookup(srcs[i]->ht, key))) return (vc_opt *)node->data;
+    }
+    return 0;
+}
+
+/* Append the sources of every section of a name, in lookup order */
+static int vc_diff_children(vc_sect **srcs, size_t nsrcs, char *key, vc_sect ***list, size_t *n, size_t *cap) {
+    fasthash_node *node;
+    size_t i;
+
+    for (i = 0; i < nsrcs; i++) {
+        node = fasthash_lookup(srcs[i]->ht, key);
+        if (!node || ((vc_opt *)node->data)->type != VC_SECTION) continue;
+        if (!vc_sect_sources((vc_sect *)((vc_opt *)node->data)->value, list, n, cap)) return 0;
+    }
+    return 1;
+}
+
+/* Append a name to the path of length plen.  Returns the new length. */
+static size_t vc_diff_path(vc_diff_state *d, size_t plen, const char *key) {
+    size_t length = strlen(key), need = plen + length + 2;
+
+    if (need > d->cap) {
+        char *path = (char *)realloc(d->path, need * 2);
+        if (!path) {
+            d->failed = 1;
+            return 0;
+        }
+        d->path = path;
+        d->cap = need * 2;
+    }
+    if (plen) d->path[plen++] = '.';
+    memcpy(d->path + plen, key, length);
+    d->path[plen + length] = '\0';
+    return plen + length;
+}
+
+static void vc_diff_emit(vc_diff_state *d, size_t plen, const char *key, vc_diff_change change,
+                         vc_opt *before, vc_opt *after) {
+    vc_diff_path(d, plen, key);
+    if (d->failed) return;
+    d->changes++;
+    if (d->cb && d->cb(d->path, change, before, after, d->ctx)) d->stop = 1;
+}
@@ -7,9 +7,9 @@
  * Directive creation and handling.  Think of directives as user-defined
  * functions within a configuration file, yet the definition is in C.
  * 
- * A splay tree or a trie indexed by hashing the string should provide
- * quick access and not slow down configuration parsing. For now, I just
- * use a list.
+ * The directive list is hashed once when a config is opened, so checking
+ * whether an identifier is a directive costs a single table probe, no
+ * matter how many directives are registered.
  * 
  * Arguments are passed into a directive function as a vc_list; while this
  * is a bit uncomfortable, rest assured, vconfig typechecks for you, so
@@ -17,4 +17,83 @@
  * that you wish to use.
  */
 
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
 #include "vcdirect.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define MIN_TABLE_SIZE 16   /* Smallest directive table */
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+fasthash_table *vc_directive_table_create(vc_directive *directives, const vc_allocator *alloc) {
+    fasthash_table *table;
+    vc_directive *dir;
+    uint32_t size = MIN_TABLE_SIZE;
+    
+    if (!directives) return 0;
+    
+    /* Size the table at twice the number of directives to keep the
+     * chains short. */
+    for (dir = directives; dir->name; dir++) {
+        if ((uint32_t)(dir - directives) * 2 >= size) size *= 2;
+    }
+    
+    table = fasthash_init(size, 0, 0, 0, alloc);
+    if (!table) return 0;
+    
+    for (dir = directives; dir->name; dir++) {
+        fasthash_insert(table, dir->name, dir);
+    }
+    return table;
+}
+
+void vc_directive_table_destroy(fasthash_table *table) {
+    fasthash_cleanup(table);
+}
+
+vc_directive *vc_directive_lookup(fasthash_table *table, char *name, size_t length) {
+    fasthash_node *node;
+    if (!table) return 0;
+    
+    node = fasthash_lookupn(table, name, length);
+    return node ? (vc_directive *)node->data : 0;
+}
+
+vc_directive *vc_directives_copy(vc_directive *dirs, const vc_allocator *alloc) {
+    vc_directive *copy;
+    size_t n = 0, i;
+    
+    if (!dirs) return 0;
+    while (dirs[n].name) n++;
+    if (!(copy = (vc_directive *)vc_malloc(alloc, (n + 1) * sizeof(vc_directive)))) return 0;
+    memset(copy, 0, (n + 1) * sizeof(vc_directive));
+    for (i = 0; i < n; i++) {
+        copy[i] = dirs[i];
+        if (!(copy[i].name = vc_strndup(alloc, dirs[i].name, strlen(dirs[i].name)))) {
+            vc_directives_free(copy, alloc);
+            return 0;
+        }
+    }
+    return copy;
+}
+
+void vc_directives_free(vc_directive *dirs, const vc_allocator *alloc) {
+    vc_directive *dir;
+    
+    if (!dirs) return;
+    for (dir = dirs; dir->name; dir++) vc_free(alloc, dir->name);
+    vc_free(alloc, dirs);
+}
@@ -0,0 +1,568 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcedit.c
+ *
+ * Config edits and transactions.  Edits are applied one at a time, each
+ * recording how to undo itself, so a transaction that fails partway can
+ * be rolled back before the write lock is released.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#define _GNU_SOURCE     /* For pthread_rwlockattr_setkind_np */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcedit.h"
+#include "vcindex.h"
+#include "vcquery.h"
+#include "vcdiff.h"
+#include "vcshare.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Ways to undo an applied edit */
+typedef enum {
+    UNDO_ADD,           /* Option was added: remove it */
+    UNDO_REMOVE,        /* Option was removed: put it back */
+    UNDO_VALUE,         /* Option's value was replaced: restore it */
+    UNDO_NUMBER,        /* Number was overwritten in place: restore it */
+    UNDO_UNSHARE        /* Shared section was copied: put it back */
+} vc_undo_action;
+
+typedef struct vc_undo {
+    vc_undo_action action;
+    vc_sect *sect;      /* Section holding the option */
+    char *key;          /* Option name, within the edit's path */
+    size_t length;      /* Length of the option name */
+    vc_opt *opt;        /* Option added, removed or changed */
+    vc_opt *old;        /* UNDO_VALUE, UNDO_UNSHARE: container for the
+                         * previous value */
+    union {
+        int i;
+        int64_t l;
+        double f;
+    } num;              /* UNDO_NUMBER: previous number */
+} vc_undo;
+
+typedef struct vc_undo_log {
+    vc_undo *entries;
+    size_t n, cap;
+    const vc_allocator *alloc;  /* Allocator of the config edited */
+} vc_undo_log;
+
+/* Allocator for edits to sect, which may be NULL */
+#define EDIT_ALLOC(sect) ((sect) ? VC_SECT_ALLOC(sect) : 0)
+
+/* Section can be edited: it is parsed, and its config's own, rather than
+ * shared with other configs, or part of an included file */
+#define EDITABLE(sect) ((sect) && (sect)->ht && !(sect)->shared && \
+                        !((sect)->root->flags & VC_ROOT_FRAGMENT))
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+/* Source of generations, which are never handed out twice */
+static uint64_t generations = 0;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static vc_edit *vc_edit_create(const vc_allocator *alloc, vc_edit_op op, char *optpath, vc_type type, void *value);
+static int vc_txn_stage(vc_txn *txn, vc_edit *edit);
+
+/* Apply a list of edits under the write lock, all or nothing */
+static int vc_edit_commit(vc_sect *sect, vc_edit *edits);
+static int vc_edit_apply(vc_sect *sect, vc_edit *edit, vc_undo_log *log);
+
+/* Find the section holding the last name of a path, creating missing
+ * sections if asked.  *name and *length receive the last name. */
+static vc_sect *vc_edit_parent(vc_sect *sect, char *optpath, int create,
+                               vc_undo_log *log, char **name, size_t *length);
+
+/* Copy a shared section into the config, to be edited */
+static int vc_edit_unshare(vc_sect *sect, char *name, size_t length, vc_opt *opt, vc_undo_log *log);
+
+/* Add a new, empty section */
+static vc_opt *vc_edit_mksect(vc_sect *sect, char *name, size_t length, vc_undo_log *log);
+
+/* Allocate the value of a set edit, for an option within root */
+static void *vc_edit_value(vc_root *root, vc_edit *edit);
+
+static vc_undo *vc_undo_push(vc_undo_log *log, vc_undo_action action, vc_sect *sect,
+                             char *key, size_t length, vc_opt *opt);
+
+/* Release what a successful commit replaced, or roll a failed one back.
+ * Release returns whether options were added or removed. */
+static int vc_undo_release(vc_undo_log *log);
+static void vc_undo_rollback(vc_undo_log *log);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+int vc_set(vc_sect *sect, char *optpath, vc_type type, void *value) {
+    vc_edit *edit = vc_edit_create(EDIT_ALLOC(sect), VC_EDIT_SET, optpath, type, value);
+    int ok = edit && vc_edit_commit(sect, edit);
+    vc_free(EDIT_ALLOC(sect), edit);
+    return ok;
+}
+
+int vc_delete(vc_sect *sect, char *optpath) {
+    vc_edit *edit = vc_edit_create(EDIT_ALLOC(sect), VC_EDIT_DELETE, optpath, VC_ERROR, 0);
+    int ok = edit && vc_edit_commit(sect, edit);
+    vc_free(EDIT_ALLOC(sect), edit);
+    return ok;
+}
+
+vc_sect *vc_mkdir_sect(vc_sect *sect, char *optpath) {
+    vc_edit *edit = vc_edit_create(EDIT_ALLOC(sect), VC_EDIT_MKSECT, optpath, VC_ERROR, 0);
+    vc_sect *created = 0;
+    vc_type type;
+    
+    if (edit && vc_edit_commit(sect, edit)) {
+        vc_read_begin(sect);
+        created = (vc_sect *)vc_sect_getval(sect, optpath, &type);
+        vc_read_end(sect);
+    }
+    vc_free(EDIT_ALLOC(sect), edit);
+    return created;
+}
+
+vc_txn *vc_txn_begin(vc_sect *sect) {
+    vc_txn *txn;
+    
+    if (!EDITABLE(sect)) return 0;
+    
+    txn = (vc_txn *)vc_malloc(VC_SECT_ALLOC(sect), sizeof(vc_txn));
+    if (!txn) return 0;
+    txn->sect = sect;
+    txn->edits = 0;
+    txn->tail = &(txn->edits);
+    txn->error = 0;
+    return txn;
+}
+
+int vc_txn_set(vc_txn *txn, char *optpath, vc_type type, void *value) {
+    return vc_txn_stage(txn, vc_edit_create(txn ? EDIT_ALLOC(txn->sect) : 0, VC_EDIT_SET, optpath, type, value));
+}
+
+int vc_txn_delete(vc_txn *txn, char *optpath) {
+    return vc_txn_stage(txn, vc_edit_create(txn ? EDIT_ALLOC(txn->sect) : 0, VC_EDIT_DELETE, optpath, VC_ERROR, 0));
+}
+
+int vc_txn_mkdir_sect(vc_txn *txn, char *optpath) {
+    return vc_txn_stage(txn, vc_edit_create(txn ? EDIT_ALLOC(txn->sect) : 0, VC_EDIT_MKSECT, optpath, VC_ERROR, 0));
+}
+
+int vc_txn_commit(vc_txn *txn) {
+    int ok;
+    if (!txn) return 0;
+    
+    /* A transaction missing an edit is not applied at all */
+    ok = !txn->error && vc_edit_commit(txn->sect, txn->edits);
+    vc_txn_abort(txn);
+    return ok;
+}
+
+void vc_txn_abort(vc_txn *txn) {
+    vc_edit *edit, *next;
+    if (!txn) return;
+    
+    for (edit = txn->edits; edit; edit = next) {
+        next = edit->next;
+        vc_free(EDIT_ALLOC(txn->sect), edit);
+    }
+    vc_free(EDIT_ALLOC(txn->sect), txn);
+}
+
+void vc_lock_init(vc_root *root) {
+    pthread_rwlockattr_t attr;
+    
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    /* glibc prefers readers by default, which starves writers */
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&(root->lock), &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+void vc_read_begin(vc_sect *sect) {
+    pthread_rwlock_rdlock(&(sect->root->lock));
+}
+
+void vc_read_end(vc_sect *sect) {
+    pthread_rwlock_unlock(&(sect->root->lock));
+}
+
+uint64_t vc_generation(vc_sect *sect) {
+    return __atomic_load_n(&(sect->root->generation), __ATOMIC_ACQUIRE);
+}
+
+uint64_t vc_generation_new(void) {
+    return __atomic_add_fetch(&generations, 1, __ATOMIC_RELAXED);
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static vc_edit *vc_edit_create(const vc_allocator *alloc, vc_edit_op op, char *optpath, vc_type type, void *value) {
+    size_t pathlen = strlen(optpath) + 1, strsize = 0;
+    vc_edit *edit;
+    
+    if (op == VC_EDIT_SET) {
+        if (!value) return 0;
+        switch (type) {
+            case VC_BOOLEAN:
+            case VC_INTEGER:
+            case VC_FLOAT:
+            case VC_DURATION:
+            case VC_SIZE:
+            case VC_RATIO:
+            break;
+            case VC_STRING:
+                strsize = strlen((char *)value) + 1;
+            break;
+            default:
+                return 0;
+        }
+    }
+    
+    edit = (vc_edit *)vc_malloc(alloc, sizeof(vc_edit) + pathlen + strsize);
+    if (!edit) return 0;
+    edit->op = op;
+    edit->type = type;
+    edit->next = 0;
+    memcpy(edit->path, optpath, pathlen);
+    
+    if (op == VC_EDIT_SET) {
+        switch (type) {
+            case VC_BOOLEAN:
+            case VC_INTEGER: edit->v.i = *((int *)value); break;
+            case VC_FLOAT:
+            case VC_RATIO: edit->v.f = *((double *)value); break;
+            case VC_DURATION:
+            case VC_SIZE: edit->v.l = *((int64_t *)value); break;
+            default:
+                edit->v.s = edit->path + pathlen;
+                memcpy(edit->v.s, value, strsize);
+            break;
+        }
+    }
+    return edit;
+}
+
+static int vc_txn_stage(vc_txn *txn, vc_edit *edit) {
+    if (!txn) {
+        vc_free(0, edit);
+        return 0;
+    }
+    if (!edit) {
+        txn->error = 1;
+        return 0;
+    }
+    *(txn->tail) = edit;
+    txn->tail = &(edit->next);
+    return 1;
+}
+
+static int vc_edit_commit(vc_sect *sect, vc_edit *edits) {
+    vc_undo_log log = {0, 0, 0, 0};
+    vc_edit *edit;
+    size_t i;
+    int ok = 1;
+    
+    if (!EDITABLE(sect)) return 0;
+    log.alloc = VC_SECT_ALLOC(sect);
+    
+    pthread_rwlock_wrlock(&(sect->root->lock));
+    for (edit = edits; edit && ok; edit = edit->next) {
+        ok = vc_edit_apply(sect, edit, &log);
+    }
+    
+    /* Updates in place leave the paths, and so the index, as they were.
+     * Hashes are dropped before release frees removed sections. */
+    if (ok) {
+        for (i = 0; i < log.n; i++) vc_hash_drop(log.entries[i].sect);
+        if (vc_undo_release(&log)) {
+            vc_index_drop(sect->root);
+            vc_keys_drop(sect->root->sect);
+        }
+        vc_hash_sect(sect->root->sect);
+        __atomic_store_n(&(sect->root->generation), vc_generation_new(), __ATOMIC_RELEASE);
+    } else {
+        vc_undo_rollback(&log);
+    }
+    pthread_rwlock_unlock(&(sect->root->lock));
+    
+    vc_free(log.alloc, log.entries);
+    return ok;
+}
+
+static int vc_edit_apply(vc_sect *sect, vc_edit *edit, vc_undo_log *log) {
+    vc_sect *parent;
+    fasthash_node *node;
+    vc_opt *opt;
+    char *name;
+    size_t length;
+    
+    parent = vc_edit_parent(sect, edit->path, edit->op != VC_EDIT_DELETE, log, &name, &length);
+    if (!parent) return 0;
+    node = fasthash_lookupn(parent->ht, name, length);
+    opt = node ? (vc_opt *)node->data : 0;
+    
+    switch (edit->op) {
+        case VC_EDIT_SET: {
+            vc_undo *undo;
+            void *value;
+    
+            /* A section must be deleted before its name is reused */
+            if (opt && opt->type == VC_SECTION) return 0;
+    
+            /* Numbers of the same type are overwritten where they are */
+            if (opt && opt->type == edit->type && edit->type != VC_STRING) {
+                if (!(undo = vc_undo_push(log, UNDO_NUMBER, parent, name, length, opt))) return 0;
+                if (edit->type == VC_FLOAT || edit->type == VC_RATIO) {
+                    undo->num.f = *((double *)opt->value);
+                    *((double *)opt->value) = edit->v.f;
+                } else if (edit->type == VC_DURATION || edit->type == VC_SIZE) {
+                    undo->num.l = *((int64_t *)opt->value);
+                    *((int64_t *)opt->value) = edit->v.l;
+                } else {
+                    undo->num.i = *((int *)opt->value);
+                    *((int *)opt->value) = edit->v.i;
+                }
+                return 1;
+            }
+    
+            if (!(value = vc_edit_value(parent->root, edit))) return 0;
+            if (opt) {
+                /* The old value is kept, in a container of its own, until
+                 * the transaction is done with. */
+                vc_opt *old = (vc_opt *)vc_malloc(log->alloc, sizeof(vc_opt));
+                if (!old || !(undo = vc_undo_push(log, UNDO_VALUE, parent, name, length, opt))) {
+                    vc_free(log->alloc, old);
+                    vc_free(log->alloc, value);
+                    return 0;
+                }
+                *old = *opt;
+                undo->old = old;
+            } else {
+                opt = (vc_opt *)vc_malloc(log->alloc, sizeof(vc_opt));
+                if (!opt || fasthash_insertn(parent->ht, name, length, opt) >= parent->ht->size) {
+                    vc_free(log->alloc, opt);
+                    vc_free(log->alloc, value);
+                    return 0;
+                }
+                opt->type = VC_ERROR;
+                opt->value = 0;
+                if (!vc_undo_push(log, UNDO_ADD, parent, name, length, opt)) {
+                    fasthash_removen(parent->ht, name, length);
+                    vc_free(log->alloc, opt);
+                    vc_free(log->alloc, value);
+                    return 0;
+                }
+            }
+            opt->type = edit->type;
+            opt->flags = 0;
+            opt->value = value;
+        } break;
+        case VC_EDIT_DELETE:
+            if (!opt || !vc_undo_push(log, UNDO_REMOVE, parent, name, length, opt)) return 0;
+            fasthash_removen(parent->ht, name, length);
+        break;
+        case VC_EDIT_MKSECT:
+            if (opt) return opt->type == VC_SECTION;
+            return vc_edit_mksect(parent, name, length, log) != 0;
+    }
+    return 1;
+}
+
+static vc_sect *vc_edit_parent(vc_sect *sect, char *optpath, int create,
+                               vc_undo_log *log, char **name, size_t *length) {
+    char *seg = optpath, *dot;
+    
+    while ((dot = strchr(seg, '.'))) {
+        fasthash_node *node;
+        vc_opt *opt;
+    
+        if (dot == seg) return 0;
+    
+        /* Only the config's own sections are followed, not included ones */
+        node = fasthash_lookupn(sect->ht, seg, dot - seg);
+        if (node) {
+            opt = (vc_opt *)node->data;
+            if (opt->type != VC_SECTION) return 0;
+            if (((vc_sect *)opt->value)->shared && !vc_edit_unshare(sect, seg, dot - seg, opt, log)) return 0;
+        } else if (!create || !(opt = vc_edit_mksect(sect, seg, dot - seg, log))) {
+            return 0;
+        }
+        sect = (vc_sect *)opt->value;
+        seg = dot + 1;
+    }
+    
+    if (!*seg) return 0;
+    *name = seg;
+    *length = strlen(seg);
+    return sect;
+}
+
+/* Other configs may hold the shared section, so the option takes a copy
+ * of its own, and the shared one is released with the transaction. */
+static int vc_edit_unshare(vc_sect *sect, char *name, size_t length, vc_opt *opt, vc_undo_log *log) {
+    vc_opt *old = (vc_opt *)vc_malloc(log->alloc, sizeof(vc_opt));
+    vc_sect *copy = vc_share_copy(sect, (vc_sect *)opt->value);
+    vc_undo *undo;
+    
+    if (!old || !copy || !(undo = vc_undo_push(log, UNDO_UNSHARE, sect, name, length, opt))) {
+        vc_free(log->alloc, old);
+        vc_sect_destroy(copy);
+        return 0;
+    }
+    *old = *opt;
+    undo->old = old;
+    opt->value = copy;
+    return 1;
+}
+
+static vc_opt *vc_edit_mksect(vc_sect *sect, char *name, size_t length, vc_undo_log *log) {
+    vc_opt *opt = (vc_opt *)vc_malloc(log->alloc, sizeof(vc_opt));
+    if (!opt) return 0;
+    
+    opt->type = VC_SECTION;
+    opt->flags = 0;
+    opt->value = vc_sect_create(sect->root, sect);
+    if (!opt->value || !((vc_sect *)opt->value)->ht) {
+        vc_opt_destroy(opt, log->alloc);
+        return 0;
+    }
+    
+    if (fasthash_insertn(sect->ht, name, length, opt) >= sect->ht->size) {
+        vc_opt_destroy(opt, log->alloc);
+        return 0;
+    }
+    if (!vc_undo_push(log, UNDO_ADD, sect, name, length, opt)) {
+        fasthash_removen(sect->ht, name, length);
+        vc_opt_destroy(opt, log->alloc);
+        return 0;
+    }
+    return opt;
+}
+
+static void *vc_edit_value(vc_root *root, vc_edit *edit) {
+    switch (edit->type) {
+        case VC_BOOLEAN:
+        case VC_INTEGER: {
+            int *v = (int *)vc_malloc(root->alloc, sizeof(int));
+            if (v) *v = edit->v.i;
+            return v;
+        }
+        case VC_FLOAT:
+        case VC_RATIO: {
+            double *v = (double *)vc_malloc(root->alloc, sizeof(double));
+            if (v) *v = edit->v.f;
+            return v;
+        }
+        case VC_DURATION:
+        case VC_SIZE: {
+            int64_t *v = (int64_t *)vc_malloc(root->alloc, sizeof(int64_t));
+            if (v) *v = edit->v.l;
+            return v;
+        }
+        case VC_STRING:
+            /* Not interned, even if the config's values are: values set
+             * one at a time rarely repeat, so there is nothing to save */
+            return vc_strndup(root->alloc, edit->v.s, strlen(edit->v.s));
+        default:
+            return 0;
+    }
+}
+
+static vc_undo *vc_undo_push(vc_undo_log *log, vc_undo_action action, vc_sect *sect,
+                             char *key, size_t length, vc_opt *opt) {
+    vc_undo *undo;
+    
+    if (log->n == log->cap) {
+        size_t cap = log->cap ? log->cap * 2 : 8;
+        vc_undo *entries = (vc_undo *)vc_realloc(log->alloc, log->entries, cap * sizeof(vc_undo));
+        if (!entries) return 0;
+        log->entries = entries;
+        log->cap = cap;
+    }
+    
+    undo = &(log->entries[log->n++]);
+    undo->action = action;
+    undo->sect = sect;
+    undo->key = key;
+    undo->length = length;
+    undo->opt = opt;
+    undo->old = 0;
+    return undo;
+}
+
+static int vc_undo_release(vc_undo_log *log) {
+    int structural = 0;
+    size_t i;
+    
+    for (i = 0; i < log->n; i++) {
+        vc_undo *undo = &(log->entries[i]);
+        switch (undo->action) {
+            case UNDO_ADD: structural = 1; break;
+            case UNDO_REMOVE:
+                vc_opt_destroy(undo->opt, log->alloc);
+                structural = 1;
+            break;
+            case UNDO_VALUE: vc_opt_destroy(undo->old, log->alloc); break;
+            case UNDO_UNSHARE:
+                vc_opt_destroy(undo->old, log->alloc);
+                structural = 1;
+            break;
+            default: break;
+        }
+    }
+    return structural;
+}
+
+static void vc_undo_rollback(vc_undo_log *log) {
+    size_t i = log->n;
+    
+    /* Newest first, so sections added by the transaction are emptied
+     * before they are removed. */
+    while (i--) {
+        vc_undo *undo = &(log->entries[i]);
+        vc_opt *opt = undo->opt;
+        switch (undo->action) {
+            case UNDO_ADD:
+                fasthash_removen(undo->sect->ht, undo->key, undo->length);
+                vc_opt_destroy(opt, log->alloc);
+            break;
+            case UNDO_REMOVE:
+                fasthash_insertn(undo->sect->ht, undo->key, undo->length, opt);
+            break;
+            case UNDO_VALUE:
+            case UNDO_UNSHARE: {
+                vc_opt replaced = *opt;
+                *opt = *(undo->old);
+                *(undo->old) = replaced;
+                vc_opt_destroy(undo->old, log->alloc);
+            } break;
+            case UNDO_NUMBER:
+                if (opt->type == VC_FLOAT || opt->type == VC_RATIO) *((double *)opt->value) = undo->num.f;
+                else if (opt->type == VC_DURATION || opt->type == VC_SIZE) *((int64_t *)opt->value) = undo->num.l;
+                else *((int *)opt->value) = undo->num.i;
+            break;
+        }
+    }
+}
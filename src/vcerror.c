@@ -31,7 +31,8 @@ static const vc_error error_defs[] = {
 /**********************************************************************/
 /**** Static Function Prototypes **************************************/
 /**********************************************************************/
-/* NONE */
+/* Format an error, and pass it to the sink */
+static void vc_report_verror(vc_errsink *sink, vc_error_type err, struct vc_parser *parser, va_list args);
 
 /**********************************************************************/
 /**** Function Definitions ********************************************/
@@ -42,24 +43,55 @@ static const vc_error error_defs[] = {
 /**********************************************************************/
 void vc_print_error(vc_error_type err, struct vc_parser *parser, ...) {
     va_list args;
-    va_start (args, parser);
-    const vc_error *error = &(error_defs[err]);
-    char buffer[256];
-
+    vc_errsink *sink = 0;
+    
+    /* Errors go wherever the caller of vconfig_open asked for them */
+    if (parser && parser->params) sink = parser->params->errors;
     
-    bzero(buffer, 256);
+    va_start(args, parser);
+    vc_report_verror(sink, err, parser, args);
+    va_end(args);
+}
+
+void vc_report_error(vc_errsink *sink, vc_error_type err, struct vc_parser *parser, ...) {
+    va_list args;
+    va_start(args, parser);
+    vc_report_verror(sink, err, parser, args);
+    va_end(args);
+}
 
-    if (error->flags & O_FILE) {
-        sprintf(buffer, "%s:%d: %s\n", parser->file, parser->line, error->msg);
+void vc_emit_error(vc_errsink *sink, vc_error_type err, const char *msg) {
+    if (sink && sink->fn) {
+        sink->fn(sink->ctx, err, msg);
     } else {
-        sprintf(buffer, "%s\n", error->msg);
+        fprintf(stderr, "%s\n", msg);
     }
+}
 
-    vfprintf(stderr, buffer, args);
-    va_end(args);
+void vc_error_record(void *ctx, vc_error_type err, const char *msg) {
+    vc_load_error *error = (vc_load_error *)ctx;
+    
+    /* Later errors are usually consequences of the first */
+    if (error->type != VC_ERROR_SUCCESS) return;
+    error->type = err;
+    snprintf(error->msg, sizeof(error->msg), "%s", msg);
 }
 
 /**********************************************************************/
 /******** Static Function Definitions *********************************/
 /**********************************************************************/
-/* NONE */
+
+static void vc_report_verror(vc_errsink *sink, vc_error_type err, struct vc_parser *parser, va_list args) {
+    const vc_error *error = &(error_defs[err]);
+    char msg[VC_ERROR_MSG_SIZE];
+    size_t n = 0;
+    
+    /* Only the error's own text is a format.  File names are data, and
+     * may hold anything, '%' included. */
+    if ((error->flags & O_FILE) && parser) {
+        n = (size_t)snprintf(msg, sizeof(msg), "%s:%d: ", parser->file, parser->line);
+        if (n >= sizeof(msg)) n = sizeof(msg) - 1;
+    }
+    vsnprintf(msg + n, sizeof(msg) - n, error->msg, args);
+    vc_emit_error(sink, err, msg);
+}
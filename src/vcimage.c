@@ -0,0 +1,745 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcimage.c
+ *
+ * Shared-memory config images.  A publisher lays out a parsed config as
+ * a relocatable image in a POSIX shared memory segment, which other
+ * processes map read-only and query in place.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vcimage.h"
+#include "vcinclude.h"
+#include "vcerror.h"
+#include "vcedit.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define NAME_SIZE       256     /* Maximum segment name length */
+#define ATTACH_RETRIES  8       /* Attempts to catch a stable generation */
+#define INITIAL_SIZE    4096    /* Initial image buffer size */
+
+#define IMAGE_HEADER(base) ((vc_image_header *)(base))
+#define IMAGE_SECTS(base)  ((vc_image_sect *)((base) + IMAGE_HEADER(base)->sects))
+#define IMAGE_ENTRIES(base, s) ((vc_image_entry *)((base) + (s)->entries))
+
+/* [off, off + len) lies within an image of the given size */
+#define IN_IMAGE(off, len, size) ((off) <= (size) && (len) <= (size) - (off))
+
+#define THROW_IMAGE_ERROR(name, reason) {                       \
+    vc_report_error(0, VC_ERROR_IMAGE, 0, name, reason);        \
+    goto err;                                                   \
+}
+
+/* Image being laid out.  References into the buffer are kept as offsets,
+ * as it moves when it grows. */
+typedef struct vc_image_builder {
+    char *buf;                      /* Image buffer */
+    size_t size;                    /* Bytes used */
+    size_t cap;                     /* Bytes allocated */
+    
+    vc_image_sect *sects;           /* Section table, appended last */
+    uint32_t nsects;                /* Sections so far */
+    uint32_t capsects;              /* Capacity of section table */
+    uint64_t nopts;                 /* Non-section options so far */
+    
+    fasthash_table *strings;        /* Offsets of strings already written */
+    int failed;                     /* Set on allocation failure */
+} vc_image_builder;
+
+/* Option of a section being laid out.  A section may be merged from
+ * several parsed sections, through includes. */
+typedef struct vc_image_item {
+    char *key;                      /* Option name */
+    size_t keylen;                  /* Option name length */
+    vc_opt *opt;                    /* Option that takes precedence */
+    vc_sect **srcs;                 /* Sections: every section merged in */
+    size_t nsrcs;                   /* Number of merged sections */
+    size_t capsrcs;                 /* Capacity of srcs */
+} vc_image_item;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+/* Image layout */
+static int vc_image_build(vc_image_builder *b, vc_sect *sect);
+static uint32_t vc_image_section(vc_image_builder *b, vc_sect **srcs, size_t nsrcs);
+static uint64_t vc_image_alloc(vc_image_builder *b, size_t size);
+static uint64_t vc_image_string(vc_image_builder *b, char *str, size_t length);
+static uint64_t vc_image_array_put(vc_image_builder *b, vc_array *arr);
+static int vc_image_keycmp(const char *a, size_t alen, const char *b, size_t blen);
+static int vc_image_itemcmp(const void *a, const void *b);
+
+/* Image lookup */
+static vc_image_entry *vc_image_find(char *base, vc_image_sect *sect, char *key, size_t length);
+
+/* Check every offset in a mapped image.  Returns why it's invalid, or
+ * NULL if lookups can trust it. */
+static const char *vc_image_check(const char *base, size_t size);
+static int vc_image_check_string(const char *base, uint64_t size, uint64_t off);
+
+/* Shared memory helpers */
+static void *vc_image_map(char *name, int oflag, size_t size, size_t *mapped);
+static int vc_image_write(char *name, char *buf, size_t size);
+static long vc_futex(uint32_t *addr, int op, uint32_t val, struct timespec *timeout);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+vc_publisher *vc_publisher_open(char *name) {
+    vc_publisher *pub = (vc_publisher *)malloc(sizeof(vc_publisher));
+    if (!pub) return 0;
+    
+    pub->name = strdup(name);
+    pub->control = (vc_image_control *)vc_image_map(name, O_RDWR | O_CREAT, sizeof(vc_image_control), 0);
+    if (!pub->name || !pub->control) {
+        free(pub->name);
+        free(pub);
+        return 0;
+    }
+    
+    /* Closing a publisher leaves its segments in place, so a restarted
+     * one carries on from the last generation, and attached processes
+     * see its first publish as an update. */
+    if (pub->control->magic != VC_IMAGE_MAGIC) {
+        pub->control->generation = 0;
+        pub->control->magic = VC_IMAGE_MAGIC;
+    }
+    pub->generation = pub->control->generation;
+    return pub;
+}
+
+int vc_publish(vc_publisher *pub, vc_sect *sect) {
+    vc_image_builder b;
+    char name[NAME_SIZE];
+    uint32_t gen;
+    int ok;
+    
+    /* Images are republished from the parsed config, not from another
+     * image. */
+    if (!sect || !sect->ht) THROW_IMAGE_ERROR(pub->name, "Not a parsed config");
+    if (!vc_image_build(&b, sect)) THROW_IMAGE_ERROR(pub->name, strerror(ENOMEM));
+    
+    gen = pub->generation + 1;
+    if (!gen) gen = 1;
+    IMAGE_HEADER(b.buf)->generation = gen;
+    
+    snprintf(name, sizeof(name), "%s.%u", pub->name, gen);
+    ok = vc_image_write(name, b.buf, b.size);
+    free(b.buf);
+    if (!ok) THROW_IMAGE_ERROR(name, strerror(errno));
+    
+    /* Switch generations, wake waiters, then retire the old image */
+    __atomic_store_n(&(pub->control->generation), gen, __ATOMIC_RELEASE);
+    vc_futex(&(pub->control->generation), FUTEX_WAKE, INT_MAX, 0);
+    if (pub->generation) {
+        snprintf(name, sizeof(name), "%s.%u", pub->name, pub->generation);
+        shm_unlink(name);
+    }
+    pub->generation = gen;
+    return 1;
+    
+err:
+    return 0;
+}
+
+void vc_publisher_close(vc_publisher *pub) {
+    if (!pub) return;
+    
+    /* The control segment and the current image stay, for processes
+     * attached now and later, until vc_image_unlink removes them */
+    munmap(pub->control, sizeof(vc_image_control));
+    free(pub->name);
+    free(pub);
+}
+
+int vc_image_unlink(char *name) {
+    char iname[NAME_SIZE];
+    vc_image_control *control;
+    uint32_t gen = 0;
+    
+    control = (vc_image_control *)vc_image_map(name, O_RDONLY, sizeof(vc_image_control), 0);
+    if (control) {
+        if (control->magic == VC_IMAGE_MAGIC) gen = __atomic_load_n(&(control->generation), __ATOMIC_ACQUIRE);
+        munmap(control, sizeof(vc_image_control));
+    }
+    if (gen) {
+        snprintf(iname, sizeof(iname), "%s.%u", name, gen);
+        shm_unlink(iname);
+    }
+    return !shm_unlink(name);
+}
+
+vc_sect *vc_image_attach(char *name) {
+    char iname[NAME_SIZE];
+    vc_image_control *control;
+    vc_image_header *hdr;
+    vc_image *img = 0;
+    vc_root *root = 0;
+    const char *reason;
+    char *base = 0;
+    size_t size = 0;
+    uint32_t gen, i;
+    int tries;
+    
+    control = (vc_image_control *)vc_image_map(name, O_RDONLY, sizeof(vc_image_control), 0);
+    if (!control) {
+        vc_report_error(0, VC_ERROR_IMAGE, 0, name, strerror(errno));
+        return 0;
+    }
+    if (control->magic != VC_IMAGE_MAGIC) THROW_IMAGE_ERROR(name, "Not a config image");
+    
+    /* The publisher may retire an image between reading the generation
+     * and opening it, in which case try the new one. */
+    for (tries = 0; !base && tries < ATTACH_RETRIES; tries++) {
+        gen = __atomic_load_n(&(control->generation), __ATOMIC_ACQUIRE);
+        if (!gen) THROW_IMAGE_ERROR(name, "Nothing published");
+    
+        snprintf(iname, sizeof(iname), "%s.%u", name, gen);
+        base = (char *)vc_image_map(iname, O_RDONLY, 0, &size);
+    }
+    if (!base) THROW_IMAGE_ERROR(name, "Unable to map image");
+    
+    /* Images never change once published, so they're checked once, here,
+     * rather than on every lookup */
+    if ((reason = vc_image_check(base, size))) THROW_IMAGE_ERROR(iname, reason);
+    hdr = IMAGE_HEADER(base);
+    
+    img = (vc_image *)malloc(sizeof(vc_image));
+    root = (vc_root *)malloc(sizeof(vc_root));
+    if (!img || !root) THROW_IMAGE_ERROR(name, strerror(ENOMEM));
+    img->handles = (vc_sect *)malloc(hdr->nsects * sizeof(vc_sect));
+    if (!img->handles) THROW_IMAGE_ERROR(name, strerror(ENOMEM));
+    img->base = base;
+    img->size = size;
+    img->control = control;
+    
+    root->sect = &(img->handles[0]);
+    root->flags = 0;
+    root->alloc = 0;
+    root->source = 0;
+    root->pool = 0;
+    root->image = img;
+    root->generation = vc_generation_new();
+    root->index = 0;
+    vc_lock_init(root);
+    pthread_mutex_init(&(root->index_lock), 0);
+    for (i = 0; i < hdr->nsects; i++) {
+        img->handles[i].ht = 0;
+        img->handles[i].root = root;
+        img->handles[i].parent = 0;
+        img->handles[i].includes = 0;
+        img->handles[i].keys = 0;
+        img->handles[i].hashed = 0;
+        img->handles[i].shared = 0;
+    }
+    return root->sect;
+    
+err:
+    if (img) free(img->handles);
+    free(img);
+    free(root);
+    if (base) munmap(base, size);
+    munmap(control, sizeof(vc_image_control));
+    return 0;
+}
+
+void vc_image_detach(vc_sect *sect) {
+    vc_image *img;
+    if (!sect || !sect->root || !(img = sect->root->image)) return;
+    
+    munmap(img->base, img->size);
+    munmap(img->control, sizeof(vc_image_control));
+    pthread_rwlock_destroy(&(sect->root->lock));
+    pthread_mutex_destroy(&(sect->root->index_lock));
+    free(sect->root);
+    free(img->handles);
+    free(img);
+}
+
+int vc_image_wait(vc_sect *sect, int timeout_ms) {
+    vc_image *img = sect->root->image;
+    uint32_t gen = IMAGE_HEADER(img->base)->generation;
+    uint32_t *word = &(img->control->generation);
+    struct timespec deadline, now, ts, *timeout = 0;
+    
+    /* The futex takes a relative timeout, so what's left of it is worked
+     * out again after each wakeup */
+    if (timeout_ms >= 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        timeout = &ts;
+    }
+    
+    while (__atomic_load_n(word, __ATOMIC_ACQUIRE) == gen) {
+        if (timeout) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            ts.tv_sec = deadline.tv_sec - now.tv_sec;
+            ts.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (ts.tv_nsec < 0) {
+                ts.tv_sec--;
+                ts.tv_nsec += 1000000000;
+            }
+            if (ts.tv_sec < 0) break;
+        }
+        if (vc_futex(word, FUTEX_WAIT, gen, timeout) && errno == ETIMEDOUT) break;
+    }
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE) != gen;
+}
+
+void *vc_image_getval(vc_sect *sect, char *optpath, vc_type *type) {
+    return vc_image_getvaln(sect, optpath, strlen(optpath), type);
+}
+
+void *vc_image_getvaln(vc_sect *sect, char *optpath, size_t length, vc_type *type) {
+    vc_image *img = sect->root->image;
+    vc_image_sect *sects = IMAGE_SECTS(img->base);
+    vc_image_entry *entry;
+    uint64_t index = sect - img->handles;
+    char *ptr, *end = optpath + length;
+    
+    for (;;) {
+        ptr = optpath;
+        while (ptr < end && *ptr != '.') ptr++;
+    
+        entry = vc_image_find(img->base, &(sects[index]), optpath, ptr - optpath);
+        if (!entry) return NULL;
+    
+        if (ptr == end) break;
+        if (entry->type != VC_SECTION) return NULL;
+        index = entry->v.off;
+        optpath = ptr + 1;
+    }
+    return vc_image_value(sect, entry, type);
+}
+
+vc_image_entry *vc_image_range(vc_sect *sect, const char *prefix, size_t length, size_t *count) {
+    vc_image *img = sect->root->image;
+    vc_image_sect *s = &(IMAGE_SECTS(img->base)[sect - img->handles]);
+    vc_image_entry *entries = IMAGE_ENTRIES(img->base, s);
+    size_t lo = 0, hi = s->nentries, first;
+    
+    /* Keys are sorted, so those with the prefix are contiguous */
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(img->base + entries[mid].key, prefix, length) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    first = lo;
+    while (lo < s->nentries && !strncmp(img->base + entries[lo].key, prefix, length)) lo++;
+    
+    *count = lo - first;
+    return entries + first;
+}
+
+void *vc_image_value(vc_sect *sect, vc_image_entry *entry, vc_type *type) {
+    vc_image *img = sect->root->image;
+    
+    *type = (vc_type)entry->type;
+    switch (entry->type) {
+        case VC_BOOLEAN:
+        case VC_INTEGER: return &(entry->v.i);
+        case VC_FLOAT:
+        case VC_RATIO:   return &(entry->v.f);
+        case VC_DURATION:
+        case VC_SIZE:    return &(entry->v.l);
+        case VC_STRING:
+        case VC_ARRAY:   return img->base + entry->v.off;
+        case VC_SECTION: return &(img->handles[entry->v.off]);
+        default:         return NULL;
+    }
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Lay out a parsed config.  On success, b->buf holds the image. */
+static int vc_image_build(vc_image_builder *b, vc_sect *sect) {
+    vc_sect **srcs = 0;
+    size_t nsrcs = 0, capsrcs = 0;
+    vc_image_header *hdr;
+    uint64_t off;
+    
+    bzero(b, sizeof(vc_image_builder));
+    b->strings = fasthash_init(1024, 0, 0, 0, 0);
+    if (!b->strings) return 0;
+    
+    vc_image_alloc(b, sizeof(vc_image_header));
+    if (vc_sect_sources(sect, &srcs, &nsrcs, &capsrcs)) {
+        vc_image_section(b, srcs, nsrcs);
+    } else {
+        b->failed = 1;
+    }
+    free(srcs);
+    
+    off = vc_image_alloc(b, b->nsects * sizeof(vc_image_sect));
+    if (!b->failed) {
+        memcpy(b->buf + off, b->sects, b->nsects * sizeof(vc_image_sect));
+        hdr = IMAGE_HEADER(b->buf);
+        hdr->magic = VC_IMAGE_MAGIC;
+        hdr->version = VC_IMAGE_VERSION;
+        hdr->nsects = b->nsects;
+        hdr->nopts = b->nopts;
+        hdr->size = b->size;
+        hdr->sects = off;
+    }
+    
+    fasthash_cleanup(b->strings);
+    free(b->sects);
+    if (b->failed) {
+        free(b->buf);
+        b->buf = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/* Lay out a section merged from srcs, which are in order of precedence.
+ * Returns its index in the section table. */
+static uint32_t vc_image_section(vc_image_builder *b, vc_sect **srcs, size_t nsrcs) {
+    vc_image_item *items = 0;
+    size_t nitems = 0, capitems = 0, i;
+    fasthash_table *seen;
+    index_node *in;
+    fasthash_node *node;
+    uint32_t index;
+    uint64_t off;
+    
+    /* Reserve this section's slot before its children take theirs */
+    if (b->nsects == b->capsects) {
+        uint32_t cap = b->capsects ? b->capsects * 2 : 64;
+        vc_image_sect *sects = (vc_image_sect *)realloc(b->sects, cap * sizeof(vc_image_sect));
+        if (!sects) {
+            b->failed = 1;
+            return 0;
+        }
+        b->sects = sects;
+        b->capsects = cap;
+    }
+    index = b->nsects++;
+    b->sects[index].entries = 0;
+    b->sects[index].nentries = 0;
+    
+    /* Merge the options of every source.  The first definition of a name
+     * wins, except that sections of the same name are merged. */
+    seen = fasthash_init(256, 0, 0, 0, 0);
+    if (!seen) {
+        b->failed = 1;
+        return index;
+    }
+    for (i = 0; i < nsrcs; i++) {
+        for (in = srcs[i]->ht->index_list; in; in = in->next) {
+            for (node = srcs[i]->ht->entries[in->index]; node; node = node->next) {
+                vc_opt *opt = (vc_opt *)node->data;
+                fasthash_node *prev = fasthash_lookup(seen, node->key);
+                vc_image_item *item;
+    
+                if (prev) {
+                    item = &(items[(size_t)prev->data - 1]);
+                    if (item->opt->type != VC_SECTION || opt->type != VC_SECTION) continue;
+                } else {
+                    if (nitems == capitems) {
+                        size_t cap = capitems ? capitems * 2 : 16;
+                        vc_image_item *grown = (vc_image_item *)realloc(items, cap * sizeof(vc_image_item));
+                        if (!grown) goto fail;
+                        items = grown;
+                        capitems = cap;
+                    }
+                    item = &(items[nitems++]);
+                    bzero(item, sizeof(vc_image_item));
+                    item->key = node->key;
+                    item->keylen = strlen(node->key);
+                    item->opt = opt;
+                    fasthash_insert(seen, node->key, (void *)nitems);
+                }
+    
+                if (opt->type == VC_SECTION &&
+                    !vc_sect_sources((vc_sect *)opt->value, &(item->srcs), &(item->nsrcs), &(item->capsrcs))) {
+                    goto fail;
+                }
+            }
+        }
+    }
+    
+    qsort(items, nitems, sizeof(vc_image_item), vc_image_itemcmp);
+    off = vc_image_alloc(b, nitems * sizeof(vc_image_entry));
+    b->sects[index].entries = off;
+    b->sects[index].nentries = nitems;
+    
+    /* Fill in the entries.  Each is built on the stack, as laying out its
+     * value may move the buffer. */
+    for (i = 0; i < nitems && !b->failed; i++) {
+        vc_opt *opt = items[i].opt;
+        vc_image_entry entry;
+    
+        bzero(&entry, sizeof(entry));
+        entry.key = vc_image_string(b, items[i].key, items[i].keylen);
+        entry.keylen = (uint32_t)items[i].keylen;
+        entry.type = opt->type;
+        switch (opt->type) {
+            case VC_BOOLEAN:
+            case VC_INTEGER: entry.v.i = *((int *)opt->value); break;
+            case VC_FLOAT:
+            case VC_RATIO:   entry.v.f = *((double *)opt->value); break;
+            case VC_DURATION:
+            case VC_SIZE:    entry.v.l = *((int64_t *)opt->value); break;
+            case VC_STRING:
+                entry.v.off = vc_image_string(b, (char *)opt->value, strlen((char *)opt->value));
+                break;
+            case VC_ARRAY:   entry.v.off = vc_image_array_put(b, (vc_array *)opt->value); break;
+            case VC_SECTION: entry.v.off = vc_image_section(b, items[i].srcs, items[i].nsrcs); break;
+            default: break;
+        }
+        if (opt->type != VC_SECTION) b->nopts++;
+        if (!b->failed) memcpy(b->buf + off + i * sizeof(vc_image_entry), &entry, sizeof(entry));
+    }
+    goto done;
+    
+fail:
+    b->failed = 1;
+done:
+    for (i = 0; i < nitems; i++) free(items[i].srcs);
+    free(items);
+    fasthash_cleanup(seen);
+    return index;
+}
+
+/* Reserve zeroed, 8-byte aligned space in the image */
+static uint64_t vc_image_alloc(vc_image_builder *b, size_t size) {
+    size_t off = (b->size + 7) & ~(size_t)7;
+    
+    if (b->failed) return 0;
+    if (off + size > b->cap) {
+        size_t cap = b->cap ? b->cap : INITIAL_SIZE;
+        char *buf;
+        while (off + size > cap) cap *= 2;
+        buf = (char *)realloc(b->buf, cap);
+        if (!buf) {
+            b->failed = 1;
+            return 0;
+        }
+        bzero(buf + b->cap, cap - b->cap);
+        b->buf = buf;
+        b->cap = cap;
+    }
+    b->size = off + size;
+    return off;
+}
+
+/* Write a string once, returning its offset */
+static uint64_t vc_image_string(vc_image_builder *b, char *str, size_t length) {
+    fasthash_node *node = fasthash_lookupn(b->strings, str, length);
+    uint64_t off;
+    
+    if (node) return (uint64_t)(uintptr_t)node->data;
+    off = vc_image_alloc(b, length + 1);
+    if (b->failed) return 0;
+    memcpy(b->buf + off, str, length);
+    fasthash_insertn(b->strings, str, length, (void *)(uintptr_t)off);
+    return off;
+}
+
+static uint64_t vc_image_array_put(vc_image_builder *b, vc_array *arr) {
+    vc_image_array *hdr;
+    uint64_t off, elems;
+    size_t i;
+    
+    off = vc_image_alloc(b, sizeof(vc_image_array) + arr->length * sizeof(uint64_t));
+    if (b->failed) return 0;
+    elems = off + sizeof(vc_image_array);
+    
+    if (arr->type == VC_STRING) {
+        for (i = 0; i < arr->length; i++) {
+            uint64_t str = vc_image_string(b, arr->v.strs[i], strlen(arr->v.strs[i]));
+            if (b->failed) return 0;
+            memcpy(b->buf + elems + i * sizeof(uint64_t), &str, sizeof(uint64_t));
+        }
+    } else if (arr->length) {
+        memcpy(b->buf + elems, arr->v.data, arr->length * sizeof(uint64_t));
+    }
+    
+    hdr = (vc_image_array *)(b->buf + off);
+    hdr->type = arr->type;
+    hdr->length = arr->length;
+    return off;
+}
+
+static int vc_image_keycmp(const char *a, size_t alen, const char *b, size_t blen) {
+    int cmp = memcmp(a, b, alen < blen ? alen : blen);
+    if (cmp) return cmp;
+    return (alen > blen) - (alen < blen);
+}
+
+static int vc_image_itemcmp(const void *a, const void *b) {
+    const vc_image_item *x = (const vc_image_item *)a;
+    const vc_image_item *y = (const vc_image_item *)b;
+    return vc_image_keycmp(x->key, x->keylen, y->key, y->keylen);
+}
+
+/* Binary search of a section's sorted options */
+static vc_image_entry *vc_image_find(char *base, vc_image_sect *sect, char *key, size_t length) {
+    vc_image_entry *entries = IMAGE_ENTRIES(base, sect);
+    size_t lo = 0, hi = sect->nentries;
+    
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = vc_image_keycmp(base + entries[mid].key, entries[mid].keylen, key, length);
+        if (!cmp) return &(entries[mid]);
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return NULL;
+}
+
+static const char *vc_image_check(const char *base, size_t size) {
+    const vc_image_header *hdr = (const vc_image_header *)base;
+    const vc_image_sect *sects;
+    uint64_t s, e, i;
+    
+    if (size < sizeof(vc_image_header) || hdr->magic != VC_IMAGE_MAGIC) return "Not a config image";
+    if (hdr->version != VC_IMAGE_VERSION) return "Unsupported image version";
+    if (hdr->size > size) return "Image is truncated";
+    size = hdr->size;
+    if (!hdr->nsects || hdr->sects % 8 ||
+        !IN_IMAGE(hdr->sects, (uint64_t)hdr->nsects * sizeof(vc_image_sect), size)) {
+        return "Section table out of bounds";
+    }
+    
+    sects = (const vc_image_sect *)(base + hdr->sects);
+    for (s = 0; s < hdr->nsects; s++) {
+        const vc_image_entry *entries = (const vc_image_entry *)(base + sects[s].entries);
+        
+        if (sects[s].entries % 8 || sects[s].nentries > size / sizeof(vc_image_entry) ||
+            !IN_IMAGE(sects[s].entries, sects[s].nentries * sizeof(vc_image_entry), size)) {
+            return "Option table out of bounds";
+        }
+        for (e = 0; e < sects[s].nentries; e++) {
+            const vc_image_entry *entry = &(entries[e]);
+            const vc_image_array *arr;
+            
+            if (!IN_IMAGE(entry->key, (uint64_t)entry->keylen + 1, size) || base[entry->key + entry->keylen]) {
+                return "Key out of bounds";
+            }
+            switch (entry->type) {
+                case VC_BOOLEAN: case VC_INTEGER: case VC_FLOAT: case VC_RATIO:
+                case VC_DURATION: case VC_SIZE:
+                break;
+                case VC_STRING:
+                    if (!vc_image_check_string(base, size, entry->v.off)) return "String out of bounds";
+                break;
+                case VC_SECTION:
+                    if (entry->v.off >= hdr->nsects) return "Section index out of bounds";
+                break;
+                case VC_ARRAY:
+                    if (entry->v.off % 8 || !IN_IMAGE(entry->v.off, sizeof(vc_image_array), size)) {
+                        return "Array out of bounds";
+                    }
+                    arr = (const vc_image_array *)(base + entry->v.off);
+                    if (arr->length > size / sizeof(uint64_t) ||
+                        !IN_IMAGE(entry->v.off + sizeof(vc_image_array), arr->length * sizeof(uint64_t), size)) {
+                        return "Array out of bounds";
+                    }
+                    if (arr->type == VC_STRING) {
+                        const uint64_t *strs = (const uint64_t *)(arr + 1);
+                        for (i = 0; i < arr->length; i++) {
+                            if (!vc_image_check_string(base, size, strs[i])) return "String out of bounds";
+                        }
+                    } else if (arr->length && arr->type != VC_INTEGER && arr->type != VC_FLOAT) {
+                        return "Invalid array type";
+                    }
+                break;
+                default:
+                    return "Invalid option type";
+            }
+        }
+    }
+    return NULL;
+}
+
+/* A NUL-terminated string starts at off, and ends within the image */
+static int vc_image_check_string(const char *base, uint64_t size, uint64_t off) {
+    return off < size && memchr(base + off, '\0', size - off);
+}
+
+/* Map a shared memory segment.  Writable segments are created with the
+ * given size if needed; read-only ones are mapped whole. */
+static void *vc_image_map(char *name, int oflag, size_t size, size_t *mapped) {
+    int writable = (oflag & O_ACCMODE) == O_RDWR;
+    struct stat st;
+    void *addr;
+    int fd;
+    
+    if ((fd = shm_open(name, oflag, 0644)) < 0) return 0;
+    if (fstat(fd, &st)) goto err;
+    if (writable && (size_t)st.st_size < size && ftruncate(fd, size)) goto err;
+    if (!writable) {
+        if ((size_t)st.st_size < size || !st.st_size) goto err;
+        size = st.st_size;
+    }
+    
+    addr = mmap(0, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return 0;
+    if (mapped) *mapped = size;
+    return addr;
+    
+err:
+    close(fd);
+    return 0;
+}
+
+/* Write a new image segment, replacing any stale one of the same name */
+static int vc_image_write(char *name, char *buf, size_t size) {
+    size_t done = 0;
+    int fd;
+    
+    shm_unlink(name);
+    if ((fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644)) < 0) return 0;
+    while (done < size) {
+        ssize_t n = write(fd, buf + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            shm_unlink(name);
+            return 0;
+        }
+        done += n;
+    }
+    close(fd);
+    return 1;
+}
+
+/* The generation word is shared between processes, so these are not
+ * private futex operations. */
+static long vc_futex(uint32_t *addr, int op, uint32_t val, struct timespec *timeout) {
+    return syscall(SYS_futex, addr, op, val, timeout, 0, 0);
+}
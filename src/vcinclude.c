@@ -0,0 +1,419 @@
+/* 
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcinclude.c
+ * 
+ * Include handling for VConfig.  Included files are parsed as separate
+ * configs ("fragments") on a worker pool, and cached process-wide by
+ * device, inode, modification time and size, so that each is parsed once
+ * and shared read-only between every config including it.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <glob.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "vcinclude.h"
+#include "vcparse.h"
+#include "vcerror.h"
+#include "vcthread.h"
+#include "vcdiff.h"
+#include "vcdirect.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define CACHE_SIZE 1024     /* Fragment cache buckets */
+#define KEY_SIZE 192        /* Longest cache key */
+
+/* FNV-1a, for the directives a fragment is parsed with */
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME  0x100000001b3ULL
+
+/* Cycle detection marks */
+#define MARK_ACTIVE ((void *)1)     /* Fragment is on the DFS stack */
+#define MARK_DONE   ((void *)2)     /* Fragment and its includes are done */
+
+/* Trees of failed fragments, to be destroyed once the cache lock is
+ * released */
+typedef struct vc_sect_list {
+    vc_sect **sects;
+    size_t n, cap;
+} vc_sect_list;
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+
+/* Fragment cache and worker pool, shared by every config */
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cache_cond = PTHREAD_COND_INITIALIZER;
+static fasthash_table *cache;
+static vc_threadpool *workers;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static vc_fragment *vc_fragment_acquire(vc_parser *parser, char *path);
+static void vc_fragment_job(void *arg);
+static void vc_fragment_wait(vc_fragment *frag);
+static int vc_fragment_visit(vc_parser *parser, vc_fragment *frag, fasthash_table *marks,
+                             vc_sect_list *dropped);
+static void vc_fragment_drop(vc_fragment *frag, vc_sect_list *dropped);
+
+/* Directives are compared by contents, as callers often build the list
+ * for each open.  Copies are terminated as the list is. */
+static uint64_t vc_directives_digest(vc_directive *dirs);
+static int vc_directives_equal(vc_directive *a, vc_directive *b);
+static int vc_include_append(vc_parser *parser, vc_fragment *frag, char *spelling);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+int vc_include_add(vc_parser *parser, char *pattern) {
+    char path[PATH_MAX];
+    char *slash = parser->file ? strrchr(parser->file, '/') : 0;
+    glob_t matches;
+    size_t i;
+    int rc;
+    
+    /* Relative paths are relative to the including file */
+    if (pattern[0] != '/' && slash) {
+        snprintf(path, sizeof(path), "%.*s%s", (int)(slash - parser->file + 1), parser->file, pattern);
+    } else {
+        snprintf(path, sizeof(path), "%s", pattern);
+    }
+    
+    rc = glob(path, 0, 0, &matches);
+    if (rc == GLOB_NOMATCH) {
+        /* Only a plain path is required to exist */
+        if (!strpbrk(pattern, "*?[")) VC_THROW_ERROR(INCLUDE_FILE, parser, path);
+        return 1;
+    } else if (rc) {
+        VC_THROW_ERROR(INCLUDE_FILE, parser, path);
+    }
+    
+    for (i = 0; i < matches.gl_pathc; i++) {
+        vc_fragment *frag = vc_fragment_acquire(parser, matches.gl_pathv[i]);
+        if (!frag) {
+            /* Such as a dangling link.  The match goes with the glob. */
+            snprintf(path, sizeof(path), "%s", matches.gl_pathv[i]);
+            globfree(&matches);
+            VC_THROW_ERROR(INCLUDE_FILE, parser, path);
+        }
+        if (!vc_include_append(parser, frag, i ? 0 : pattern)) {
+            vc_fragment_release(frag);
+            globfree(&matches);
+            VC_THROW_ERROR(NO_MEMORY, parser);
+        }
+    }
+    
+    globfree(&matches);
+    return 1;
+    
+err:
+    return 0;
+}
+
+int vc_include_finish(vc_parser *parser) {
+    vc_sect_list dropped = {0, 0, 0};
+    fasthash_table *marks;
+    size_t i;
+    int ok = 1;
+    
+    if (!parser->ndeps) return 1;
+    
+    marks = fasthash_init(CACHE_SIZE, 0, 0, 0, 0);
+    if (!marks) return 0;
+    
+    pthread_mutex_lock(&cache_lock);
+    for (i = 0; ok && i < parser->ndeps; i++) {
+        ok = vc_fragment_visit(parser, parser->deps[i], marks, &dropped);
+    }
+    pthread_mutex_unlock(&cache_lock);
+    
+    /* Failed fragments give up their trees, and so the includes in them,
+     * so fragments that include each other don't keep each other alive */
+    for (i = 0; i < dropped.n; i++) vc_sect_destroy(dropped.sects[i]);
+    free(dropped.sects);
+    fasthash_cleanup(marks);
+    return ok;
+}
+
+void vc_fragment_complete(vc_fragment *frag, vc_sect *sect, vc_parser *parser) {
+    pthread_mutex_lock(&cache_lock);
+    
+    /* A failed parse has already released its includes */
+    if (sect) {
+        frag->deps = parser->deps;
+        frag->ndeps = parser->ndeps;
+    } else if (parser) {
+        free(parser->deps);
+    }
+    if (parser) {
+        parser->deps = 0;
+        parser->ndeps = 0;
+    }
+    
+    if (sect) sect->root->flags |= VC_ROOT_FRAGMENT;
+    frag->sect = sect;
+    frag->state = sect ? VC_FRAG_READY : VC_FRAG_FAILED;
+    pthread_cond_broadcast(&cache_cond);
+    pthread_mutex_unlock(&cache_lock);
+}
+
+void vc_fragment_release(vc_fragment *frag) {
+    fasthash_node *node;
+    if (!frag) return;
+    
+    pthread_mutex_lock(&cache_lock);
+    if (--frag->refs) {
+        pthread_mutex_unlock(&cache_lock);
+        return;
+    }
+    
+    /* Nobody can find the fragment once it leaves the cache, but it may
+     * still be loading. */
+    node = fasthash_lookup(cache, frag->key);
+    if (node && node->data == frag) fasthash_remove(cache, frag->key);
+    vc_fragment_wait(frag);
+    pthread_mutex_unlock(&cache_lock);
+    
+    vc_sect_destroy(frag->sect);
+    vc_directive_table_destroy(frag->directives);
+    vc_directives_free(frag->dirs, 0);
+    free(frag->deps);
+    free(frag->path);
+    free(frag->key);
+    free(frag);
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Find a fragment in the cache, or create it and queue it for parsing */
+static vc_fragment *vc_fragment_acquire(vc_parser *parser, char *path) {
+    char key[KEY_SIZE];
+    struct stat st;
+    fasthash_node *node;
+    vc_fragment *frag;
+    
+    if (stat(path, &st)) return 0;
+    
+    /* The parameters a fragment is parsed with are part of its identity,
+     * including the allocator, whose memory it lives in.  Directives are
+     * digested here, and compared in full on a hit. */
+    snprintf(key, sizeof(key), "%lx:%lx:%lld.%09ld:%lld:%llx:%x:%p",
+        (unsigned long)st.st_dev, (unsigned long)st.st_ino,
+        (long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec,
+        (long long)st.st_size, (unsigned long long)vc_directives_digest(parser->params->directives),
+        (unsigned)parser->params->flags, (void *)parser->params->allocator);
+    
+    pthread_mutex_lock(&cache_lock);
+    if (!cache) cache = fasthash_init(CACHE_SIZE, 0, 0, 0, 0);
+    if (!cache) goto err;
+    
+    node = fasthash_lookup(cache, key);
+    if (node) {
+        frag = (vc_fragment *)node->data;
+        if (vc_directives_equal(frag->dirs, parser->params->directives)) {
+            frag->refs++;
+            pthread_mutex_unlock(&cache_lock);
+            return frag;
+        }
+    }
+    
+    frag = (vc_fragment *)malloc(sizeof(vc_fragment));
+    if (!frag) goto err;
+    bzero(frag, sizeof(vc_fragment));
+    frag->path = strdup(path);
+    frag->key = strdup(key);
+    frag->dirs = vc_directives_copy(parser->params->directives, 0);
+    if (frag->dirs) frag->directives = vc_directive_table_create(frag->dirs, 0);
+    if (!frag->path || !frag->key || (parser->params->directives && !frag->directives)) {
+        vc_directive_table_destroy(frag->directives);
+        vc_directives_free(frag->dirs, 0);
+        free(frag->path);
+        free(frag->key);
+        free(frag);
+        goto err;
+    }
+    frag->state = VC_FRAG_LOADING;
+    frag->refs = 1;
+    frag->params = *(parser->params);
+    frag->params.file = frag->path;
+    frag->errsink.fn = vc_error_record;
+    frag->errsink.ctx = &(frag->error);
+    frag->params.errors = &(frag->errsink);
+    frag->params.directives = frag->dirs;
+    
+    /* A digest collision leaves the fragment out of the cache */
+    if (!node) fasthash_insert(cache, frag->key, frag);
+    
+    if (!workers) workers = vc_threadpool_create(0);
+    pthread_mutex_unlock(&cache_lock);
+    
+    /* Without a worker pool, parse it right here */
+    if (!workers || !vc_threadpool_submit(workers, vc_fragment_job, frag)) {
+        vc_fragment_job(frag);
+    }
+    return frag;
+    
+err:
+    pthread_mutex_unlock(&cache_lock);
+    return 0;
+}
+
+static void vc_fragment_job(void *arg) {
+    vc_parse_fragment((vc_fragment *)arg);
+}
+
+/* Wait for a fragment to finish loading, helping with queued parses in
+ * the meantime.  Must be called with the cache lock held. */
+static void vc_fragment_wait(vc_fragment *frag) {
+    while (frag->state == VC_FRAG_LOADING) {
+        int ran = 0;
+        
+        if (workers) {
+            pthread_mutex_unlock(&cache_lock);
+            ran = vc_threadpool_run_one(workers);
+            pthread_mutex_lock(&cache_lock);
+        }
+        if (!ran && frag->state == VC_FRAG_LOADING) {
+            pthread_cond_wait(&cache_cond, &cache_lock);
+        }
+    }
+}
+
+/* Depth-first walk of the include graph, waiting for each fragment and
+ * checking for failures and cycles.  Must be called with the cache lock
+ * held.  Every fragment on the path to a failure is marked as failed, as
+ * none of them can be used. */
+static int vc_fragment_visit(vc_parser *parser, vc_fragment *frag, fasthash_table *marks,
+                             vc_sect_list *dropped) {
+    char key[32];
+    fasthash_node *node;
+    size_t i;
+    
+    snprintf(key, sizeof(key), "%p", (void *)frag);
+    node = fasthash_lookup(marks, key);
+    if (node) {
+        if (node->data == MARK_DONE) return 1;
+        VC_THROW_ERROR(INCLUDE_CYCLE, parser, frag->path);
+    }
+    fasthash_insert(marks, key, MARK_ACTIVE);
+    
+    vc_fragment_wait(frag);
+    if (frag->state != VC_FRAG_READY) {
+        /* Pass on the fragment's own error, to every config including it */
+        if (frag->error.type != VC_ERROR_SUCCESS) {
+            vc_emit_error(parser->params->errors, frag->error.type, frag->error.msg);
+        }
+        VC_THROW_ERROR(INCLUDE_FAILED, parser, frag->path);
+    }
+    
+    for (i = 0; i < frag->ndeps; i++) {
+        if (!vc_fragment_visit(parser, frag->deps[i], marks, dropped)) goto err;
+    }
+    
+    /* Its includes are hashed, so the fragment can be.  Fragments are
+     * shared, so this is done under the lock, once. */
+    vc_hash_sect(frag->sect);
+    fasthash_lookup(marks, key)->data = MARK_DONE;
+    return 1;
+    
+err:
+    frag->state = VC_FRAG_FAILED;
+    vc_fragment_drop(frag, dropped);
+    return 0;
+}
+
+/* Take the tree of a failed fragment, for the caller to destroy.  No
+ * config can use it, and the includes it holds may lead back to the
+ * fragment.  Its dependencies go with them.  Must be called with the
+ * cache lock held. */
+static void vc_fragment_drop(vc_fragment *frag, vc_sect_list *dropped) {
+    if (!frag->sect) return;
+    if (dropped->n == dropped->cap) {
+        size_t cap = dropped->cap ? dropped->cap * 2 : 8;
+        vc_sect **sects = (vc_sect **)realloc(dropped->sects, sizeof(vc_sect *) * cap);
+        if (!sects) return;
+        dropped->sects = sects;
+        dropped->cap = cap;
+    }
+    dropped->sects[dropped->n++] = frag->sect;
+    frag->sect = 0;
+    free(frag->deps);
+    frag->deps = 0;
+    frag->ndeps = 0;
+}
+
+static uint64_t vc_directives_digest(vc_directive *dirs) {
+    uint64_t hash = FNV_OFFSET;
+    const unsigned char *bytes;
+    size_t i;
+    
+    for (; dirs && dirs->name; dirs++) {
+        for (bytes = (const unsigned char *)dirs->name; *bytes; bytes++) hash = (hash ^ *bytes) * FNV_PRIME;
+        for (i = 0; i < sizeof(dirs->format) && dirs->format[i]; i++) {
+            hash = (hash ^ (unsigned char)dirs->format[i]) * FNV_PRIME;
+        }
+        bytes = (const unsigned char *)&(dirs->func);
+        for (i = 0; i < sizeof(dirs->func); i++) hash = (hash ^ bytes[i]) * FNV_PRIME;
+        hash = (hash ^ (unsigned)dirs->flags) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static int vc_directives_equal(vc_directive *a, vc_directive *b) {
+    if (!a || !b) return !(a && a->name) && !(b && b->name);
+    for (; a->name && b->name; a++, b++) {
+        if (strcmp(a->name, b->name) || a->flags != b->flags || a->func != b->func ||
+            strncmp(a->format, b->format, sizeof(a->format))) {
+            return 0;
+        }
+    }
+    return !a->name && !b->name;
+}
+
+/* Add an include reference to the parser's current section, and record
+ * the fragment as a dependency of the file being parsed. */
+static int vc_include_append(vc_parser *parser, vc_fragment *frag, char *spelling) {
+    vc_sect *sect = parser->sects[parser->depth].sect;
+    size_t length = spelling ? strlen(spelling) + 1 : 0;
+    vc_include *inc, **tail;
+    
+    if (parser->ndeps == parser->capdeps) {
+        size_t cap = parser->capdeps ? parser->capdeps * 2 : 8;
+        vc_fragment **deps = realloc(parser->deps, sizeof(vc_fragment *) * cap);
+        if (!deps) return 0;
+        parser->deps = deps;
+        parser->capdeps = cap;
+    }
+    
+    inc = (vc_include *)vc_malloc(VC_SECT_ALLOC(sect), sizeof(vc_include) + length);
+    if (!inc) return 0;
+    inc->frag = frag;
+    inc->spelling = spelling ? memcpy((char *)(inc + 1), spelling, length) : 0;
+    inc->next = 0;
+    
+    for (tail = &(sect->includes); *tail; tail = &((*tail)->next));
+    *tail = inc;
+    
+    parser->deps[parser->ndeps++] = frag;
+    return 1;
+}
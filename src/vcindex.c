@@ -0,0 +1,149 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcindex.c
+ *
+ * Full-path index.  Every path that names an option, in the config or
+ * anything it includes, is resolved once by walking the sections, and
+ * the result stored under the whole path.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcindex.h"
+#include "vcinclude.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define INDEX_SIZE 64       /* Initial buckets; the table grows */
+
+/* Path being built during the walk */
+typedef struct vc_index_path {
+    char *buf;
+    size_t length, cap;
+} vc_index_path;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static fasthash_table *vc_index_build(vc_root *root);
+
+/* Index every path under sect, which is reached by path */
+static int vc_index_walk(fasthash_table *index, vc_sect *root, vc_sect *sect, vc_index_path *path);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+fasthash_table *vc_index_get(vc_root *root) {
+    fasthash_table *index = __atomic_load_n(&(root->index), __ATOMIC_ACQUIRE);
+    if (index) return index;
+    
+    /* Readers may race to build it; the first one does */
+    pthread_mutex_lock(&(root->index_lock));
+    index = root->index;
+    if (!index) {
+        index = vc_index_build(root);
+        __atomic_store_n(&(root->index), index, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&(root->index_lock));
+    return index;
+}
+
+void vc_index_drop(vc_root *root) {
+    fasthash_cleanup(root->index);
+    root->index = 0;
+}
+
+void vc_index_stats(vc_root *root, vc_stats *stats) {
+    fasthash_table *index;
+    index_node *in;
+    fasthash_node *node;
+    
+    if (!(root->flags & VC_ROOT_PATH_INDEX) || !(index = vc_index_get(root))) return;
+    
+    stats->index_bytes += sizeof(fasthash_table) + index->size * sizeof(fasthash_node *);
+    for (in = index->index_list; in; in = in->next) {
+        stats->index_bytes += sizeof(index_node);
+        for (node = index->entries[in->index]; node; node = node->next) {
+            stats->index_entries++;
+            stats->index_bytes += sizeof(fasthash_node) + strlen(node->key) + 1;
+        }
+    }
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static fasthash_table *vc_index_build(vc_root *root) {
+    vc_index_path path = {0, 0, 0};
+    fasthash_table *index;
+    
+    index = fasthash_init(INDEX_SIZE, (root->flags & VC_ROOT_SEEDED_HASH) ? FH_KEYED : 0, 0, 0, root->alloc);
+    if (!index) return 0;
+    
+    if (!vc_index_walk(index, root->sect, root->sect, &path)) {
+        fasthash_cleanup(index);
+        index = 0;
+    }
+    vc_free(root->alloc, path.buf);
+    return index;
+}
+
+static int vc_index_walk(fasthash_table *index, vc_sect *root, vc_sect *sect, vc_index_path *path) {
+    size_t prefix = path->length;
+    index_node *in;
+    fasthash_node *node;
+    vc_include *inc;
+    
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            size_t keylen = strlen(node->key);
+            
+            if (prefix + keylen + 2 > path->cap) {
+                size_t cap = (prefix + keylen + 2) * 2;
+                char *buf = (char *)vc_realloc(index->alloc, path->buf, cap);
+                if (!buf) return 0;
+                path->buf = buf;
+                path->cap = cap;
+            }
+            if (prefix) path->buf[prefix] = '.';
+            path->length = prefix + !!prefix;
+            memcpy(path->buf + path->length, node->key, keylen + 1);
+            path->length += keylen;
+            
+            /* A path may be reachable through several sections, which
+             * shadow each other; the walk decides which one it names. */
+            if (!fasthash_lookupn(index, path->buf, path->length)) {
+                vc_opt *found = vc_getopt_walk(root, path->buf);
+                if (found && fasthash_insertn(index, path->buf, path->length, found) >= index->size) {
+                    return 0;
+                }
+            }
+            
+            /* Even a shadowed section may hold paths that aren't */
+            if (opt->type == VC_SECTION && !vc_index_walk(index, root, (vc_sect *)opt->value, path)) {
+                return 0;
+            }
+        }
+    }
+    
+    for (inc = sect->includes; inc; inc = inc->next) {
+        path->length = prefix;
+        if (inc->frag->sect && !vc_index_walk(index, root, inc->frag->sect, path)) return 0;
+    }
+    path->length = prefix;
+    return 1;
+}
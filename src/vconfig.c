@@ -8,10 +8,6 @@
  * lookup. It supports automatic type conversion for values in the
  * configuration file.
  * 
- * TO DO:
- *      - Support multi-line strings.
- *      - Support array types.
- * 
  * The format of configuration files is as follows:
  * ------------------------------------------------
  * globalOptionA = valueA
@@ -47,10 +43,18 @@
  * Option names should not contain ' ', '.', '[', and ']'.  Option values
  * are parsed as the following:
  * 
- *      - String: Anything in quotes
+ *      - String: Anything in quotes.  Supports the escapes \n, \t, \r,
+ *                \\, \', \", \xNN and \uXXXX.
  *      - Integer: Any numerical string.
  *      - Boolean: Any case of true/false.  Evaluates to a char with
  *                 value 1 if true, 0 if false.
+ *      - Duration: A number with a unit, e.g. 30s, 2h30m or 1.5ms.
+ *                  Evaluates to nanoseconds.
+ *      - Size: A number with a unit, e.g. 512MiB or 4KB.  Evaluates to
+ *              bytes.
+ *      - Ratio: A percentage, e.g. 50%.  Evaluates to 0.5.
+ *      - Array: Comma-separated numbers or strings within brackets, e.g.
+ *               ports = [80, 443, 8080].  Arrays may span lines.
  * 
  * Accessing values is done by passing a string to vc_getopt, and
  * can access nested values by can be done as follows (assuming vcfg is
@@ -72,15 +76,25 @@
 /**********************************************************************/
 #include "vconfig.h"
 #include "vcdirect.h"
+#include "vcimage.h"
 
 /**********************************************************************/
 /**** Macro Definitions ***********************************************/
 /**********************************************************************/
+/* Lookups in vcfg go through the thread's cache */
+#define CACHED(vcfg) ((vcfg)->root && ((vcfg)->root->flags & VC_ROOT_LOOKUP_CACHE))
 
 /**********************************************************************/
 /**** Static Function Prototypes **************************************/
 /**********************************************************************/
-/* NONE */
+/* Look up a value of a given type, in a parsed config or an image */
+static void *vconfig_lookup(vconfig *vcfg, char *optpath, vc_type type);
+
+/* Look up a value of a given type through a view */
+static void *vconfig_view_lookup(vc_view *view, char *optpath, vc_type type);
+
+/* Look up an array and check its element type */
+static void *vconfig_getarray_typed(vconfig *vcfg, char *optpath, vc_type type, size_t *length);
 
 /**********************************************************************/
 /**** Function Definitions ********************************************/
@@ -95,112 +109,501 @@ vconfig *vconfig_open(vc_params *params) {
 }
 /* Simple open - no directives */
 vconfig *vconfig_open_simple(char *file) {
-    vc_params p = {file, 0};
+    vc_params p = {file, 0, 0, 0, 0};
     return vc_parse_file(&p);
 }
 
+/* In-memory parse */
+vconfig *vconfig_parse_buffer(const char *data, size_t length, vc_params *params) {
+    vc_params defaults = {0, 0, 0, 0, 0};
+    return vc_parse_buffer(data, length, params ? params : &defaults);
+}
+
+/* Batch open, on a worker pool */
+size_t vconfig_open_many(char **paths, size_t n, vc_batch_params *opts,
+                         vconfig **handles, vc_load_error *errors) {
+    vc_batch_params defaults = {0, 0, 0, 0};
+    return vc_parse_files(paths, n, opts ? opts : &defaults, handles, errors);
+}
+
+int vconfig_open_async(vc_params *params, vc_async_cb cb, void *ctx) {
+    return vc_async_open(params, cb, ctx);
+}
+
+size_t vconfig_open_many_async(char **paths, size_t n, vc_batch_params *opts,
+                               vc_async_cb cb, void *ctx) {
+    vc_batch_params defaults = {0, 0, 0, 0};
+    return vc_async_open_many(paths, n, opts ? opts : &defaults, cb, ctx);
+}
+
 vconfig *vconfig_close(vconfig *vcfg) {
     vc_sect_destroy(vcfg);
     return 0;
 }
 
+/* Shared-memory publication */
+vc_publisher *vconfig_publisher_open(char *name) {
+    return vc_publisher_open(name);
+}
+
+int vconfig_publish(vc_publisher *pub, vconfig *vcfg) {
+    return vc_publish(pub, vcfg);
+}
+
+void vconfig_publisher_close(vc_publisher *pub) {
+    vc_publisher_close(pub);
+}
+
+int vconfig_unpublish(char *name) {
+    return vc_image_unlink(name);
+}
+
+vconfig *vconfig_attach(char *name) {
+    return vc_image_attach(name);
+}
+
+int vconfig_wait_update(vconfig *vcfg, int timeout_ms) {
+    if (!vcfg->root->image) return 0;
+    return vc_image_wait(vcfg, timeout_ms);
+}
+
+/* Layered views */
+vc_view *vconfig_view_create(void) {
+    return vc_view_create();
+}
+
+void vconfig_view_destroy(vc_view *view) {
+    vc_view_destroy(view);
+}
+
+int vconfig_layer_push(vc_view *view, vconfig *vcfg) {
+    return vc_view_push(view, vcfg);
+}
+
+vconfig *vconfig_layer_pop(vc_view *view) {
+    return vc_view_pop(view);
+}
+
+vconfig *vconfig_flatten(vc_view *view) {
+    return vc_view_flatten(view);
+}
+
+vc_opt *vconfig_view_getopt(vc_view *view, char *optpath) {
+    return vc_view_getopt(view, optpath);
+}
+
+void *vconfig_view_getval(vc_view *view, char *optpath) {
+    vc_type type;
+    return vc_view_getval(view, optpath, &type);
+}
+
+int *vconfig_view_getbool(vc_view *view, char *optpath) {
+	return (int *)vconfig_view_lookup(view, optpath, VC_BOOLEAN);
+}
+
+int *vconfig_view_getint(vc_view *view, char *optpath) {
+	return (int *)vconfig_view_lookup(view, optpath, VC_INTEGER);
+}
+
+char *vconfig_view_getstr(vc_view *view, char *optpath) {
+	return (char *)vconfig_view_lookup(view, optpath, VC_STRING);
+}
+
+/* Edits */
+int vconfig_set_bool(vconfig *vcfg, char *optpath, int value) {
+    value = !!value;
+    return vc_set(vcfg, optpath, VC_BOOLEAN, &value);
+}
+
+int vconfig_set_int(vconfig *vcfg, char *optpath, int value) {
+    return vc_set(vcfg, optpath, VC_INTEGER, &value);
+}
+
+int vconfig_set_float(vconfig *vcfg, char *optpath, double value) {
+    return vc_set(vcfg, optpath, VC_FLOAT, &value);
+}
+
+int vconfig_set_duration_ns(vconfig *vcfg, char *optpath, int64_t ns) {
+    return vc_set(vcfg, optpath, VC_DURATION, &ns);
+}
+
+int vconfig_set_bytes(vconfig *vcfg, char *optpath, int64_t bytes) {
+    return vc_set(vcfg, optpath, VC_SIZE, &bytes);
+}
+
+int vconfig_set_ratio(vconfig *vcfg, char *optpath, double ratio) {
+    return vc_set(vcfg, optpath, VC_RATIO, &ratio);
+}
+
+int vconfig_set_str(vconfig *vcfg, char *optpath, char *value) {
+    return vc_set(vcfg, optpath, VC_STRING, value);
+}
+
+int vconfig_delete(vconfig *vcfg, char *optpath) {
+    return vc_delete(vcfg, optpath);
+}
+
+vconfig *vconfig_mkdir_sect(vconfig *vcfg, char *optpath) {
+    return vc_mkdir_sect(vcfg, optpath);
+}
+
+void vconfig_read_begin(vconfig *vcfg) {
+    vc_read_begin(vcfg);
+}
+
+void vconfig_read_end(vconfig *vcfg) {
+    vc_read_end(vcfg);
+}
+
+vc_txn *vconfig_txn_begin(vconfig *vcfg) {
+    return vc_txn_begin(vcfg);
+}
+
+int vconfig_txn_set_bool(vc_txn *txn, char *optpath, int value) {
+    value = !!value;
+    return vc_txn_set(txn, optpath, VC_BOOLEAN, &value);
+}
+
+int vconfig_txn_set_int(vc_txn *txn, char *optpath, int value) {
+    return vc_txn_set(txn, optpath, VC_INTEGER, &value);
+}
+
+int vconfig_txn_set_float(vc_txn *txn, char *optpath, double value) {
+    return vc_txn_set(txn, optpath, VC_FLOAT, &value);
+}
+
+int vconfig_txn_set_duration_ns(vc_txn *txn, char *optpath, int64_t ns) {
+    return vc_txn_set(txn, optpath, VC_DURATION, &ns);
+}
+
+int vconfig_txn_set_bytes(vc_txn *txn, char *optpath, int64_t bytes) {
+    return vc_txn_set(txn, optpath, VC_SIZE, &bytes);
+}
+
+int vconfig_txn_set_ratio(vc_txn *txn, char *optpath, double ratio) {
+    return vc_txn_set(txn, optpath, VC_RATIO, &ratio);
+}
+
+int vconfig_txn_set_str(vc_txn *txn, char *optpath, char *value) {
+    return vc_txn_set(txn, optpath, VC_STRING, value);
+}
+
+int vconfig_txn_delete(vc_txn *txn, char *optpath) {
+    return vc_txn_delete(txn, optpath);
+}
+
+int vconfig_txn_mkdir_sect(vc_txn *txn, char *optpath) {
+    return vc_txn_mkdir_sect(txn, optpath);
+}
+
+int vconfig_txn_commit(vc_txn *txn) {
+    return vc_txn_commit(txn);
+}
+
+void vconfig_txn_abort(vc_txn *txn) {
+    vc_txn_abort(txn);
+}
+
+/* Writing */
+int vconfig_write(vconfig *vcfg, int fd, vc_write_opts *opts) {
+    return vc_write(vcfg, fd, opts);
+}
+
+char *vconfig_write_buffer(vconfig *vcfg, vc_write_opts *opts, size_t *length) {
+    return vc_write_buffer(vcfg, opts, length);
+}
+
+/* Get memory/size statistics for a config or section. */
+void vconfig_stats(vconfig *vcfg, vc_stats *stats) {
+    bzero(stats, sizeof(vc_stats));
+    if (vcfg->root->image) {
+        vc_image_header *hdr = (vc_image_header *)vcfg->root->image->base;
+        stats->sections = hdr->nsects;
+        stats->options = hdr->nopts;
+        return;
+    }
+    vc_sect_stats(vcfg, stats);
+}
+
+/* Visit every option matching a path pattern */
+long vconfig_query(vconfig *vcfg, const char *pattern, vc_query_cb cb, void *ctx) {
+    return vc_query(vcfg, pattern, cb, ctx);
+}
+
+/* Report the options that differ between two configs */
+long vconfig_diff(vconfig *before, vconfig *after, vc_diff_cb cb, void *ctx) {
+    return vc_diff(before, after, cb, ctx);
+}
+
+/* Tapes */
+vc_tape *vconfig_tape_open(vc_params *params) {
+    return vc_parse_tape_file(params);
+}
+
+vc_tape *vconfig_tape_parse(const char *data, size_t length, vc_params *params) {
+    vc_params defaults = {0, 0, 0, 0, 0};
+    return vc_parse_tape(data, length, params ? params : &defaults);
+}
+
+void vconfig_tape_free(vc_tape *tape) {
+    vc_tape_free(tape);
+}
+
 /* Get option. Returns a generic container struct. */
 vc_opt *vconfig_getopt(vconfig *vcfg, char *opt) {
+    if (CACHED(vcfg)) return vc_cache_getopt(vcfg, opt);
     return vc_getopt(vcfg, opt);
 }
 
+/* Lookup cache counters of the calling thread */
+void vconfig_cache_stats(vc_cache_stats *stats) {
+    vc_cache_stats_get(stats);
+}
+
+void vconfig_cache_reset(void) {
+    vc_cache_reset();
+}
+
 /* Get value. Returns the value within the container if known ahead 
  * of time. */
 void *vconfig_getval(vconfig *vcfg, char *opt) {
-    return vc_getval(vcfg, opt);
+    vc_type type;
+    vc_opt *found;
+    
+    if (CACHED(vcfg)) {
+        found = vc_cache_getopt(vcfg, opt);
+        return found ? found->value : NULL;
+    }
+    return vc_sect_getval(vcfg, opt, &type);
 }
 
 /* Get a boolean.  If the option path does not exist, or the value is
  * not a boolean, NULL is returned. */
 int *vconfig_getbool(vconfig *vcfg, char *optpath) {
-	vc_opt *opt = vc_getopt(vcfg, optpath);
-	if (opt && opt->type == VC_BOOLEAN) return (int *)opt->value;
-	return NULL;
+	return (int *)vconfig_lookup(vcfg, optpath, VC_BOOLEAN);
 }
 
 /* Get an integer.  If the option path does not exist, or the value is
  * not an integer, NULL is returned. */
 int *vconfig_getint(vconfig *vcfg, char *optpath) {
-	vc_opt *opt = vc_getopt(vcfg, optpath);
-	if (opt && opt->type == VC_INTEGER) return (int *)opt->value;
-	return NULL;
+	return (int *)vconfig_lookup(vcfg, optpath, VC_INTEGER);
 }
 
 /* Get a string.  If the option path does not exist, or the value is
  * not an integer, NULL is returned. */
 char *vconfig_getstr(vconfig *vcfg, char *optpath) {
-	vc_opt *opt = vc_getopt(vcfg, optpath);
-	if (opt && opt->type == VC_STRING) return (char *)opt->value;
-	return NULL;
+	return (char *)vconfig_lookup(vcfg, optpath, VC_STRING);
+}
+
+/* Get a duration, size or ratio.  The unit was applied when the config
+ * was parsed, so these are lookups like any other. */
+int64_t *vconfig_getduration_ns(vconfig *vcfg, char *optpath) {
+	return (int64_t *)vconfig_lookup(vcfg, optpath, VC_DURATION);
+}
+
+int64_t *vconfig_getbytes(vconfig *vcfg, char *optpath) {
+	return (int64_t *)vconfig_lookup(vcfg, optpath, VC_SIZE);
+}
+
+double *vconfig_getratio(vconfig *vcfg, char *optpath) {
+	return (double *)vconfig_lookup(vcfg, optpath, VC_RATIO);
+}
+
+/* Get an array.  Returns the packed array container, or NULL if the
+ * option path does not exist or the value is not an array. */
+vc_array *vconfig_getarray(vconfig *vcfg, char *optpath) {
+	/* Image arrays aren't vc_arrays; use the typed getters on those */
+	if (vcfg->root->image) return NULL;
+	return (vc_array *)vconfig_lookup(vcfg, optpath, VC_ARRAY);
+}
+
+/* Get the elements of a typed array, and the element count. */
+int64_t *vconfig_getintarray(vconfig *vcfg, char *optpath, size_t *length) {
+	return (int64_t *)vconfig_getarray_typed(vcfg, optpath, VC_INTEGER, length);
+}
+
+double *vconfig_getfloatarray(vconfig *vcfg, char *optpath, size_t *length) {
+	return (double *)vconfig_getarray_typed(vcfg, optpath, VC_FLOAT, length);
+}
+
+char **vconfig_getstrarray(vconfig *vcfg, char *optpath, size_t *length) {
+	return (char **)vconfig_getarray_typed(vcfg, optpath, VC_STRING, length);
 }
 
 /* Get a config subsection. If the option path does not exist, or the
  * value is not an integer, NULL is returned. */
 vconfig *vconfig_getsect(vconfig *vcfg, char *optpath) {
-	vc_opt *opt = vc_getopt(vcfg, optpath);
-	if (opt && opt->type == VC_SECTION) return (vconfig *)opt->value;
-	return NULL;
+	return (vconfig *)vconfig_lookup(vcfg, optpath, VC_SECTION);
+}
+
+/* Get a value of a given type by an option path of a given length */
+void *vconfig_getvaln(vconfig *vcfg, const char *optpath, size_t length, vc_type type) {
+	vc_type found;
+	void *value = vc_sect_getvaln(vcfg, (char *)optpath, length, &found);
+	return (value && found == type) ? value : NULL;
+}
+
+/* Get a value of a given type by a pre-hashed option path */
+void *vconfig_getval_key(vconfig *vcfg, const vc_keypath *kp, vc_type type) {
+	vc_type found;
+	void *value = vc_sect_getval_key(vcfg, kp, &found);
+	return (value && found == type) ? value : NULL;
 }
 
 /**********************************************************************/
 /******** Static Function Definitions *********************************/
 /**********************************************************************/
 
-#ifdef STANDALONE
-
-#include <stdio.h>
+static void *vconfig_lookup(vconfig *vcfg, char *optpath, vc_type type) {
+	vc_type found;
+	void *value;
+	vc_opt *opt;
+	
+	if (CACHED(vcfg)) {
+		opt = vc_cache_getopt(vcfg, optpath);
+		return (opt && opt->type == type) ? opt->value : NULL;
+	}
+	value = vc_sect_getval(vcfg, optpath, &found);
+	return (value && found == type) ? value : NULL;
+}
 
+static void *vconfig_view_lookup(vc_view *view, char *optpath, vc_type type) {
+	vc_type found;
+	void *value = vc_view_getval(view, optpath, &found);
+	return (value && found == type) ? value : NULL;
+}
 
-#define VC_DIRECTIVE(name, flags, format)                               \
-    {#name, flags, format, VC_DIRECTIVE_##name##_fn__}
+static void *vconfig_getarray_typed(vconfig *vcfg, char *optpath, vc_type type, size_t *length) {
+	vc_array *arr;
+	
+	/* Image arrays hold offsets for strings, so only numbers can be
+	 * returned in place. */
+	if (vcfg->root->image) {
+		vc_image_array *iarr = (vc_image_array *)vconfig_lookup(vcfg, optpath, VC_ARRAY);
+		if (!iarr || type == VC_STRING || (iarr->length && iarr->type != (uint32_t)type)) return NULL;
+		if (length) *length = iarr->length;
+		return iarr + 1;
+	}
+	
+	arr = vconfig_getarray(vcfg, optpath);
+	if (!arr || (arr->length && arr->type != type)) return NULL;
+	if (length) *length = arr->length;
+	return arr->v.data;
+}
 
-#define VC_DEF_DIRECTIVE(name)                                          \
-    int VC_DIRECTIVE_##name##_fn__(vc_sect *sect, vc_list *__dir_args)
+#ifdef STANDALONE
 
-#define VC_GETARG_INT() *((int *)__dir_args->value); __dir_args = __dir_args->next
-#define VC_GETARG_FLOAT() *((double *)__dir_args->value); __dir_args = __dir_args->next
-#define VC_GETARG_STR() ((char *)__dir_args->value); __dir_args = __dir_args->next
-#define VC_GETARG_BOOL() VC_GETARG_INT()
+#include <stdio.h>
 
 VC_DEF_DIRECTIVE(addtwo) {
     /* get args */
     int a = VC_GETARG_INT();
     int b = VC_GETARG_INT();
     printf("addtwo: %d + %d = %d\n", a, b, a + b);
-    return a + b;    
+    return 0;
 }
 
 VC_DEF_DIRECTIVE(multwo) {
     int a = VC_GETARG_INT();
     int b = VC_GETARG_INT();
     printf("multwo: %d * %d = %d\n", a, b, a * b);
-    return a * b;
+    return 0;
+}
+
+VC_DEF_DIRECTIVE(echo) {
+    char *str = VC_GETARG_STR();
+    printf("echo: %s\n", str);
+    return 0;
 }
 
 /* Declare directives */
 vc_directive _directives[] = {
     VC_DIRECTIVE(addtwo, 0, "ii"),
-    VC_DIRECTIVE(multwo, 0, "ii")
+    VC_DIRECTIVE(multwo, 0, "ii"),
+    VC_DIRECTIVE(echo, 0, "s"),
+    {0, 0, "", 0}
 };
 
+/* Print an option, as found by a lookup or a query */
+static void print_value(const char *path, vc_type type, void *value) {
+    switch (type) {
+        case VC_BOOLEAN:
+            printf("%s = %s\n", path, *((int *)value) ? "TRUE" : "FALSE");
+        break;
+        case VC_INTEGER:
+            printf("%s = %d\n", path, *((int *)value));
+        break;
+        case VC_FLOAT:
+            printf("%s = %lf\n", path, *((double *)value));
+        break;
+        case VC_STRING:
+            printf("%s = \"%s\"\n", path, (char *)value);
+        break;
+        case VC_DURATION:
+        case VC_SIZE:
+        case VC_RATIO: {
+            char str[512];
+            vc_unit_format(str, sizeof(str), type, value);
+            printf("%s = %s\n", path, str);
+        } break;
+        case VC_SECTION:
+            printf("%s = <section %p>\n", path, value);
+        break;
+        case VC_ARRAY: {
+            vc_array *arr = (vc_array *)value;
+            size_t j;
+            printf("%s = [", path);
+            for (j = 0; j < arr->length; j++) {
+                if (j) printf(", ");
+                if (arr->type == VC_INTEGER) printf("%lld", (long long)arr->v.ints[j]);
+                else if (arr->type == VC_FLOAT) printf("%lf", arr->v.floats[j]);
+                else printf("\"%s\"", arr->v.strs[j]);
+            }
+            printf("]\n");
+        } break;
+        default:
+            printf("%s = <unknown type>\n", path);
+    }
+}
+
+static int print_match(const char *path, vc_type type, void *value, void *ctx) {
+    (void)ctx;
+    print_value(path, type, value);
+    return 0;
+}
+
 int main(int argc, char **argv) {
     vconfig *conf;
     vc_params p;
-    int i, a = 3, b = 4;
-
-    vc_list testlist1, testlist2;
+    int i, first = 1, show_stats = 0;
+    
+    bzero(&p, sizeof(vc_params));
     
-    if (argc < 2) {
-        printf("Usage: %s <filename> [<optpath1> [<optpath2> ...]]\n", argv[0]);
+    /* Options */
+    for (; first < argc && argv[first][0] == '-'; first++) {
+        if (!strcmp(argv[first], "-s")) show_stats = 1;
+        else if (!strcmp(argv[first], "-i")) p.flags |= VC_PARAM_INTERN_VALUES;
+        else if (!strcmp(argv[first], "-k")) p.flags |= VC_PARAM_SEEDED_HASH;
+        else if (!strcmp(argv[first], "-x")) p.flags |= VC_PARAM_PATH_INDEX;
+        else if (!strcmp(argv[first], "-q")) p.flags |= VC_PARAM_KEY_INDEX;
+        else if (!strcmp(argv[first], "-u")) p.flags |= VC_PARAM_VALIDATE_UTF8;
+        else if (!strcmp(argv[first], "-d")) p.flags |= VC_PARAM_SHARE_SECTIONS;
+        else break;
+    }
+    
+    if (argc - first < 1) {
+        printf("Usage: %s [-s] [-i] [-k] [-x] [-q] [-u] [-d] <filename> [<optpath1> [<optpath2> ...]]\n", argv[0]);
+        printf("\t-s\tPrint config statistics\n");
+        printf("\t-i\tIntern string values\n");
+        printf("\t-k\tHash keys with a random seed\n");
+        printf("\t-x\tIndex full option paths\n");
+        printf("\t-q\tKeep section keys sorted, for queries ('*' in an optpath)\n");
+        printf("\t-u\tReject strings that aren't valid UTF-8\n");
+        printf("\t-d\tShare identical sections (see vcshare.h)\n");
         return 1;
     }
     
-    p.file = argv[1];
+    p.file = argv[first];
     p.directives = _directives;
     
     conf = vconfig_open(&p);
@@ -210,38 +613,30 @@ int main(int argc, char **argv) {
         vc_opt *opt;
         printf("Config file loaded.\n");
         
-        testlist1.type = testlist2.type = VC_INTEGER;
-        testlist1.value = &a; testlist2.value = &b;
-        testlist1.next = &testlist2;
-        
-        _directives[0].func(0, &testlist1);
-        _directives[1].func(0, &testlist1);
+        if (show_stats) {
+            vc_stats stats;
+            vconfig_stats(conf, &stats);
+            printf("Sections: %zu\n", stats.sections);
+            printf("Options: %zu\n", stats.options);
+            printf("Interned strings: %zu (%zu bytes, %zu bytes saved)\n",
+                stats.intern_strings, stats.intern_bytes, stats.intern_saved);
+            if (p.flags & VC_PARAM_PATH_INDEX) {
+                printf("Path index: %zu paths (%zu bytes)\n", stats.index_entries, stats.index_bytes);
+            }
+            if (p.flags & VC_PARAM_SHARE_SECTIONS) {
+                printf("Shared sections: %zu (%zu in the store)\n", stats.shared_sections, vc_share_count());
+            }
+        }
 
-        for (i = 2; i < argc; i++) {
-            opt = vconfig_getopt(conf, argv[i]);
-            if (!opt) {
-                printf("%s = <null>\n", argv[i]);
-            } else {
-                switch (opt->type) {
-                    case VC_BOOLEAN:
-                        printf("%s = %s\n", argv[i], *((int *)opt->value) ? "TRUE" : "FALSE");
-                    break;
-                    case VC_INTEGER:
-                        printf("%s = %d\n", argv[i], *((int *)opt->value));
-                    break;
-                    case VC_FLOAT:
-                        printf("%s = %lf\n", argv[i], *((double *)opt->value));
-                    break;
-                    case VC_STRING:
-                        printf("%s = \"%s\"\n", argv[i], (char *)opt->value);
-                    break;
-                    case VC_SECTION:
-                        printf("%s = <section %p>\n", argv[i], opt->value);
-                    break;
-                    default:
-                        printf("%s = <unknown type>\n", argv[i]);
-                }
+        /* Option paths with a '*' in them are queries */
+        for (i = first + 1; i < argc; i++) {
+            if (strchr(argv[i], '*')) {
+                if (vconfig_query(conf, argv[i], print_match, 0) <= 0) printf("%s = <no match>\n", argv[i]);
+                continue;
             }
+            opt = vconfig_getopt(conf, argv[i]);
+            if (!opt) printf("%s = <null>\n", argv[i]);
+            else print_value(argv[i], opt->type, opt->value);
         }
         vconfig_close(conf);
     }
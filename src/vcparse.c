@@ -16,34 +16,53 @@
  *       | "u" | "v" | "w" | "x" | "y" | "z" ;
  * alpha = upper | lower ;
  * numeric = "0" | "1" | "2" | "3" | "4" | "5" | "6" | "7" | "8" | "9" ;
+ * hex = numeric | "A" | "B" | "C" | "D" | "E" | "F"
+ *     | "a" | "b" | "c" | "d" | "e" | "f" ;
  * 
  * newline = "\n" ;
  * whitespace = { " " | "\t" } ;
  * eol = { whitespace } , newline ;
  *
- * cfg = { newline | whitespace | comment | section | assignment } ;
+ * cfg = { newline | whitespace | comment | section | assignment | directive | include } ;
  * 
  * comment = "#" , { any-char - newline } , newline ;
  * section = section-header , cfg , section-footer ;
  * assignment = identifier , whitespace , "=" , whitespace , value , eol ;
+ * include = "include" , whitespace , string , eol ;
+ * directive = identifier , { whitespace , ( string | integer | float | boolean ) } , eol ;
  * 
  * section-header = "[" , { whitespace } , section-name , { whitespace }, "]" , eol ;
  * section-footer = "[" , { whitespace } , "/" , section-name , { whitespace } , "]" , eol ;
  * section-name = identifier , { whitespace , identifier } ;
  * 
  * identifier = alpha, { alpha | numeric | "-" | "_" | "/" | "\" } ;
- * value = { string | integer | float | boolean } ;
+ * value = { string | integer | float | boolean | duration | size | ratio | array } ;
  * 
- * string = sstring | dstring ;
- * sstring = "'" , { any-char - "'" } , "'" ;
- * dstring = '"' , { any-char - '"' } , '"' ;
+ * string = literal , { { whitespace | newline } , literal } ;
+ * literal = sstring | dstring ;
+ * sstring = "'" , { schar | escape } , "'" ;
+ * dstring = '"' , { dchar | escape } , '"' ;
+ * schar = any-char - ( "'" | "\" | newline ) ;
+ * dchar = any-char - ( '"' | "\" | newline ) ;
+ * escape = "\" , ( "n" | "t" | "r" | "\" | "'" | '"'
+ *        | "x" , hex , hex | "u" , hex , hex , hex , hex ) ;
  * 
  * integer = [ "-" ] , numeric, { numeric } ;
  * 
  * float = [ "-" ] , { numeric } , "." , { numeric } ;
  * 
+ * number = numeric , { numeric } , [ "." , { numeric } ] | "." , numeric , { numeric } ;
+ * duration = [ "-" ] , number , duration-unit , { number , duration-unit } ;
+ * duration-unit = "ns" | "us" | "ms" | "s" | "m" | "h" | "d" ;
+ * size = number , ( "B" | "kB" | "KB" | "MB" | "GB" | "TB" | "PB"
+ *      | "KiB" | "MiB" | "GiB" | "TiB" | "PiB" ) ;
+ * ratio = [ "-" ] , number , "%" ;
+ * 
  * boolean = true | false ;
  * 
+ * array = "[" , { eol } , [ element , { { eol } , "," , { eol } , element } ] , { eol } , [ "," ] , { eol } , "]" ;
+ * element = string | integer | float ;
+ * 
  * true = yes | ( ( "T" | "t" ) , [ ( "R" | "r" ) , ( "U" | "u" ) , ( "E" | "e" ) ] ) ;
  * yes = ( "Y" | "y" ) , [ ( "E" | "e" ) , ( "S" | "s" ) ] ;
  * 
@@ -56,6 +75,7 @@
 /**********************************************************************/
 #include <ctype.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +83,14 @@
 
 #include "vcparse.h"
 #include "vcerror.h"
+#include "vcdirect.h"
+#include "vcinclude.h"
+#include "vctape.h"
+#include "vcthread.h"
+#include "vcdiff.h"
+#include "vcutf8.h"
+#include "vcunit.h"
+#include "vcshare.h"
 
 /**********************************************************************/
 /**** Macro Definitions ***********************************************/
@@ -70,14 +98,16 @@
 
 
 
-#define SKIP_WHITESPACE(ptr)                        \
-    while (*(ptr) == ' ' || *(ptr) == '\t') (ptr)++;
+#define ARRAY_STACK_ELEMS 64   /* Array elements staged before using the heap */
+
+#define SKIP_WHITESPACE(ptr, end)                   \
+    while ((ptr) < (end) && (*(ptr) == ' ' || *(ptr) == '\t')) (ptr)++;
 
 #define SINGLE_CHAR_TOKEN(c, t)                 \
     c:                                          \
         token->type = VC_TOKEN_##t;             \
         token->length = 1;                      \
-        if (*(parser->ptr)) parser->ptr += 1;
+        parser->ptr += 1;
 
 #define ACCEPT(t) if (parser->token.type == VC_TOKEN_##t)
 #define EXPECT(t) if (parser->token.type != VC_TOKEN_##t) {                                 \
@@ -99,7 +129,7 @@ static const char *vc_token_str[] = {
 
 #define DEF_PARSE_RULE(rule) static int vc_parse_##rule(vc_parser *parser)
 #define PARSE(rule) if (!vc_parse_##rule(parser)) {\
-    fprintf(stderr, "Parse failure in rule: '%s'\n", #rule);\
+    vc_print_error(VC_ERROR_RULE, parser, #rule);\
     goto err;\
 }
 
@@ -108,25 +138,64 @@ static const char *vc_token_str[] = {
 /**** Static Function Prototypes **************************************/
 /**********************************************************************/
 
-/* Initializes the parser */
-static void vc_parser_init(vc_parser *parser, char *data);
+/* Parse a file, as a root config or as an included fragment */
+static vc_sect *vc_parse_path(vc_params *params, fasthash_table *directives, vc_fragment *frag);
+static vc_sect *vc_parse_owned(vc_params *params, fasthash_table *directives, vc_fragment *frag,
+                               char *buffer, size_t length);
+
+/* Batch of files being parsed by vc_parse_files */
+typedef struct vc_batch {
+    char **paths;                   /* Files to parse */
+    size_t n;                       /* Number of files */
+    size_t next;                    /* Next file to claim */
+    size_t loaded;                  /* Files parsed successfully */
+    vc_batch_params *opts;          /* Shared parameters */
+    fasthash_table *directives;     /* Directives, hashed once */
+    vc_sect **confs;                /* Results */
+    vc_load_error *errors;          /* Errors, if wanted */
+} vc_batch;
+
+/* Worker job: parse files from the batch until none are left */
+static void vc_batch_job(void *arg);
+
+/* Initializes the parser, to build sections or, given a builder, a tape */
+static void vc_parser_init(vc_parser *parser, char *data, vc_params *params, vc_tape_builder *tape);
+
+/* Parse a buffer with an initialized parser.  Returns zero on error. */
+static int vc_parse_run(char *buffer, size_t length, vc_parser *parser);
 
 /* Obtain the next token from the parser */
 static int vc_parser_get_token(vc_parser *parser);
 
+/* Nonzero if a value token is a number that doesn't convert */
+static int bad_number(vc_token *token, int scalar);
+
+/* Nonzero if a token ends a statement */
+static int statement_end(vc_token *token);
+
 /* Directive handling */
 static vc_directive *is_directive(vc_parser *parser);
+static int handle_directive(vc_parser *parser, vc_directive *d);
 
 /* Character validators */
+static int escape_length(char *str, char *end);
+static int escape_is_utf8(char *str);
+static inline uint32_t hex_digit(char c);
+static int string_is_utf8(vc_parser *parser, char *stop);
 static unsigned char is_boolean(char *str, size_t length, int *boolval);
 static inline unsigned char is_identifier_char(char c);
 static inline unsigned char is_alpha_char(char c);
 static inline unsigned char is_digit_char(char c);
 static inline unsigned char is_id_symbol_char(char c);
 
+/* Include handling */
+static unsigned char is_include(vc_parser *parser);
+
 /* Parse subrules */
 DEF_PARSE_RULE(assignment);
 DEF_PARSE_RULE(section);
+DEF_PARSE_RULE(include);
+static int vc_parse_array(vc_parser *parser, char *optname, size_t optlength);
 
 /**********************************************************************/
 /**** Function Definitions ********************************************/
@@ -137,43 +206,167 @@ DEF_PARSE_RULE(section);
 /**********************************************************************/
 
 vc_sect *vc_parse_file(vc_params *params) {
+    fasthash_table *directives;
+    vc_sect *conf;
+    
+    /* Hash the directives once, up front.  Included files share them. */
+    directives = vc_directive_table_create(params->directives, params->allocator);
+    conf = vc_parse_path(params, directives, 0);
+    vc_directive_table_destroy(directives);
+    
+    return conf;
+}
+
+vc_sect *vc_parse_loaded(vc_params *params, char *buffer, size_t length) {
+    fasthash_table *directives;
+    vc_sect *conf;
+    
+    directives = vc_directive_table_create(params->directives, params->allocator);
+    conf = vc_parse_owned(params, directives, 0, buffer, length);
+    vc_directive_table_destroy(directives);
+    
+    return conf;
+}
+
+size_t vc_parse_files(char **paths, size_t n, vc_batch_params *opts,
+                      vc_sect **confs, vc_load_error *errors) {
+    vc_batch batch;
+    vc_threadpool *pool;
+    int i, threads;
+    
+    batch.paths = paths;
+    batch.n = n;
+    batch.next = 0;
+    batch.loaded = 0;
+    batch.opts = opts;
+    batch.directives = vc_directive_table_create(opts->directives, opts->allocator);
+    batch.confs = confs;
+    batch.errors = errors;
+    
+    /* Workers claim files one at a time, so a few large files don't hold
+     * up the rest.  The calling thread is one of the workers. */
+    threads = opts->threads > 0 ? opts->threads : vc_cpu_count();
+    if ((size_t)threads > n) threads = (int)n;
+    pool = threads > 1 ? vc_threadpool_create(threads - 1) : 0;
+    for (i = 0; pool && i < pool->nthreads; i++) {
+        if (!vc_threadpool_submit(pool, vc_batch_job, &batch)) break;
+    }
+    vc_batch_job(&batch);
+    if (pool) vc_threadpool_wait(pool);
+    
+    vc_threadpool_destroy(pool);
+    vc_directive_table_destroy(batch.directives);
+    return batch.loaded;
+}
+
+void vc_parse_fragment(vc_fragment *frag) {
+    vc_parse_path(&(frag->params), frag->directives, frag);
+}
+
+vc_sect *vc_parse_buffer(const char *data, size_t length, vc_params *params) {
+    fasthash_table *directives;
+    vc_parser parser_inst;
+    vc_sect *conf;
+    
+    directives = vc_directive_table_create(params->directives, params->allocator);
+    vc_parser_init(&parser_inst, (char *)data, params, 0);
+    parser_inst.file = params->file ? params->file : "<buffer>";
+    parser_inst.directives = directives;
+    
+    /* The data remains the caller's, so the parser doesn't own it, and
+     * string values are copied out rather than terminated in place. */
+    conf = vc_parse_stream((char *)data, length, &parser_inst);
+    if (conf && !vc_include_finish(&parser_inst)) {
+        vc_sect_destroy(conf);
+        conf = 0;
+    }
+    vc_hash_sect(conf);
+    
+    free(parser_inst.deps);
+    vc_directive_table_destroy(directives);
+    return conf;
+}
+
+vc_sect *vc_parse_stream(char *buffer, size_t length, vc_parser *parser) {
+    if (vc_parse_run(buffer, length, parser)) return parser->sects[0].sect;
+    
+    /* Clean up the section(s) created */
+    vc_sect_destroy(parser->sects[0].sect);
+    return 0;
+}
+
+vc_tape *vc_parse_tape(const char *data, size_t length, vc_params *params) {
+    fasthash_table *directives;
+    vc_parser parser_inst;
+    vc_tape_builder builder;
+    vc_tape *tape = 0;
+    
+    if (!vc_tape_init(&builder, params->allocator)) {
+        vc_report_error(params->errors, VC_ERROR_NO_MEMORY, 0);
+        return 0;
+    }
+    directives = vc_directive_table_create(params->directives, params->allocator);
+    vc_parser_init(&parser_inst, (char *)data, params, &builder);
+    parser_inst.file = params->file ? params->file : "<buffer>";
+    parser_inst.directives = directives;
+    
+    /* Keys and strings are copied into the tape, so the data remains the
+     * caller's, as for vc_parse_buffer. */
+    if (vc_parse_run((char *)data, length, &parser_inst)) {
+        tape = vc_tape_finish(&builder);
+        if (!tape) vc_report_error(params->errors, VC_ERROR_NO_MEMORY, 0);
+    } else {
+        vc_tape_discard(&builder);
+    }
+    
+    vc_directive_table_destroy(directives);
+    return tape;
+}
+
+vc_tape *vc_parse_tape_file(vc_params *params) {
     int fd;
     size_t fsize;
+    ssize_t nread;
     char *buffer;
-    vc_parser parser_inst;
-    vc_sect *conf;
+    vc_tape *tape = 0;
     
     if ((fd = open(params->file, O_RDONLY)) < 0) {
-        VC_THROW_ERROR(FILE, 0, params->file);
+        vc_report_error(params->errors, VC_ERROR_FILE, 0, params->file);
+        return 0;
     }
     
-    /* Determine size of file */
     fsize = lseek(fd, 0, SEEK_END);
     lseek(fd, 0, SEEK_SET);
     
-    /* Allocate a buffer to hold the file's contents.  Right now, we
-     * do single-chunk reads, as streaming isn't implemented yet. */
-    buffer = (char *)malloc(sizeof(char) * (fsize + 1));
-    bzero(buffer, sizeof(char) * (fsize + 1));
-    vc_parser_init(&parser_inst, buffer);
-    parser_inst.file = params->file;
-    parser_inst.directives = params->directives;
-    
-    /* Read the file, and parse the contents. */
-    read(fd, buffer, fsize);
-    conf = vc_parse_stream(buffer, &parser_inst);
+    /* Nothing on the tape references the buffer, so it is freed as soon
+     * as the tape is built. */
+    buffer = (char *)vc_malloc(params->allocator, sizeof(char) * (fsize + 1));
+    if (!buffer) {
+        vc_report_error(params->errors, VC_ERROR_NO_MEMORY, 0);
+    } else {
+        nread = read(fd, buffer, fsize);
+        if (nread < 0) nread = 0;
+        tape = vc_parse_tape(buffer, (size_t)nread, params);
+        vc_free(params->allocator, buffer);
+    }
     close(fd);
-    
-    free(buffer);
-    
-    return conf;
-    
-err:
-    return 0;
+    return tape;
 }
 
-vc_sect *vc_parse_stream(char *buffer, vc_parser *parser) {
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static int vc_parse_run(char *buffer, size_t length, vc_parser *parser) {
     parser->ptr = buffer;
+    parser->start = buffer;
+    parser->end = buffer + length;
+    
+    /* The root section is made with the parser, and may not have been */
+    if (!parser->tape && !parser->sects[0].sect) {
+        VC_THROW_ERROR(NO_MEMORY, parser);
+    }
     
     /* Loop until we have no more tokens to parse, which indicates EOF */
     while (vc_parser_get_token(parser)) {
@@ -189,14 +382,14 @@ vc_sect *vc_parse_stream(char *buffer, vc_parser *parser) {
             PARSE(section);
         } 
         
-        /* If an identifier is parsed, then we assume assignment.  In
-         * the future, we will need to check directives before assuming
-         * assignment is taking place. */
+        /* If an identifier is parsed, it is either a directive or an
+         * assignment. */
         else ACCEPT(IDENTIFIER) {
-            vc_directive *d = is_directive(parser);
-            if (d) {
-                printf("Directive '%s' encountered.\n", d->name);
-                //handle_directive(d, parser);
+            vc_directive *d;
+            if (is_include(parser)) {
+                PARSE(include);
+            } else if ((d = is_directive(parser))) {
+                if (!handle_directive(parser, d)) goto err;
             } else {
                 PARSE(assignment);
             }
@@ -222,19 +415,106 @@ vc_sect *vc_parse_stream(char *buffer, vc_parser *parser) {
         VC_THROW_ERROR(NONZERO_DEPTH, parser, parser->depth);
     }
     
-    /* Return the root section */
-    return parser->sects[0].sect;
+    vc_hash_close(parser->sects[0].sect);
+    return 1;
 
 err:
-    /* Clean up the section(s) created */
-    vc_sect_destroy(parser->sects[0].sect);
     return 0;
 }
 
+static vc_sect *vc_parse_path(vc_params *params, fasthash_table *directives, vc_fragment *frag) {
+    int fd;
+    size_t fsize;
+    ssize_t nread;
+    char *buffer;
+    
+    if ((fd = open(params->file, O_RDONLY)) < 0) {
+        vc_report_error(params->errors, VC_ERROR_FILE, 0, params->file);
+        if (frag) vc_fragment_complete(frag, 0, 0);
+        return 0;
+    }
+    
+    /* Determine size of file */
+    fsize = lseek(fd, 0, SEEK_END);
+    lseek(fd, 0, SEEK_SET);
+    
+    /* Allocate a buffer to hold the file's contents.  Right now, we
+     * do single-chunk reads, as streaming isn't implemented yet.  The
+     * scanner is bounded by the length read, so the buffer needn't be
+     * zeroed or terminated. */
+    buffer = (char *)vc_malloc(params->allocator, sizeof(char) * (fsize + 1));
+    if (!buffer) {
+        vc_report_error(params->errors, VC_ERROR_NO_MEMORY, 0);
+        close(fd);
+        if (frag) vc_fragment_complete(frag, 0, 0);
+        return 0;
+    }
+    
+    /* Read the file, and parse the contents. */
+    nread = read(fd, buffer, fsize);
+    if (nread < 0) nread = 0;
+    close(fd);
+    return vc_parse_owned(params, directives, frag, buffer, (size_t)nread);
+}
 
-/**********************************************************************/
-/******** Static Function Definitions *********************************/
-/**********************************************************************/
+/* Parse a file's contents, read into a buffer from params->allocator,
+ * which the config takes over. */
+static vc_sect *vc_parse_owned(vc_params *params, fasthash_table *directives, vc_fragment *frag,
+                               char *buffer, size_t length) {
+    vc_parser parser_inst;
+    vc_sect *conf;
+    
+    vc_parser_init(&parser_inst, buffer, params, 0);
+    parser_inst.file = params->file;
+    parser_inst.owns = 1;
+    parser_inst.directives = directives;
+    parser_inst.frag = frag;
+    conf = vc_parse_stream(buffer, length, &parser_inst);
+    
+    /* A root config isn't loaded until everything it includes is, and
+     * sections including files are hashed once they are. */
+    if (conf && !frag && !vc_include_finish(&parser_inst)) {
+        vc_sect_destroy(conf);
+        conf = 0;
+    }
+    if (!frag) vc_hash_sect(conf);
+    
+    /* String values may reference the buffer, so the root section takes
+     * ownership of it, unless values were interned. */
+    if (conf && !(conf->root->flags & VC_ROOT_INTERN_VALUES)) {
+        conf->root->source = buffer;
+    } else {
+        vc_free(params->allocator, buffer);
+    }
+    
+    if (frag) {
+        vc_fragment_complete(frag, conf, &parser_inst);
+    } else {
+        free(parser_inst.deps);
+    }
+    return conf;
+}
+
+static void vc_batch_job(void *arg) {
+    vc_batch *batch = (vc_batch *)arg;
+    size_t i;
+    
+    while ((i = __atomic_fetch_add(&(batch->next), 1, __ATOMIC_RELAXED)) < batch->n) {
+        vc_errsink sink = {vc_error_record, 0};
+        vc_params params = {batch->paths[i], batch->opts->directives, batch->opts->flags, 0, batch->opts->allocator};
+        
+        /* Each file records its own first error, instead of printing */
+        if (batch->errors) {
+            batch->errors[i].type = VC_ERROR_SUCCESS;
+            batch->errors[i].msg[0] = '\0';
+            sink.ctx = &(batch->errors[i]);
+            params.errors = &sink;
+        }
+        
+        batch->confs[i] = vc_parse_path(&params, batch->directives, 0);
+        if (batch->confs[i]) __atomic_fetch_add(&(batch->loaded), 1, __ATOMIC_RELAXED);
+    }
+}
 
 /**********************************************************************/
 /************ Parse Subrules ******************************************/
@@ -250,7 +530,19 @@ DEF_PARSE_RULE(assignment) {
     EXPECT(ASSIGN) {
         REQUIRE(vc_parser_get_token(parser));
 
-        if (!vc_addoptn(parser->sects[parser->depth].sect, optname, optlength, &(parser->token))) {
+        /* A LBRACKET ([) here starts an array value */
+        ACCEPT(LBRACKET) {
+            return vc_parse_array(parser, optname, optlength);
+        }
+
+        if (bad_number(&(parser->token), !parser->tape)) {
+            VC_THROW_ERROR(NUMBER_RANGE, parser, (int)parser->token.length, parser->token.position);
+        }
+        if (parser->tape) {
+            if (!vc_tape_add(parser->tape, optname, optlength, &(parser->token))) {
+                VC_THROW_ERROR(UNEXPECTED, parser, vc_token_str[parser->token.type], parser->token.length, parser->token.position);
+            }
+        } else if (!vc_addoptn(parser->sects[parser->depth].sect, optname, optlength, &(parser->token))) {
             VC_THROW_ERROR(UNEXPECTED, parser, vc_token_str[parser->token.type], parser->token.length, parser->token.position);
         }
         return 1;
@@ -262,9 +554,10 @@ err:
 DEF_PARSE_RULE(section) {
     vc_token tok;
     tok.type = VC_TOKEN_SECT_BEGIN;
+    tok.flags = 0;
     
     /* Check for section end, which starts with a '/' */
-    if(*(parser->ptr) == '/') {
+    if (parser->ptr < parser->end && *(parser->ptr) == '/') {
         tok.type = VC_TOKEN_SECT_END;
         (parser->ptr)++;
     }
@@ -284,26 +577,36 @@ DEF_PARSE_RULE(section) {
             if (tok.type == VC_TOKEN_SECT_BEGIN) {
                 /* Don't allow depth overflow */
                 if (parser->depth == MAX_DEPTH) VC_THROW_ERROR(DEPTH_OVERFLOW, parser, MAX_DEPTH);
-                char *label = strndup(tok.position, tok.length + 1);
-                vc_opt *newsect_opt;
-                label[tok.length] = '\0';
-                newsect_opt = vc_addopt(parser->sects[parser->depth].sect, label, &tok);
+                vc_opt *newsect_opt = 0;
+                if (parser->tape) {
+                    if (!vc_tape_begin(parser->tape, tok.position, tok.length)) VC_THROW_ERROR(NO_MEMORY, parser);
+                } else {
+                    newsect_opt = vc_addoptn(parser->sects[parser->depth].sect, tok.position, tok.length, &tok);
+                    if (!newsect_opt) VC_THROW_ERROR(NO_MEMORY, parser);
+                }
                 parser->depth++;
                 parser->sects[parser->depth].position = tok.position;
                 parser->sects[parser->depth].length = tok.length;
-                parser->sects[parser->depth].sect = (vc_sect *)newsect_opt->value;
-                free(label);
+                parser->sects[parser->depth].sect = newsect_opt ? (vc_sect *)newsect_opt->value : 0;
             } else {
                 /* Otherwise, verify we're closing the most recently-opened section.
                  * Don't allow depth underflow */
                 if (parser->depth == 0) VC_THROW_ERROR(DEPTH_UNDERFLOW, parser);
-                if (strncmp(tok.position, parser->sects[parser->depth].position, tok.length)) {
+                if (tok.length != parser->sects[parser->depth].length ||
+                    memcmp(tok.position, parser->sects[parser->depth].position, tok.length)) {
                     VC_THROW_ERROR(SECT_MISMATCH, parser,
                         parser->sects[parser->depth].length, 
                         parser->sects[parser->depth].position,
                         tok.length, tok.position
                     );
                 }
+                if (parser->tape && !vc_tape_end(parser->tape)) VC_THROW_ERROR(NO_MEMORY, parser);
+                vc_hash_close(parser->sects[parser->depth].sect);
+                if (parser->sects[parser->depth].sect &&
+                    (parser->sects[parser->depth].sect->root->flags & VC_ROOT_SHARE_SECTIONS)) {
+                    vc_share_close(parser->sects[parser->depth - 1].sect, tok.position, tok.length,
+                                   parser->sects[parser->depth].sect);
+                }
                 parser->depth--;
             }
             return 1;
@@ -313,35 +616,145 @@ err:
     return 0;
 }
 
+DEF_PARSE_RULE(include) {
+    char pattern[PATH_MAX];
+    
+    /* Get the path, which may be a glob pattern */
+    REQUIRE(vc_parser_get_token(parser));
+    EXPECT(STRING) {
+        size_t length = parser->token.length;
+        if (length >= sizeof(pattern)) {
+            VC_THROW_ERROR(INCLUDE_FILE, parser, "<path too long>");
+        }
+        if (parser->token.flags & VC_TOKEN_F_DECODE) {
+            length = vc_string_decode(pattern, parser->token.position, length);
+        } else {
+            memcpy(pattern, parser->token.position, length);
+        }
+        pattern[length] = '\0';
+        
+        /* A tape records the include, rather than loading it */
+        if (parser->tape) {
+            if (!vc_tape_include(parser->tape, pattern, length)) VC_THROW_ERROR(NO_MEMORY, parser);
+            return 1;
+        }
+        return vc_include_add(parser, pattern);
+    }
+err:
+    return 0;
+}
+
+static int vc_parse_array(vc_parser *parser, char *optname, size_t optlength) {
+    const vc_allocator *alloc = parser->params->allocator;
+    vc_token stack_elems[ARRAY_STACK_ELEMS];
+    vc_token *elems = stack_elems;
+    size_t count = 0, capacity = ARRAY_STACK_ELEMS;
+    int want_value = 1;
+    
+    /* Collect element tokens until the closing RBRACKET (]).  Newlines
+     * and comments between elements are allowed, so long arrays can be
+     * split over several lines. */
+    for (;;) {
+        REQUIRE(vc_parser_get_token(parser));
+        
+        ACCEPT(NEWLINE) continue;
+        else ACCEPT(COMMENT) continue;
+        else ACCEPT(RBRACKET) break;
+        else if (!want_value) {
+            EXPECT(COMMA) want_value = 1;
+        } else if (parser->token.type == VC_TOKEN_INTEGER ||
+                   parser->token.type == VC_TOKEN_FLOAT ||
+                   parser->token.type == VC_TOKEN_STRING) {
+            /* Grow the staging area if needed */
+            if (count == capacity) {
+                vc_token *grown;
+                capacity *= 2;
+                if (elems == stack_elems) {
+                    grown = (vc_token *)vc_malloc(alloc, sizeof(vc_token) * capacity);
+                    if (grown) memcpy(grown, stack_elems, sizeof(stack_elems));
+                } else {
+                    grown = (vc_token *)vc_realloc(alloc, elems, sizeof(vc_token) * capacity);
+                }
+                if (!grown) VC_THROW_ERROR(NO_MEMORY, parser);
+                elems = grown;
+            }
+            if (bad_number(&(parser->token), 0)) {
+                VC_THROW_ERROR(NUMBER_RANGE, parser, (int)parser->token.length, parser->token.position);
+            }
+            elems[count++] = parser->token;
+            want_value = 0;
+        } else {
+            VC_THROW_ERROR(UNEXPECTED, parser, vc_token_str[parser->token.type], parser->token.length, parser->token.position);
+        }
+    }
+    
+    if (parser->tape) {
+        if (!vc_tape_add_array(parser->tape, optname, optlength, elems, count)) {
+            VC_THROW_ERROR(ARRAY_TYPE, parser);
+        }
+    } else if (!vc_addarrayn(parser->sects[parser->depth].sect, optname, optlength, elems, count)) {
+        VC_THROW_ERROR(ARRAY_TYPE, parser);
+    }
+    
+    if (elems != stack_elems) vc_free(alloc, elems);
+    return 1;
+    
+err:
+    if (elems != stack_elems) vc_free(alloc, elems);
+    return 0;
+}
+
 /**********************************************************************/
 /************ Helper functions ****************************************/
 /**********************************************************************/
 
-static void vc_parser_init(vc_parser *parser, char *data) {
+static void vc_parser_init(vc_parser *parser, char *data, vc_params *params, vc_tape_builder *tape) {
+    int flags = 0;
+    if (params->flags & VC_PARAM_INTERN_VALUES) flags |= VC_ROOT_INTERN_VALUES;
+    if (params->flags & VC_PARAM_SEEDED_HASH) flags |= VC_ROOT_SEEDED_HASH;
+    if (params->flags & VC_PARAM_PATH_INDEX) flags |= VC_ROOT_PATH_INDEX;
+    if (params->flags & VC_PARAM_KEY_INDEX) flags |= VC_ROOT_KEY_INDEX;
+    if (params->flags & VC_PARAM_SHARE_SECTIONS) flags |= VC_ROOT_SHARE_SECTIONS;
+    if (params->flags & VC_PARAM_LOOKUP_CACHE) flags |= VC_ROOT_LOOKUP_CACHE;
+    
     parser->ptr = data;     /* Initialize pointer to beginning of data */
+    parser->end = data;     /* Set along with the length, when parsing */
+    parser->start = data;
     parser->line = 1;       /* Initialize line counter to one */
     parser->depth = 0;      /* Initialize section depth to zero */
+    parser->owns = 0;       /* Strings are copied unless told otherwise */
+    parser->params = params;
+    parser->directives = 0;
+    parser->tape = tape;
+    parser->frag = 0;
+    parser->deps = 0;
+    parser->ndeps = parser->capdeps = 0;
     
     parser->sects[0].position = "root";
     parser->sects[0].length = 4;
-    parser->sects[0].sect = vc_root_sect();
+    parser->sects[0].sect = tape ? 0 : vc_root_sect(flags, params->allocator);
 }
 
 static int vc_parser_get_token(vc_parser *parser) {
     vc_token *token;
     #define PPTR (parser->ptr)
-    if (!parser || !*PPTR) return 0;
+    #define PEND (parser->end)
+    if (!parser || PPTR >= PEND) return 0;
     token = &(parser->token);
     
-    /* Skip all whitespace */
-    SKIP_WHITESPACE(parser->ptr);
+    /* Skip all whitespace.  Every read below is bounded by the end of the
+     * data, which needn't be NUL-terminated. */
+    SKIP_WHITESPACE(PPTR, PEND);
+    if (PPTR == PEND) return 0;
     token->position = parser->ptr;
+    token->flags = 0;
     
     /* Determine type of token */
     switch (*PPTR) {
         /* Test single-character tokens */
         case SINGLE_CHAR_TOKEN('\n', NEWLINE); parser->line++; break;
         case SINGLE_CHAR_TOKEN(';', SEMICOLON); break;
+        case SINGLE_CHAR_TOKEN(',', COMMA);     break;
         case SINGLE_CHAR_TOKEN('[', LBRACKET);  break;
         case SINGLE_CHAR_TOKEN(']', RBRACKET);  break;
         case SINGLE_CHAR_TOKEN('=', ASSIGN);    break;
@@ -349,19 +762,66 @@ static int vc_parser_get_token(vc_parser *parser) {
             token->type = VC_TOKEN_COMMENT;
             
             /* Ignore rest of the line */
-            while (*PPTR && *PPTR != '\n') PPTR++;
+            while (PPTR < PEND && *PPTR != '\n') PPTR++;
             token->length = (size_t)(PPTR - token->position);
         break;
         case '"': case '\'': {
             char c = *PPTR;
+            char *end = 0;
+            char *bad = 0;      /* First escape that isn't UTF-8 */
+            int validate = parser->params && (parser->params->flags & VC_PARAM_VALIDATE_UTF8);
             token->type = VC_TOKEN_STRING;
             PPTR++; (token->position)++;
-            while (*PPTR && *PPTR != '\n' && !(*PPTR == c && *(PPTR - 1) != '\\'))PPTR++;
-            token->length = (size_t)(PPTR - token->position);
-            if (*PPTR != c) {
+            
+            /* Scan the literal, and any literals adjacent to it, in a single
+             * pass.  Escapes are only validated here; they are decoded when
+             * the value is stored. */
+            for (;;) {
+                while (PPTR < PEND && *PPTR != '\n' && *PPTR != c) {
+                    if (*PPTR == '\\') {
+                        int n = escape_length(PPTR, PEND);
+                        if (!n) {
+                            token->type = VC_TOKEN_INVALID;
+                            break;
+                        }
+                        token->flags |= VC_TOKEN_F_DECODE;
+                        if (validate && !bad && !escape_is_utf8(PPTR)) bad = PPTR;
+                        PPTR += n;
+                    } else {
+                        PPTR++;
+                    }
+                }
+                if (PPTR == PEND || *PPTR != c) {
+                    token->type = VC_TOKEN_INVALID;
+                    break;
+                }
+                end = PPTR++;
+                
+                /* Continue with the next literal if one follows, possibly
+                 * on a following line. */
+                {
+                    char *next = PPTR;
+                    int lines = 0;
+                    while (next < PEND && (*next == ' ' || *next == '\t' || *next == '\n')) {
+                        if (*next == '\n') lines++;
+                        next++;
+                    }
+                    if (next == PEND || (*next != '"' && *next != '\'')) break;
+                    c = *next;
+                    PPTR = next + 1;
+                    parser->line += lines;
+                    token->flags |= VC_TOKEN_F_DECODE;
+                }
+            }
+            
+            if (token->type != VC_TOKEN_INVALID && validate && !string_is_utf8(parser, bad ? bad : end)) {
                 token->type = VC_TOKEN_INVALID;
+            }
+            if (token->type == VC_TOKEN_INVALID) {
+                token->length = (size_t)(PPTR - token->position);
             } else {
-                PPTR++;
+                token->length = (size_t)(end - token->position);
+                if (parser->owns) token->flags |= VC_TOKEN_F_BORROW;
             }
         } break;
         /* Test for floating point with leading decimal. */
@@ -374,19 +834,32 @@ static int vc_parser_get_token(vc_parser *parser) {
             //int has_decimal = 0;
             if (token->type != VC_TOKEN_FLOAT) token->type = VC_TOKEN_INTEGER;
             
-            while (*PPTR && *PPTR != ' ' && *PPTR != '\t' && *PPTR != '\n' && *PPTR != '#' && *PPTR != ';') {
+            while (PPTR < PEND && *PPTR != ' ' && *PPTR != '\t' && *PPTR != '\n' && *PPTR != '#' && *PPTR != ';' && *PPTR != ',' && *PPTR != ']') {
                 if (*PPTR == '.') {
                     if (token->type == VC_TOKEN_INTEGER) {
                         token->type = VC_TOKEN_FLOAT;
                     } else {
                         token->type = VC_TOKEN_INVALID;
                     }
+                } else if (*PPTR == '-' && PPTR == token->position) {
+                    /* Leading minus sign */
                 } else if ((*PPTR - '0') < 0 || (*PPTR - '0') > 9) {
                     token->type = VC_TOKEN_INVALID;
                 }
-                if (*PPTR) PPTR++;
+                PPTR++;
             }
             token->length = (size_t)(PPTR - token->position);
+
+            /* Not a plain number, but it may be one with a unit */
+            if (token->type == VC_TOKEN_INVALID) {
+                vc_unit_value unit;
+                switch (vc_unit_parse(token->position, token->length, &unit)) {
+                    case VC_DURATION: token->type = VC_TOKEN_DURATION; break;
+                    case VC_SIZE:     token->type = VC_TOKEN_SIZE; break;
+                    case VC_RATIO:    token->type = VC_TOKEN_RATIO; break;
+                    default: break;
+                }
+            }
         } break;
         default: {
             int boolval;    /* if we have a boolean value, 1 = true, 0 = false */
@@ -397,11 +870,11 @@ static int vc_parser_get_token(vc_parser *parser) {
             } else {
                 token->type = VC_TOKEN_INVALID;
             }
-            while (*PPTR && *PPTR != ' ' && *PPTR != '\t' && *PPTR != '\n' && *PPTR != '#' && *PPTR != ';' && *PPTR != ']') {
+            while (PPTR < PEND && *PPTR != ' ' && *PPTR != '\t' && *PPTR != '\n' && *PPTR != '#' && *PPTR != ';' && *PPTR != ',' && *PPTR != ']') {
                 if (!is_identifier_char(*PPTR)) {
                     token->type = VC_TOKEN_INVALID;
                 }
-                if (*PPTR) (PPTR)++;
+                (PPTR)++;
             }
             token->length = (size_t)(PPTR - token->position);
             
@@ -413,6 +886,7 @@ static int vc_parser_get_token(vc_parser *parser) {
         } break;
     }
     #undef PPTR
+    #undef PEND
     return 1;
 }
 
@@ -427,6 +901,59 @@ int strcincmp(char const *a, char const *b, int n)
     return 0;
 }
 
+/* Returns the length of a valid escape sequence starting at the
+ * backslash, or zero if it is not valid or runs past end.  An escape for
+ * NUL would cut the stored string short, so isn't valid.  Nor is a \u
+ * surrogate, unless it is a high one followed by a low one, which are
+ * taken together. */
+static int escape_length(char *str, char *end) {
+    uint32_t cp = 0, lo = 0;
+    int i, n;
+    if (end - str < 2) return 0;
+    switch (str[1]) {
+        case 'n': case 't': case 'r':
+        case '\\': case '\'': case '"':
+            return 2;
+        case 'x': n = 2; break;
+        case 'u': n = 4; break;
+        default: return 0;
+    }
+    if (end - str < n + 2) return 0;
+    for (i = 0; i < n; i++) {
+        if (!isxdigit((unsigned char)str[2 + i])) return 0;
+        cp = (cp << 4) | hex_digit(str[2 + i]);
+    }
+    if (!cp) return 0;
+    if (cp < 0xD800 || cp > 0xDFFF) return n + 2;
+    
+    if (cp > 0xDBFF || end - str < 12 || str[6] != '\\' || str[7] != 'u') return 0;
+    for (i = 0; i < 4; i++) {
+        if (!isxdigit((unsigned char)str[8 + i])) return 0;
+        lo = (lo << 4) | hex_digit(str[8 + i]);
+    }
+    return (lo >= 0xDC00 && lo <= 0xDFFF) ? 12 : 0;
+}
+
+/* Nonzero if an escape, which escape_length has accepted, decodes to
+ * valid UTF-8.  Only \x escapes above 0x7F don't, being lone bytes. */
+static int escape_is_utf8(char *str) {
+    return str[1] != 'x' || ((hex_digit(str[2]) << 4) | hex_digit(str[3])) < 0x80;
+}
+
+/* Check the string token being scanned, up to stop, and report the first
+ * byte that isn't valid UTF-8.  stop is the closing quote, or the first
+ * escape that isn't UTF-8, which is reported if nothing before it is. */
+static int string_is_utf8(vc_parser *parser, char *stop) {
+    vc_token *token = &(parser->token);
+    size_t length = (size_t)(stop - token->position);
+    size_t offset = vc_utf8_check(token->position, length);
+    
+    if (offset == length && *stop != '\\') return 1;
+    offset += (size_t)(token->position - parser->start);
+    vc_print_error(VC_ERROR_INVALID_UTF8, parser, offset);
+    return 0;
+}
+
 static unsigned char is_boolean(char *str, size_t length, int *boolval) {
     if (length == 1) {
         if (tolower(*str) == 'f' || tolower(*str) == 'n') {
@@ -453,45 +980,141 @@ static unsigned char is_boolean(char *str, size_t length, int *boolval) {
     return 0;
 }
 
-static vc_directive *is_directive(vc_parser *parser) {
-    vc_directive *dir = parser->directives;
-    if (!dir) return 0;
-    while (dir && dir->name) {
-        if (strlen(dir->name) != parser->token.length || 
-        strncmp(parser->token.position, dir->name, parser->token.length)) {dir++; continue;}
-        return dir;
-    }
-    return 0;
+/* An include statement is the identifier 'include' followed by a string,
+ * so 'include' can still be used as an option name. */
+static unsigned char is_include(vc_parser *parser) {
+    char *ptr = parser->ptr;
+    if (parser->token.length != 7 || strncmp(parser->token.position, "include", 7)) return 0;
+    
+    SKIP_WHITESPACE(ptr, parser->end);
+    return (ptr < parser->end && (*ptr == '"' || *ptr == '\'')) ? 1 : 0;
 }
 
-static unsigned char handle_directive(vc_parser *parser, vc_directive *d) {
-    return 0;
-#if 0
-    vc_list *args, *newarg, *argp;
-    char *a = d->format;
-    if (!a) {
-        d->func(parser->sects[parser->depth].sect, args);
-        return 1;
+/* A statement ends at a newline, semicolon or comment, or the end of the
+ * file, which the caller checks for */
+static int statement_end(vc_token *token) {
+    return token->type == VC_TOKEN_NEWLINE || token->type == VC_TOKEN_SEMICOLON ||
+           token->type == VC_TOKEN_COMMENT;
+}
+
+/* Scalar integers are stored as an int; array elements, and everything
+ * on a tape, as an int64_t */
+static int bad_number(vc_token *token, int scalar) {
+    int64_t i;
+    double f;
+    
+    switch (token->type) {
+        case VC_TOKEN_INTEGER:
+            return !vc_token_int(token, &i) || (scalar && (i < INT_MIN || i > INT_MAX));
+        case VC_TOKEN_FLOAT:
+            return !vc_token_float(token, &f);
+        default:
+            return 0;
     }
+}
+
+static vc_directive *is_directive(vc_parser *parser) {
+    return vc_directive_lookup(parser->directives, parser->token.position, parser->token.length);
+}
+
+/* Parse the arguments of a directive according to its format string,
+ * and call it.  Arguments are built on the stack; strings are referenced
+ * in place if possible, and otherwise copied into a stack buffer. */
+static int handle_directive(vc_parser *parser, vc_directive *d) {
+    vc_list args[VC_DIRECTIVE_MAXARGS];
+    union {
+        int i;
+        double f;
+    } vals[VC_DIRECTIVE_MAXARGS];
+    char strbuf[VC_DIRECTIVE_STRBUF];
+    size_t strused = 0;
+    int64_t i;
+    char *a;
+    int n, result;
     
-    while (*a) {
+    for (a = d->format, n = 0; *a && n < VC_DIRECTIVE_MAXARGS; a++, n++) {
+        vc_token *tok = &(parser->token);
+        if (!vc_parser_get_token(parser) || statement_end(tok)) {
+            VC_THROW_ERROR(DIRECTIVE_ARGS, parser, d->name, "too few");
+        }
+        
+        args[n].flags = 0;
+        args[n].next = &args[n + 1];
         switch (*a) {
             case 'i':
-                REQUIRE(vc_parser_get_token(parser));
                 EXPECT(INTEGER) {
-                    newarg = malloc(sizeof(vc_list));
+                    if (bad_number(tok, 1)) VC_THROW_ERROR(NUMBER_RANGE, parser, (int)tok->length, tok->position);
+                    vc_token_int(tok, &i);
+                    vals[n].i = (int)i;
+                    args[n].type = VC_INTEGER;
+                    args[n].value = &vals[n].i;
+                }
+            break;
+            case 'f':
+                if (tok->type != VC_TOKEN_INTEGER && tok->type != VC_TOKEN_FLOAT) {
+                    VC_THROW_ERROR(EXPECTED, parser, vc_token_str[VC_TOKEN_FLOAT], vc_token_str[tok->type]);
+                } else if (!vc_token_float(tok, &(vals[n].f))) {
+                    VC_THROW_ERROR(NUMBER_RANGE, parser, (int)tok->length, tok->position);
+                } else {
+                    args[n].type = VC_FLOAT;
+                    args[n].value = &vals[n].f;
+                }
+            break;
+            case 'b':
+                EXPECT(BOOLEAN) {
+                    vals[n].i = (int)tok->length;
+                    args[n].type = VC_BOOLEAN;
+                    args[n].value = &vals[n].i;
+                }
+            break;
+            case 's':
+                EXPECT(STRING) {
+                    char *v = tok->position;
+                    size_t length = tok->length;
                     
+                    if (!(tok->flags & VC_TOKEN_F_BORROW)) {
+                        if (strused + length + 1 > sizeof(strbuf)) {
+                            VC_THROW_ERROR(DIRECTIVE_ARGS, parser, d->name, "strings too long");
+                        }
+                        v = strbuf + strused;
+                    }
+                    if (tok->flags & VC_TOKEN_F_DECODE) {
+                        length = vc_string_decode(v, tok->position, length);
+                    } else if (v != tok->position) {
+                        memcpy(v, tok->position, length);
+                    }
+                    v[length] = '\0';
+                    if (v != tok->position) strused += length + 1;
+                    
+                    args[n].type = VC_STRING;
+                    args[n].value = v;
                 }
             break;
-            default: 
-                printf("Unexpected format value '%c'.\n", *a);
-                goto err;
+            default:
+                VC_THROW_ERROR(DIRECTIVE_FORMAT, parser, *a, d->name);
         }
     }
+    if (n) args[n - 1].next = 0;
+    
+    /* The statement must end with the last argument, so that extra ones
+     * aren't taken for statements of their own */
+    if (vc_parser_get_token(parser) && !statement_end(&(parser->token))) {
+        VC_THROW_ERROR(DIRECTIVE_ARGS, parser, d->name, "too many");
+    }
+    
+    result = d->func(parser->sects[parser->depth].sect, n ? args : 0);
+    if (result < 0) {
+        VC_THROW_ERROR(DIRECTIVE_FAILED, parser, d->name, result);
+    }
+    return 1;
+    
 err:
-    /* Clean up list */
     return 0;
-#endif
+}
+
+/* Value of a hex digit, which isxdigit has accepted */
+static inline uint32_t hex_digit(char c) {
+    return (uint32_t)(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
 }
 
 static unsigned char is_identifier_char(char c) {
@@ -0,0 +1,359 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcquery.c
+ *
+ * Path queries.  A query descends one segment at a time.  Through
+ * includes, a section is the merge of every section reached by the same
+ * path, in lookup order, so each level works on that list of sources.
+ * A name is matched from the first source that holds it, and a section
+ * name descends into the sections of that name in every source, as a
+ * lookup that misses in the first falls through to the rest.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcquery.h"
+#include "vcimage.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+
+/* Segment of a query */
+typedef struct vc_query_seg {
+    const char *str;            /* Name, or prefix if a pattern */
+    size_t length;              /* Length of str */
+    int pattern;                /* Matches names starting with str */
+} vc_query_seg;
+
+/* A name matched at one level, and where it leads */
+typedef struct vc_query_match {
+    const char *key;            /* Matched name */
+    vc_opt *opt;                /* Option of the first source holding it */
+    vc_sect **srcs;             /* Sections of that name, in lookup order */
+    size_t nsrcs, capsrcs;
+} vc_query_match;
+
+/* Query in progress */
+typedef struct vc_query_state {
+    vc_query_seg *segs;         /* Segments of the pattern */
+    size_t nsegs;
+    vc_query_cb cb;
+    void *ctx;
+    int sorted;                 /* Search sections' sorted keys */
+
+    char *path;                 /* Path of the current match */
+    size_t cap;
+
+    long matches;               /* Matches visited so far */
+    int stop;                   /* Callback asked to stop */
+    int failed;                 /* Memory ran out */
+} vc_query_state;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+/* Matching */
+static void vc_query_sects(vc_query_state *q, vc_sect **srcs, size_t nsrcs, size_t seg, size_t plen);
+static void vc_query_image(vc_query_state *q, vc_sect *sect, size_t seg, size_t plen);
+static int vc_query_add(vc_query_state *q, vc_query_match **matches, size_t *n, size_t *cap,
+                        fasthash_table *seen, int literal, const char *key, vc_opt *opt, int last);
+static size_t vc_query_path(vc_query_state *q, size_t plen, const char *key, size_t length);
+static void vc_query_emit(vc_query_state *q, vc_type type, void *value);
+
+/* Sorted keys */
+static vc_keys *vc_keys_get(vc_sect *sect);
+static vc_keys *vc_keys_build(vc_sect *sect);
+static size_t vc_keys_lower(vc_keys *keys, const char *str, size_t length);
+static int vc_keys_cmp(const void *a, const void *b);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+long vc_query(vc_sect *sect, const char *pattern, vc_query_cb cb, void *ctx) {
+    vc_query_state q;
+    vc_sect **srcs = 0;
+    size_t nsrcs = 0, capsrcs = 0, i;
+    const char *ptr;
+
+    if (!sect || !pattern || !*pattern) return -1;
+
+    bzero(&q, sizeof(q));
+    for (q.nsegs = 1, ptr = pattern; *ptr; ptr++) q.nsegs += (*ptr == '.');
+    q.segs = (vc_query_seg *)malloc(q.nsegs * sizeof(vc_query_seg));
+    if (!q.segs) return -1;
+
+    for (i = 0, ptr = pattern; i < q.nsegs; i++) {
+        const char *end = ptr;
+        while (*end && *end != '.') end++;
+        q.segs[i].str = ptr;
+        q.segs[i].length = end - ptr;
+        q.segs[i].pattern = (end > ptr && end[-1] == '*');
+        if (q.segs[i].pattern) q.segs[i].length--;
+        ptr = end + 1;
+    }
+    q.cb = cb;
+    q.ctx = ctx;
+    q.sorted = sect->root && (sect->root->flags & VC_ROOT_KEY_INDEX);
+
+    if (sect->root && sect->root->image) {
+        vc_query_image(&q, sect, 0, 0);
+    } else if (sect->ht) {
+        if (vc_sect_sources(sect, &srcs, &nsrcs, &capsrcs)) {
+            vc_query_sects(&q, srcs, nsrcs, 0, 0);
+        } else {
+            q.failed = 1;
+        }
+    }
+
+    free(srcs);
+    free(q.path);
+    free(q.segs);
+    return q.failed ? -1 : q.matches;
+}
+
+void vc_keys_drop(vc_sect *sect) {
+    index_node *in;
+    fasthash_node *node;
+
+    /* Shared sections don't change, so their keys stay sorted */
+    if (!sect || !sect->ht || sect->shared) return;
+
+    if (sect->keys) {
+        vc_free(VC_SECT_ALLOC(sect), sect->keys->nodes);
+        vc_free(VC_SECT_ALLOC(sect), sect->keys);
+        sect->keys = 0;
+    }
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            if (opt->type == VC_SECTION) vc_keys_drop((vc_sect *)opt->value);
+        }
+    }
+}
+
+void vc_keys_stats(vc_sect *sect, vc_stats *stats) {
+    vc_keys *keys = __atomic_load_n(&(sect->keys), __ATOMIC_ACQUIRE);
+    if (keys) stats->keys_bytes += sizeof(vc_keys) + keys->length * sizeof(fasthash_node *);
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Match segment seg against the merged sources of a parsed section,
+ * which is reached by the path of length plen. */
+static void vc_query_sects(vc_query_state *q, vc_sect **srcs, size_t nsrcs, size_t seg, size_t plen) {
+    vc_query_seg *s = &(q->segs[seg]);
+    int last = (seg + 1 == q->nsegs);
+    vc_query_match *matches = 0;
+    size_t nmatches = 0, capmatches = 0, i, j;
+    fasthash_table *seen = 0;
+    fasthash_node *node;
+    index_node *in;
+    vc_keys *keys;
+
+    /* With a single source, every name is distinct */
+    if (s->pattern && nsrcs > 1 && !(seen = fasthash_init(64, 0, 0, 0, 0))) {
+        q->failed = 1;
+        return;
+    }
+
+    for (i = 0; i < nsrcs && !q->failed; i++) {
+        if (!s->pattern) {
+            node = fasthash_lookupn(srcs[i]->ht, (char *)s->str, s->length);
+            if (node && !vc_query_add(q, &matches, &nmatches, &capmatches, 0, 1, node->key, node->data, last)) break;
+        } else if (q->sorted && (keys = vc_keys_get(srcs[i]))) {
+            for (j = vc_keys_lower(keys, s->str, s->length); j < keys->length; j++) {
+                node = keys->nodes[j];
+                if (strncmp(node->key, s->str, s->length)) break;
+                if (!vc_query_add(q, &matches, &nmatches, &capmatches, seen, 0, node->key, node->data, last)) break;
+            }
+        } else {
+            for (in = srcs[i]->ht->index_list; in && !q->failed; in = in->next) {
+                for (node = srcs[i]->ht->entries[in->index]; node; node = node->next) {
+                    if (strncmp(node->key, s->str, s->length)) continue;
+                    if (!vc_query_add(q, &matches, &nmatches, &capmatches, seen, 0, node->key, node->data, last)) break;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < nmatches && !q->stop && !q->failed; i++) {
+        size_t length = vc_query_path(q, plen, matches[i].key, strlen(matches[i].key));
+        if (q->failed) break;
+        if (last) vc_query_emit(q, matches[i].opt->type, matches[i].opt->value);
+        else vc_query_sects(q, matches[i].srcs, matches[i].nsrcs, seg + 1, length);
+    }
+
+    for (i = 0; i < nmatches; i++) free(matches[i].srcs);
+    free(matches);
+    fasthash_cleanup(seen);
+}
+
+/* Image sections are merged and sorted when published, so each level is
+ * a single section, searched directly. */
+static void vc_query_image(vc_query_state *q, vc_sect *sect, size_t seg, size_t plen) {
+    vc_query_seg *s = &(q->segs[seg]);
+    int last = (seg + 1 == q->nsegs);
+    vc_image_entry *entries;
+    size_t count, i, length;
+    vc_type type;
+    void *value;
+
+    if (!s->pattern) {
+        if (!(value = vc_image_getvaln(sect, (char *)s->str, s->length, &type))) return;
+        if (!last && type != VC_SECTION) return;
+        length = vc_query_path(q, plen, s->str, s->length);
+        if (q->failed) return;
+        if (last) vc_query_emit(q, type, value);
+        else vc_query_image(q, (vc_sect *)value, seg + 1, length);
+        return;
+    }
+
+    entries = vc_image_range(sect, s->str, s->length, &count);
+    for (i = 0; i < count && !q->stop && !q->failed; i++) {
+        value = vc_image_value(sect, &(entries[i]), &type);
+        if (!last && type != VC_SECTION) continue;
+        length = vc_query_path(q, plen, sect->root->image->base + entries[i].key, entries[i].keylen);
+        if (q->failed) return;
+        if (last) vc_query_emit(q, type, value);
+        else vc_query_image(q, (vc_sect *)value, seg + 1, length);
+    }
+}
+
+/* Record a name matched in a source.  The first source holding a name
+ * decides its option; every section of the name is descended into.
+ * Names are told apart by seen, unless they can only be the same one (a
+ * literal segment) or are all distinct (a single source).  Returns zero
+ * if the query failed. */
+static int vc_query_add(vc_query_state *q, vc_query_match **matches, size_t *n, size_t *cap,
+                        fasthash_table *seen, int literal, const char *key, vc_opt *opt, int last) {
+    vc_query_match *m;
+    fasthash_node *prev = 0;
+
+    /* Past the last segment, only sections lead anywhere */
+    if (!last && opt->type != VC_SECTION) return 1;
+
+    if (seen && (prev = fasthash_lookup(seen, (char *)key))) {
+        m = &((*matches)[(size_t)prev->data - 1]);
+        if (last) return 1;
+    } else if (literal && *n) {
+        m = &((*matches)[0]);
+        if (last) return 1;
+    } else {
+        if (*n == *cap) {
+            size_t grown = *cap ? *cap * 2 : 8;
+            vc_query_match *list = (vc_query_match *)realloc(*matches, grown * sizeof(vc_query_match));
+            if (!list) goto fail;
+            *matches = list;
+            *cap = grown;
+        }
+        m = &((*matches)[(*n)++]);
+        bzero(m, sizeof(vc_query_match));
+        m->key = key;
+        m->opt = opt;
+        if (seen && fasthash_insert(seen, (char *)key, (void *)*n) >= seen->size) goto fail;
+    }
+
+    if (!last && !vc_sect_sources((vc_sect *)opt->value, &(m->srcs), &(m->nsrcs), &(m->capsrcs))) goto fail;
+    return 1;
+
+fail:
+    q->failed = 1;
+    return 0;
+}
+
+/* Append a name to the path of length plen.  Returns the new length. */
+static size_t vc_query_path(vc_query_state *q, size_t plen, const char *key, size_t length) {
+    size_t need = plen + length + 2;
+
+    if (need > q->cap) {
+        char *path = (char *)realloc(q->path, need * 2);
+        if (!path) {
+            q->failed = 1;
+            return 0;
+        }
+        q->path = path;
+        q->cap = need * 2;
+    }
+    if (plen) q->path[plen++] = '.';
+    memcpy(q->path + plen, key, length);
+    q->path[plen + length] = '\0';
+    return plen + length;
+}
+
+static void vc_query_emit(vc_query_state *q, vc_type type, void *value) {
+    q->matches++;
+    if (q->cb && q->cb(q->path, type, value, q->ctx)) q->stop = 1;
+}
+
+/* Get the sorted keys of a section, sorting them if needed.  Readers may
+ * race to sort them; the first one does. */
+static vc_keys *vc_keys_get(vc_sect *sect) {
+    vc_keys *keys = __atomic_load_n(&(sect->keys), __ATOMIC_ACQUIRE);
+    if (keys || !sect->root) return keys;
+
+    pthread_mutex_lock(&(sect->root->index_lock));
+    keys = sect->keys;
+    if (!keys) {
+        keys = vc_keys_build(sect);
+        __atomic_store_n(&(sect->keys), keys, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&(sect->root->index_lock));
+    return keys;
+}
+
+static vc_keys *vc_keys_build(vc_sect *sect) {
+    const vc_allocator *alloc = VC_SECT_ALLOC(sect);
+    vc_keys *keys = (vc_keys *)vc_malloc(alloc, sizeof(vc_keys));
+    index_node *in;
+    fasthash_node *node;
+    size_t n = 0;
+
+    if (!keys) return 0;
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) n++;
+    }
+    keys->nodes = (fasthash_node **)vc_malloc(alloc, (n ? n : 1) * sizeof(fasthash_node *));
+    if (!keys->nodes) {
+        vc_free(alloc, keys);
+        return 0;
+    }
+
+    keys->length = 0;
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            keys->nodes[keys->length++] = node;
+        }
+    }
+    qsort(keys->nodes, keys->length, sizeof(fasthash_node *), vc_keys_cmp);
+    return keys;
+}
+
+/* First key not less than the given prefix */
+static size_t vc_keys_lower(vc_keys *keys, const char *str, size_t length) {
+    size_t lo = 0, hi = keys->length;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(keys->nodes[mid]->key, str, length) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int vc_keys_cmp(const void *a, const void *b) {
+    return strcmp((*(fasthash_node **)a)->key, (*(fasthash_node **)b)->key);
+}
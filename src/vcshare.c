@@ -0,0 +1,264 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcshare.c
+ *
+ * Shared sections.  The store is a table of sections by content hash,
+ * and two roots which own them: one for configs with seeded hashes and
+ * one for the rest.  The roots have no pool, as readers look up keys in
+ * shared sections without the store's lock, and a pool grows as others
+ * are added.  Each shared table copies its keys, and never changes once
+ * it is in the store.  Finding, adding and removing sections happen
+ * under the store's lock.  References are counted atomically, as one is
+ * only taken without the lock by a holder of another, and the count only
+ * reaches zero under the lock.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcshare.h"
+#include "vcdiff.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define STORE_SIZE  256     /* Initial buckets; the table grows */
+
+/* Length of a key in a section's table */
+#define KEY_LENGTH(sect, key) \
+    ((sect)->ht->pool ? FH_STRING(key)->length : strlen(key))
+
+typedef struct vc_share_store {
+    pthread_mutex_t lock;
+    vc_sect *roots[2];          /* Owners of shared sections: unseeded, seeded */
+    vc_sect **buckets;          /* Shared sections by content hash */
+    size_t size;                /* Number of buckets, a power of two */
+    size_t count;               /* Number of shared sections */
+} vc_share_store;
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+static vc_share_store store = {PTHREAD_MUTEX_INITIALIZER, {0, 0}, 0, 0, 0};
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static int vc_share_ready(vc_sect *sect);
+static vc_sect *vc_share_find(vc_sect *sect, vc_root *root);
+static int vc_share_equal(vc_sect *a, vc_sect *b);
+static void vc_share_insert(vc_sect *sect);
+static void vc_share_grow(void);
+
+/* Copy sect's options into a new section of root.  Subsections are
+ * referenced, not copied. */
+static vc_sect *vc_share_dup(vc_root *root, vc_sect *parent, vc_sect *sect, uint32_t size);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+void vc_share_close(vc_sect *parent, const char *name, size_t length, vc_sect *sect) {
+    int seeded = !!(sect->root->flags & VC_ROOT_SEEDED_HASH);
+    fasthash_node *node = fasthash_lookupn(parent->ht, (char *)name, length);
+    vc_opt *opt = node ? (vc_opt *)node->data : 0;
+    vc_sect *shared = 0;
+
+    if (!opt || opt->value != sect || !vc_share_ready(sect)) return;
+
+    pthread_mutex_lock(&(store.lock));
+    if (!store.roots[seeded]) {
+        store.roots[seeded] = vc_root_sect(VC_ROOT_COPY_KEYS | (seeded ? VC_ROOT_SEEDED_HASH : 0), 0);
+    }
+    if (store.roots[seeded]) {
+        if ((shared = vc_share_find(sect, store.roots[seeded]->root))) {
+            __atomic_add_fetch(&(shared->refs), 1, __ATOMIC_RELAXED);
+        } else {
+            /* Shared tables are sized to what they hold, as nothing is
+             * added to them */
+            uint32_t size = sect->ht->count + sect->ht->count / 2 + 1;
+            if (store.count >= store.size) vc_share_grow();
+            if (store.buckets && (shared = vc_share_dup(store.roots[seeded]->root, 0, sect, size))) {
+                shared->shared = 1;
+                shared->refs = 1;
+                vc_share_insert(shared);
+            }
+        }
+    }
+    pthread_mutex_unlock(&(store.lock));
+
+    if (!shared) return;
+    opt->value = shared;
+    vc_sect_destroy(sect);
+}
+
+void vc_share_release(vc_sect *sect) {
+    vc_sect **link;
+
+    pthread_mutex_lock(&(store.lock));
+    if (__atomic_sub_fetch(&(sect->refs), 1, __ATOMIC_ACQ_REL)) {
+        pthread_mutex_unlock(&(store.lock));
+        return;
+    }
+    for (link = &(store.buckets[sect->hash.lo & (store.size - 1)]); *link != sect; link = &((*link)->next));
+    *link = sect->next;
+    store.count--;
+    pthread_mutex_unlock(&(store.lock));
+
+    /* Its subsections are released as its table is torn down */
+    sect->shared = 0;
+    vc_sect_destroy(sect);
+}
+
+vc_sect *vc_share_copy(vc_sect *parent, vc_sect *sect) {
+    return vc_share_dup(parent->root, parent, sect, 256);
+}
+
+size_t vc_share_count(void) {
+    size_t count;
+
+    pthread_mutex_lock(&(store.lock));
+    count = store.count;
+    pthread_mutex_unlock(&(store.lock));
+    return count;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* A section can be shared once it is hashed, includes nothing, and its
+ * subsections are shared */
+static int vc_share_ready(vc_sect *sect) {
+    index_node *in;
+    fasthash_node *node;
+
+    if (!sect->hashed || sect->includes) return 0;
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            if (opt->type == VC_SECTION && !((vc_sect *)opt->value)->shared) return 0;
+        }
+    }
+    return 1;
+}
+
+static vc_sect *vc_share_find(vc_sect *sect, vc_root *root) {
+    vc_sect *match;
+
+    if (!store.buckets) return 0;
+    for (match = store.buckets[sect->hash.lo & (store.size - 1)]; match; match = match->next) {
+        if (match->hash.lo == sect->hash.lo && match->hash.hi == sect->hash.hi &&
+            match->root == root && vc_share_equal(sect, match)) {
+            return match;
+        }
+    }
+    return 0;
+}
+
+/* Subsections of both are shared, so equal ones are the same section */
+static int vc_share_equal(vc_sect *a, vc_sect *b) {
+    index_node *in;
+    fasthash_node *node, *other;
+
+    if (a->ht->count != b->ht->count) return 0;
+    for (in = a->ht->index_list; in; in = in->next) {
+        for (node = a->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data, *match;
+
+            other = fasthash_lookupn(b->ht, node->key, KEY_LENGTH(a, node->key));
+            if (!other) return 0;
+            match = (vc_opt *)other->data;
+            if (opt->type == VC_SECTION) {
+                if (match->type != VC_SECTION || match->value != opt->value) return 0;
+            } else if (!vc_diff_equal(opt, match)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static void vc_share_insert(vc_sect *sect) {
+    vc_sect **bucket = &(store.buckets[sect->hash.lo & (store.size - 1)]);
+
+    sect->next = *bucket;
+    *bucket = sect;
+    store.count++;
+}
+
+/* Double the buckets.  If that fails, chains just get longer. */
+static void vc_share_grow(void) {
+    size_t size = store.size ? store.size * 2 : STORE_SIZE, i;
+    vc_sect **buckets = (vc_sect **)calloc(size, sizeof(vc_sect *));
+    vc_sect *sect, *next;
+
+    if (!buckets) return;
+    for (i = 0; i < store.size; i++) {
+        for (sect = store.buckets[i]; sect; sect = next) {
+            next = sect->next;
+            sect->next = buckets[sect->hash.lo & (size - 1)];
+            buckets[sect->hash.lo & (size - 1)] = sect;
+        }
+    }
+    free(store.buckets);
+    store.buckets = buckets;
+    store.size = size;
+}
+
+/* Subsections are added as errors first, and only referenced once the
+ * copy is complete, so that a failed copy can be freed without releasing
+ * them, which would take the store's lock. */
+static vc_sect *vc_share_dup(vc_root *root, vc_sect *parent, vc_sect *sect, uint32_t size) {
+    vc_sect *copy = vc_sect_create_sized(root, parent, size);
+    const vc_allocator *alloc = root->alloc;
+    index_node *in;
+    fasthash_node *node;
+
+    if (!copy) return 0;
+    if (!copy->ht) goto err;
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data, *dup;
+
+            if (opt->type == VC_SECTION) {
+                if (!(dup = (vc_opt *)vc_malloc(alloc, sizeof(vc_opt)))) goto err;
+                dup->type = VC_ERROR;
+                dup->flags = 0;
+                dup->value = opt->value;
+            } else if (!(dup = vc_opt_copy(copy, opt))) {
+                goto err;
+            }
+            if (fasthash_insertn(copy->ht, node->key, KEY_LENGTH(sect, node->key), dup) >= copy->ht->size) {
+                vc_opt_destroy(dup, alloc);
+                goto err;
+            }
+        }
+    }
+
+    for (in = copy->ht->index_list; in; in = in->next) {
+        for (node = copy->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            if (opt->type != VC_ERROR) continue;
+            opt->type = VC_SECTION;
+            __atomic_add_fetch(&(((vc_sect *)opt->value)->refs), 1, __ATOMIC_RELAXED);
+        }
+    }
+    copy->hash = sect->hash;
+    copy->hashed = sect->hashed;
+    return copy;
+
+err:
+    vc_sect_destroy(copy);
+    return 0;
+}
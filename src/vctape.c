@@ -0,0 +1,275 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vctape.c
+ *
+ * Tape building and lookup.  Entries and strings grow in two buffers
+ * while parsing, and are packed behind a single header when done.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "vctape.h"
+#include "vcunit.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define TAPE_ENTRIES    256     /* Initial entries; the tape grows */
+#define TAPE_STRINGS    4096    /* Initial string bytes */
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static vc_tape_entry *vc_tape_push(vc_tape_builder *b, uint32_t type);
+static int vc_tape_string(vc_tape_builder *b, vc_tape_entry *e, const char *str, size_t length, int decode);
+static int vc_tape_value(vc_tape_builder *b, vc_token *token, uint32_t as);
+static uint32_t vc_tape_token_type(vc_token *token);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+void vc_tape_free(vc_tape *tape) {
+    if (tape) vc_free(tape->alloc, tape);
+}
+
+/* Options are KEY/value pairs; stepping over each value skips whole
+ * subtrees.  A later definition overrides an earlier one. */
+size_t vc_tape_lookup(const vc_tape *tape, size_t sect, const char *optpath) {
+    const char *end;
+    size_t i, found;
+
+    for (;;) {
+        if (sect >= tape->length || tape->entries[sect].type != VC_TAPE_SECTION) return 0;
+
+        for (end = optpath; *end && *end != '.'; end++);
+        found = 0;
+        for (i = sect + 1; i < tape->length && tape->entries[i].type != VC_TAPE_END; ) {
+            const vc_tape_entry *e = &(tape->entries[i]);
+            if (e->type != VC_TAPE_KEY) {
+                i = VC_TAPE_NEXT(tape, i);
+                continue;
+            }
+            if (e->length == (size_t)(end - optpath) && !memcmp(VC_TAPE_STR(tape, e), optpath, e->length)) {
+                found = i + 1;
+            }
+            i = VC_TAPE_NEXT(tape, i + 1);
+        }
+
+        if (!found || !*end) return found;
+        sect = found;
+        optpath = end + 1;
+    }
+}
+
+int vc_tape_init(vc_tape_builder *b, const vc_allocator *alloc) {
+    bzero(b, sizeof(vc_tape_builder));
+    b->alloc = alloc;
+    b->entries = (vc_tape_entry *)vc_malloc(alloc, TAPE_ENTRIES * sizeof(vc_tape_entry));
+    b->strings = (char *)vc_malloc(alloc, TAPE_STRINGS);
+    if (!b->entries || !b->strings) {
+        vc_tape_discard(b);
+        return 0;
+    }
+    b->cap = TAPE_ENTRIES;
+    b->capstrings = TAPE_STRINGS;
+
+    /* The root section, ended by vc_tape_finish */
+    vc_tape_push(b, VC_TAPE_SECTION);
+    b->open[0] = 0;
+    return 1;
+}
+
+int vc_tape_add(vc_tape_builder *b, const char *key, size_t keylen, vc_token *token) {
+    vc_tape_entry *k = vc_tape_push(b, VC_TAPE_KEY);
+    uint32_t type = vc_tape_token_type(token);
+
+    if (!k || !type || !vc_tape_string(b, k, key, keylen, 0)) return 0;
+    return vc_tape_value(b, token, type);
+}
+
+/* Elements are of one type, except that integers among floats are
+ * stored as floats, as in vc_array. */
+int vc_tape_add_array(vc_tape_builder *b, const char *key, size_t keylen, vc_token *tokens, size_t count) {
+    vc_tape_entry *k = vc_tape_push(b, VC_TAPE_KEY);
+    uint32_t type = 0;
+    size_t i, index;
+
+    if (!k || !vc_tape_string(b, k, key, keylen, 0)) return 0;
+
+    for (i = 0; i < count; i++) {
+        uint32_t t = vc_tape_token_type(&(tokens[i]));
+        if (t == VC_TAPE_BOOLEAN || !t) return 0;
+        if (!type || type == t) type = t;
+        else if ((type == VC_TAPE_INTEGER && t == VC_TAPE_FLOAT) ||
+                 (type == VC_TAPE_FLOAT && t == VC_TAPE_INTEGER)) type = VC_TAPE_FLOAT;
+        else return 0;
+    }
+
+    if (!vc_tape_push(b, VC_TAPE_ARRAY)) return 0;
+    index = b->length - 1;
+    b->entries[index].length = (uint32_t)count;
+    for (i = 0; i < count; i++) {
+        if (!vc_tape_value(b, &(tokens[i]), type)) return 0;
+    }
+    b->entries[index].v.next = b->length;
+    return 1;
+}
+
+int vc_tape_begin(vc_tape_builder *b, const char *key, size_t keylen) {
+    vc_tape_entry *k = vc_tape_push(b, VC_TAPE_KEY);
+
+    if (!k || !vc_tape_string(b, k, key, keylen, 0)) return 0;
+    if (b->depth == MAX_DEPTH || !vc_tape_push(b, VC_TAPE_SECTION)) return 0;
+    b->open[++(b->depth)] = b->length - 1;
+    return 1;
+}
+
+int vc_tape_end(vc_tape_builder *b) {
+    vc_tape_entry *e;
+    size_t begin;
+
+    if (!b->depth || !(e = vc_tape_push(b, VC_TAPE_END))) return 0;
+    begin = b->open[(b->depth)--];
+    e->v.next = begin;
+    b->entries[begin].v.next = b->length;
+    return 1;
+}
+
+int vc_tape_include(vc_tape_builder *b, const char *pattern, size_t length) {
+    vc_tape_entry *e = vc_tape_push(b, VC_TAPE_INCLUDE);
+    return e && vc_tape_string(b, e, pattern, length, 0);
+}
+
+vc_tape *vc_tape_finish(vc_tape_builder *b) {
+    size_t header = (sizeof(vc_tape) + 7) & ~(size_t)7;
+    vc_tape_entry *e;
+    vc_tape *tape = 0;
+
+    /* Close the root, then copy both buffers behind the header */
+    if (!b->depth && (e = vc_tape_push(b, VC_TAPE_END))) {
+        e->v.next = 0;
+        b->entries[0].v.next = b->length;
+        tape = (vc_tape *)vc_malloc(b->alloc, header + b->length * sizeof(vc_tape_entry) + b->size);
+    }
+    if (tape) {
+        tape->alloc = b->alloc;
+        tape->entries = (vc_tape_entry *)((char *)tape + header);
+        tape->length = b->length;
+        tape->strings = (char *)(tape->entries + tape->length);
+        tape->size = b->size;
+        memcpy(tape->entries, b->entries, b->length * sizeof(vc_tape_entry));
+        memcpy(tape->strings, b->strings, b->size);
+    }
+    vc_tape_discard(b);
+    return tape;
+}
+
+void vc_tape_discard(vc_tape_builder *b) {
+    vc_free(b->alloc, b->entries);
+    vc_free(b->alloc, b->strings);
+    bzero(b, sizeof(vc_tape_builder));
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Append an entry.  The pointer is only valid until the next push. */
+static vc_tape_entry *vc_tape_push(vc_tape_builder *b, uint32_t type) {
+    vc_tape_entry *e;
+
+    if (b->length == b->cap) {
+        size_t cap = b->cap * 2;
+        vc_tape_entry *grown = (vc_tape_entry *)vc_realloc(b->alloc, b->entries, cap * sizeof(vc_tape_entry));
+        if (!grown) return 0;
+        b->entries = grown;
+        b->cap = cap;
+    }
+    e = &(b->entries[b->length++]);
+    e->type = type;
+    e->length = 0;
+    e->v.i = 0;
+    return e;
+}
+
+/* Copy a string into the string buffer, decoding escapes if asked, and
+ * point an entry at it. */
+static int vc_tape_string(vc_tape_builder *b, vc_tape_entry *e, const char *str, size_t length, int decode) {
+    size_t index = e - b->entries;
+
+    if (b->size + length + 1 > b->capstrings) {
+        size_t cap = (b->size + length + 1) * 2;
+        char *grown = (char *)vc_realloc(b->alloc, b->strings, cap);
+        if (!grown) return 0;
+        b->strings = grown;
+        b->capstrings = cap;
+    }
+    if (decode) {
+        length = vc_string_decode(b->strings + b->size, str, length);
+    } else {
+        memcpy(b->strings + b->size, str, length);
+    }
+    b->strings[b->size + length] = '\0';
+
+    e = &(b->entries[index]);
+    e->v.off = b->size;
+    e->length = (uint32_t)length;
+    b->size += length + 1;
+    return 1;
+}
+
+/* Append a value entry for a token, of the given tape type */
+static int vc_tape_value(vc_tape_builder *b, vc_token *token, uint32_t as) {
+    vc_tape_entry *e = vc_tape_push(b, as);
+    vc_unit_value unit;
+
+    if (!e) return 0;
+    switch (as) {
+        case VC_TAPE_BOOLEAN:
+            e->v.i = token->length;
+        break;
+        case VC_TAPE_INTEGER:
+            if (!vc_token_int(token, &(e->v.i))) return 0;
+        break;
+        case VC_TAPE_FLOAT:
+            if (!vc_token_float(token, &(e->v.f))) return 0;
+        break;
+        case VC_TAPE_STRING:
+            return vc_tape_string(b, e, token->position, token->length, token->flags & VC_TOKEN_F_DECODE);
+        case VC_TAPE_DURATION:
+        case VC_TAPE_SIZE:
+        case VC_TAPE_RATIO:
+            if (!vc_unit_parse(token->position, token->length, &unit)) return 0;
+            if (as == VC_TAPE_RATIO) e->v.f = unit.f;
+            else e->v.i = unit.i;
+        break;
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+/* Tape type of a value token, or zero if it isn't a value */
+static uint32_t vc_tape_token_type(vc_token *token) {
+    switch (token->type) {
+        case VC_TOKEN_BOOLEAN: return VC_TAPE_BOOLEAN;
+        case VC_TOKEN_INTEGER: return VC_TAPE_INTEGER;
+        case VC_TOKEN_FLOAT:   return VC_TAPE_FLOAT;
+        case VC_TOKEN_STRING:  return VC_TAPE_STRING;
+        case VC_TOKEN_DURATION: return VC_TAPE_DURATION;
+        case VC_TOKEN_SIZE:    return VC_TAPE_SIZE;
+        case VC_TOKEN_RATIO:   return VC_TAPE_RATIO;
+        default:               return 0;
+    }
+}
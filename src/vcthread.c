@@ -0,0 +1,189 @@
+/* 
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcthread.c
+ * 
+ * Worker thread pool for VConfig.  Jobs are run in FIFO order by a fixed
+ * number of threads.  A thread waiting on the results of jobs can help
+ * run queued jobs, so jobs may safely wait on other jobs.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "vcthread.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define MAX_THREADS 64      /* Upper bound on default thread count */
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static void *vc_threadpool_worker(void *arg);
+static vc_job *vc_threadpool_take(vc_threadpool *pool);
+static void vc_threadpool_done(vc_threadpool *pool);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+vc_threadpool *vc_threadpool_create(int nthreads) {
+    vc_threadpool *pool;
+    int i;
+    
+    if (nthreads <= 0) {
+        nthreads = vc_cpu_count();
+        if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    }
+    
+    pool = (vc_threadpool *)malloc(sizeof(vc_threadpool));
+    if (!pool) return 0;
+    
+    bzero(pool, sizeof(vc_threadpool));
+    pthread_mutex_init(&pool->lock, 0);
+    pthread_cond_init(&pool->ready, 0);
+    pthread_cond_init(&pool->idle, 0);
+    
+    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * nthreads);
+    if (!pool->threads) goto err;
+    
+    for (i = 0; i < nthreads; i++) {
+        if (pthread_create(&pool->threads[i], 0, vc_threadpool_worker, pool)) break;
+        pool->nthreads++;
+    }
+    if (!pool->nthreads) goto err;
+    
+    return pool;
+    
+err:
+    free(pool->threads);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+    return 0;
+}
+
+void vc_threadpool_destroy(vc_threadpool *pool) {
+    int i;
+    if (!pool) return;
+    
+    vc_threadpool_wait(pool);
+    
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (i = 0; i < pool->nthreads; i++) {
+        pthread_join(pool->threads[i], 0);
+    }
+    
+    free(pool->threads);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int vc_threadpool_submit(vc_threadpool *pool, vc_job_fn fn, void *arg) {
+    vc_job *job = (vc_job *)malloc(sizeof(vc_job));
+    if (!job) return 0;
+    
+    job->fn = fn;
+    job->arg = arg;
+    job->next = 0;
+    
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail) pool->tail->next = job;
+    else pool->head = job;
+    pool->tail = job;
+    pool->pending++;
+    pthread_cond_signal(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+    
+    return 1;
+}
+
+int vc_threadpool_run_one(vc_threadpool *pool) {
+    vc_job *job;
+    
+    pthread_mutex_lock(&pool->lock);
+    job = vc_threadpool_take(pool);
+    pthread_mutex_unlock(&pool->lock);
+    if (!job) return 0;
+    
+    job->fn(job->arg);
+    free(job);
+    vc_threadpool_done(pool);
+    return 1;
+}
+
+void vc_threadpool_wait(vc_threadpool *pool) {
+    while (vc_threadpool_run_one(pool));
+    
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int vc_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static void *vc_threadpool_worker(void *arg) {
+    vc_threadpool *pool = (vc_threadpool *)arg;
+    vc_job *job;
+    
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->head && !pool->stop) {
+            pthread_cond_wait(&pool->ready, &pool->lock);
+        }
+        if (!pool->head) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        job = vc_threadpool_take(pool);
+        pthread_mutex_unlock(&pool->lock);
+        
+        job->fn(job->arg);
+        free(job);
+        vc_threadpool_done(pool);
+    }
+    return 0;
+}
+
+/* Dequeue the next job.  Must be called with the lock held. */
+static vc_job *vc_threadpool_take(vc_threadpool *pool) {
+    vc_job *job = pool->head;
+    if (!job) return 0;
+    
+    pool->head = job->next;
+    if (!pool->head) pool->tail = 0;
+    return job;
+}
+
+static void vc_threadpool_done(vc_threadpool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    if (!--pool->pending) pthread_cond_broadcast(&pool->idle);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -10,19 +10,42 @@
 /**********************************************************************/
 /**** Includes ********************************************************/
 /**********************************************************************/
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include "vctype.h"
 #include "vcparse.h"
+#include "vcinclude.h"
+#include "vcimage.h"
+#include "vcedit.h"
+#include "vcindex.h"
+#include "vcquery.h"
+#include "vcdiff.h"
+#include "vcunit.h"
+#include "vcshare.h"
 
 /**********************************************************************/
 /**** Macro Definitions ***********************************************/
 /**********************************************************************/
+#define NUMBUF_SIZE 64  /* Largest numeric token we convert */
 
 /**********************************************************************/
 /**** Static Function Prototypes **************************************/
 /**********************************************************************/
+/* Copy a numeric token into a NUL-terminated buffer for conversion.
+ * Returns NULL if it doesn't fit. */
+static char *vc_token_numstr(vc_token *token, char *buffer);
+
+/* String escape helpers */
+static uint32_t vc_hex_value(const char *str, int digits);
+static int vc_utf8_encode(char *out, uint32_t cp);
+
+/* Walk the sections for a pre-hashed option path */
+static vc_opt *vc_getopt_keywalk(vc_sect *sect, const vc_key *segs, uint32_t n);
+
 /* Create/Destroy VConfig option containers */
 /**********************************************************************/
 /**** Function Definitions ********************************************/
@@ -32,123 +55,496 @@
 /******** API Function Definitions ************************************/
 /**********************************************************************/
 
-vc_sect *vc_root_sect(void) {
-    return vc_sect_create();
+vc_sect *vc_root_sect(int flags, const vc_allocator *alloc) {
+    vc_root *root = (vc_root *)vc_malloc(alloc, sizeof(vc_root));
+    if (!root) return 0;
+    
+    root->alloc = alloc;
+    root->flags = flags;
+    root->source = 0;
+    root->image = 0;
+    root->generation = vc_generation_new();
+    root->index = 0;
+    root->pool = 0;
+    if (!(flags & VC_ROOT_COPY_KEYS)) {
+        root->pool = fasthash_pool_init(256, (flags & VC_ROOT_SEEDED_HASH) ? FH_KEYED : 0, alloc);
+    }
+    root->sect = 0;
+    if (root->pool || (flags & VC_ROOT_COPY_KEYS)) root->sect = vc_sect_create(root, 0);
+    if (!root->sect) {
+        fasthash_pool_cleanup(root->pool);
+        vc_free(alloc, root);
+        return 0;
+    }
+    vc_lock_init(root);
+    pthread_mutex_init(&(root->index_lock), 0);
+    
+    return root->sect;
 }
 
-vc_opt *vc_opt_create(vc_token *token) {
-    vc_opt *opt = (vc_opt *)malloc(sizeof(vc_opt));
-    opt->value = 0;
+vc_opt *vc_opt_create(vc_sect *sect, vc_token *token) {
+    const vc_allocator *alloc = VC_SECT_ALLOC(sect);
+    vc_opt *opt = (vc_opt *)vc_malloc(alloc, sizeof(vc_opt));
     if (!opt) return 0;
+    opt->flags = 0;
+    opt->value = 0;
     
     switch (token->type) {
         case VC_TOKEN_SECT_BEGIN:
             opt->type = VC_SECTION;
-            opt->value = vc_sect_create();
+            opt->value = vc_sect_create(sect->root, sect);
         break;
         case VC_TOKEN_BOOLEAN: {
-            int *v = malloc(sizeof(int));
+            int *v = vc_malloc(alloc, sizeof(int));
+            if (!v) break;
             *v = token->length;
+            opt->type = VC_BOOLEAN;
             opt->value = v;
         } break;
         case VC_TOKEN_INTEGER: case VC_TOKEN_FLOAT: {
-            char str[32];
-            strncpy(str, token->position, token->length);
-            str[token->length] = '\0';
+            double f;
+            int64_t i;
             if (token->type == VC_TOKEN_FLOAT) {
-                double *v = malloc(sizeof(double));
-                *v = atof(str);
+                double *v;
+                if (!vc_token_float(token, &f)) break;
+                if (!(v = vc_malloc(alloc, sizeof(double)))) break;
+                *v = f;
                 opt->type = VC_FLOAT;
                 opt->value = v; 
             } else {
-                int *v = malloc(sizeof(int));
-                *v = atoi(str);
+                int *v;
+                if (!vc_token_int(token, &i) || i < INT_MIN || i > INT_MAX) break;
+                if (!(v = vc_malloc(alloc, sizeof(int)))) break;
+                *v = (int)i;
                 opt->type = VC_INTEGER;
                 opt->value = v;
             }
         } break;
         case VC_TOKEN_STRING: {
-            char *v = (char *)malloc(sizeof(char) * (token->length + 1));
-            strncpy(v, token->position, token->length);
-            v[token->length] = '\0';
+            char *v = token->position;
+            size_t length = token->length;
+            
+            /* Strings within a buffer owned by the config are referenced
+             * in place; the closing quote is overwritten with the NUL
+             * terminator.  Otherwise, we need our own copy. */
+            if (token->flags & VC_TOKEN_F_BORROW) {
+                opt->flags |= VC_OPT_BORROWED;
+            } else {
+                v = (char *)vc_malloc(alloc, sizeof(char) * (length + 1));
+                if (!v) break;
+            }
+            
+            if (token->flags & VC_TOKEN_F_DECODE) {
+                length = vc_string_decode(v, token->position, length);
+            } else if (v != token->position) {
+                memcpy(v, token->position, length);
+            }
+            v[length] = '\0';
+            
+            /* Interned values belong to the pool, so any copy we made is
+             * no longer needed. */
+            if (sect->root && (sect->root->flags & VC_ROOT_INTERN_VALUES)) {
+                char *pooled = fasthash_intern(sect->root->pool, v, length);
+                if (!(opt->flags & VC_OPT_BORROWED)) vc_free(alloc, v);
+                if (!pooled) break;
+                opt->flags |= VC_OPT_BORROWED | VC_OPT_POOLED;
+                v = pooled;
+            }
             opt->type = VC_STRING;
             opt->value = v;
         } break;
+        case VC_TOKEN_DURATION: case VC_TOKEN_SIZE: case VC_TOKEN_RATIO: {
+            /* An int64_t or a double, both held in the union */
+            vc_unit_value *v = vc_malloc(alloc, sizeof(vc_unit_value));
+            if (!v) break;
+            opt->type = vc_unit_parse(token->position, token->length, v);
+            opt->value = v;
+            if (opt->type == VC_ERROR) {
+                vc_free(alloc, v);
+                opt->value = 0;
+            }
+        } break;
         default:
         break;
     }
     
     if (opt->value) return opt;
     
-    free(opt); 
+    vc_free(alloc, opt); 
     return 0;
 }
 
-void vc_opt_destroy(void *data) {
+vc_opt *vc_opt_copy(vc_sect *sect, vc_opt *src) {
+    const vc_allocator *alloc = VC_SECT_ALLOC(sect);
+    vc_opt *opt = (vc_opt *)vc_malloc(alloc, sizeof(vc_opt));
+    if (!opt) return 0;
+    opt->type = src->type;
+    opt->flags = 0;
+    opt->value = 0;
+    
+    switch (src->type) {
+        case VC_BOOLEAN:
+        case VC_INTEGER: {
+            int *v = vc_malloc(alloc, sizeof(int));
+            if (v) *v = *((int *)src->value);
+            opt->value = v;
+        } break;
+        case VC_FLOAT: {
+            double *v = vc_malloc(alloc, sizeof(double));
+            if (v) *v = *((double *)src->value);
+            opt->value = v;
+        } break;
+        case VC_DURATION:
+        case VC_SIZE:
+        case VC_RATIO: {
+            vc_unit_value *v = vc_malloc(alloc, sizeof(vc_unit_value));
+            if (v) *v = *((vc_unit_value *)src->value);
+            opt->value = v;
+        } break;
+        case VC_STRING: {
+            char *str = (char *)src->value;
+            if (sect->root && (sect->root->flags & VC_ROOT_INTERN_VALUES)) {
+                opt->value = fasthash_intern(sect->root->pool, str, strlen(str));
+                if (opt->value) opt->flags |= VC_OPT_BORROWED | VC_OPT_POOLED;
+            } else {
+                opt->value = vc_strndup(alloc, str, strlen(str));
+            }
+        } break;
+        case VC_ARRAY:
+            opt->value = vc_array_copy((vc_array *)src->value, alloc);
+        break;
+        default:
+        break;
+    }
+    
+    if (opt->value) return opt;
+    
+    vc_free(alloc, opt);
+    return 0;
+}
+
+void vc_opt_destroy(void *data, const vc_allocator *alloc) {
     vc_opt *opt = (vc_opt *)data;
     if (!data) return;
     
     switch(opt->type) {
         case VC_BOOLEAN:
         case VC_INTEGER:
-            free((int *)opt->value);
+            vc_free(alloc, (int *)opt->value);
+        break;
+        case VC_FLOAT:
+            vc_free(alloc, (double *)opt->value);
+        break;
+        case VC_DURATION:
+        case VC_SIZE:
+        case VC_RATIO:
+            vc_free(alloc, (vc_unit_value *)opt->value);
         break;
         case VC_STRING:
-            free((char *)opt->value);
+            if (opt->flags & VC_OPT_POOLED) fasthash_release((char *)opt->value);
+            else if (!(opt->flags & VC_OPT_BORROWED)) vc_free(alloc, (char *)opt->value);
         break;
         case VC_SECTION:
             vc_sect_destroy((vc_sect *)opt->value);
         break;
+        case VC_ARRAY:
+            vc_array_destroy((vc_array *)opt->value, alloc);
+        break;
         default:
         break;
     }
     
-    free(opt);
+    vc_free(alloc, opt);
+}
+
+/* Build a packed array from a list of value tokens.  All tokens must be
+ * of the same type, except that integers and floats may be mixed, in
+ * which case every element is stored as a float.  Returns NULL if the
+ * element types are incompatible, or a number is out of range. */
+vc_array *vc_array_create(vc_token *tokens, size_t count, const vc_allocator *alloc) {
+    vc_array *arr;
+    vc_type type = VC_ERROR;
+    size_t i, size = 0;
+    char *bytes;
+    
+    /* Determine the element type and the size of the payload */
+    for (i = 0; i < count; i++) {
+        vc_type t;
+        switch (tokens[i].type) {
+            case VC_TOKEN_INTEGER: t = VC_INTEGER; break;
+            case VC_TOKEN_FLOAT: t = VC_FLOAT; break;
+            case VC_TOKEN_STRING: 
+                t = VC_STRING;
+                size += tokens[i].length + 1;
+            break;
+            default: return 0;
+        }
+        
+        if (type == VC_ERROR || type == t) {
+            type = t;
+        } else if ((type == VC_INTEGER && t == VC_FLOAT) ||
+                   (type == VC_FLOAT && t == VC_INTEGER)) {
+            type = VC_FLOAT;
+        } else {
+            return 0;
+        }
+    }
+    
+    switch (type) {
+        case VC_INTEGER: size = sizeof(int64_t) * count; break;
+        case VC_FLOAT: size = sizeof(double) * count; break;
+        case VC_STRING: size += sizeof(char *) * count; break;
+        default: break;
+    }
+    
+    /* Header and elements share a single allocation */
+    arr = (vc_array *)vc_malloc(alloc, sizeof(vc_array) + size);
+    if (!arr) return 0;
+    arr->type = type;
+    arr->length = count;
+    arr->v.data = (void *)(arr + 1);
+    
+    bytes = (char *)(arr->v.strs + count);
+    for (i = 0; i < count; i++) {
+        switch (type) {
+            case VC_INTEGER:
+                if (!vc_token_int(&tokens[i], &(arr->v.ints[i]))) goto err;
+            break;
+            case VC_FLOAT:
+                if (!vc_token_float(&tokens[i], &(arr->v.floats[i]))) goto err;
+            break;
+            case VC_STRING: {
+                size_t length = tokens[i].length;
+                arr->v.strs[i] = bytes;
+                if (tokens[i].flags & VC_TOKEN_F_DECODE) {
+                    length = vc_string_decode(bytes, tokens[i].position, length);
+                } else {
+                    memcpy(bytes, tokens[i].position, length);
+                }
+                bytes[length] = '\0';
+                bytes += length + 1;
+            } break;
+            default: break;
+        }
+    }
+    
+    return arr;
+
+err:
+    vc_free(alloc, arr);
+    return 0;
+}
+
+/* Copy an array.  The copy is a single allocation, like the original,
+ * so string pointers are rebased onto it. */
+vc_array *vc_array_copy(vc_array *arr, const vc_allocator *alloc) {
+    vc_array *copy;
+    size_t size, i;
+    
+    switch (arr->type) {
+        case VC_INTEGER: size = sizeof(int64_t) * arr->length; break;
+        case VC_FLOAT: size = sizeof(double) * arr->length; break;
+        case VC_STRING: {
+            char *last = arr->v.strs[arr->length - 1];
+            size = (last + strlen(last) + 1) - (char *)arr->v.data;
+        } break;
+        default: size = 0; break;
+    }
+    
+    copy = (vc_array *)vc_malloc(alloc, sizeof(vc_array) + size);
+    if (!copy) return 0;
+    memcpy(copy, arr, sizeof(vc_array) + size);
+    copy->v.data = (void *)(copy + 1);
+    
+    if (arr->type == VC_STRING) {
+        for (i = 0; i < arr->length; i++) {
+            copy->v.strs[i] = (char *)copy + (arr->v.strs[i] - (char *)arr);
+        }
+    }
+    return copy;
+}
+
+void vc_array_destroy(vc_array *arr, const vc_allocator *alloc) {
+    vc_free(alloc, arr);
+}
+
+/* Decode a raw string token.  The token spans from just after the
+ * opening quote of the first literal to just before the closing quote
+ * of the last, so any quote found here ends one literal, and the next
+ * begins at the following quote. */
+size_t vc_string_decode(char *dst, const char *src, size_t length) {
+    const char *end = src + length;
+    char quote = src[-1];   /* Opening quote of the first literal */
+    char *out = dst;
+    
+    while (src < end) {
+        if (*src == quote) {
+            src++;
+            while (*src != '"' && *src != '\'') src++;
+            quote = *src++;
+        } else if (*src != '\\') {
+            *out++ = *src++;
+        } else {
+            switch (src[1]) {
+                case 'n': *out++ = '\n'; src += 2; break;
+                case 't': *out++ = '\t'; src += 2; break;
+                case 'r': *out++ = '\r'; src += 2; break;
+                case 'x':
+                    *out++ = (char)vc_hex_value(src + 2, 2);
+                    src += 4;
+                break;
+                case 'u': {
+                    uint32_t cp = vc_hex_value(src + 2, 4);
+                    src += 6;
+                    
+                    /* Combine UTF-16 surrogate pairs */
+                    if (cp >= 0xD800 && cp <= 0xDBFF && end - src >= 6 &&
+                        src[0] == '\\' && src[1] == 'u') {
+                        uint32_t lo = vc_hex_value(src + 2, 4);
+                        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                            src += 6;
+                        }
+                    }
+                    out += vc_utf8_encode(out, cp);
+                } break;
+                default:
+                    /* \\, \' and \" */
+                    *out++ = src[1];
+                    src += 2;
+                break;
+            }
+        }
+    }
+    
+    return (size_t)(out - dst);
 }
 
 /* Add a new VConfig option value within a VConfig section */
 vc_opt *vc_addopt(vc_sect *sect, char *name, vc_token *token) {
-    vc_opt *opt = vc_opt_create(token);
+    return vc_addoptn(sect, name, strlen(name), token);
+}
+
+/* Add a new VConfig option value within a VConfig section.  A later
+ * definition of a name replaces an earlier one. */
+vc_opt *vc_addoptn(vc_sect *sect, char *name, size_t length, vc_token *token) {
+    vc_opt *opt = vc_opt_create(sect, token);
+    void *old;
     if (!opt) return 0;
     
-    fasthash_insert(sect->ht, name, opt);
+    if (fasthash_replacen(sect->ht, name, length, opt, &old) >= sect->ht->size) {
+        vc_opt_destroy(opt, VC_SECT_ALLOC(sect));
+        return 0;
+    }
+    vc_opt_destroy(old, VC_SECT_ALLOC(sect));
+    vc_hash_drop(sect);
     return opt;
 }
 
-/* Add a new VConfig option value within a VConfig section */
-vc_opt *vc_addoptn(vc_sect *sect, char *name, size_t length, vc_token *token) {
-    vc_opt *opt = vc_opt_create(token);
-    printf("opt: %p\n", opt);
+/* Add a new VConfig array value within a VConfig section */
+vc_opt *vc_addarrayn(vc_sect *sect, char *name, size_t length, vc_token *tokens, size_t count) {
+    vc_opt *opt = (vc_opt *)vc_malloc(VC_SECT_ALLOC(sect), sizeof(vc_opt));
+    void *old;
     if (!opt) return 0;
     
-    fasthash_insertn(sect->ht, name, length, opt);
+    opt->type = VC_ARRAY;
+    opt->flags = 0;
+    opt->value = vc_array_create(tokens, count, VC_SECT_ALLOC(sect));
+    if (!opt->value) {
+        vc_free(VC_SECT_ALLOC(sect), opt);
+        return 0;
+    }
+    
+    if (fasthash_replacen(sect->ht, name, length, opt, &old) >= sect->ht->size) {
+        vc_opt_destroy(opt, VC_SECT_ALLOC(sect));
+        return 0;
+    }
+    vc_opt_destroy(old, VC_SECT_ALLOC(sect));
+    vc_hash_drop(sect);
     return opt;
 }
 
-/* Get VConfig option, within the container. */
+/* Get VConfig option, within the container.  From the root of an
+ * indexed config, this is a single probe of the index. */
 vc_opt *vc_getopt(vc_sect *sect, char *optpath) {
-    char *ptr = optpath;
+    fasthash_table *index;
+    fasthash_node *node;
+    
+    /* Images have no vc_opt containers */
+    if (!sect->ht) return NULL;
+    
+    if ((sect->root->flags & VC_ROOT_PATH_INDEX) && sect->root->sect == sect &&
+        (index = vc_index_get(sect->root))) {
+        node = fasthash_lookup(index, optpath);
+        return node ? (vc_opt *)node->data : NULL;
+    }
+    return vc_getopt_walk(sect, optpath);
+}
+
+vc_opt *vc_getoptn(vc_sect *sect, char *optpath, size_t length) {
+    fasthash_table *index;
     fasthash_node *node;
+    
+    if (!sect->ht) return NULL;
+    
+    if ((sect->root->flags & VC_ROOT_PATH_INDEX) && sect->root->sect == sect &&
+        (index = vc_index_get(sect->root))) {
+        node = fasthash_lookupn(index, optpath, length);
+        return node ? (vc_opt *)node->data : NULL;
+    }
+    return vc_getopt_walkn(sect, optpath, length);
+}
+
+vc_opt *vc_getopt_walk(vc_sect *sect, char *optpath) {
+    return vc_getopt_walkn(sect, optpath, strlen(optpath));
+}
+
+/* Options not found in the section itself are searched for in its
+ * included files, in the order they were included. */
+vc_opt *vc_getopt_walkn(vc_sect *sect, char *optpath, size_t length) {
+    char *ptr = optpath, *end = optpath + length;
+    fasthash_node *node;
+    vc_include *inc;
     vc_opt *opt;
     
-    while (*ptr && *ptr != '.') ptr++;
+    if (!sect->ht) return NULL;
+    
+    while (ptr < end && *ptr != '.') ptr++;
     node = fasthash_lookupn(sect->ht, optpath, ptr - optpath);
-    if (!node) return NULL; /* Optpath not found */
-    opt = node->data;
-    
-    if (*ptr && opt->type != VC_SECTION) {
-        /* If *ptr != 0 and we aren't at a section, then we don't return
-         * anything as our query won't be matched. */
-        return NULL;
-    } else if (*ptr && opt->type == VC_SECTION) {
-        /* Recurse into the next section. */
-        return vc_getopt((vc_sect *)opt->value, ptr + 1);
-    } else {
-        return opt;
+    if (node) {
+        opt = node->data;
+        if (ptr == end) return opt;
+        
+        /* Recurse into the next section.  If the option path continues
+         * past something that isn't a section, it won't be matched. */
+        if (opt->type == VC_SECTION) {
+            opt = vc_getopt_walkn((vc_sect *)opt->value, ptr + 1, end - ptr - 1);
+            if (opt) return opt;
+        }
+    }
+    
+    for (inc = sect->includes; inc; inc = inc->next) {
+        if (!inc->frag->sect) continue;
+        opt = vc_getopt_walkn(inc->frag->sect, optpath, length);
+        if (opt) return opt;
     }
     return NULL;
 }
 
+vc_opt *vc_getopt_key(vc_sect *sect, const vc_keypath *kp) {
+    fasthash_table *index;
+    fasthash_node *node;
+    
+    if (!sect->ht) return NULL;
+    
+    if ((sect->root->flags & VC_ROOT_PATH_INDEX) && sect->root->sect == sect &&
+        (index = vc_index_get(sect->root))) {
+        node = fasthash_lookup_hashed(index, (char *)kp->path.key, kp->path.length, kp->path.hash);
+        return node ? (vc_opt *)node->data : NULL;
+    }
+    return vc_getopt_keywalk(sect, kp->segs, kp->nsegs);
+}
+
 /* Get VConfig option value.  You must know the type ahead of time for
  * this one. */
 void *vc_getval(vc_sect *sect, char *optpath) {
@@ -157,22 +553,254 @@ void *vc_getval(vc_sect *sect, char *optpath) {
     return NULL;
 }
 
+void *vc_sect_getval(vc_sect *sect, char *optpath, vc_type *type) {
+    vc_opt *opt;
+    
+    if (sect->root && sect->root->image) return vc_image_getval(sect, optpath, type);
+    
+    opt = vc_getopt(sect, optpath);
+    if (!opt) return NULL;
+    *type = opt->type;
+    return opt->value;
+}
+
+void *vc_sect_getvaln(vc_sect *sect, char *optpath, size_t length, vc_type *type) {
+    vc_opt *opt;
+    
+    if (sect->root && sect->root->image) return vc_image_getvaln(sect, optpath, length, type);
+    
+    opt = vc_getoptn(sect, optpath, length);
+    if (!opt) return NULL;
+    *type = opt->type;
+    return opt->value;
+}
+
+void *vc_sect_getval_key(vc_sect *sect, const vc_keypath *kp, vc_type *type) {
+    vc_opt *opt;
+    
+    if (sect->root && sect->root->image) return vc_image_getvaln(sect, (char *)kp->path.key, kp->path.length, type);
+    
+    opt = vc_getopt_key(sect, kp);
+    if (!opt) return NULL;
+    *type = opt->type;
+    return opt->value;
+}
+
+int vc_sect_sources(vc_sect *sect, vc_sect ***srcs, size_t *n, size_t *cap) {
+    vc_include *inc;
+    
+    if (*n == *cap) {
+        size_t grown = *cap ? *cap * 2 : 4;
+        vc_sect **list = (vc_sect **)realloc(*srcs, grown * sizeof(vc_sect *));
+        if (!list) return 0;
+        *srcs = list;
+        *cap = grown;
+    }
+    (*srcs)[(*n)++] = sect;
+    
+    for (inc = sect->includes; inc; inc = inc->next) {
+        if (inc->frag->sect && !vc_sect_sources(inc->frag->sect, srcs, n, cap)) return 0;
+    }
+    return 1;
+}
+
 /**********************************************************************/
 /******** Static Function Definitions *********************************/
 /**********************************************************************/
 
-vc_sect *vc_sect_create(void) {
-    vc_sect *sect = (vc_sect *)malloc(sizeof(vc_sect));
+/* As vc_getopt_walk, with each segment hashed ahead of time */
+static vc_opt *vc_getopt_keywalk(vc_sect *sect, const vc_key *segs, uint32_t n) {
+    fasthash_node *node;
+    vc_include *inc;
+    vc_opt *opt;
+    
+    if (!sect->ht) return NULL;
+    
+    node = fasthash_lookup_hashed(sect->ht, (char *)segs->key, segs->length, segs->hash);
+    if (node) {
+        opt = node->data;
+        if (n == 1) return opt;
+        if (opt->type == VC_SECTION) {
+            opt = vc_getopt_keywalk((vc_sect *)opt->value, segs + 1, n - 1);
+            if (opt) return opt;
+        }
+    }
+    
+    for (inc = sect->includes; inc; inc = inc->next) {
+        if (!inc->frag->sect) continue;
+        opt = vc_getopt_keywalk(inc->frag->sect, segs, n);
+        if (opt) return opt;
+    }
+    return NULL;
+}
+
+static uint32_t vc_hex_value(const char *str, int digits) {
+    uint32_t value = 0;
+    for (; digits; digits--, str++) {
+        char c = *str;
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+    }
+    return value;
+}
+
+static int vc_utf8_encode(char *out, uint32_t cp) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+int vc_token_int(vc_token *token, int64_t *value) {
+    char str[NUMBUF_SIZE], *end;
+    long long v;
+    
+    if (!vc_token_numstr(token, str)) return 0;
+    errno = 0;
+    v = strtoll(str, &end, 10);
+    if (errno || end == str || *end) return 0;
+    *value = v;
+    return 1;
+}
+
+int vc_token_float(vc_token *token, double *value) {
+    char str[NUMBUF_SIZE], *end;
+    double v;
+    
+    if (!vc_token_numstr(token, str)) return 0;
+    errno = 0;
+    v = strtod(str, &end);
+    
+    /* Underflow leaves a usable value; overflow doesn't */
+    if ((errno == ERANGE && (v == HUGE_VAL || v == -HUGE_VAL)) || end == str || *end) return 0;
+    *value = v;
+    return 1;
+}
+
+static char *vc_token_numstr(vc_token *token, char *buffer) {
+    if (token->length > NUMBUF_SIZE - 1) return 0;
+    
+    memcpy(buffer, token->position, token->length);
+    buffer[token->length] = '\0';
+    return buffer;
+}
+
+vc_sect *vc_sect_create(vc_root *root, vc_sect *parent) {
+    return vc_sect_create_sized(root, parent, 256);
+}
+
+vc_sect *vc_sect_create_sized(vc_root *root, vc_sect *parent, uint32_t size) {
+    const vc_allocator *alloc = root ? root->alloc : 0;
+    vc_sect *sect = (vc_sect *)vc_malloc(alloc, sizeof(vc_sect));
+    uint32_t opts = 0;
     if (!sect) return 0;
     
-    sect->ht = fasthash_init(256, 0, vc_opt_destroy);
+    /* Without a pool to hash them, keys of a seeded root are hashed by
+     * each table under its own seed */
+    if (root && !root->pool && (root->flags & VC_ROOT_SEEDED_HASH)) opts = FH_KEYED;
+    sect->ht = fasthash_init(size, opts, vc_opt_destroy, root ? root->pool : 0, alloc);
+    if (!sect->ht) {
+        vc_free(alloc, sect);
+        return 0;
+    }
+    sect->root = root;
+    sect->parent = parent;
+    sect->includes = 0;
+    sect->keys = 0;
+    sect->hash.lo = 0;
+    sect->hash.hi = 0;
+    sect->hashed = 0;
+    sect->shared = 0;
+    sect->refs = 0;
+    sect->next = 0;
     
     return sect;
 }
 
 void vc_sect_destroy(vc_sect *sect) {
+    const vc_allocator *alloc;
+    vc_include *inc, *next;
     if (!sect) return;
     
+    /* Image sections are handles into a mapping, released all at once
+     * with the root. */
+    if (sect->root && sect->root->image) {
+        if (sect->root->sect == sect) vc_image_detach(sect);
+        return;
+    }
+    
+    /* Shared sections go with their last reference */
+    if (sect->shared) {
+        vc_share_release(sect);
+        return;
+    }
+    
+    alloc = VC_SECT_ALLOC(sect);
+    if (sect->keys) {
+        vc_free(alloc, sect->keys->nodes);
+        vc_free(alloc, sect->keys);
+    }
     fasthash_cleanup(sect->ht);
-    free(sect);
+    for (inc = sect->includes; inc; inc = next) {
+        next = inc->next;
+        vc_fragment_release(inc->frag);
+        vc_free(alloc, inc);
+    }
+    
+    /* The root section also tears down the per-config state.  This must
+     * come after the table, as its keys live in the pool. */
+    if (sect->root && sect->root->sect == sect) {
+        vc_free(alloc, sect->root->source);
+        fasthash_pool_cleanup(sect->root->pool);
+        pthread_rwlock_destroy(&(sect->root->lock));
+        vc_index_drop(sect->root);
+        pthread_mutex_destroy(&(sect->root->index_lock));
+        vc_free(alloc, sect->root);
+    }
+    vc_free(alloc, sect);
+}
+
+void vc_sect_stats(vc_sect *sect, vc_stats *stats) {
+    index_node *in;
+    fasthash_node *node;
+    
+    if (!sect) return;
+    
+    /* Pool statistics are per config, so only the root reports them */
+    if (sect->root && sect->root->sect == sect && sect->root->pool) {
+        stats->intern_strings += sect->root->pool->count;
+        stats->intern_bytes += sect->root->pool->bytes;
+        stats->intern_saved += sect->root->pool->saved;
+        vc_index_stats(sect->root, stats);
+    }
+    
+    stats->sections++;
+    if (sect->shared) stats->shared_sections++;
+    vc_keys_stats(sect, stats);
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            if (opt->type == VC_SECTION) {
+                vc_sect_stats((vc_sect *)opt->value, stats);
+            } else {
+                stats->options++;
+            }
+        }
+    }
 }
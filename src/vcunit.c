@@ -0,0 +1,248 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcunit.c
+ *
+ * Durations, sizes and ratios.  Numbers are scanned as a whole part and
+ * a fraction over a power of ten, so that 1.5s is exactly 1500000000ns
+ * rather than whatever a double makes of it, and scaled by the unit in
+ * 128 bits, to catch overflow.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcunit.h"
+
+/**********************************************************************/
+/**** Macro/Type Definitions ******************************************/
+/**********************************************************************/
+#define NS_SEC          1000000000ULL   /* Nanoseconds in a second */
+#define FRAC_MAX        1000000000000000000ULL  /* Fraction digits kept */
+#define FORMAT_SIZE     64              /* Longest value written */
+#define RATIO_DECIMALS  40              /* Most decimals tried for a ratio */
+
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define IS_ALPHA(c) (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z'))
+
+typedef unsigned __int128 vc_u128;
+
+/* Unit name, and what one of it is in nanoseconds or bytes */
+typedef struct vc_unit {
+    const char *name;
+    uint64_t scale;
+} vc_unit;
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+
+/* Smallest first; vc_unit_duration picks from these by index */
+static const vc_unit durations[] = {
+    {"ns", 1},
+    {"us", 1000},
+    {"ms", 1000000},
+    {"s",  NS_SEC},
+    {"m",  60 * NS_SEC},
+    {"h",  3600 * NS_SEC},
+    {"d",  86400 * NS_SEC},
+    {0, 0}
+};
+
+/* Where two names share a scale, the first is written */
+static const vc_unit sizes[] = {
+    {"B",   1},
+    {"kB",  1000ULL},
+    {"KB",  1000ULL},
+    {"MB",  1000000ULL},
+    {"GB",  1000000000ULL},
+    {"TB",  1000000000000ULL},
+    {"PB",  1000000000000000ULL},
+    {"KiB", 1ULL << 10},
+    {"MiB", 1ULL << 20},
+    {"GiB", 1ULL << 30},
+    {"TiB", 1ULL << 40},
+    {"PiB", 1ULL << 50},
+    {0, 0}
+};
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static const char *vc_unit_number(const char *p, const char *end, uint64_t *whole, uint64_t *frac, uint64_t *denom);
+static const vc_unit *vc_unit_find(const vc_unit *units, const char *name, size_t length);
+static vc_type vc_unit_ratio(const char *str, size_t length, vc_unit_value *value);
+static int vc_unit_fixed(char *out, uint64_t v, const vc_unit *unit);
+static int vc_unit_duration(char *out, int64_t ns);
+static int vc_unit_size(char *out, int64_t bytes);
+static int vc_unit_percent(char *out, double ratio);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+vc_type vc_unit_parse(const char *str, size_t length, vc_unit_value *value) {
+    const char *p = str, *end = str + length, *name;
+    uint64_t whole, frac, denom;
+    vc_u128 total = 0;
+    const vc_unit *unit;
+    vc_type type = VC_ERROR;
+    int negative = 0;
+
+    if (length && str[length - 1] == '%') return vc_unit_ratio(str, length - 1, value);
+    if (p < end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+
+    /* Durations may have several parts, such as 2h30m; sizes have one */
+    while (p < end) {
+        if (type == VC_SIZE || !(p = vc_unit_number(p, end, &whole, &frac, &denom))) return VC_ERROR;
+        for (name = p; p < end && IS_ALPHA(*p); p++);
+
+        if (type != VC_SIZE && (unit = vc_unit_find(durations, name, p - name))) {
+            type = VC_DURATION;
+        } else if (type == VC_ERROR && (unit = vc_unit_find(sizes, name, p - name))) {
+            type = VC_SIZE;
+        } else {
+            return VC_ERROR;
+        }
+
+        total += (vc_u128)whole * unit->scale + (vc_u128)frac * unit->scale / denom;
+        if (total > INT64_MAX) return VC_ERROR;
+    }
+
+    if (type == VC_ERROR || (negative && type == VC_SIZE)) return VC_ERROR;
+    value->i = negative ? -(int64_t)total : (int64_t)total;
+    return type;
+}
+
+int vc_unit_format(char *buf, size_t size, vc_type type, const void *value) {
+    char out[FORMAT_SIZE * 8];
+
+    switch (type) {
+        case VC_DURATION: vc_unit_duration(out, *((const int64_t *)value)); break;
+        case VC_SIZE:     vc_unit_size(out, *((const int64_t *)value)); break;
+        case VC_RATIO:    vc_unit_percent(out, *((const double *)value)); break;
+        default:          out[0] = '\0'; break;
+    }
+    return snprintf(buf, size, "%s", out);
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Scan digits, with an optional fraction, into whole + frac / denom.
+ * Returns the end of the number, or NULL if there are no digits or the
+ * whole part overflows.  Fraction digits past 18 are dropped. */
+static const char *vc_unit_number(const char *p, const char *end, uint64_t *whole, uint64_t *frac, uint64_t *denom) {
+    int digits = 0;
+
+    *whole = 0;
+    *frac = 0;
+    *denom = 1;
+    for (; p < end && IS_DIGIT(*p); p++, digits++) {
+        if (*whole > (UINT64_MAX - 9) / 10) return 0;
+        *whole = *whole * 10 + (uint64_t)(*p - '0');
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && IS_DIGIT(*p); p++, digits++) {
+            if (*denom == FRAC_MAX) continue;
+            *frac = *frac * 10 + (uint64_t)(*p - '0');
+            *denom *= 10;
+        }
+    }
+    return digits ? p : 0;
+}
+
+static const vc_unit *vc_unit_find(const vc_unit *units, const char *name, size_t length) {
+    for (; units->name; units++) {
+        if (strlen(units->name) == length && !memcmp(units->name, name, length)) return units;
+    }
+    return 0;
+}
+
+/* The number before a percent sign, over 100 */
+static vc_type vc_unit_ratio(const char *str, size_t length, vc_unit_value *value) {
+    const char *p = str, *end = str + length;
+    uint64_t whole, frac, denom;
+    char buf[FORMAT_SIZE];
+
+    if (p < end && *p == '-') p++;
+    if (length >= sizeof(buf) || vc_unit_number(p, end, &whole, &frac, &denom) != end) return VC_ERROR;
+
+    memcpy(buf, str, length);
+    buf[length] = '\0';
+    value->f = strtod(buf, 0) / 100;
+    return VC_RATIO;
+}
+
+/* Write v in a unit with a power-of-ten scale, with any fraction, and
+ * without trailing zeros.  Returns the length written. */
+static int vc_unit_fixed(char *out, uint64_t v, const vc_unit *unit) {
+    uint64_t rem = v % unit->scale;
+    int n = sprintf(out, "%llu", (unsigned long long)(v / unit->scale));
+    uint64_t s;
+
+    if (rem) {
+        out[n++] = '.';
+        for (s = unit->scale / 10; s; s /= 10) out[n++] = (char)('0' + rem / s % 10);
+        while (out[n - 1] == '0') n--;
+    }
+    return n + sprintf(out + n, "%s", unit->name);
+}
+
+/* Under a second, in the largest unit reached, such as 1.5ms; otherwise
+ * in hours, minutes and seconds, such as 2h30m or 1m0.5s */
+static int vc_unit_duration(char *out, int64_t ns) {
+    uint64_t v = ns < 0 ? -(uint64_t)ns : (uint64_t)ns, h, m;
+    int n = 0;
+
+    if (ns < 0) out[n++] = '-';
+    if (!v) return sprintf(out, "0s");
+    if (v < NS_SEC) return n + vc_unit_fixed(out + n, v, &durations[v >= 1000000 ? 2 : v >= 1000 ? 1 : 0]);
+
+    h = v / durations[5].scale;
+    v %= durations[5].scale;
+    m = v / durations[4].scale;
+    v %= durations[4].scale;
+    if (h) n += sprintf(out + n, "%lluh", (unsigned long long)h);
+    if (m) n += sprintf(out + n, "%llum", (unsigned long long)m);
+    if (v) n += vc_unit_fixed(out + n, v, &durations[3]);
+    out[n] = '\0';
+    return n;
+}
+
+/* In the largest unit that divides it exactly */
+static int vc_unit_size(char *out, int64_t bytes) {
+    const vc_unit *unit, *best = &sizes[0];
+
+    for (unit = sizes; unit->name; unit++) {
+        if (bytes && bytes % (int64_t)unit->scale == 0 && unit->scale > best->scale) best = unit;
+    }
+    return sprintf(out, "%lld%s", (long long)(bytes / (int64_t)best->scale), best->name);
+}
+
+/* With the fewest decimals that read back as the same ratio.  Exponents
+ * can't be read back, so this is %f rather than %g. */
+static int vc_unit_percent(char *out, double ratio) {
+    int decimals, n = 0;
+
+    for (decimals = 0; decimals <= RATIO_DECIMALS; decimals++) {
+        n = snprintf(out, FORMAT_SIZE * 8 - 1, "%.*f", decimals, ratio * 100);
+        if (strtod(out, 0) / 100 == ratio) break;
+    }
+    out[n++] = '%';
+    out[n] = '\0';
+    return n;
+}
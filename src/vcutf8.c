@@ -0,0 +1,314 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcutf8.c
+ *
+ * UTF-8 validation.  The vector paths classify every byte by its high
+ * nibble, and the byte before it by both nibbles, through three 16-entry
+ * tables; a byte is in error when the three classes share a bit, other
+ * than where the byte two or three back calls for a continuation.  They
+ * only say whether a block is valid: on an error, the exact offset is
+ * found by the scalar path, from the last character boundary before the
+ * block.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+#include "vcutf8.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VC_UTF8_X86
+#include <immintrin.h>
+#endif
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+
+/* Error classes of a pair of bytes */
+#define TOO_SHORT       (1 << 0)    /* Lead or ASCII, then lead or ASCII */
+#define TOO_LONG        (1 << 1)    /* ASCII, then continuation */
+#define OVERLONG_3      (1 << 2)    /* E0, then 80..9F */
+#define TOO_LARGE       (1 << 3)    /* F4, then 90..BF, or F5 and up */
+#define SURROGATE       (1 << 4)    /* ED, then A0..BF */
+#define OVERLONG_2      (1 << 5)    /* C0 or C1 */
+#define TOO_LARGE_1000  (1 << 6)    /* F5 and up, then 80..8F */
+#define OVERLONG_4      (1 << 6)    /* F0, then 80..8F */
+#define TWO_CONTS       (1 << 7)    /* Continuation, then continuation */
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+/* Classes of the first byte, by its high nibble */
+#define BYTE_1_HIGH                                                     \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                             \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,                             \
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,                         \
+    TOO_SHORT | OVERLONG_2,                                             \
+    TOO_SHORT,                                                          \
+    TOO_SHORT | OVERLONG_3 | SURROGATE,                                 \
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+/* Classes of the first byte, by its low nibble */
+#define BYTE_1_LOW                                                      \
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,                       \
+    CARRY | OVERLONG_2,                                                 \
+    CARRY,                                                              \
+    CARRY,                                                              \
+    CARRY | TOO_LARGE,                                                  \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,                     \
+    CARRY | TOO_LARGE | TOO_LARGE_1000,                                 \
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+
+/* Classes of the second byte, by its high nibble */
+#define BYTE_2_HIGH                                                     \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                         \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                         \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,         \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,          \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,          \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+
+/* Largest values of the last three bytes of a block that don't start a
+ * sequence running into the next block */
+#define LAST_3_MAX  (char)0xEF, (char)0xDF, (char)0xBF
+
+/**********************************************************************/
+/**** Static Declarations *********************************************/
+/**********************************************************************/
+static int best_impl = -1;      /* vc_utf8_impl, or -1 until found */
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static size_t vc_utf8_scalar(const unsigned char *s, size_t i, size_t length);
+static size_t vc_utf8_restart(const unsigned char *s, size_t i);
+#ifdef VC_UTF8_X86
+static size_t vc_utf8_sse41(const unsigned char *s, size_t length);
+static size_t vc_utf8_avx2(const unsigned char *s, size_t length);
+#endif
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+/* Most strings in a config are short, and faster done a byte at a time
+ * than copied into a padded block */
+size_t vc_utf8_check(const char *data, size_t length) {
+    if (length < 16) return vc_utf8_scalar((const unsigned char *)data, 0, length);
+    return vc_utf8_check_impl(data, length, vc_utf8_get_impl());
+}
+
+size_t vc_utf8_check_impl(const char *data, size_t length, vc_utf8_impl impl) {
+    const unsigned char *s = (const unsigned char *)data;
+    vc_utf8_impl best = vc_utf8_get_impl();
+
+    if (impl > best) impl = best;
+    switch (impl) {
+#ifdef VC_UTF8_X86
+        case VC_UTF8_AVX2: return vc_utf8_avx2(s, length);
+        case VC_UTF8_SSE41: return vc_utf8_sse41(s, length);
+#endif
+        default: return vc_utf8_scalar(s, 0, length);
+    }
+}
+
+/* Found on first use.  Every thread finds the same, so a race to store
+ * it is harmless. */
+vc_utf8_impl vc_utf8_get_impl(void) {
+    int impl = __atomic_load_n(&best_impl, __ATOMIC_RELAXED);
+
+    if (impl >= 0) return (vc_utf8_impl)impl;
+    impl = VC_UTF8_SCALAR;
+#ifdef VC_UTF8_X86
+    if (__builtin_cpu_supports("avx2")) impl = VC_UTF8_AVX2;
+    else if (__builtin_cpu_supports("sse4.1")) impl = VC_UTF8_SSE41;
+#endif
+    __atomic_store_n(&best_impl, impl, __ATOMIC_RELAXED);
+    return (vc_utf8_impl)impl;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Validate from offset i, which starts a character */
+static size_t vc_utf8_scalar(const unsigned char *s, size_t i, size_t length) {
+    uint64_t word;
+    unsigned char c, lo, hi;
+    size_t n, k;
+
+    while (i < length) {
+        /* Skip ASCII eight bytes at a time */
+        if (length - i >= 8) {
+            memcpy(&word, s + i, 8);
+            if (!(word & 0x8080808080808080ULL)) {
+                i += 8;
+                continue;
+            }
+        }
+        c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+
+        /* Continuation bytes to follow, and the range of the first */
+        lo = 0x80;
+        hi = 0xBF;
+        if (c < 0xC2) {
+            return i;
+        } else if (c < 0xE0) {
+            n = 1;
+        } else if (c < 0xF0) {
+            n = 2;
+            if (c == 0xE0) lo = 0xA0;
+            else if (c == 0xED) hi = 0x9F;
+        } else if (c < 0xF5) {
+            n = 3;
+            if (c == 0xF0) lo = 0x90;
+            else if (c == 0xF4) hi = 0x8F;
+        } else {
+            return i;
+        }
+
+        if (length - i <= n || s[i + 1] < lo || s[i + 1] > hi) return i;
+        for (k = 2; k <= n; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return i;
+        }
+        i += n + 1;
+    }
+    return length;
+}
+
+/* Where to validate from, given an error in the block at offset i.  The
+ * blocks before it are valid, but for a sequence in their last three
+ * bytes, so the first character starting in those bytes will do. */
+static size_t vc_utf8_restart(const unsigned char *s, size_t i) {
+    size_t start = i > 3 ? i - 3 : 0;
+    while (start < i && (s[start] & 0xC0) == 0x80) start++;
+    return start;
+}
+
+#ifdef VC_UTF8_X86
+__attribute__((target("sse4.1")))
+static size_t vc_utf8_sse41(const unsigned char *s, size_t length) {
+    const __m128i byte_1_high = _mm_setr_epi8(BYTE_1_HIGH);
+    const __m128i byte_1_low = _mm_setr_epi8(BYTE_1_LOW);
+    const __m128i byte_2_high = _mm_setr_epi8(BYTE_2_HIGH);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i high = _mm_set1_epi8((char)0x80);
+    const __m128i last = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, LAST_3_MAX);
+    __m128i in, prev = _mm_setzero_si128(), incomplete = _mm_setzero_si128();
+    __m128i prev1, prev2, prev3, special, must23, error;
+    unsigned char tail[16];
+    size_t i;
+
+    /* The last block is padded with NULs, which ends any sequence left
+     * open, so it is an error there */
+    for (i = 0; i <= length; i += 16) {
+        if (length - i >= 16) {
+            in = _mm_loadu_si128((const __m128i *)(s + i));
+        } else {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, s + i, length - i);
+            in = _mm_loadu_si128((const __m128i *)tail);
+        }
+
+        if (_mm_testz_si128(in, high)) {
+            error = incomplete;
+            incomplete = _mm_setzero_si128();
+        } else {
+            prev1 = _mm_alignr_epi8(in, prev, 15);
+            special = _mm_and_si128(
+                _mm_and_si128(
+                    _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                    _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+
+            /* Third and fourth bytes are where the byte two or three back
+             * is E0 and up, or F0 and up */
+            prev2 = _mm_alignr_epi8(in, prev, 14);
+            prev3 = _mm_alignr_epi8(in, prev, 13);
+            must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+            error = _mm_xor_si128(_mm_and_si128(must23, high), special);
+            incomplete = _mm_subs_epu8(in, last);
+        }
+
+        if (!_mm_testz_si128(error, error)) return vc_utf8_scalar(s, vc_utf8_restart(s, i), length);
+        prev = in;
+    }
+    return length;
+}
+
+__attribute__((target("avx2")))
+static size_t vc_utf8_avx2(const unsigned char *s, size_t length) {
+    const __m256i byte_1_high = _mm256_setr_epi8(BYTE_1_HIGH, BYTE_1_HIGH);
+    const __m256i byte_1_low = _mm256_setr_epi8(BYTE_1_LOW, BYTE_1_LOW);
+    const __m256i byte_2_high = _mm256_setr_epi8(BYTE_2_HIGH, BYTE_2_HIGH);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i high = _mm256_set1_epi8((char)0x80);
+    const __m256i last = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, LAST_3_MAX);
+    __m256i in, prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256();
+    __m256i carry, prev1, prev2, prev3, special, must23, error;
+    unsigned char tail[32];
+    size_t i;
+
+    for (i = 0; i <= length; i += 32) {
+        if (length - i >= 32) {
+            in = _mm256_loadu_si256((const __m256i *)(s + i));
+        } else {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, s + i, length - i);
+            in = _mm256_loadu_si256((const __m256i *)tail);
+        }
+
+        if (!_mm256_movemask_epi8(in)) {
+            error = incomplete;
+            incomplete = _mm256_setzero_si256();
+        } else {
+            /* alignr works within 128-bit lanes, so each lane is paired
+             * with the one before it */
+            carry = _mm256_permute2x128_si256(prev, in, 0x21);
+            prev1 = _mm256_alignr_epi8(in, carry, 15);
+            special = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                    _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+
+            prev2 = _mm256_alignr_epi8(in, carry, 14);
+            prev3 = _mm256_alignr_epi8(in, carry, 13);
+            must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+            error = _mm256_xor_si256(_mm256_and_si256(must23, high), special);
+            incomplete = _mm256_subs_epu8(in, last);
+        }
+
+        if (!_mm256_testz_si256(error, error)) break;
+        prev = in;
+    }
+
+    /* Clear the upper halves, or SSE code after this pays for saving them */
+    _mm256_zeroupper();
+    return i <= length ? vc_utf8_scalar(s, vc_utf8_restart(s, i), length) : length;
+}
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcview.c
+ *
+ * Layered views: lookups that fall through a stack of configs, and
+ * flattening of the stack into a single config.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vcview.h"
+#include "vcedit.h"
+#include "vcdiff.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define PATH_SIZE 256           /* Longest section path that is cached */
+#define LAYER_BIT(i) ((uint64_t)1 << (i))
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+/* Mask of layers without the section named by the first length bytes
+ * of optpath. */
+static uint64_t vc_view_misses(vc_view *view, char *optpath, size_t length);
+
+/* Forget cached misses.  Called with the lock held; returns zero if the
+ * misses couldn't be reset. */
+static int vc_view_reset(vc_view *view);
+
+/* Whether a layer has been edited since misses were last reset */
+static int vc_view_stale(vc_view *view);
+
+/* Whether misses were last reset at the given layer generations */
+static int vc_view_current(vc_view *view, uint64_t *gens);
+
+/* Merge srcs, in order of precedence, into dst */
+static int vc_view_merge(vc_sect *dst, vc_sect **srcs, size_t nsrcs);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+vc_view *vc_view_create(void) {
+    vc_view *view = (vc_view *)malloc(sizeof(vc_view));
+    if (!view) return 0;
+    
+    view->nlayers = 0;
+    view->misses = fasthash_init(256, 0, fasthash_free_data, 0, 0);
+    if (!view->misses) {
+        free(view);
+        return 0;
+    }
+    pthread_rwlock_init(&(view->lock), 0);
+    return view;
+}
+
+void vc_view_destroy(vc_view *view) {
+    if (!view) return;
+    fasthash_cleanup(view->misses);
+    pthread_rwlock_destroy(&(view->lock));
+    free(view);
+}
+
+int vc_view_push(vc_view *view, vc_sect *sect) {
+    if (!sect || view->nlayers == VC_VIEW_MAX_LAYERS) return 0;
+    
+    view->layers[view->nlayers++] = sect;
+    pthread_rwlock_wrlock(&(view->lock));
+    vc_view_reset(view);
+    pthread_rwlock_unlock(&(view->lock));
+    return 1;
+}
+
+vc_sect *vc_view_pop(vc_view *view) {
+    vc_sect *sect;
+    if (!view->nlayers) return 0;
+    
+    sect = view->layers[--view->nlayers];
+    pthread_rwlock_wrlock(&(view->lock));
+    vc_view_reset(view);
+    pthread_rwlock_unlock(&(view->lock));
+    return sect;
+}
+
+vc_opt *vc_view_getopt(vc_view *view, char *optpath) {
+    char *dot = strrchr(optpath, '.');
+    uint64_t misses = dot ? vc_view_misses(view, optpath, dot - optpath) : 0;
+    vc_opt *opt;
+    int i;
+    
+    for (i = view->nlayers - 1; i >= 0; i--) {
+        if (misses & LAYER_BIT(i)) continue;
+        if ((opt = vc_getopt(view->layers[i], optpath))) return opt;
+    }
+    return NULL;
+}
+
+void *vc_view_getval(vc_view *view, char *optpath, vc_type *type) {
+    char *dot = strrchr(optpath, '.');
+    uint64_t misses = dot ? vc_view_misses(view, optpath, dot - optpath) : 0;
+    void *value;
+    int i;
+    
+    for (i = view->nlayers - 1; i >= 0; i--) {
+        if (misses & LAYER_BIT(i)) continue;
+        if ((value = vc_sect_getval(view->layers[i], optpath, type))) return value;
+    }
+    return NULL;
+}
+
+vc_sect *vc_view_flatten(vc_view *view) {
+    vc_sect **srcs = 0;
+    size_t nsrcs = 0, capsrcs = 0;
+    vc_sect *root;
+    int i, ok = 1, flags = 0;
+    
+    /* Keys from a layer that needed seeded hashing still do */
+    for (i = view->nlayers - 1; i >= 0 && ok; i--) {
+        if (view->layers[i]->root->image) ok = 0;
+        else ok = vc_sect_sources(view->layers[i], &srcs, &nsrcs, &capsrcs);
+        flags |= view->layers[i]->root->flags & VC_ROOT_SEEDED_HASH;
+    }
+    
+    root = ok ? vc_root_sect(flags, 0) : 0;
+    if (root && !vc_view_merge(root, srcs, nsrcs)) {
+        vc_sect_destroy(root);
+        root = 0;
+    }
+    vc_hash_sect(root);
+    free(srcs);
+    return root;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+static uint64_t vc_view_misses(vc_view *view, char *optpath, size_t length) {
+    uint64_t gens[VC_VIEW_MAX_LAYERS], mask = 0, *copy;
+    char path[PATH_SIZE];
+    fasthash_node *node;
+    int i;
+    
+    /* Long paths are simply probed in every layer */
+    if (length >= PATH_SIZE) return 0;
+    
+    /* Generations are read before the layers are probed.  Edits bump them
+     * once applied, so an edit made during the probes leaves them
+     * different from the view's, and the mask isn't kept. */
+    for (i = 0; i < view->nlayers; i++) gens[i] = vc_generation(view->layers[i]);
+    
+    pthread_rwlock_rdlock(&(view->lock));
+    node = vc_view_current(view, gens) ? fasthash_lookupn(view->misses, optpath, length) : 0;
+    if (node) mask = *((uint64_t *)node->data);
+    pthread_rwlock_unlock(&(view->lock));
+    if (node) return mask;
+    
+    memcpy(path, optpath, length);
+    path[length] = '\0';
+    for (i = 0; i < view->nlayers; i++) {
+        vc_type type;
+        if (!vc_sect_getval(view->layers[i], path, &type) || type != VC_SECTION) {
+            mask |= LAYER_BIT(i);
+        }
+    }
+    
+    /* Another thread may have got here first, with the same answer */
+    pthread_rwlock_wrlock(&(view->lock));
+    if (vc_view_stale(view)) vc_view_reset(view);
+    if (vc_view_current(view, gens) && view->misses->count < VC_VIEW_MAX_MISSES &&
+        !fasthash_lookupn(view->misses, optpath, length) &&
+        (copy = (uint64_t *)malloc(sizeof(uint64_t)))) {
+        *copy = mask;
+        if (fasthash_insertn(view->misses, optpath, length, copy) >= view->misses->size) free(copy);
+    }
+    pthread_rwlock_unlock(&(view->lock));
+    return mask;
+}
+
+static int vc_view_reset(vc_view *view) {
+    fasthash_table *misses = fasthash_init(256, 0, fasthash_free_data, 0, 0);
+    int i;
+    if (!misses) return 0;
+    
+    fasthash_cleanup(view->misses);
+    view->misses = misses;
+    for (i = 0; i < view->nlayers; i++) view->gens[i] = vc_generation(view->layers[i]);
+    return 1;
+}
+
+static int vc_view_stale(vc_view *view) {
+    int i;
+    for (i = 0; i < view->nlayers; i++) {
+        if (view->gens[i] != vc_generation(view->layers[i])) return 1;
+    }
+    return 0;
+}
+
+static int vc_view_current(vc_view *view, uint64_t *gens) {
+    int i;
+    for (i = 0; i < view->nlayers; i++) {
+        if (view->gens[i] != gens[i]) return 0;
+    }
+    return 1;
+}
+
+static int vc_view_merge(vc_sect *dst, vc_sect **srcs, size_t nsrcs) {
+    const vc_allocator *alloc = VC_SECT_ALLOC(dst);
+    index_node *in;
+    fasthash_node *node;
+    size_t i;
+    
+    /* Earlier sources take precedence, so the first definition of a name
+     * wins, except that sections of the same name are merged. */
+    for (i = 0; i < nsrcs; i++) {
+        for (in = srcs[i]->ht->index_list; in; in = in->next) {
+            for (node = srcs[i]->ht->entries[in->index]; node; node = node->next) {
+                vc_opt *opt = (vc_opt *)node->data;
+                fasthash_node *prev = fasthash_lookup(dst->ht, node->key);
+                vc_opt *copy;
+    
+                if (opt->type == VC_SECTION) {
+                    vc_sect **children = 0;
+                    size_t nchildren = 0, capchildren = 0;
+                    int ok;
+    
+                    if (prev && ((vc_opt *)prev->data)->type != VC_SECTION) continue;
+                    if (!prev) {
+                        copy = (vc_opt *)vc_malloc(alloc, sizeof(vc_opt));
+                        if (!copy) return 0;
+                        copy->type = VC_SECTION;
+                        copy->flags = 0;
+                        copy->value = vc_sect_create(dst->root, dst);
+                        if (!copy->value || !((vc_sect *)copy->value)->ht ||
+                            fasthash_insert(dst->ht, node->key, copy) >= dst->ht->size) {
+                            vc_opt_destroy(copy, alloc);
+                            return 0;
+                        }
+                    } else {
+                        copy = (vc_opt *)prev->data;
+                    }
+    
+                    ok = vc_sect_sources((vc_sect *)opt->value, &children, &nchildren, &capchildren) &&
+                         vc_view_merge((vc_sect *)copy->value, children, nchildren);
+                    free(children);
+                    if (!ok) return 0;
+                } else if (!prev) {
+                    copy = vc_opt_copy(dst, opt);
+                    if (!copy) return 0;
+                    if (fasthash_insert(dst->ht, node->key, copy) >= dst->ht->size) {
+                        vc_opt_destroy(copy, alloc);
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,443 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vcwrite.c
+ *
+ * Config writer.  Emits a parsed config in the vconfig text format,
+ * through a large buffer and writev.
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vcwrite.h"
+#include "vcinclude.h"
+#include "vcunit.h"
+
+/**********************************************************************/
+/**** Macro Definitions ***********************************************/
+/**********************************************************************/
+#define MEMORY_SIZE 65536       /* Initial size when writing to memory */
+
+/* Output state.  When writing to a file, buffered bytes from mark up to
+ * used haven't been added to the iovec yet. */
+typedef struct vc_writer {
+    int fd;                     /* Output file, or -1 for memory */
+    char *buf;                  /* Output buffer */
+    size_t used;                /* Bytes in buffer */
+    size_t cap;                 /* Buffer size */
+    size_t mark;                /* Start of bytes not yet in iov */
+    struct iovec iov[VC_WRITE_IOVMAX];
+    int niov;                   /* Segments waiting to be written */
+    int indent;                 /* Spaces per section level */
+    int error;                  /* errno of the first failure */
+} vc_writer;
+
+/* Section entry, for sorting */
+typedef struct vc_write_entry {
+    char *key;
+    vc_opt *opt;
+} vc_write_entry;
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+/* Output */
+static void vw_put(vc_writer *w, const char *data, size_t length);
+static void vw_direct(vc_writer *w, const char *data, size_t length);
+static void vw_segment(vc_writer *w, const char *data, size_t length);
+static void vw_flush(vc_writer *w);
+static void vw_indent(vc_writer *w, int depth);
+
+/* Values */
+static void vw_int(vc_writer *w, long long value);
+static void vw_float(vc_writer *w, double value);
+static void vw_string(vc_writer *w, const char *str);
+static void vw_unit(vc_writer *w, vc_type type, const void *value);
+static void vw_array(vc_writer *w, vc_array *arr);
+static void vw_sect(vc_writer *w, vc_sect *sect, int depth);
+
+static int vw_entrycmp(const void *a, const void *b);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+/**********************************************************************/
+/******** API Function Definitions ************************************/
+/**********************************************************************/
+
+int vc_write(vc_sect *sect, int fd, vc_write_opts *opts) {
+    vc_writer w;
+    
+    /* Only parsed configs can be walked */
+    if (!sect || !sect->ht) {
+        errno = EINVAL;
+        return 0;
+    }
+    
+    bzero(&w, sizeof(vc_writer));
+    w.fd = fd;
+    w.cap = VC_WRITE_BUFSIZE;
+    w.indent = opts ? opts->indent : VC_WRITE_INDENT;
+    if (!(w.buf = (char *)malloc(w.cap))) return 0;
+    
+    vw_sect(&w, sect, 0);
+    vw_flush(&w);
+    free(w.buf);
+    
+    if (w.error) {
+        errno = w.error;
+        return 0;
+    }
+    return 1;
+}
+
+char *vc_write_buffer(vc_sect *sect, vc_write_opts *opts, size_t *length) {
+    vc_writer w;
+    
+    if (!sect || !sect->ht) return 0;
+    
+    bzero(&w, sizeof(vc_writer));
+    w.fd = -1;
+    w.cap = MEMORY_SIZE;
+    w.indent = opts ? opts->indent : VC_WRITE_INDENT;
+    if (!(w.buf = (char *)malloc(w.cap))) return 0;
+    
+    vw_sect(&w, sect, 0);
+    vw_put(&w, "", 1);
+    if (w.error) {
+        free(w.buf);
+        errno = w.error;
+        return 0;
+    }
+    
+    if (length) *length = w.used - 1;
+    return w.buf;
+}
+
+/**********************************************************************/
+/******** Static Function Definitions *********************************/
+/**********************************************************************/
+
+/* Append bytes to the buffer, flushing (or growing it, in memory) as
+ * needed. */
+static void vw_put(vc_writer *w, const char *data, size_t length) {
+    if (w->error) return;
+    
+    if (w->used + length > w->cap) {
+        if (w->fd >= 0) {
+            vw_flush(w);
+            if (length > w->cap) {
+                vw_direct(w, data, length);
+                return;
+            }
+        } else {
+            size_t cap = w->cap;
+            char *buf;
+            while (w->used + length > cap) cap *= 2;
+            if (!(buf = (char *)realloc(w->buf, cap))) {
+                w->error = ENOMEM;
+                return;
+            }
+            w->buf = buf;
+            w->cap = cap;
+        }
+    }
+    memcpy(w->buf + w->used, data, length);
+    w->used += length;
+}
+
+/* Write bytes that stay valid until the next flush, without copying
+ * them into the buffer. */
+static void vw_direct(vc_writer *w, const char *data, size_t length) {
+    if (w->fd < 0) {
+        vw_put(w, data, length);
+        return;
+    }
+    if (w->error) return;
+    
+    /* Room for the buffered bytes, this segment, and the buffer tail that
+     * a flush adds. */
+    if (w->niov > VC_WRITE_IOVMAX - 3) vw_flush(w);
+    
+    vw_segment(w, w->buf + w->mark, w->used - w->mark);
+    w->mark = w->used;
+    vw_segment(w, data, length);
+}
+
+static void vw_segment(vc_writer *w, const char *data, size_t length) {
+    if (!length) return;
+    w->iov[w->niov].iov_base = (void *)data;
+    w->iov[w->niov].iov_len = length;
+    w->niov++;
+}
+
+static void vw_flush(vc_writer *w) {
+    struct iovec *iov = w->iov;
+    int niov;
+    
+    if (w->fd < 0) return;
+    
+    vw_segment(w, w->buf + w->mark, w->used - w->mark);
+    niov = w->niov;
+    while (niov && !w->error) {
+        ssize_t n = writev(w->fd, iov, niov);
+        if (n < 0) {
+            if (errno != EINTR) w->error = errno;
+            continue;
+        }
+    
+        /* Skip what was written, which may end partway through a segment */
+        while (niov && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            niov--;
+        }
+        if (niov) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    
+    w->niov = 0;
+    w->used = w->mark = 0;
+}
+
+static void vw_indent(vc_writer *w, int depth) {
+    static const char spaces[] = "                                ";
+    size_t n = (size_t)depth * w->indent;
+    
+    while (n) {
+        size_t chunk = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+        vw_put(w, spaces, chunk);
+        n -= chunk;
+    }
+}
+
+static void vw_int(vc_writer *w, long long value) {
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    unsigned long long v = value < 0 ? -(unsigned long long)value : (unsigned long long)value;
+    
+    do {
+        *--p = '0' + (v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) *--p = '-';
+    
+    vw_put(w, p, digits + sizeof(digits) - p);
+}
+
+/* Floats are written with the fewest digits that read back exactly.  The
+ * format has no exponents, so those are expanded, and there is always a
+ * decimal point so the value reads back as a float. */
+static void vw_float(vc_writer *w, double value) {
+    char str[512];
+    char *e;
+    int precision, n;
+    
+    /* The format has no spelling for these */
+    if (!isfinite(value)) {
+        if (!w->error) w->error = EDOM;
+        return;
+    }
+    
+    /* Up to DBL_DIG digits print back exactly what was parsed, and %g
+     * drops trailing zeros, so that is usually the shortest form. */
+    for (precision = DBL_DIG; precision <= 17; precision++) {
+        snprintf(str, sizeof(str), "%.*g", precision, value);
+        if (strtod(str, 0) == value) break;
+    }
+    
+    n = strlen(str);
+    if ((e = strchr(str, 'e'))) {
+        int exponent = atoi(e + 1);
+        int decimals = precision - 1 - exponent;
+        n = snprintf(str, sizeof(str), "%.*f", decimals > 0 ? decimals : 0, value);
+    
+        /* %f keeps the zeros that %g dropped */
+        if (strchr(str, '.')) {
+            while (str[n - 1] == '0' && str[n - 2] != '.') n--;
+            str[n] = '\0';
+        }
+    }
+    
+    if (!strchr(str, '.') && n < (int)sizeof(str) - 2) {
+        str[n++] = '.';
+        str[n++] = '0';
+    }
+    vw_put(w, str, n);
+}
+
+static void vw_string(vc_writer *w, const char *str) {
+    const char *run = str, *p;
+    char esc[4] = {'\\', 'x', 0, 0};
+    static const char hex[] = "0123456789abcdef";
+    
+    vw_put(w, "\"", 1);
+    for (p = str; ; p++) {
+        unsigned char c;
+        const char *rep;
+        size_t replen = 2;
+    
+        /* Skip over the common case in a tight loop */
+        while ((c = (unsigned char)*p) >= 0x20 && c != '"' && c != '\\' && c != 0x7f) p++;
+        if (!c) break;
+    
+        switch (c) {
+            case '"':  rep = "\\\""; break;
+            case '\\': rep = "\\\\"; break;
+            case '\n': rep = "\\n"; break;
+            case '\t': rep = "\\t"; break;
+            case '\r': rep = "\\r"; break;
+            default:
+                esc[2] = hex[c >> 4];
+                esc[3] = hex[c & 0xf];
+                rep = esc;
+                replen = 4;
+            break;
+        }
+    
+        vw_put(w, run, p - run);
+        vw_put(w, rep, replen);
+        run = p + 1;
+    }
+    
+    /* A long run with nothing to escape is written from the config */
+    if ((size_t)(p - run) >= VC_WRITE_DIRECT) {
+        vw_direct(w, run, p - run);
+    } else {
+        vw_put(w, run, p - run);
+    }
+    vw_put(w, "\"", 1);
+}
+
+/* Durations, sizes and ratios, in the largest unit that keeps them exact */
+static void vw_unit(vc_writer *w, vc_type type, const void *value) {
+    char str[512];
+    int n;
+    
+    if (type == VC_RATIO && !isfinite(*((const double *)value))) {
+        if (!w->error) w->error = EDOM;
+        return;
+    }
+    n = vc_unit_format(str, sizeof(str), type, value);
+    
+    vw_put(w, str, n < (int)sizeof(str) ? n : (int)sizeof(str) - 1);
+}
+
+static void vw_array(vc_writer *w, vc_array *arr) {
+    size_t i;
+    
+    vw_put(w, "[", 1);
+    for (i = 0; i < arr->length; i++) {
+        if (i) vw_put(w, ", ", 2);
+        switch (arr->type) {
+            case VC_INTEGER: vw_int(w, arr->v.ints[i]); break;
+            case VC_FLOAT:   vw_float(w, arr->v.floats[i]); break;
+            case VC_STRING:  vw_string(w, arr->v.strs[i]); break;
+            default: break;
+        }
+    }
+    vw_put(w, "]", 1);
+}
+
+static void vw_sect(vc_writer *w, vc_sect *sect, int depth) {
+    vc_write_entry *entries;
+    vc_include *inc;
+    index_node *in;
+    fasthash_node *node;
+    size_t n = 0, cap = 64, i;
+    int pass;
+    
+    /* Each statement is written once, as it was written, so relative
+     * paths and globs stay so */
+    for (inc = sect->includes; inc; inc = inc->next) {
+        if (!inc->spelling) continue;
+        vw_indent(w, depth);
+        vw_put(w, "include ", 8);
+        vw_string(w, inc->spelling);
+        vw_put(w, "\n", 1);
+    }
+    
+    if (!(entries = (vc_write_entry *)malloc(cap * sizeof(vc_write_entry)))) {
+        w->error = ENOMEM;
+        return;
+    }
+    for (in = sect->ht->index_list; in; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            if (n == cap) {
+                vc_write_entry *grown = (vc_write_entry *)realloc(entries, 2 * cap * sizeof(vc_write_entry));
+                if (!grown) {
+                    free(entries);
+                    w->error = ENOMEM;
+                    return;
+                }
+                entries = grown;
+                cap *= 2;
+            }
+            entries[n].key = node->key;
+            entries[n].opt = (vc_opt *)node->data;
+            n++;
+        }
+    }
+    qsort(entries, n, sizeof(vc_write_entry), vw_entrycmp);
+    
+    /* Options first, then subsections */
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < n && !w->error; i++) {
+            vc_opt *opt = entries[i].opt;
+            size_t keylen = strlen(entries[i].key);
+    
+            if ((opt->type == VC_SECTION) != pass) continue;
+            vw_indent(w, depth);
+    
+            if (opt->type == VC_SECTION) {
+                vw_put(w, "[", 1);
+                vw_put(w, entries[i].key, keylen);
+                vw_put(w, "]\n", 2);
+                vw_sect(w, (vc_sect *)opt->value, depth + 1);
+                vw_indent(w, depth);
+                vw_put(w, "[/", 2);
+                vw_put(w, entries[i].key, keylen);
+                vw_put(w, "]\n", 2);
+                continue;
+            }
+    
+            vw_put(w, entries[i].key, keylen);
+            vw_put(w, " = ", 3);
+            switch (opt->type) {
+                case VC_BOOLEAN:
+                    if (*((int *)opt->value)) vw_put(w, "true", 4);
+                    else vw_put(w, "false", 5);
+                break;
+                case VC_INTEGER: vw_int(w, *((int *)opt->value)); break;
+                case VC_FLOAT:   vw_float(w, *((double *)opt->value)); break;
+                case VC_STRING:  vw_string(w, (char *)opt->value); break;
+                case VC_ARRAY:   vw_array(w, (vc_array *)opt->value); break;
+                case VC_DURATION:
+                case VC_SIZE:
+                case VC_RATIO:   vw_unit(w, opt->type, opt->value); break;
+                default: break;
+            }
+            vw_put(w, "\n", 1);
+        }
+    }
+    
+    free(entries);
+}
+
+static int vw_entrycmp(const void *a, const void *b) {
+    return strcmp(((const vc_write_entry *)a)->key, ((const vc_write_entry *)b)->key);
+}
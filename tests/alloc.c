@@ -0,0 +1,290 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: alloc.c
+ *
+ * Allocators: a counting allocator sees every allocation it made freed
+ * once the config is closed, whatever was parsed, indexed or edited, with
+ * its context passed to each call; a config holds nothing from malloc
+ * while open but the sections it shares; and a load that runs out part
+ * way fails cleanly.  malloc is replaced, as in flatten.c, to count what
+ * doesn't go through the allocator.
+ */
+
+#include "test.h"
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static long mallocs;        /* malloc allocations not yet freed */
+
+void *malloc(size_t size) {
+    void *p = __libc_malloc(size);
+    if (p) mallocs++;
+    return p;
+}
+
+void *calloc(size_t n, size_t size) {
+    void *p = __libc_calloc(n, size);
+    if (p) mallocs++;
+    return p;
+}
+
+void *realloc(void *ptr, size_t size) {
+    void *p = __libc_realloc(ptr, size);
+    if (p && !ptr) mallocs++;
+    return p;
+}
+
+void free(void *ptr) {
+    if (ptr) mallocs--;
+    __libc_free(ptr);
+}
+
+/* The counting allocator's context */
+typedef struct counts {
+    long live;              /* Allocations not yet freed */
+    long total;             /* Allocations made */
+    long armed;             /* Allocations left before one fails; -1: off */
+    int misuse;             /* Set on a wrong context, or a free of NULL */
+} counts;
+
+static counts counted = {0, 0, -1, 0};
+
+static int take(counts *c) {
+    if (c != &counted) c->misuse = counted.misuse = 1;
+    if (c->armed == 0) return 0;
+    if (c->armed > 0) c->armed--;
+    return 1;
+}
+
+static void *count_alloc(void *ctx, size_t size) {
+    counts *c = (counts *)ctx;
+    void *p = take(c) ? __libc_malloc(size) : 0;
+    if (p) c->live++, c->total++;
+    return p;
+}
+
+static void *count_realloc(void *ctx, void *ptr, size_t size) {
+    counts *c = (counts *)ctx;
+    void *p = take(c) ? __libc_realloc(ptr, size) : 0;
+    if (p && !ptr) c->live++, c->total++;
+    return p;
+}
+
+static void count_free(void *ctx, void *ptr) {
+    counts *c = (counts *)ctx;
+    if (c != &counted || !ptr) counted.misuse = 1;
+    c->live--;
+    __libc_free(ptr);
+}
+
+static const vc_allocator counting = {count_alloc, count_realloc, count_free, &counted};
+
+static int marked;
+
+VC_DEF_DIRECTIVE(mark) {
+    char *name = VC_GETARG_STR();
+    marked += !strcmp(name, "here");
+    return 0;
+}
+
+static vc_directive directives[] = {
+    VC_DIRECTIVE(mark, 0, "s"),
+    {0, 0, "", 0}
+};
+
+static const char *text =
+    "port = 80\n"
+    "name = \"edge\"\n"
+    "alias = \"edge\"\n"
+    "timeout = 1.5s\n"
+    "ints = [1, 2, 3]\n"
+    "floats = [0.5, 1.5]\n"
+    "names = [\"a\", \"b\", \"a\"]\n"
+    "mark \"here\"\n"
+    "[srv]\n"
+    "port = 443\n"
+    "[tls]\n"
+    "level = 2\n"
+    "[/tls]\n"
+    "[/srv]\n"
+    "[copy]\n"
+    "port = 443\n"
+    "[tls]\n"
+    "level = 2\n"
+    "[/tls]\n"
+    "[/copy]\n";
+
+static vconfig *parse_counted(const char *data, int flags) {
+    vc_params p = {0, directives, flags, &test_errors, &counting};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_parse_buffer(data, strlen(data), &p);
+}
+
+static vconfig *open_counted(const char *name, int flags) {
+    char path[PATH_MAX];
+    vc_params p = {test_path(path, sizeof(path), name), directives, flags, &test_errors, &counting};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_open(&p);
+}
+
+/* Lookups and queries that build what the flags ask for */
+static int ignore(const char *path, vc_type type, void *value, void *ctx) {
+    (void)path, (void)type, (void)value, (void)ctx;
+    return 0;
+}
+
+static int use(vconfig *vcfg) {
+    return test_int(vcfg, "srv.tls.level") == 2 && test_int(vcfg, "copy.port") == 443 &&
+           vconfig_query(vcfg, "*.port", ignore, 0) == 2;
+}
+
+/* Whether the config has every value of main.cfg, and its include */
+static int complete(vconfig *vcfg) {
+    vc_array *ints = vcfg ? vconfig_getarray(vcfg, "ints") : 0;
+    return test_int(vcfg, "port") == 80 && !strcmp(test_str(vcfg, "name"), "edge") &&
+           ints && ints->length == 3 && test_int(vcfg, "srv.tls.level") == 2 &&
+           test_int(vcfg, "inc.port") == 9;
+}
+
+int main(void) {
+    static const int flag_sets[] = {
+        0, VC_PARAM_INTERN_VALUES, VC_PARAM_SEEDED_HASH, VC_PARAM_PATH_INDEX, VC_PARAM_KEY_INDEX,
+        VC_PARAM_SHARE_SECTIONS, VC_PARAM_LOOKUP_CACHE,
+        VC_PARAM_INTERN_VALUES | VC_PARAM_PATH_INDEX | VC_PARAM_KEY_INDEX | VC_PARAM_SHARE_SECTIONS
+    };
+    vconfig *vcfg;
+    char *main_cfg;
+    vc_txn *txn;
+    long before, n, total;
+    size_t f;
+    int ok, failed;
+
+    test_begin("alloc");
+    if (!test_write("inc.cfg", "[inc]\nport = 9\nnames = [\"x\", \"y\"]\n[/inc]\n") ||
+        !(main_cfg = (char *)malloc(strlen(text) + 32))) {
+        perror("write");
+        return 2;
+    }
+    sprintf(main_cfg, "include \"inc.cfg\"\n%s", text);
+    ok = test_write("main.cfg", main_cfg);
+    free(main_cfg);
+    if (!ok) {
+        perror("write");
+        return 2;
+    }
+
+    /* Everything a config allocates, under each flag, is freed when it
+     * closes, and none of it comes from malloc but shared sections */
+    for (ok = 1, f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++) {
+        before = mallocs;
+        marked = 0;
+        vcfg = parse_counted(text, flag_sets[f]);
+        if (!vcfg || !use(vcfg) || marked != 1 || counted.live <= 0) {
+            printf("\t\tflags %x: didn't load\n", flag_sets[f]);
+            ok = 0;
+        }
+        vconfig_cache_reset();
+        if (mallocs != before && !(flag_sets[f] & VC_PARAM_SHARE_SECTIONS)) {
+            printf("\t\tflags %x: %ld from malloc\n", flag_sets[f], mallocs - before);
+            ok = 0;
+        }
+        vconfig_close(vcfg);
+        if (counted.live) {
+            printf("\t\tflags %x: %ld not freed\n", flag_sets[f], counted.live);
+            ok = 0;
+            counted.live = 0;
+        }
+    }
+    RESULT("parsed", ok && counted.total > 0 && !counted.misuse);
+
+    /* Shared sections are malloc'd, being the store's, and freed with the
+     * last config holding them.  The store itself stays. */
+    {
+        vconfig *again;
+        vc_stats stats;
+
+        vconfig_close(parse_counted(text, VC_PARAM_SHARE_SECTIONS));
+        before = mallocs;
+        vcfg = parse_counted(text, VC_PARAM_SHARE_SECTIONS);
+        again = parse_counted(text, VC_PARAM_SHARE_SECTIONS);
+        memset(&stats, 0, sizeof(stats));
+        if (again) vconfig_stats(again, &stats);
+        ok = vcfg && again && stats.shared_sections > 0 && mallocs > before;
+        vconfig_close(vcfg);
+        ok = ok && mallocs > before && test_int(again, "copy.tls.level") == 2;
+        vconfig_close(again);
+        RESULT("shared", ok && mallocs == before && !counted.live);
+    }
+
+    /* Edits, kept and rolled back, are freed with the config */
+    vcfg = parse_counted(text, VC_PARAM_INTERN_VALUES | VC_PARAM_PATH_INDEX);
+    ok = vcfg && vconfig_set_int(vcfg, "srv.extra", 1) && vconfig_set_str(vcfg, "name", "other") &&
+         vconfig_set_str(vcfg, "new.deep.name", "deep") && vconfig_delete(vcfg, "copy") &&
+         vconfig_delete(vcfg, "ints") && !vconfig_getopt(vcfg, "copy.port") &&
+         !strcmp(test_str(vcfg, "new.deep.name"), "deep") && test_int(vcfg, "srv.tls.level") == 2;
+    txn = vconfig_txn_begin(vcfg);
+    vconfig_txn_set_int(txn, "txn.a", 1);
+    vconfig_txn_set_str(txn, "txn.b", "b");
+    ok = ok && vconfig_txn_commit(txn) && test_int(vcfg, "txn.a") == 1;
+    txn = vconfig_txn_begin(vcfg);
+    vconfig_txn_set_int(txn, "rolled", 1);
+    vconfig_txn_delete(txn, "missing");
+    ok = ok && !vconfig_txn_commit(txn);
+    txn = vconfig_txn_begin(vcfg);
+    vconfig_txn_set_int(txn, "aborted", 1);
+    vconfig_txn_abort(txn);
+    vconfig_close(vcfg);
+    RESULT("edited", ok && !counted.live && !counted.misuse);
+
+    /* Files, and the files they include, which are cached until the last
+     * config using them closes */
+    {
+        vconfig *again;
+        vcfg = open_counted("main.cfg", 0);
+        again = open_counted("main.cfg", 0);
+        ok = complete(vcfg) && complete(again);
+        vconfig_close(vcfg);
+        ok = ok && test_int(again, "inc.port") == 9;
+        vconfig_close(again);
+        RESULT("included", ok && !counted.live && !counted.misuse);
+    }
+
+    /* Loads that fail free what they had */
+    vcfg = parse_counted("port = 80\n[a]\nb = [1, 2\n", 0);
+    RESULT("failed", !vcfg && !counted.live);
+    vcfg = parse_counted("[a]\nb = 1\n[/c]\n", VC_PARAM_INTERN_VALUES);
+    RESULT("failed, sections", !vcfg && !counted.live);
+
+    /* Fail each allocation of a load in turn: it fails, or is complete,
+     * and either way leaves nothing behind */
+    counted.armed = 1000000;
+    vcfg = open_counted("main.cfg", VC_PARAM_INTERN_VALUES);
+    total = 1000000 - counted.armed;
+    counted.armed = -1;
+    vconfig_close(vcfg);
+    for (failed = 0, ok = 1, n = 0; n < total; n++) {
+        counted.armed = n;
+        vcfg = open_counted("main.cfg", VC_PARAM_INTERN_VALUES);
+        counted.armed = -1;
+        if (!vcfg) {
+            failed++;
+        } else if (!complete(vcfg)) {
+            printf("\t\tallocation %ld: incomplete\n", n);
+            ok = 0;
+        }
+        vconfig_close(vcfg);
+        if (counted.live) {
+            printf("\t\tallocation %ld: %ld not freed\n", n, counted.live);
+            ok = 0;
+            counted.live = 0;
+        }
+    }
+    RESULT("out of memory", ok && total > 20 && failed > total / 2 && !counted.misuse);
+
+    return test_end();
+}
@@ -0,0 +1,75 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: array.c
+ *
+ * Array values: integers, floats and strings, integers mixed with floats,
+ * arrays over several lines, elements of different kinds, and numbers
+ * too large or too long to convert, as elements and as plain values.
+ */
+
+#include <stdint.h>
+
+#include "test.h"
+
+/* Parse one line, and say whether it loaded */
+static int parses(const char *text) {
+    vconfig *vcfg = test_parse(text, 0);
+    vconfig_close(vcfg);
+    return vcfg != 0;
+}
+
+int main(void) {
+    vconfig *vcfg;
+    int64_t *ints;
+    double *floats;
+    char **strs;
+    size_t n, m, k;
+
+    test_begin("array");
+
+    vcfg = test_parse("ports = [80, 443, -8080]\n"
+                      "weights = [0.5, 1.25]\n"
+                      "mixed = [1, 2.5, -3]\n"
+                      "hosts = [\"a\", \"b c\", 'd\\te']\n"
+                      "long = [\n  1,  # first\n  2,\n\n  3\n]\n"
+                      "empty = []\n"
+                      "limits = [9223372036854775807, -9223372036854775808]\n", 0);
+    ints = vcfg ? vconfig_getintarray(vcfg, "ports", &n) : 0;
+    RESULT("integers", ints && n == 3 && ints[0] == 80 && ints[1] == 443 && ints[2] == -8080);
+    floats = vcfg ? vconfig_getfloatarray(vcfg, "weights", &n) : 0;
+    RESULT("floats", floats && n == 2 && floats[0] == 0.5 && floats[1] == 1.25);
+    floats = vcfg ? vconfig_getfloatarray(vcfg, "mixed", &n) : 0;
+    RESULT("mixed", floats && n == 3 && floats[0] == 1 && floats[1] == 2.5 && floats[2] == -3 &&
+                    !vconfig_getintarray(vcfg, "mixed", &n));
+    strs = vcfg ? vconfig_getstrarray(vcfg, "hosts", &n) : 0;
+    RESULT("strings", strs && n == 3 && !strcmp(strs[0], "a") && !strcmp(strs[1], "b c") &&
+                      !strcmp(strs[2], "d\te"));
+    ints = vcfg ? vconfig_getintarray(vcfg, "long", &n) : 0;
+    RESULT("lines", ints && n == 3 && ints[0] == 1 && ints[2] == 3);
+    RESULT("empty", vcfg && vconfig_getintarray(vcfg, "empty", &n) && n == 0 &&
+                    vconfig_getstrarray(vcfg, "empty", &m) && m == 0 &&
+                    vconfig_getfloatarray(vcfg, "empty", &k) && k == 0);
+    ints = vcfg ? vconfig_getintarray(vcfg, "limits", &n) : 0;
+    RESULT("limits", ints && n == 2 && ints[0] == INT64_MAX && ints[1] == INT64_MIN);
+    RESULT("not an array", vcfg && !vconfig_getarray(vcfg, "missing") && !vconfig_getintarray(vcfg, "hosts", &n));
+    vconfig_close(vcfg);
+
+    /* Malformed arrays */
+    RESULT("kinds", !parses("a = [1, \"two\"]\n") && test_error.type == VC_ERROR_ARRAY_TYPE);
+    RESULT("syntax", !parses("a = [1 2]\n") && !parses("a = [1,\n") && !parses("a = [true]\n"));
+
+    /* Numbers that don't fit fail the load, rather than being clamped or
+     * cut short */
+    RESULT("int overflow", !parses("b = [1, 99999999999999999999999]\n") &&
+                           test_error.type == VC_ERROR_NUMBER_RANGE &&
+                           strstr(test_error.msg, "99999999999999999999999"));
+    RESULT("int underflow", !parses("b = [-9223372036854775809]\n") && test_error.type == VC_ERROR_NUMBER_RANGE);
+    RESULT("too long", !parses("b = [1.00000000000000000000000000000000000000000000000000000000000000001]\n") &&
+                       test_error.type == VC_ERROR_NUMBER_RANGE);
+    RESULT("scalar", parses("port = 2147483647\n") && !parses("port = 2147483648\n") &&
+                     test_error.type == VC_ERROR_NUMBER_RANGE && !parses("port = 99999999999999999999\n"));
+
+    return test_end();
+}
@@ -0,0 +1,185 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: async.c
+ *
+ * Asynchronous loads: files read and parsed off the calling thread, files
+ * that can't be opened or read, directive lists that don't outlast the
+ * call queueing them, loads that run out of memory, and batches.
+ */
+
+#include <pthread.h>
+
+#include "test.h"
+
+#define BATCH 32
+
+/* What a callback was given, by the order the loads were queued in */
+typedef struct result {
+    int called;
+    vconfig *conf;
+    vc_error_type type;
+} result;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static int pending;
+static int marks;
+
+VC_DEF_DIRECTIVE(mark) {
+    __atomic_add_fetch(&marks, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/* Allocations left before one fails (-1: never), and those not freed */
+static long armed = -1;
+static long live;
+
+/* Count an allocation, or fail it.  Returns zero if it must fail. */
+static int take(void) {
+    return __atomic_load_n(&armed, __ATOMIC_RELAXED) < 0 ||
+           __atomic_fetch_sub(&armed, 1, __ATOMIC_RELAXED) != 0;
+}
+
+static void *count_alloc(void *ctx, size_t size) {
+    void *p;
+    (void)ctx;
+    if (!take()) return 0;
+    if ((p = malloc(size))) __atomic_add_fetch(&live, 1, __ATOMIC_RELAXED);
+    return p;
+}
+
+static void *count_realloc(void *ctx, void *ptr, size_t size) {
+    if (!ptr) return count_alloc(ctx, size);
+    return take() ? realloc(ptr, size) : 0;
+}
+
+static void count_free(void *ctx, void *ptr) {
+    (void)ctx;
+    __atomic_sub_fetch(&live, 1, __ATOMIC_RELAXED);
+    free(ptr);
+}
+
+static const vc_allocator counting = {count_alloc, count_realloc, count_free, 0};
+
+static void loaded(const char *path, vc_sect *conf, const vc_load_error *error, void *ctx) {
+    result *r = (result *)ctx;
+
+    (void)path;
+    pthread_mutex_lock(&lock);
+    r->called++;
+    r->conf = conf;
+    r->type = conf ? VC_ERROR_SUCCESS : error->type;
+    pending--;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+/* Batch loads share a context, so each finds its own slot by its path */
+static void loaded_batch(const char *path, vc_sect *conf, const vc_load_error *error, void *ctx) {
+    const char *slash = strrchr(path, '/');
+    loaded(path, conf, error, &(((result *)ctx)[atoi(slash + 2)]));
+}
+
+static int queue(const char *name, vc_directive *directives, const vc_allocator *alloc, result *r) {
+    char path[PATH_MAX];
+    vc_params p = {test_path(path, sizeof(path), name), directives, 0, 0, alloc};
+
+    pthread_mutex_lock(&lock);
+    pending++;
+    pthread_mutex_unlock(&lock);
+    if (vconfig_open_async(&p, loaded, r)) return 1;
+    pthread_mutex_lock(&lock);
+    pending--;
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+static void wait_all(void) {
+    pthread_mutex_lock(&lock);
+    while (pending) pthread_cond_wait(&cond, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+int main(void) {
+    char name[] = "mark", path[PATH_MAX], *paths[BATCH], file[16];
+    vc_directive dirs[] = {{name, 0, "", VC_DIRECTIVE_mark_fn__}, {0, 0, "", 0}};
+    vc_batch_params opts = {0, 0, 0, 0};
+    result good = {0}, missing = {0}, dir = {0}, marked = {0}, batch[BATCH];
+    size_t queued;
+    int i, ok, failed;
+    long n;
+
+    test_begin("async");
+    if (!test_write("good.cfg", "port = 80\n[srv]\nname = \"a\"\n[/srv]\n") ||
+        !test_write("marked.cfg", "mark\nport = 81\n") ||
+        mkdir(test_path(path, sizeof(path), "dir.cfg"), 0755)) {
+        perror("write");
+        return 2;
+    }
+
+    /* The directive list is overwritten as soon as the load is queued */
+    ok = queue("good.cfg", 0, 0, &good) && queue("missing.cfg", 0, 0, &missing) &&
+         queue("dir.cfg", 0, 0, &dir) && queue("marked.cfg", dirs, 0, &marked);
+    strcpy(name, "xxxx");
+    dirs[0].func = 0;
+    wait_all();
+    printf("\tMode: %s\n", vc_async_get_mode() == VC_ASYNC_URING ? "io_uring" : "threads");
+
+    RESULT("queued", ok);
+    RESULT("loaded", good.called == 1 && test_int(good.conf, "port") == 80 &&
+                     !strcmp(test_str(good.conf, "srv.name"), "a"));
+    RESULT("missing", missing.called == 1 && !missing.conf && missing.type == VC_ERROR_FILE);
+    RESULT("unreadable", dir.called == 1 && !dir.conf && dir.type == VC_ERROR_FILE);
+    RESULT("directives copied", marked.called == 1 && test_int(marked.conf, "port") == 81 && marks == 1);
+    vconfig_close(good.conf);
+    vconfig_close(marked.conf);
+
+    /* Fail each allocation of a load with directives in turn, until one
+     * loads.  Whether queueing or loading fails, nothing is kept, though
+     * a load is freed only after its callback returns. */
+    strcpy(name, "mark");
+    dirs[0].func = VC_DIRECTIVE_mark_fn__;
+    for (failed = 0, n = 0; n < 1000; n++) {
+        memset(&marked, 0, sizeof(marked));
+        armed = n;
+        if (queue("marked.cfg", dirs, &counting, &marked)) wait_all();
+        armed = -1;
+        vconfig_close(marked.conf);
+        if (marked.conf) break;
+        failed++;
+    }
+    for (i = 0; i < 1000 && __atomic_load_n(&live, __ATOMIC_RELAXED); i++) usleep(1000);
+    RESULT("out of memory", failed > 3 && n < 1000 && !__atomic_load_n(&live, __ATOMIC_RELAXED));
+
+    /* A batch, each file with its own result */
+    memset(batch, 0, sizeof(batch));
+    for (i = 0; i < BATCH; i++) {
+        snprintf(file, sizeof(file), "b%d.cfg", i);
+        snprintf(path, sizeof(path), "value = %d\n", i);
+        if (!test_write(file, path)) {
+            perror("write");
+            return 2;
+        }
+        paths[i] = strdup(test_path(path, sizeof(path), file));
+    }
+    pthread_mutex_lock(&lock);
+    pending += BATCH;
+    pthread_mutex_unlock(&lock);
+    queued = vconfig_open_many_async(paths, BATCH, &opts, loaded_batch, batch);
+    if (queued != BATCH) {
+        pthread_mutex_lock(&lock);
+        pending -= BATCH - queued;
+        pthread_mutex_unlock(&lock);
+    }
+    wait_all();
+    for (ok = queued == BATCH, i = 0; i < BATCH; i++) {
+        if (batch[i].called != 1 || test_int(batch[i].conf, "value") != i) ok = 0;
+        vconfig_close(batch[i].conf);
+        free(paths[i]);
+    }
+    RESULT("batch", ok);
+
+    return test_end();
+}
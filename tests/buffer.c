@@ -0,0 +1,141 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: buffer.c
+ *
+ * Parsing a buffer in place: each config is copied to the end of a
+ * read-only page with an inaccessible page after it, with no terminator,
+ * so reading past its length or writing to it faults.  Configs cut short
+ * at every byte are parsed the same way, and must fail or load without
+ * touching anything beyond their length.
+ */
+
+#include <sys/mman.h>
+
+#include "test.h"
+
+static char *page;          /* Read-only page, then a guard page */
+static long pagesize;
+
+static int listened;
+
+VC_DEF_DIRECTIVE(listen) {
+    char *host = VC_GETARG_STR();
+    int port = VC_GETARG_INT();
+    listened = !strcmp(host, "0.0.0.0") && port == 8080;
+    return 0;
+}
+
+static vc_directive directives[] = {
+    VC_DIRECTIVE(listen, 0, "si"),
+    {0, 0, "", 0}
+};
+
+/* Place data at the end of the page, just before the guard page */
+static const char *place(const char *data, size_t length) {
+    char *at = page + pagesize - length;
+
+    mprotect(page, pagesize, PROT_READ | PROT_WRITE);
+    memset(page, 'x', pagesize);
+    memcpy(at, data, length);
+    mprotect(page, pagesize, PROT_READ);
+    return at;
+}
+
+static vconfig *parse_placed(const char *data, size_t length, int flags) {
+    vc_params p = {0, directives, flags, &test_errors, 0};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_parse_buffer(place(data, length), length, &p);
+}
+
+static const char *full =
+    "port = 80\n"
+    "name = \"a \\\"quoted\\\" \\u00e9 value\"\n"
+    "alias = 'single' \"joined\"\n"
+    "ratio = 0.25\n"
+    "big = -1234567\n"
+    "timeout = 1.5s\n"
+    "ports = [80, 443]\n"
+    "listen \"0.0.0.0\" 8080\n"
+    "# a comment\n"
+    "[srv]\n"
+    "host = \"example.org\"; port = 443\n"
+    "[/srv]\n"
+    "last = true";
+
+int main(void) {
+    vconfig *vcfg;
+    vc_tape *tape;
+    size_t n, length = strlen(full);
+    int ok, flags;
+
+    test_begin("buffer");
+    pagesize = sysconf(_SC_PAGESIZE);
+    page = mmap(0, 2 * pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED || mprotect(page + pagesize, pagesize, PROT_NONE)) {
+        perror("mmap");
+        return 2;
+    }
+
+    /* The whole config, ending at the guard page without a newline */
+    for (flags = 0; flags <= VC_PARAM_INTERN_VALUES; flags += VC_PARAM_INTERN_VALUES) {
+        listened = 0;
+        vcfg = parse_placed(full, length, flags);
+        RESULT(flags ? "whole (interned)" : "whole",
+               vcfg && listened && test_int(vcfg, "port") == 80 &&
+               !strcmp(test_str(vcfg, "name"), "a \"quoted\" \xc3\xa9 value") &&
+               !strcmp(test_str(vcfg, "alias"), "singlejoined") && test_int(vcfg, "big") == -1234567 &&
+               !strcmp(test_str(vcfg, "srv.host"), "example.org") && test_int(vcfg, "srv.port") == 443 &&
+               vconfig_getbool(vcfg, "last") && *vconfig_getbool(vcfg, "last"));
+        vconfig_close(vcfg);
+    }
+
+    /* Strings are copied out, so the config outlives the buffer */
+    vcfg = parse_placed(full, length, 0);
+    mprotect(page, pagesize, PROT_READ | PROT_WRITE);
+    memset(page, 0, pagesize);
+    RESULT("copied", vcfg && !strcmp(test_str(vcfg, "srv.host"), "example.org"));
+    vconfig_close(vcfg);
+
+    /* Every prefix of it, which ends mid-token more often than not */
+    for (ok = 1, n = 0; n < length; n++) {
+        vcfg = parse_placed(full, n, 0);
+        if (!vcfg && test_error.type == VC_ERROR_SUCCESS) ok = 0;
+        vconfig_close(vcfg);
+    }
+    RESULT("prefixes", ok);
+
+    /* Tokens that scan ahead, cut off at the end of the buffer */
+    {
+        static const char *cut[] = {
+            "a = \"abc", "a = \"ab\\", "a = \"\\u00", "a = \"\\x4", "a = 'x", "a = \"x\" '",
+            "a = 12", "a = 1.", "a = 1e", "a = 5m", "a = 50%", "a = [1,", "a = [\"x\"",
+            "[sect", "[/", "# comment", "a", "a =", "include \"x", "listen \"0.0", "a = tru"
+        };
+        size_t i;
+
+        for (ok = 1, i = 0; i < sizeof(cut) / sizeof(cut[0]); i++) {
+            vcfg = parse_placed(cut[i], strlen(cut[i]), 0);
+            if (!vcfg && test_error.type == VC_ERROR_SUCCESS) ok = 0;
+            vconfig_close(vcfg);
+        }
+        RESULT("cut tokens", ok);
+    }
+
+    /* Tapes read the buffer the same way */
+    {
+        vc_params p = {0, directives, 0, &test_errors, 0};
+        tape = vconfig_tape_parse(place(full, length), length, &p);
+        RESULT("tape", tape != 0);
+    }
+    vconfig_tape_free(tape);
+
+    /* Nothing is read at all from an empty buffer */
+    vcfg = parse_placed("", 0, 0);
+    RESULT("empty", vcfg && !vconfig_getopt(vcfg, "port"));
+    vconfig_close(vcfg);
+
+    munmap(page, 2 * pagesize);
+    return test_end();
+}
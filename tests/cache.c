@@ -0,0 +1,169 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: cache.c
+ *
+ * The lookup cache: repeated lookups hit, absences included, and every
+ * edit, transaction or reload makes the next lookup walk the sections
+ * again, so nothing stale is ever returned.  Path buffers reused for
+ * another path, sections sharing a literal, long paths, evictions and
+ * other threads' caches are each answered as an uncached lookup would be.
+ */
+
+#include <pthread.h>
+
+#include "test.h"
+
+static vc_cache_stats stats;
+
+/* Counters since the last call */
+static uint64_t hits, misses;
+
+static void count(void) {
+    vc_cache_stats now;
+    vconfig_cache_stats(&now);
+    hits = now.hits - stats.hits;
+    misses = now.misses - stats.misses;
+    stats = now;
+}
+
+static vconfig *shared;
+static uint64_t thread_hits, thread_misses;
+static int thread_port;
+
+static void *lookups(void *arg) {
+    vc_cache_stats mine;
+    (void)arg;
+    thread_port = test_int(shared, "port");
+    thread_port = test_int(shared, "port");
+    vconfig_cache_stats(&mine);
+    thread_hits = mine.hits;
+    thread_misses = mine.misses;
+    return 0;
+}
+
+int main(void) {
+    char path[VC_CACHE_PATH * 2], name[32];
+    vconfig *vcfg, *other, *srv;
+    pthread_t thread;
+    vc_txn *txn;
+    int i, ok;
+
+    test_begin("cache");
+    vcfg = test_parse("port = 80\nname = \"edge\"\n[srv]\nport = 443\n[/srv]\n", VC_PARAM_LOOKUP_CACHE);
+    if (!vcfg) {
+        fprintf(stderr, "Couldn't parse the config\n");
+        return 2;
+    }
+    vconfig_cache_reset();
+    memset(&stats, 0, sizeof(stats));
+
+    /* The second lookup of a literal is a hit, whether or not the option
+     * is there */
+    ok = test_int(vcfg, "port") == 80;
+    count();
+    RESULT("miss", ok && misses == 1 && hits == 0);
+    ok = test_int(vcfg, "port") == 80 && vconfig_getopt(vcfg, "port") != 0;
+    count();
+    RESULT("hit", ok && hits == 2 && misses == 0);
+    ok = !vconfig_getint(vcfg, "missing") && !vconfig_getint(vcfg, "missing");
+    count();
+    RESULT("absent", ok && hits == 1 && misses == 1);
+
+    /* Edits change the config's generation, so what was cached before
+     * them is never returned */
+    ok = vconfig_set_int(vcfg, "port", 81) && test_int(vcfg, "port") == 81;
+    count();
+    RESULT("modified", ok && misses == 1 && test_int(vcfg, "port") == 81);
+    RESULT("added", vconfig_set_int(vcfg, "missing", 5) && test_int(vcfg, "missing") == 5);
+    RESULT("deleted", vconfig_delete(vcfg, "missing") && !vconfig_getint(vcfg, "missing") &&
+                      vconfig_delete(vcfg, "srv") && !vconfig_getint(vcfg, "srv.port"));
+    txn = vconfig_txn_begin(vcfg);
+    vconfig_txn_set_int(txn, "port", 82);
+    vconfig_txn_set_int(txn, "srv.port", 8443);
+    RESULT("transaction", vconfig_txn_commit(txn) && test_int(vcfg, "port") == 82 &&
+                          test_int(vcfg, "srv.port") == 8443);
+    txn = vconfig_txn_begin(vcfg);
+    vconfig_txn_set_int(txn, "port", 83);
+    vconfig_txn_delete(txn, "nothing");
+    RESULT("rolled back", !vconfig_txn_commit(txn) && test_int(vcfg, "port") == 82);
+
+    /* A buffer that now holds another path isn't taken for the first */
+    strcpy(name, "port");
+    ok = vconfig_getint(vcfg, name) && *vconfig_getint(vcfg, name) == 82;
+    strcpy(name, "srv.port");
+    RESULT("reused buffer", ok && vconfig_getint(vcfg, name) && *vconfig_getint(vcfg, name) == 8443);
+
+    /* The same literal looked up in a section, and in another config */
+    srv = vconfig_getsect(vcfg, "srv");
+    other = test_parse("port = 1\n", VC_PARAM_LOOKUP_CACHE);
+    RESULT("sections", srv && test_int(srv, "port") == 8443 && test_int(vcfg, "port") == 82 &&
+                       test_int(srv, "port") == 8443);
+    RESULT("other config", test_int(other, "port") == 1 && test_int(vcfg, "port") == 82);
+
+    /* A reload is a new config, even one at the same address */
+    for (ok = 1, i = 0; ok && i < 10; i++) {
+        vconfig_close(other);
+        snprintf(name, sizeof(name), "port = %d\n", i);
+        other = test_parse(name, VC_PARAM_LOOKUP_CACHE);
+        ok = test_int(other, "port") == i;
+    }
+    RESULT("reloaded", ok);
+    vconfig_close(other);
+
+    /* Long paths are looked up without the cache */
+    memset(path, 0, sizeof(path));
+    for (i = 0; i < VC_CACHE_PATH; i += 2) strcat(path, "a.");
+    strcat(path, "port");
+    ok = vconfig_set_int(vcfg, path, 7) && test_int(vcfg, path) == 7;
+    count();
+    ok = ok && test_int(vcfg, path) == 7;
+    count();
+    RESULT("long path", ok && hits == 0);
+
+    /* More paths than the cache holds evict each other, and are still
+     * found */
+    for (ok = 1, i = 0; ok && i < VC_CACHE_SIZE * 2; i++) {
+        snprintf(name, sizeof(name), "k%d", i);
+        ok = vconfig_set_int(vcfg, name, i);
+    }
+    {
+        static char keys[VC_CACHE_SIZE * 2][8];
+        vc_cache_stats before, after;
+
+        vconfig_cache_stats(&before);
+        for (i = 0; ok && i < VC_CACHE_SIZE * 2; i++) {
+            snprintf(keys[i], sizeof(keys[i]), "k%d", i);
+            ok = test_int(vcfg, keys[i]) == i;
+        }
+        for (i = 0; ok && i < VC_CACHE_SIZE * 2; i++) ok = test_int(vcfg, keys[i]) == i;
+        vconfig_cache_stats(&after);
+        RESULT("evictions", ok && after.evictions > before.evictions);
+    }
+
+    /* Each thread has a cache and counters of its own */
+    shared = vcfg;
+    count();
+    pthread_create(&thread, 0, lookups, 0);
+    pthread_join(thread, 0);
+    count();
+    RESULT("threads", thread_port == 82 && thread_misses == 1 && thread_hits == 1 && hits == 0 && misses == 0);
+
+    /* Reset empties the cache and zeroes the counters */
+    vconfig_cache_reset();
+    vconfig_cache_stats(&stats);
+    ok = !stats.hits && !stats.misses && !stats.evictions && test_int(vcfg, "port") == 82;
+    count();
+    RESULT("reset", ok && misses == 1);
+
+    /* Configs without the flag don't use it */
+    other = test_parse("port = 2\n", 0);
+    ok = test_int(other, "port") == 2 && test_int(other, "port") == 2;
+    count();
+    RESULT("uncached", ok && hits == 0 && misses == 0);
+    vconfig_close(other);
+
+    vconfig_close(vcfg);
+    return test_end();
+}
@@ -0,0 +1,169 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: diff.c
+ *
+ * Diffs: options added, removed and modified, sections added or removed
+ * reported once, content hashes that ignore the order of options but not
+ * their values, includes and shadowing as lookups see them, and hashes
+ * kept up to date by edits.
+ */
+
+#include "test.h"
+
+#define MAX_CHANGES 32
+
+/* Changes reported, as "+path", "-path" or "~path", sorted at the end */
+typedef struct changes {
+    char found[MAX_CHANGES][64];
+    int n;
+    int stop;               /* Stop after this many; 0 for never */
+    int consistent;         /* Whether before and after fit each change */
+} changes;
+
+static int collect(const char *path, vc_diff_change change, vc_opt *before, vc_opt *after, void *ctx) {
+    changes *c = (changes *)ctx;
+
+    if (c->n < MAX_CHANGES) snprintf(c->found[c->n], sizeof(c->found[0]), "%c%s", "+-~"[change], path);
+    if ((change == VC_DIFF_ADDED && (before || !after)) || (change == VC_DIFF_REMOVED && (!before || after)) ||
+        (change == VC_DIFF_MODIFIED && (!before || !after))) {
+        c->consistent = 0;
+    }
+    c->n++;
+    return c->stop && c->n >= c->stop;
+}
+
+static int compare(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+/* Whether a diff reports exactly the changes expected, a space-separated
+ * list in sorted order */
+static int diff(vconfig *before, vconfig *after, const char *expect) {
+    char joined[MAX_CHANGES * 64] = "";
+    changes c;
+    long count;
+    int i;
+
+    memset(&c, 0, sizeof(c));
+    c.consistent = 1;
+    count = vconfig_diff(before, after, collect, &c);
+    if (count != c.n || c.n > MAX_CHANGES || !c.consistent) return 0;
+    qsort(c.found, c.n, sizeof(c.found[0]), compare);
+    for (i = 0; i < c.n; i++) {
+        if (i) strcat(joined, " ");
+        strcat(joined, c.found[i]);
+    }
+    if (strcmp(joined, expect)) {
+        printf("\t\t%s\n", joined);
+        return 0;
+    }
+    return 1;
+}
+
+static int same_hash(vconfig *a, vconfig *b) {
+    return a && b && a->hashed && b->hashed && a->hash.lo == b->hash.lo && a->hash.hi == b->hash.hi;
+}
+
+static const char *base =
+    "port = 80\n"
+    "name = \"edge\"\n"
+    "ratio = 0.0\n"
+    "ports = [80, 443]\n"
+    "timeout = 30s\n"
+    "[srv]\n"
+    "host = \"a\"\n"
+    "[tls]\n"
+    "level = 2\n"
+    "[/tls]\n"
+    "[/srv]\n"
+    "[log]\n"
+    "level = 1\n"
+    "[/log]\n";
+
+int main(void) {
+    vconfig *a, *b, *inc, *img;
+    vc_publisher *pub;
+    char name[64];
+    changes c;
+
+    test_begin("diff");
+    a = test_parse(base, 0);
+    if (!a) {
+        fprintf(stderr, "Couldn't parse the config\n");
+        return 2;
+    }
+
+    /* The same options, in another order, hash the same and differ in
+     * nothing */
+    b = test_parse("[log]\nlevel = 1\n[/log]\ntimeout = 30s\nports = [80, 443]\n[srv]\n[tls]\nlevel = 2\n[/tls]\n"
+                   "host = \"a\"\n[/srv]\nratio = 0.0\nname = \"edge\"\nport = 80\n", 0);
+    RESULT("reordered", same_hash(a, b) && diff(a, b, ""));
+    vconfig_close(b);
+
+    /* Each kind of change, with both sides of it */
+    b = test_parse("port = 81\nname = \"edge\"\nratio = 0.0\nports = [80, 8443]\ntimeout = 30s\nextra = 1\n"
+                   "[srv]\nhost = 5\n[tls]\nlevel = 2\n[/tls]\n[/srv]\n", 0);
+    RESULT("changes", !same_hash(a, b) && diff(a, b, "+extra -log ~port ~ports ~srv.host"));
+    RESULT("reversed", diff(b, a, "+log -extra ~port ~ports ~srv.host"));
+    vconfig_close(b);
+
+    /* A section added or removed is one change; an option changed deep
+     * down changes the hash of each section above it */
+    b = test_parse(base, 0);
+    RESULT("sections", vconfig_set_int(b, "new.deep.port", 1) && vconfig_set_int(b, "srv.tls.level", 3) &&
+                       vconfig_delete(b, "log") && diff(a, b, "+new -log ~srv.tls.level") &&
+                       !same_hash(vconfig_getsect(a, "srv"), vconfig_getsect(b, "srv")));
+
+    /* Edits rehash, so undoing them hashes as before */
+    RESULT("undone", vconfig_set_int(b, "srv.tls.level", 2) && vconfig_delete(b, "new") &&
+                     vconfig_set_int(b, "log.level", 1) && diff(a, b, "") && same_hash(a, b));
+    RESULT("durations", vconfig_set_duration_ns(b, "timeout", 31000000000LL) && diff(a, b, "~timeout") &&
+                        vconfig_set_duration_ns(b, "timeout", 30000000000LL) && same_hash(a, b));
+    vconfig_close(b);
+
+    /* Floats are compared bit for bit */
+    b = test_parse("port = 80\nname = \"edge\"\nratio = -0.0\nports = [80, 443]\ntimeout = 30s\n"
+                   "[srv]\nhost = \"a\"\n[tls]\nlevel = 2\n[/tls]\n[/srv]\n[log]\nlevel = 1\n[/log]\n", 0);
+    RESULT("floats", diff(a, b, "~ratio"));
+    vconfig_close(b);
+
+    /* An option in an included file is the same as one written out, and
+     * shadowing hides an included value from the diff */
+    if (!test_write("log.cfg", "[log]\nlevel = 1\n[/log]\n") ||
+        !test_write("shadow.cfg", "port = 9\n[log]\nlevel = 1\n[/log]\n") ||
+        !test_write("inc.cfg", "port = 80\nname = \"edge\"\nratio = 0.0\nports = [80, 443]\ntimeout = 30s\n"
+                               "[srv]\nhost = \"a\"\n[tls]\nlevel = 2\n[/tls]\n[/srv]\ninclude \"log.cfg\"\n") ||
+        !test_write("shadowed.cfg", "port = 80\nname = \"edge\"\nratio = 0.0\nports = [80, 443]\ntimeout = 30s\n"
+                                    "[srv]\nhost = \"a\"\n[tls]\nlevel = 2\n[/tls]\n[/srv]\n"
+                                    "include \"shadow.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+    inc = test_open("inc.cfg", 0, 0);
+    RESULT("included", inc && diff(a, inc, "") && diff(inc, a, ""));
+    vconfig_close(inc);
+    inc = test_open("shadowed.cfg", 0, 0);
+    RESULT("shadowed", inc && diff(a, inc, "") && test_int(inc, "port") == 80);
+    vconfig_close(inc);
+
+    /* A nonzero return stops the diff */
+    b = test_parse("port = 1\nname = \"x\"\nratio = 1.0\n", 0);
+    memset(&c, 0, sizeof(c));
+    c.stop = 2;
+    RESULT("stop", vconfig_diff(a, b, collect, &c) == 2 && c.n == 2);
+    vconfig_close(b);
+
+    /* Images have no hashes to compare */
+    snprintf(name, sizeof(name), "/vctest-diff-%d", (int)getpid());
+    pub = vconfig_publisher_open(name);
+    img = pub && vconfig_publish(pub, a) ? vconfig_attach(name) : 0;
+    RESULT("image", img && vconfig_diff(a, img, collect, &c) == -1 && vconfig_diff(img, a, collect, &c) == -1);
+    vconfig_close(img);
+    vconfig_publisher_close(pub);
+    vconfig_unpublish(name);
+
+    vconfig_close(a);
+    return test_end();
+}
@@ -0,0 +1,117 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: directive.c
+ *
+ * Directives: arguments of each type, the ways a call can end, calls
+ * with too few or too many arguments or arguments of the wrong type,
+ * string arguments too long to copy, and directives that fail.
+ */
+
+#include "test.h"
+
+static char host[64];
+static int port, calls;
+static double weight;
+
+VC_DEF_DIRECTIVE(listen) {
+    char *h = VC_GETARG_STR();
+    int p = VC_GETARG_INT();
+    snprintf(host, sizeof(host), "%s", h);
+    port = p;
+    calls++;
+    return 0;
+}
+
+VC_DEF_DIRECTIVE(weigh) {
+    double w = VC_GETARG_FLOAT();
+    int on = VC_GETARG_BOOL();
+    weight = on ? w : -1;
+    calls++;
+    return 0;
+}
+
+VC_DEF_DIRECTIVE(mark) {
+    calls++;
+    return 0;
+}
+
+VC_DEF_DIRECTIVE(fail) {
+    calls++;
+    return -3;
+}
+
+static vc_directive directives[] = {
+    VC_DIRECTIVE(listen, 0, "si"),
+    VC_DIRECTIVE(weigh, 0, "fb"),
+    VC_DIRECTIVE(mark, 0, ""),
+    VC_DIRECTIVE(fail, 0, ""),
+    {0, 0, "", 0}
+};
+
+/* Parse a config with the directives, counting calls from zero.  Returns
+ * nonzero if it loaded. */
+static int run(const char *text) {
+    vc_params p = {0, directives, 0, &test_errors, 0};
+    vconfig *vcfg;
+
+    calls = 0;
+    test_error.type = VC_ERROR_SUCCESS;
+    vcfg = vconfig_parse_buffer(text, strlen(text), &p);
+    vconfig_close(vcfg);
+    return vcfg != 0;
+}
+
+int main(void) {
+    char *text;
+    size_t n;
+
+    test_begin("directive");
+
+    RESULT("arguments", run("listen \"0.0.0.0\" 8080\nweigh 2 true\n") && calls == 2 &&
+                        !strcmp(host, "0.0.0.0") && port == 8080 && weight == 2.0);
+    RESULT("no arguments", run("mark\nmark\n") && calls == 2);
+
+    /* A call ends at a newline, semicolon, comment or the end of the file */
+    RESULT("semicolon", run("listen \"a\" 1; listen \"b\" 2; port = 3\n") && calls == 2 &&
+                        !strcmp(host, "b") && port == 2);
+    RESULT("comment", run("listen \"a\" 1 # the public port\nmark # none\n") && calls == 2);
+    RESULT("end of file", run("listen \"a\" 4") && calls == 1 && port == 4);
+
+    /* Too few arguments, however the statement ends */
+    RESULT("too few", !run("listen \"a\"\nport = 1\n") && calls == 0 &&
+                      test_error.type == VC_ERROR_DIRECTIVE_ARGS && strstr(test_error.msg, "too few"));
+    RESULT("too few at end", !run("listen \"a\"") && calls == 0 && test_error.type == VC_ERROR_DIRECTIVE_ARGS);
+    RESULT("too few before ;", !run("weigh 1.5; mark\n") && calls == 0 &&
+                               test_error.type == VC_ERROR_DIRECTIVE_ARGS);
+
+    /* Too many, which were once parsed as statements of their own */
+    RESULT("too many", !run("listen \"a\" 80 81\n") && calls == 0 &&
+                       test_error.type == VC_ERROR_DIRECTIVE_ARGS && strstr(test_error.msg, "too many"));
+    RESULT("too many strings", !run("listen \"a\" 80 \"b\"\n") && calls == 0 &&
+                               test_error.type == VC_ERROR_DIRECTIVE_ARGS);
+    RESULT("arguments to none", !run("mark port = 1\n") && calls == 0 &&
+                                test_error.type == VC_ERROR_DIRECTIVE_ARGS);
+
+    /* Wrong types */
+    RESULT("wrong type", !run("listen 80 \"a\"\n") && test_error.type == VC_ERROR_EXPECTED);
+    RESULT("float from int", run("weigh 3 false\n") && weight == -1);
+    RESULT("int range", !run("listen \"a\" 4294967296\n") && test_error.type == VC_ERROR_NUMBER_RANGE);
+
+    /* Strings copied off the buffer must fit the argument buffer */
+    n = VC_DIRECTIVE_STRBUF + 16;
+    text = (char *)malloc(n + 32);
+    memcpy(text, "listen \"", 8);
+    memset(text + 8, 'h', n);
+    strcpy(text + 8 + n, "\" 80\n");
+    RESULT("long string", !run(text) && calls == 0 && test_error.type == VC_ERROR_DIRECTIVE_ARGS &&
+                          strstr(test_error.msg, "too long"));
+    free(text);
+
+    /* A failing directive stops the parse */
+    RESULT("failed", !run("mark\nfail\nmark\n") && calls == 2 && test_error.type == VC_ERROR_DIRECTIVE_FAILED &&
+                     strstr(test_error.msg, "(-3)"));
+
+    return test_end();
+}
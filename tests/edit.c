@@ -0,0 +1,89 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: edit.c
+ *
+ * Edits and transactions: setting, deleting, transactions applied all
+ * or not at all, edits that must not reach other configs through shared
+ * sections or included files, and string values in interning configs.
+ */
+
+#include "test.h"
+
+int main(void) {
+    vconfig *a, *b, *srv;
+    vc_stats before, after;
+    vc_txn *txn;
+    char value[32];
+    int i, ok;
+
+    test_begin("edit");
+
+    /* Single edits, including sections created along the path */
+    a = test_parse("port = 80\nname = \"a\"\n[srv]\nport = 8080\n[/srv]\n", 0);
+    ok = vconfig_set_int(a, "port", 81) && vconfig_set_str(a, "name", "renamed") &&
+         vconfig_set_int(a, "new.deep.port", 9) && vconfig_delete(a, "srv.port");
+    RESULT("edits", ok && test_int(a, "port") == 81 && !strcmp(test_str(a, "name"), "renamed") &&
+                    test_int(a, "new.deep.port") == 9 && !vconfig_getopt(a, "srv.port"));
+    ok = !vconfig_set_int(a, "port.x", 1) && !vconfig_delete(a, "missing") && !vconfig_set_int(a, "srv", 1);
+    RESULT("bad edits", ok);
+
+    /* A transaction with a failing edit leaves the config as it was */
+    txn = vconfig_txn_begin(a);
+    vconfig_txn_set_int(txn, "port", 1);
+    vconfig_txn_set_str(txn, "name", "txn");
+    vconfig_txn_delete(txn, "missing");
+    ok = vconfig_txn_commit(txn);
+    RESULT("txn rollback", !ok && test_int(a, "port") == 81 &&
+                           !strcmp(test_str(a, "name"), "renamed"));
+    txn = vconfig_txn_begin(a);
+    vconfig_txn_set_int(txn, "port", 2);
+    vconfig_txn_mkdir_sect(txn, "empty");
+    ok = vconfig_txn_commit(txn);
+    RESULT("txn commit", ok && test_int(a, "port") == 2 &&
+                         vconfig_getsect(a, "empty"));
+    vconfig_close(a);
+
+    /* A shared section, reached through one config, isn't edited for all */
+    a = test_parse("[srv]\nport = 80\n[/srv]\n", VC_PARAM_SHARE_SECTIONS);
+    b = test_parse("[srv]\nport = 80\n[/srv]\n", VC_PARAM_SHARE_SECTIONS);
+    srv = vconfig_getsect(a, "srv");
+    ok = srv && srv == vconfig_getsect(b, "srv") && !vconfig_set_int(srv, "port", 443) && !vconfig_txn_begin(srv);
+    RESULT("shared base", ok && test_int(b, "srv.port") == 80);
+    ok = vconfig_set_int(a, "srv.port", 443);
+    RESULT("shared path", ok && test_int(a, "srv.port") == 443 && test_int(b, "srv.port") == 80);
+    vconfig_close(a);
+    vconfig_close(b);
+
+    /* Nor is a section of an included file */
+    if (!test_write("tls.cfg", "[tls]\nciphers = \"HIGH\"\n[/tls]\n") ||
+        !test_write("root.cfg", "include \"tls.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+    a = test_open("root.cfg", 0, 0);
+    b = test_open("root.cfg", 0, 0);
+    ok = a && b && !vconfig_set_str(vconfig_getsect(a, "tls"), "ciphers", "NULL");
+    RESULT("included base", ok && !strcmp(test_str(b, "tls.ciphers"), "HIGH"));
+    ok = vconfig_set_str(a, "tls.ciphers", "LOW");
+    RESULT("included shadow", ok && !strcmp(test_str(a, "tls.ciphers"), "LOW") &&
+                              !strcmp(test_str(b, "tls.ciphers"), "HIGH"));
+    vconfig_close(a);
+    vconfig_close(b);
+
+    /* Values set in a config interning its values don't pile up in its
+     * pool */
+    a = test_parse("name = \"first\"\n", VC_PARAM_INTERN_VALUES);
+    vconfig_stats(a, &before);
+    for (ok = 1, i = 0; i < 1000; i++) {
+        snprintf(value, sizeof(value), "value-%d", i);
+        if (!vconfig_set_str(a, "name", value)) ok = 0;
+    }
+    vconfig_stats(a, &after);
+    RESULT("interned values", ok && !strcmp(test_str(a, "name"), "value-999") &&
+                              after.intern_strings == before.intern_strings);
+    vconfig_close(a);
+
+    return test_end();
+}
@@ -0,0 +1,56 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: error.c
+ *
+ * Error reports: the file and line of a syntax error, file names that
+ * look like format directives reported as they are, and messages longer
+ * than the buffer cut short rather than overrun.
+ */
+
+#include "test.h"
+
+int main(void) {
+    char path[PATH_MAX], name[251], expect[PATH_MAX + 16];
+    vconfig *vcfg;
+
+    test_begin("error");
+
+    /* File and line come before the message */
+    if (mkdir(test_path(path, sizeof(path), "d%n"), 0755) ||
+        !test_write("plain.cfg", "port = 80\nport 81\n") ||
+        !test_write("d%n/x%s%s%s%s%n.cfg", "port = 80\nport 81\n") ||
+        !test_write("inc.cfg", "include \"d%n/x%s%s%s%s%n.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+    vcfg = test_open("plain.cfg", 0, 0);
+    snprintf(expect, sizeof(expect), "%s:2: ", test_path(path, sizeof(path), "plain.cfg"));
+    RESULT("file and line", !vcfg && test_error.type != VC_ERROR_SUCCESS &&
+                            !strncmp(test_error.msg, expect, strlen(expect)));
+
+    /* A path full of conversions is printed, not interpreted */
+    vcfg = test_open("d%n/x%s%s%s%s%n.cfg", 0, 0);
+    snprintf(expect, sizeof(expect), "%s:2: ", test_path(path, sizeof(path), "d%n/x%s%s%s%s%n.cfg"));
+    RESULT("percent in path", !vcfg && test_error.type != VC_ERROR_SUCCESS &&
+                              !strncmp(test_error.msg, expect, strlen(expect)));
+    vcfg = test_open("inc.cfg", 0, 0);
+    RESULT("percent in include", !vcfg && test_error.type != VC_ERROR_SUCCESS &&
+                                 strstr(test_error.msg, "x%s%s%s%s%n.cfg"));
+
+    /* A name filling the buffer leaves the message cut, and terminated */
+    memset(name, 'a', sizeof(name) - 5);
+    strcpy(name + sizeof(name) - 5, ".cfg");
+    name[200] = '%';
+    name[201] = 'd';
+    if (!test_write(name, "port 81\n")) {
+        perror("write");
+        return 2;
+    }
+    vcfg = test_open(name, 0, 0);
+    RESULT("long path", !vcfg && test_error.type != VC_ERROR_SUCCESS &&
+                        strlen(test_error.msg) == VC_ERROR_MSG_SIZE - 1 && strstr(test_error.msg, "%d"));
+
+    return test_end();
+}
@@ -0,0 +1,109 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: flatten.c
+ *
+ * Flattening views: earlier layers win, sections merge, and a flatten
+ * that runs out of memory part way fails as a whole, leaking nothing.
+ * Flattened configs come from malloc, so this test replaces it, failing
+ * the nth allocation made while a flatten runs.
+ */
+
+#include "test.h"
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static long armed = -1;     /* Allocations left before one fails; -1: off */
+static long live;           /* Allocations not yet freed */
+
+/* Count an allocation, or fail it.  Returns zero if it must fail. */
+static int take(void) {
+    if (armed == 0) return 0;
+    if (armed > 0) armed--;
+    return 1;
+}
+
+void *malloc(size_t size) {
+    void *p = take() ? __libc_malloc(size) : 0;
+    if (p) live++;
+    return p;
+}
+
+void *calloc(size_t n, size_t size) {
+    void *p = take() ? __libc_calloc(n, size) : 0;
+    if (p) live++;
+    return p;
+}
+
+void *realloc(void *ptr, size_t size) {
+    void *p;
+    if (!take()) return 0;
+    p = __libc_realloc(ptr, size);
+    if (p && !ptr) live++;
+    return p;
+}
+
+void free(void *ptr) {
+    if (ptr) live--;
+    __libc_free(ptr);
+}
+
+/* Whether a flattened config has every option, from the right layer */
+static int complete(vconfig *flat) {
+    return test_int(flat, "port") == 443 && !strcmp(test_str(flat, "name"), "base") &&
+           test_int(flat, "srv.port") == 8443 && !strcmp(test_str(flat, "srv.host"), "a") &&
+           test_int(flat, "srv.tls.level") == 2 && test_int(flat, "log.level") == 3;
+}
+
+int main(void) {
+    vconfig *base, *top, *flat;
+    vc_view *view;
+    long n, before, total;
+    int failed, ok;
+
+    test_begin("flatten");
+    base = test_parse("port = 80\nname = \"base\"\n[srv]\nport = 80\nhost = \"a\"\n[tls]\nlevel = 2\n[/tls]\n[/srv]\n", 0);
+    top = test_parse("port = 443\n[srv]\nport = 8443\n[/srv]\n[log]\nlevel = 3\n[/log]\n", 0);
+    view = vconfig_view_create();
+    if (!base || !top || !view || !vconfig_layer_push(view, base) || !vconfig_layer_push(view, top)) {
+        fprintf(stderr, "Couldn't build the view\n");
+        return 2;
+    }
+
+    armed = 1000000;
+    flat = vconfig_flatten(view);
+    total = 1000000 - armed;
+    armed = -1;
+    RESULT("merged", complete(flat));
+    vconfig_close(flat);
+
+    /* Fail each allocation a flatten makes in turn.  Each either fails
+     * the flatten, or is one it can do without. */
+    for (failed = 0, ok = 1, n = 0; n < total; n++) {
+        before = live;
+        armed = n;
+        flat = vconfig_flatten(view);
+        armed = -1;
+        if (!flat) {
+            failed++;
+        } else if (!complete(flat)) {
+            printf("\t\tallocation %ld: incomplete\n", n);
+            ok = 0;
+        }
+        vconfig_close(flat);
+        if (live != before) {
+            printf("\t\tallocation %ld: %ld leaked\n", n, live - before);
+            ok = 0;
+        }
+    }
+    RESULT("out of memory", ok && total > 10 && failed > total / 2);
+
+    vconfig_view_destroy(view);
+    vconfig_close(top);
+    vconfig_close(base);
+    return test_end();
+}
@@ -0,0 +1,66 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: gen.c
+ *
+ * Generated accessors: a header written by vconfig-gen from tests/gen.cfg
+ * compiles, and each accessor finds what a lookup by the option's path
+ * does, in configs of the same shape, configs missing the options, and
+ * configs holding other types at the same paths.
+ */
+
+#include "test.h"
+#include "gen-test.h"
+
+/* Each accessor against the getter for its path */
+static int same(vconfig *vcfg) {
+    return gt_port(vcfg) == vconfig_getint(vcfg, "port") &&
+           gt_name(vcfg) == vconfig_getstr(vcfg, "name") &&
+           gt_debug(vcfg) == vconfig_getbool(vcfg, "debug") &&
+           gt_weight(vcfg) == vconfig_getvaln(vcfg, "weight", 6, VC_FLOAT) &&
+           gt_timeout(vcfg) == vconfig_getduration_ns(vcfg, "timeout") &&
+           gt_cache(vcfg) == vconfig_getbytes(vcfg, "cache") &&
+           gt_load(vcfg) == vconfig_getratio(vcfg, "load") &&
+           gt_ports(vcfg) == vconfig_getarray(vcfg, "ports") &&
+           gt_server(vcfg) == vconfig_getsect(vcfg, "server") &&
+           gt_server_port(vcfg) == vconfig_getint(vcfg, "server.port") &&
+           gt_server_host_name(vcfg) == vconfig_getstr(vcfg, "server.host-name") &&
+           gt_server_tls(vcfg) == vconfig_getsect(vcfg, "server.tls") &&
+           gt_server_tls_level(vcfg) == vconfig_getint(vcfg, "server.tls.level");
+}
+
+int main(void) {
+    vconfig *vcfg;
+
+    test_begin("gen");
+
+    /* The same shape as the reference, with other values */
+    vcfg = test_parse("port = 8080\nname = \"core\"\ndebug = false\nweight = 2.5\n"
+                      "timeout = 1m\ncache = 1GiB\nload = 10%\nports = [1, 2, 3]\n"
+                      "[server]\nport = 8443\nhost-name = \"b\"\n[tls]\nlevel = 3\n[/tls]\n[/server]\n", 0);
+    RESULT("values", vcfg && gt_port(vcfg) && *gt_port(vcfg) == 8080 && !strcmp(gt_name(vcfg), "core") &&
+                     *gt_timeout(vcfg) == 60000000000LL && *gt_server_tls_level(vcfg) == 3 &&
+                     !strcmp(gt_server_host_name(vcfg), "b"));
+    RESULT("same as lookups", vcfg && same(vcfg));
+    vconfig_close(vcfg);
+
+    /* Options missing, in part or altogether */
+    vcfg = test_parse("port = 1\n[server]\n[/server]\n", 0);
+    RESULT("missing", vcfg && same(vcfg) && gt_port(vcfg) && !gt_name(vcfg) && !gt_server_port(vcfg) &&
+                      !gt_server_tls_level(vcfg));
+    vconfig_close(vcfg);
+
+    /* Other types at the same paths */
+    vcfg = test_parse("port = \"80\"\nname = 1\nserver = 2\ndebug = 1\ntimeout = 30\n", 0);
+    RESULT("other types", vcfg && same(vcfg) && !gt_port(vcfg) && !gt_name(vcfg) && !gt_server(vcfg) &&
+                          !gt_server_port(vcfg) && !gt_debug(vcfg) && !gt_timeout(vcfg));
+    vconfig_close(vcfg);
+
+    /* Keys hashed under a seed are rehashed at lookup */
+    vcfg = test_parse("port = 9\n[server]\n[tls]\nlevel = 4\n[/tls]\n[/server]\n", VC_PARAM_SEEDED_HASH);
+    RESULT("seeded", vcfg && same(vcfg) && *gt_port(vcfg) == 9 && *gt_server_tls_level(vcfg) == 4);
+    vconfig_close(vcfg);
+
+    return test_end();
+}
@@ -0,0 +1,145 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: hashing.c
+ *
+ * Hash tables: growth as entries are added and removed, with every key
+ * still found and every used bucket indexed once; and seeded hashing,
+ * which spreads keys built to collide under djb2, in tables and in
+ * configs opened with VC_PARAM_SEEDED_HASH.
+ */
+
+#include <stdint.h>
+
+#include "test.h"
+
+#define FLOOD_BLOCKS 10         /* 1024 keys of one djb2 hash */
+
+/* Key i of the flood: each bit picks "az" or "bY", which djb2 hashes the
+ * same */
+static void flood_key(char *key, long i) {
+    int b;
+    for (b = 0; b < FLOOD_BLOCKS; b++) memcpy(key + 2 * b, (i >> b) & 1 ? "bY" : "az", 2);
+    key[2 * FLOOD_BLOCKS] = '\0';
+}
+
+/* Longest chain in a table */
+static uint32_t longest(fasthash_table *table) {
+    uint32_t b, n, most = 0;
+    fasthash_node *node;
+
+    for (b = 0; table && b < table->size; b++) {
+        for (n = 0, node = table->entries[b]; node; node = node->next) n++;
+        if (n > most) most = n;
+    }
+    return most;
+}
+
+/* Every key 0..n-1 (as "k<i>") is found, and each used bucket is in the
+ * index exactly once */
+static int consistent(fasthash_table *table, long n, long step) {
+    char key[16];
+    uint32_t b, used = 0, indexed = 0;
+    index_node *in;
+    long i;
+
+    for (i = 0; i < n; i += step) {
+        snprintf(key, sizeof(key), "k%ld", i);
+        if (!fasthash_lookup(table, key) || (long)(uintptr_t)fasthash_lookup(table, key)->data != i + 1) return 0;
+    }
+    for (b = 0; b < table->size; b++) used += table->entries[b] != 0;
+    for (in = table->index_list; in; in = in->next) {
+        if (!table->entries[in->index]) return 0;
+        indexed++;
+    }
+    return used == indexed;
+}
+
+int main(void) {
+    char key[2 * FLOOD_BLOCKS + 8], *text, *p;
+    fasthash_table *table, *other;
+    vconfig *vcfg, *sect;
+    long i;
+    int ok;
+
+    test_begin("hashing");
+
+    /* Tables double as they fill, keeping chains short */
+    table = fasthash_init(8, 0, 0, 0, 0);
+    for (ok = table != 0, i = 0; ok && i < 5000; i++) {
+        snprintf(key, sizeof(key), "k%ld", i);
+        ok = fasthash_insert(table, key, (void *)(uintptr_t)(i + 1)) < table->size;
+    }
+    RESULT("growth", ok && table->count == 5000 && table->size >= 5000 / FH_LOAD_FACTOR &&
+                     longest(table) < 16 && consistent(table, 5000, 1));
+
+    /* Removing every other key empties buckets, which leave the index */
+    for (i = 1; ok && i < 5000; i += 2) {
+        snprintf(key, sizeof(key), "k%ld", i);
+        ok = (long)(uintptr_t)fasthash_remove(table, key) == i + 1;
+    }
+    snprintf(key, sizeof(key), "k%d", 1);
+    RESULT("removal", ok && table->count == 2500 && !fasthash_lookup(table, key) && consistent(table, 5000, 2));
+    fasthash_cleanup(table);
+
+    /* djb2 can't tell the flood keys apart */
+    table = fasthash_init(256, 0, 0, 0, 0);
+    for (ok = table != 0, i = 0; ok && i < (1L << FLOOD_BLOCKS); i++) {
+        flood_key(key, i);
+        ok = fasthash_insert(table, key, (void *)(uintptr_t)(i + 1)) < table->size;
+    }
+    RESULT("flood, djb2", ok && longest(table) == (1U << FLOOD_BLOCKS));
+    fasthash_cleanup(table);
+
+    /* A seeded table spreads them, and finds them whatever hash it's
+     * handed */
+    table = fasthash_init(256, FH_KEYED, 0, 0, 0);
+    for (ok = table != 0, i = 0; ok && i < (1L << FLOOD_BLOCKS); i++) {
+        flood_key(key, i);
+        ok = fasthash_insert(table, key, (void *)(uintptr_t)(i + 1)) < table->size;
+    }
+    for (i = 0; ok && i < (1L << FLOOD_BLOCKS); i++) {
+        flood_key(key, i);
+        ok = fasthash_lookup_hashed(table, key, strlen(key), 0) == fasthash_lookup(table, key) &&
+             (long)(uintptr_t)fasthash_lookup(table, key)->data == i + 1;
+    }
+    RESULT("flood, seeded", ok && longest(table) < 16);
+
+    /* Each seeded table draws its own seed */
+    other = fasthash_init(256, FH_KEYED, 0, 0, 0);
+    RESULT("seeds", other && memcmp(table->seed, other->seed, sizeof(table->seed)) &&
+                    hash_siphash13(table->seed, (unsigned char *)"key", 3) ==
+                    hash_siphash13(table->seed, (unsigned char *)"key", 3) &&
+                    hash_siphash13(table->seed, (unsigned char *)"key", 3) !=
+                    hash_siphash13(other->seed, (unsigned char *)"key", 3));
+    fasthash_cleanup(other);
+    fasthash_cleanup(table);
+
+    /* A config of flood keys, opened with seeded hashing */
+    text = (char *)malloc((2 * FLOOD_BLOCKS + 16) << FLOOD_BLOCKS);
+    p = text + sprintf(text, "[flood]\n");
+    for (i = 0; i < (1L << FLOOD_BLOCKS); i++) {
+        flood_key(key, i);
+        p += sprintf(p, "%s = %ld\n", key, i);
+    }
+    strcpy(p, "[/flood]\n");
+    vcfg = test_parse(text, VC_PARAM_SEEDED_HASH);
+    sect = vcfg ? vconfig_getsect(vcfg, "flood") : 0;
+    strcpy(key, "flood.");
+    for (ok = sect != 0, i = 0; ok && i < (1L << FLOOD_BLOCKS); i++) {
+        flood_key(key + 6, i);
+        ok = test_int(vcfg, key) == i;
+    }
+    RESULT("seeded config", ok && (vcfg->root->pool->opts & FH_KEYED) && longest(sect->ht) < 16);
+    vconfig_close(vcfg);
+
+    /* Without the flag, the same config loads the same, only slower */
+    vcfg = test_parse(text, 0);
+    flood_key(key + 6, 77);
+    RESULT("unseeded config", vcfg && !(vcfg->root->pool->opts & FH_KEYED) && test_int(vcfg, key) == 77);
+    vconfig_close(vcfg);
+    free(text);
+
+    return test_end();
+}
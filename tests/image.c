@@ -0,0 +1,143 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: image.c
+ *
+ * Shared-memory images: publishing and attaching, images whose offsets
+ * point outside the segment, waiting for updates, with and without one
+ * arriving, and the image outliving its publisher until unpublished.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "test.h"
+
+static vc_publisher *pub;
+static vconfig *src;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Publish again, once the main thread is waiting */
+static void *republish(void *arg) {
+    (void)arg;
+    usleep(50000);
+    vconfig_publish(pub, src);
+    return 0;
+}
+
+/* Map the image of a generation writable, to damage it */
+static char *image_map(const char *name, uint32_t gen, size_t *size) {
+    char iname[128];
+    struct stat st;
+    char *base;
+    int fd;
+
+    snprintf(iname, sizeof(iname), "%s.%u", name, gen);
+    if ((fd = shm_open(iname, O_RDWR, 0)) < 0) return 0;
+    if (fstat(fd, &st)) {
+        close(fd);
+        return 0;
+    }
+    base = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    *size = st.st_size;
+    return base == MAP_FAILED ? 0 : base;
+}
+
+int main(void) {
+    vc_image_header *hdr;
+    vc_image_sect *sects;
+    vc_image_entry *entry;
+    vconfig *img, *bad;
+    pthread_t thread;
+    char name[64];
+    uint64_t saved;
+    size_t size;
+    double start;
+    char *base;
+    int woke;
+
+    test_begin("image");
+    snprintf(name, sizeof(name), "/vctest-image-%d", (int)getpid());
+    src = test_parse("port = 80\nhost = \"example.org\"\n[server]\nport = 443\n[/server]\n", 0);
+    pub = vconfig_publisher_open(name);
+    if (!src || !pub || !vconfig_publish(pub, src)) {
+        fprintf(stderr, "Couldn't publish %s\n", name);
+        return 2;
+    }
+
+    img = vconfig_attach(name);
+    RESULT("attach", test_int(img, "port") == 80 && test_int(img, "server.port") == 443 &&
+                     !strcmp(test_str(img, "host"), "example.org"));
+
+    /* Damage the published image: a key, then a string, out of bounds */
+    if (!(base = image_map(name, 1, &size))) {
+        perror("shm_open");
+        return 2;
+    }
+    hdr = (vc_image_header *)base;
+    sects = (vc_image_sect *)(base + hdr->sects);
+    entry = (vc_image_entry *)(base + sects[0].entries);
+    saved = entry->key;
+    entry->key = (uint64_t)1 << 40;
+    bad = vconfig_attach(name);
+    RESULT("key out of bounds", !bad);
+    vconfig_close(bad);
+    entry->key = saved;
+
+    for (entry = (vc_image_entry *)(base + sects[0].entries); entry->type != VC_STRING; entry++);
+    saved = entry->v.off;
+    entry->v.off = hdr->size;
+    bad = vconfig_attach(name);
+    RESULT("string out of bounds", !bad);
+    vconfig_close(bad);
+    entry->v.off = saved;
+
+    bad = vconfig_attach(name);
+    RESULT("repaired", test_int(bad, "port") == 80);
+    vconfig_close(bad);
+    munmap(base, size);
+
+    /* Without an update, the wait ends at its timeout, not later */
+    start = now();
+    woke = vconfig_wait_update(img, 100);
+    RESULT("timeout", !woke && now() - start >= 0.09 && now() - start < 1.0);
+
+    /* An update arriving during the wait ends it */
+    pthread_create(&thread, 0, republish, 0);
+    woke = vconfig_wait_update(img, 5000);
+    pthread_join(thread, 0);
+    RESULT("update", woke);
+    vconfig_close(img);
+
+    /* Closing the publisher leaves the image, and a new one on the name
+     * publishes an update to it */
+    vconfig_publisher_close(pub);
+    img = vconfig_attach(name);
+    RESULT("after close", test_int(img, "port") == 80);
+    pub = vconfig_publisher_open(name);
+    woke = pub && vconfig_publish(pub, src) && vconfig_wait_update(img, 0);
+    bad = vconfig_attach(name);
+    RESULT("restart", woke && bad && ((vc_image_header *)bad->root->image->base)->generation == 3);
+    vconfig_close(bad);
+    vconfig_publisher_close(pub);
+
+    /* Until it's unpublished, which attached processes don't notice */
+    RESULT("unpublish", vconfig_unpublish(name) && !vconfig_unpublish(name) &&
+                        test_int(img, "port") == 80);
+    bad = vconfig_attach(name);
+    RESULT("unpublished", !bad);
+    vconfig_close(bad);
+
+    vconfig_close(img);
+    vconfig_close(src);
+    return test_end();
+}
@@ -0,0 +1,86 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: include.c
+ *
+ * Include statements: lookups through included files, sharing of
+ * fragments between configs, directive sets as part of a fragment's
+ * identity, glob matches that can't be read, and include cycles.
+ */
+
+#include "test.h"
+
+static int marks;
+
+VC_DEF_DIRECTIVE(mark) {
+    marks += VC_GETARG_INT();
+    return 0;
+}
+
+VC_DEF_DIRECTIVE(other) {
+    return 0;
+}
+
+int main(void) {
+    vc_directive with_mark[] = {VC_DIRECTIVE(mark, 0, "i"), {0, 0, "", 0}};
+    vc_directive same_mark[] = {VC_DIRECTIVE(mark, 0, "i"), {0, 0, "", 0}};
+    vc_directive without_mark[] = {VC_DIRECTIVE(other, 0, ""), {0, 0, "", 0}};
+    vconfig *a, *b;
+    char path[PATH_MAX];
+
+    test_begin("include");
+    if (!test_write("common.cfg", "shared = 7\n[tls]\nciphers = \"HIGH\"\n[/tls]\n") ||
+        !test_write("root.cfg", "port = 80\ninclude \"common.cfg\"\n[server]\ninclude \"common.cfg\"\n[/server]\n") ||
+        !test_write("marked.cfg", "mark 1\nmarked = 1\n") ||
+        !test_write("uses-mark.cfg", "include \"marked.cfg\"\n") ||
+        !test_write("dangling.cfg", "include \"links/*.cfg\"\n") ||
+        !test_write("cycle1.cfg", "include \"cycle2.cfg\"\n") ||
+        !test_write("cycle2.cfg", "include \"cycle1.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+
+    /* Included options, at the top and within a section */
+    a = test_open("root.cfg", 0, 0);
+    b = test_open("root.cfg", 0, 0);
+    RESULT("lookup", test_int(a, "port") == 80 && test_int(a, "shared") == 7 &&
+                     test_int(a, "server.shared") == 7 && !strcmp(test_str(a, "tls.ciphers"), "HIGH"));
+    RESULT("shared", a && b && vconfig_getopt(a, "shared") == vconfig_getopt(b, "shared"));
+    vconfig_close(a);
+    vconfig_close(b);
+
+    /* Equal directive lists share the fragment, whatever their address */
+    marks = 0;
+    a = test_open("uses-mark.cfg", 0, with_mark);
+    b = test_open("uses-mark.cfg", 0, same_mark);
+    RESULT("same directives", a && b && marks == 1 &&
+                              vconfig_getopt(a, "marked") == vconfig_getopt(b, "marked"));
+    vconfig_close(b);
+
+    /* A config without the directive can't use the fragment parsed with
+     * it, while that is still cached */
+    b = test_open("uses-mark.cfg", 0, without_mark);
+    RESULT("other directives", !b && test_error.type != VC_ERROR_SUCCESS);
+    vconfig_close(b);
+    vconfig_close(a);
+
+    /* A glob matching a file that can't be opened is an error */
+    if (mkdir(test_path(path, sizeof(path), "links"), 0755) ||
+        symlink("/nonexistent/vctest.cfg", test_path(path, sizeof(path), "links/gone.cfg"))) {
+        perror("symlink");
+        return 2;
+    }
+    a = test_open("dangling.cfg", 0, 0);
+    RESULT("dangling match", !a && test_error.type == VC_ERROR_INCLUDE_FILE &&
+                             strstr(test_error.msg, "gone.cfg"));
+    vconfig_close(a);
+
+    /* Cycles fail, every time (and, under a leak checker, are freed) */
+    a = test_open("cycle1.cfg", 0, 0);
+    RESULT("cycle", !a && test_error.type != VC_ERROR_SUCCESS);
+    a = test_open("cycle1.cfg", 0, 0);
+    RESULT("cycle again", !a && test_error.type != VC_ERROR_SUCCESS);
+
+    return test_end();
+}
@@ -0,0 +1,110 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: index.c
+ *
+ * The full-path index: built on the first lookup, kept by edits that
+ * update values in place, and dropped and rebuilt after edits that add or
+ * remove options or sections, so an indexed config always answers as one
+ * without the index does.
+ */
+
+#include "test.h"
+
+/* Paths every check compares, some of which the edits add or remove */
+static char *paths[] = {
+    "port", "name", "srv.port", "srv.tls.level", "srv.extra", "new", "new.deep.port",
+    "inc", "shadow", "srv.tls"
+};
+#define NPATHS (sizeof(paths) / sizeof(paths[0]))
+
+/* Whether the indexed config finds what the plain one does at each path */
+static int agree(vconfig *indexed, vconfig *plain) {
+    size_t i;
+
+    for (i = 0; i < NPATHS; i++) {
+        vc_opt *a = vconfig_getopt(indexed, paths[i]), *b = vconfig_getopt(plain, paths[i]);
+        if (!a != !b || (a && a->type != b->type) ||
+            (a && a->type == VC_INTEGER && *(int *)a->value != *(int *)b->value)) {
+            printf("\t\t%s\n", paths[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static size_t index_entries(vconfig *vcfg) {
+    vc_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    vconfig_stats(vcfg, &stats);
+    return stats.index_entries;
+}
+
+/* Apply the same edit to both configs */
+#define BOTH(call, a, b, ...) (call(a, __VA_ARGS__) && call(b, __VA_ARGS__))
+
+int main(void) {
+    vconfig *ix, *plain;
+    fasthash_table *index = 0;
+    vc_txn *txn;
+    int ok;
+
+    test_begin("index");
+    if (!test_write("inc.cfg", "inc = 5\nshadow = 6\n") ||
+        !test_write("main.cfg", "port = 80\nname = \"a\"\n[srv]\nport = 443\n[tls]\nlevel = 1\n[/tls]\n[/srv]\n"
+                                "include \"inc.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+    ix = test_open("main.cfg", VC_PARAM_PATH_INDEX, 0);
+    plain = test_open("main.cfg", 0, 0);
+    if (!ix || !plain) {
+        fprintf(stderr, "Couldn't open main.cfg\n");
+        return 2;
+    }
+
+    /* Built on the first lookup, with a path for every option */
+    RESULT("lazy", !ix->root->index);
+    RESULT("built", agree(ix, plain) && (index = ix->root->index) && index_entries(ix) == 8 &&
+                    !plain->root->index);
+
+    /* Values updated in place leave the paths, and the index, alone */
+    RESULT("in place", BOTH(vconfig_set_int, ix, plain, "port", 81) && ix->root->index == index &&
+                       test_int(ix, "port") == 81 && agree(ix, plain));
+
+    /* Adding options drops the index, and the next lookup builds it with
+     * them */
+    RESULT("added", BOTH(vconfig_set_int, ix, plain, "srv.extra", 1) && !ix->root->index &&
+                    test_int(ix, "srv.extra") == 1 && ix->root->index && index_entries(ix) == 9 &&
+                    agree(ix, plain));
+    RESULT("sections added", BOTH(vconfig_set_int, ix, plain, "new.deep.port", 2) &&
+                             test_int(ix, "new.deep.port") == 2 && index_entries(ix) == 12 &&
+                             agree(ix, plain));
+
+    /* An option in the config shadows the include's, however it's found */
+    RESULT("shadowed", BOTH(vconfig_set_int, ix, plain, "shadow", 7) && test_int(ix, "shadow") == 7 &&
+                       index_entries(ix) == 12 && agree(ix, plain));
+
+    /* Removing options and sections takes their paths out */
+    RESULT("removed", BOTH(vconfig_delete, ix, plain, "srv.extra") && !vconfig_getopt(ix, "srv.extra") &&
+                      index_entries(ix) == 11 && agree(ix, plain));
+    RESULT("sections removed", BOTH(vconfig_delete, ix, plain, "srv.tls") && !vconfig_getopt(ix, "srv.tls.level") &&
+                               index_entries(ix) == 9 && agree(ix, plain));
+    RESULT("unshadowed", BOTH(vconfig_delete, ix, plain, "shadow") && test_int(ix, "shadow") == 6 &&
+                         agree(ix, plain));
+
+    /* A transaction that fails leaves the index as it was */
+    vconfig_getopt(ix, "port");
+    index = ix->root->index;
+    txn = vconfig_txn_begin(ix);
+    vconfig_txn_set_int(txn, "rolled", 1);
+    vconfig_txn_delete(txn, "missing");
+    ok = vconfig_txn_commit(txn);
+    RESULT("rolled back", !ok && index && ix->root->index == index && !vconfig_getopt(ix, "rolled") &&
+                          agree(ix, plain));
+
+    vconfig_close(plain);
+    vconfig_close(ix);
+    return test_end();
+}
@@ -0,0 +1,105 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: intern.c
+ *
+ * String interning: keys stored once per config, values with
+ * VC_PARAM_INTERN_VALUES, strings released as options are replaced or
+ * deleted, so a pool edited for a long time stays the size of what is in
+ * use, and roots with VC_ROOT_COPY_KEYS, which have no pool at all.
+ */
+
+#include "test.h"
+#include "vcparse.h"
+
+/* The pooled copy of a key in a section's table */
+static char *pooled_key(vconfig *sect, char *key) {
+    fasthash_node *node = sect ? fasthash_lookup(sect->ht, key) : 0;
+    return node ? node->key : 0;
+}
+
+static size_t pool_strings(vconfig *vcfg) {
+    vc_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    vconfig_stats(vcfg, &stats);
+    return stats.intern_strings;
+}
+
+int main(void) {
+    char key[32], value[32], buf[8];
+    vconfig *vcfg, *a, *b;
+    vc_token token;
+    vc_stats stats;
+    char *k, *v;
+    size_t before;
+    int i, ok;
+
+    test_begin("intern");
+
+    /* A key used in several sections is stored once */
+    vcfg = test_parse("port = 1\n[a]\nport = 2\n[/a]\n[b]\nport = 3\nport = 4\n[/b]\n", 0);
+    a = vcfg ? vconfig_getsect(vcfg, "a") : 0;
+    b = vcfg ? vconfig_getsect(vcfg, "b") : 0;
+    k = pooled_key(vcfg, "port");
+    RESULT("keys", k && pooled_key(a, "port") == k && pooled_key(b, "port") == k &&
+                   FH_STRING(k)->refs == 3 && test_int(vcfg, "b.port") == 4);
+
+    /* Deleting from one section leaves the others their key */
+    RESULT("delete", vconfig_delete(vcfg, "a.port") && FH_STRING(k)->refs == 2 &&
+                     test_int(vcfg, "port") == 1 && test_int(vcfg, "b.port") == 4);
+    vconfig_close(vcfg);
+
+    /* Values, with the flag, are pooled alongside the keys */
+    vcfg = test_parse("a = \"same\"\nb = \"same\"\nc = \"other\"\n", VC_PARAM_INTERN_VALUES);
+    v = vcfg ? vconfig_getstr(vcfg, "a") : 0;
+    memset(&stats, 0, sizeof(stats));
+    if (vcfg) vconfig_stats(vcfg, &stats);
+    RESULT("values", v && vconfig_getstr(vcfg, "b") == v && FH_STRING(v)->refs == 2 &&
+                     stats.intern_strings == 5 && stats.intern_saved == 5);
+    RESULT("value replaced", vconfig_set_str(vcfg, "a", "new") && FH_STRING(v)->refs == 1 &&
+                             !strcmp(test_str(vcfg, "a"), "new") && !strcmp(test_str(vcfg, "b"), "same"));
+    vconfig_close(vcfg);
+
+    /* Values without the flag are the config's own */
+    vcfg = test_parse("a = \"same\"\nb = \"same\"\n", 0);
+    RESULT("values copied", vcfg && vconfig_getstr(vcfg, "a") != vconfig_getstr(vcfg, "b") &&
+                            pool_strings(vcfg) == 2);
+    vconfig_close(vcfg);
+
+    /* Setting and deleting a new key each time leaves the pool no bigger
+     * than what was there, give or take a pool's worth of strings waiting
+     * to be freed */
+    vcfg = test_parse("keep = 1\n", VC_PARAM_INTERN_VALUES);
+    before = pool_strings(vcfg);
+    for (ok = vcfg != 0, i = 0; ok && i < 20000; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        snprintf(value, sizeof(value), "v%d", i);
+        ok = vconfig_set_str(vcfg, key, value) && vconfig_delete(vcfg, key);
+    }
+    RESULT("bounded", ok && pool_strings(vcfg) < before + 512 && test_int(vcfg, "keep") == 1);
+
+    /* A key freed from the pool can be used again */
+    RESULT("reused", vconfig_set_int(vcfg, "k7", 7) && test_int(vcfg, "k7") == 7 &&
+                     vconfig_delete(vcfg, "k7") && !vconfig_getint(vcfg, "k7"));
+    vconfig_close(vcfg);
+
+    /* Without a pool, each table keeps a copy of its keys */
+    vcfg = vc_root_sect(VC_ROOT_COPY_KEYS, 0);
+    strcpy(key, "port");
+    strcpy(buf, "8080");
+    token.type = VC_TOKEN_INTEGER;
+    token.flags = 0;
+    token.position = buf;
+    token.length = 4;
+    ok = vcfg && !vcfg->root->pool && !vcfg->ht->pool && vc_addopt(vcfg, key, &token);
+    k = ok ? pooled_key(vcfg, "port") : 0;
+    strcpy(key, "xxxx");
+    RESULT("copied keys", ok && k && k != key && test_int(vcfg, "port") == 8080 && pool_strings(vcfg) == 0);
+    token.length = 2;
+    RESULT("copied replace", vc_addopt(vcfg, "port", &token) && pooled_key(vcfg, "port") == k &&
+                             test_int(vcfg, "port") == 80);
+    vconfig_close(vcfg);
+
+    return test_end();
+}
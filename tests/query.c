@@ -0,0 +1,158 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: query.c
+ *
+ * Path queries: whole-segment wildcards and prefixes, matches from
+ * included files visited once with the value a lookup finds, the same
+ * answers with VC_PARAM_KEY_INDEX, whose sorted keys follow edits, and
+ * from a published image.
+ */
+
+#include "test.h"
+
+#define MAX_MATCHES 32
+
+/* Matches of a query, as "path=value", sorted when the query ends */
+typedef struct matches {
+    char found[MAX_MATCHES][64];
+    int n;
+    int stop;               /* Stop after this many; 0 for never */
+} matches;
+
+static int collect(const char *path, vc_type type, void *value, void *ctx) {
+    matches *m = (matches *)ctx;
+
+    if (m->n < MAX_MATCHES) {
+        if (type == VC_INTEGER) {
+            snprintf(m->found[m->n], sizeof(m->found[0]), "%s=%d", path, *(int *)value);
+        } else if (type == VC_STRING) {
+            snprintf(m->found[m->n], sizeof(m->found[0]), "%s=%s", path, (char *)value);
+        } else {
+            snprintf(m->found[m->n], sizeof(m->found[0]), "%s", path);
+        }
+    }
+    m->n++;
+    return m->stop && m->n >= m->stop;
+}
+
+static int compare(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+/* Whether a query visits exactly the matches expected, a space-separated
+ * list in sorted order */
+static int query(vconfig *vcfg, const char *pattern, const char *expect) {
+    char joined[MAX_MATCHES * 64] = "";
+    matches m;
+    long count;
+    int i;
+
+    memset(&m, 0, sizeof(m));
+    count = vconfig_query(vcfg, pattern, collect, &m);
+    if (count != m.n || m.n > MAX_MATCHES) return 0;
+    qsort(m.found, m.n, sizeof(m.found[0]), compare);
+    for (i = 0; i < m.n; i++) {
+        if (i) strcat(joined, " ");
+        strcat(joined, m.found[i]);
+    }
+    if (strcmp(joined, expect)) {
+        printf("\t\t%s: %s\n", pattern, joined);
+        return 0;
+    }
+    return 1;
+}
+
+/* The checks any config of main.cfg passes, indexed or not */
+static int answers(vconfig *vcfg) {
+    return query(vcfg, "upstreams.*.port", "upstreams.a.port=80 upstreams.b.port=81 upstreams.c.port=9") &&
+           query(vcfg, "features.beta_*",
+                 "features.beta_=0 features.beta_inc=6 features.beta_x=1 features.beta_y=2") &&
+           query(vcfg, "features.beta*",
+                 "features.beta=5 features.beta_=0 features.beta_inc=6 features.beta_x=1 features.beta_y=2 "
+                 "features.betamax=3") &&
+           query(vcfg, "*.beta_x", "features.beta_x=1") &&
+           query(vcfg, "upstreams.*", "upstreams.a upstreams.b upstreams.c") &&
+           query(vcfg, "upstreams.a.*", "upstreams.a.host=h1 upstreams.a.port=80") &&
+           query(vcfg, "upstreams.*.h*", "upstreams.a.host=h1 upstreams.b.host=h2") &&
+           query(vcfg, "port", "port=1") &&
+           query(vcfg, "features.gamma*", "") &&
+           query(vcfg, "missing.*", "");
+}
+
+int main(void) {
+    vconfig *plain, *indexed, *img;
+    vc_publisher *pub;
+    vc_stats stats;
+    char name[64];
+    matches m;
+    long count;
+
+    test_begin("query");
+    if (!test_write("inc.cfg", "[features]\nbeta_inc = 6\nbeta_x = 100\n[/features]\n"
+                               "[upstreams]\n[c]\nport = 9\n[/c]\n[/upstreams]\n") ||
+        !test_write("main.cfg", "port = 1\n"
+                                "[upstreams]\n[a]\nhost = \"h1\"\nport = 80\n[/a]\n"
+                                "[b]\nhost = \"h2\"\nport = 81\n[/b]\n[/upstreams]\n"
+                                "[features]\nbeta_x = 1\nbeta_y = 2\nbetamax = 3\nalpha = 4\nbeta = 5\n"
+                                "beta_ = 0\n[/features]\n"
+                                "include \"inc.cfg\"\n")) {
+        perror("write");
+        return 2;
+    }
+    plain = test_open("main.cfg", 0, 0);
+    indexed = test_open("main.cfg", VC_PARAM_KEY_INDEX, 0);
+    if (!plain || !indexed) {
+        fprintf(stderr, "Couldn't open main.cfg\n");
+        return 2;
+    }
+
+    /* Wildcards and prefixes, with included options found, and shadowed
+     * ones visited once */
+    RESULT("matches", answers(plain) && !vconfig_getsect(plain, "features")->keys);
+
+    /* A nonzero return stops the query at that match */
+    memset(&m, 0, sizeof(m));
+    m.stop = 2;
+    count = vconfig_query(plain, "features.*", collect, &m);
+    RESULT("stop", count == 2 && m.n == 2);
+    RESULT("empty pattern", vconfig_query(plain, "", collect, &m) == -1);
+
+    /* Sorted keys give the same answers, and are built when first
+     * queried */
+    RESULT("key index, lazy", !vconfig_getsect(indexed, "features")->keys);
+    memset(&stats, 0, sizeof(stats));
+    RESULT("key index", answers(indexed) && vconfig_getsect(indexed, "features")->keys &&
+                        (vconfig_stats(indexed, &stats), stats.keys_bytes > 0));
+
+    /* Adding and removing options drops the sorted keys, and the next
+     * query sorts them again */
+    RESULT("key index, added", vconfig_set_int(indexed, "features.beta_new", 7) &&
+                               !vconfig_getsect(indexed, "features")->keys &&
+                               query(indexed, "features.beta_*",
+                                     "features.beta_=0 features.beta_inc=6 features.beta_new=7 "
+                                     "features.beta_x=1 features.beta_y=2") &&
+                               vconfig_getsect(indexed, "features")->keys);
+    RESULT("key index, removed", vconfig_delete(indexed, "features.beta_y") &&
+                                 vconfig_delete(indexed, "features.beta_") &&
+                                 query(indexed, "features.beta_*",
+                                       "features.beta_inc=6 features.beta_new=7 features.beta_x=1"));
+    RESULT("key index, sections", vconfig_set_int(indexed, "upstreams.d.port", 82) &&
+                                  query(indexed, "upstreams.*.port",
+                                        "upstreams.a.port=80 upstreams.b.port=81 upstreams.c.port=9 "
+                                        "upstreams.d.port=82"));
+
+    /* Images are searched through their sorted sections */
+    snprintf(name, sizeof(name), "/vctest-query-%d", (int)getpid());
+    pub = vconfig_publisher_open(name);
+    img = pub && vconfig_publish(pub, plain) ? vconfig_attach(name) : 0;
+    RESULT("image", img && answers(img));
+    vconfig_close(img);
+    vconfig_publisher_close(pub);
+    vconfig_unpublish(name);
+
+    vconfig_close(indexed);
+    vconfig_close(plain);
+    return test_end();
+}
@@ -0,0 +1,126 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: share.c
+ *
+ * Shared sections: configs with the same sections holding one copy,
+ * sections that differ or hash differently kept apart, the store emptied
+ * as configs close, and lookups in shared sections while other threads
+ * add and release sections with keys of their own.
+ */
+
+#include <pthread.h>
+
+#include "test.h"
+
+#define READERS 4
+#define WRITERS 4
+#define ROUNDS  200
+
+static const char *text =
+    "[srv]\nport = 80\nname = \"a\"\n[tls]\nciphers = \"HIGH\"\n[/tls]\n[/srv]\n";
+
+static vconfig *base;
+static int stop;
+
+/* Look up through the shared sections of one config until told to stop */
+static void *reader(void *arg) {
+    long bad = 0;
+
+    (void)arg;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) {
+        if (test_int(base, "srv.port") != 80 || strcmp(test_str(base, "srv.tls.ciphers"), "HIGH")) bad++;
+    }
+    return (void *)bad;
+}
+
+/* Open and close configs whose sections have keys no other has, so each
+ * adds its own section to the store.  Errors aren't recorded, as
+ * test_parse records them for one thread. */
+static void *writer(void *arg) {
+    vc_params p = {0, 0, VC_PARAM_SHARE_SECTIONS, 0, 0};
+    char cfg[256];
+    vconfig *vcfg;
+    long bad = 0, i;
+
+    for (i = 0; i < ROUNDS; i++) {
+        snprintf(cfg, sizeof(cfg), "[srv]\nport = 80\nkey_%ld_%ld = %ld\n[extra_%ld]\nv = 1\n[/extra_%ld]\n[/srv]\n",
+                 (long)arg, i, i, i, i);
+        vcfg = vconfig_parse_buffer(cfg, strlen(cfg), &p);
+        snprintf(cfg, sizeof(cfg), "srv.key_%ld_%ld", (long)arg, i);
+        if (test_int(vcfg, cfg) != i) bad++;
+        vconfig_close(vcfg);
+    }
+    return (void *)bad;
+}
+
+int main(void) {
+    pthread_t readers[READERS], writers[WRITERS];
+    vconfig *a, *b, *c, *s;
+    vc_sect *srv;
+    vc_stats stats;
+    size_t empty;
+    void *bad;
+    long i;
+    int ok;
+
+    test_begin("share");
+    empty = vc_share_count();
+
+    /* Two configs with the same sections hold one copy of each */
+    a = test_parse(text, VC_PARAM_SHARE_SECTIONS);
+    b = test_parse(text, VC_PARAM_SHARE_SECTIONS);
+    srv = a ? vconfig_getsect(a, "srv") : 0;
+    RESULT("shared", srv && srv->shared && srv == vconfig_getsect(b, "srv") &&
+                     vconfig_getsect(a, "srv.tls") == vconfig_getsect(b, "srv.tls") &&
+                     vc_share_count() == empty + 2);
+    RESULT("values", test_int(b, "srv.port") == 80 && !strcmp(test_str(b, "srv.name"), "a") &&
+                     !strcmp(test_str(b, "srv.tls.ciphers"), "HIGH"));
+    RESULT("own keys", srv && !srv->ht->pool);
+    vconfig_stats(a, &stats);
+    RESULT("stats", stats.shared_sections == 2);
+
+    /* One that differs shares only what is the same */
+    c = test_parse("[srv]\nport = 81\nname = \"a\"\n[tls]\nciphers = \"HIGH\"\n[/tls]\n[/srv]\n",
+                   VC_PARAM_SHARE_SECTIONS);
+    RESULT("different", c && vconfig_getsect(c, "srv") != srv && test_int(c, "srv.port") == 81 &&
+                        vconfig_getsect(c, "srv.tls") == vconfig_getsect(a, "srv.tls") &&
+                        vc_share_count() == empty + 3);
+
+    /* Seeded configs hash keys differently, so share only among
+     * themselves */
+    s = test_parse(text, VC_PARAM_SHARE_SECTIONS | VC_PARAM_SEEDED_HASH);
+    ok = s && vconfig_getsect(s, "srv") != srv && test_int(s, "srv.port") == 80;
+    vconfig_close(b);
+    b = test_parse(text, VC_PARAM_SHARE_SECTIONS | VC_PARAM_SEEDED_HASH);
+    RESULT("seeded", ok && b && vconfig_getsect(b, "srv") == vconfig_getsect(s, "srv") &&
+                     !strcmp(test_str(b, "srv.tls.ciphers"), "HIGH") && vc_share_count() == empty + 5);
+    vconfig_close(s);
+    vconfig_close(b);
+    vconfig_close(c);
+    RESULT("released", vc_share_count() == empty + 2 && test_int(a, "srv.port") == 80);
+    vconfig_close(a);
+    RESULT("empty", vc_share_count() == empty);
+
+    /* Readers in one config's shared sections, while sections are added
+     * and freed around them */
+    base = test_parse(text, VC_PARAM_SHARE_SECTIONS);
+    for (i = 0; i < READERS; i++) pthread_create(&(readers[i]), 0, reader, 0);
+    for (i = 0; i < WRITERS; i++) pthread_create(&(writers[i]), 0, writer, (void *)i);
+    for (ok = 1, i = 0; i < WRITERS; i++) {
+        pthread_join(writers[i], &bad);
+        if (bad) ok = 0;
+    }
+    RESULT("concurrent writers", ok);
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for (ok = 1, i = 0; i < READERS; i++) {
+        pthread_join(readers[i], &bad);
+        if (bad) ok = 0;
+    }
+    RESULT("concurrent readers", base && ok);
+    vconfig_close(base);
+    RESULT("concurrent empty", vc_share_count() == empty);
+
+    return test_end();
+}
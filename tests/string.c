@@ -0,0 +1,107 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: string.c
+ *
+ * String values: each escape, adjacent literals joined across quotes and
+ * lines, and escapes refused whether or not UTF-8 is validated: those
+ * for NUL, which would cut the stored string short, and \u surrogates
+ * that aren't a pair.
+ */
+
+#include "test.h"
+
+/* A value as written between the quotes, and what it should decode to */
+typedef struct string_case {
+    const char *text;
+    const char *value;
+} string_case;
+
+static const string_case cases[] = {
+    {"plain",                   "plain"},
+    {"a\\nb\\tc\\rd",           "a\nb\tc\rd"},
+    {"q\\\"q\\'q\\\\q",         "q\"q'q\\q"},
+    {"\\x41\\x7e",              "A~"},
+    {"\\u00e9\\u20ac",          "\xc3\xa9\xe2\x82\xac"},
+    {"\\ud83d\\ude00",          "\xf0\x9f\x98\x80"},
+    {"\\x01",                   "\x01"}
+};
+#define NCASES (sizeof(cases) / sizeof(cases[0]))
+
+/* Escapes no config may hold */
+static const char *refused[] = {
+    "\\x00", "a\\u0000b", "\\ud800", "\\udc00", "\\ud800x", "\\ud800\\u0041",
+    "\\udc00\\ud800", "\\q", "\\x4", "\\u12g4"
+};
+#define NREFUSED (sizeof(refused) / sizeof(refused[0]))
+
+/* Parse one string option with the given flags, returning the config */
+static vconfig *parse_value(const char *value, int flags) {
+    char text[256];
+
+    snprintf(text, sizeof(text), "name = \"%s\"\n", value);
+    return test_parse(text, flags);
+}
+
+int main(void) {
+    vconfig *vcfg;
+    char **strs;
+    size_t i, n;
+    int ok, mode;
+
+    test_begin("string");
+
+    for (mode = 0; mode < 2; mode++) {
+        int flags = mode ? VC_PARAM_VALIDATE_UTF8 : 0;
+
+        for (ok = 1, i = 0; i < NCASES; i++) {
+            vcfg = parse_value(cases[i].text, flags);
+            if (strcmp(test_str(vcfg, "name"), cases[i].value)) {
+                printf("\t\t%s\n", cases[i].text);
+                ok = 0;
+            }
+            vconfig_close(vcfg);
+        }
+        RESULT(mode ? "escapes (utf8)" : "escapes", ok);
+
+        for (ok = 1, i = 0; i < NREFUSED; i++) {
+            vcfg = parse_value(refused[i], flags);
+            if (vcfg || test_error.type == VC_ERROR_SUCCESS) {
+                printf("\t\t%s\n", refused[i]);
+                ok = 0;
+            }
+            vconfig_close(vcfg);
+        }
+        RESULT(mode ? "refused (utf8)" : "refused", ok);
+    }
+
+    /* A byte escape above 0x7f is a lone byte: kept as it is, unless
+     * strings must be UTF-8 */
+    vcfg = parse_value("\\xff", 0);
+    RESULT("raw byte", !strcmp(test_str(vcfg, "name"), "\xff"));
+    vconfig_close(vcfg);
+
+    /* Adjacent literals, of either quote, on the same line or later ones */
+    vcfg = test_parse("a = \"one \" 'two' \"three\"\n"
+                      "b = \"x\\n\"\n    \"y\"\n\n  'z'\n"
+                      "c = \"\" \"\"\n", 0);
+    RESULT("joined", !strcmp(test_str(vcfg, "a"), "one twothree") &&
+                     !strcmp(test_str(vcfg, "b"), "x\nyz") && vconfig_getstr(vcfg, "c") &&
+                     !strcmp(test_str(vcfg, "c"), ""));
+    vconfig_close(vcfg);
+    vcfg = test_parse("b = \"x\"\n  \"y\"\n\n  'z'\nport 80\n", 0);
+    RESULT("lines counted", !vcfg && !strncmp(test_error.msg, "<buffer>:5:", 11));
+    vcfg = test_parse("a = \"one\" \"two\nb = 1\n", 0);
+    RESULT("unterminated", !vcfg && test_error.type != VC_ERROR_SUCCESS);
+
+    /* Strings in arrays are decoded the same way */
+    vcfg = test_parse("a = [\"\\u00e9\" \"!\", 'b\\tc']\n", 0);
+    strs = vcfg ? vconfig_getstrarray(vcfg, "a", &n) : 0;
+    RESULT("arrays", strs && n == 2 && !strcmp(strs[0], "\xc3\xa9!") && !strcmp(strs[1], "b\tc"));
+    vconfig_close(vcfg);
+    vcfg = test_parse("a = [\"ok\", \"\\x00\"]\n", 0);
+    RESULT("arrays refused", !vcfg);
+
+    return test_end();
+}
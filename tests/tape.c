@@ -0,0 +1,235 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: tape.c
+ *
+ * Tapes: the layout vctape.h describes, each value type, lookups that skip
+ * subtrees and take the last definition, the same values as the hash
+ * tree, includes recorded rather than loaded, and one allocation per tape,
+ * even when memory runs out part way.
+ */
+
+#include "test.h"
+#include "vctape.h"
+
+static int armed = -1;      /* Allocations left before one fails; -1: off */
+static long live;           /* Allocations not yet freed */
+
+static void *count_alloc(void *ctx, size_t size) {
+    void *p;
+    (void)ctx;
+    if (armed == 0) return 0;
+    if (armed > 0) armed--;
+    if ((p = malloc(size))) live++;
+    return p;
+}
+
+static void *count_realloc(void *ctx, void *ptr, size_t size) {
+    void *p;
+    (void)ctx;
+    if (armed == 0) return 0;
+    if (armed > 0) armed--;
+    if ((p = realloc(ptr, size)) && !ptr) live++;
+    return p;
+}
+
+static void count_free(void *ctx, void *ptr) {
+    (void)ctx;
+    live--;
+    free(ptr);
+}
+
+static const vc_allocator counting = {count_alloc, count_realloc, count_free, 0};
+
+static int directive_sect = -1;
+
+VC_DEF_DIRECTIVE(note) {
+    directive_sect = sect != 0;
+    return 0;
+}
+
+static vc_directive directives[] = {
+    VC_DIRECTIVE(note, 0, "s"),
+    {0, 0, "", 0}
+};
+
+static vc_tape *tape_of(const char *text, const vc_allocator *alloc) {
+    vc_params p = {0, directives, 0, &test_errors, alloc};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_tape_parse(text, strlen(text), &p);
+}
+
+/* Whether entry i has the type, and next or length, given */
+static int entry(vc_tape *tape, size_t i, vc_tape_type type, uint64_t next) {
+    vc_tape_entry *e = tape->entries + i;
+    if (i >= tape->length || e->type != type) return 0;
+    if (type == VC_TAPE_SECTION || type == VC_TAPE_END || type == VC_TAPE_ARRAY) return e->v.next == next;
+    return 1;
+}
+
+static int key(vc_tape *tape, size_t i, const char *name) {
+    return i < tape->length && tape->entries[i].type == VC_TAPE_KEY &&
+           !strcmp(VC_TAPE_STR(tape, &tape->entries[i]), name);
+}
+
+static const char *types =
+    "on = true\n"
+    "port = 80\n"
+    "ratio = 0.25\n"
+    "name = \"edge\"\n"
+    "timeout = 1.5s\n"
+    "buffer = 4KiB\n"
+    "load = 75%\n"
+    "floats = [0.5, 1.5]\n"
+    "names = [\"a\", \"bc\"]\n"
+    "note \"hello\"\n"
+    "include \"other/*.cfg\"\n"
+    "[srv]\n"
+    "port = 443\n"
+    "port = 8443\n"
+    "[tls]\n"
+    "level = 2\n"
+    "[/tls]\n"
+    "after = 1\n"
+    "[/srv]\n";
+
+/* Every option of the tape below the SECTION at index sect has the value
+ * the hash tree has at its path */
+static int same_as_tree(vc_tape *tape, size_t sect, vconfig *tree, const char *prefix) {
+    char path[128];
+    vc_tape_entry *k, *v;
+    size_t i;
+    vc_opt *opt;
+
+    for (i = sect + 1; tape->entries[i].type != VC_TAPE_END; i = VC_TAPE_NEXT(tape, i + 1)) {
+        k = &tape->entries[i];
+        v = &tape->entries[i + 1];
+        snprintf(path, sizeof(path), "%s%s", prefix, VC_TAPE_STR(tape, k));
+        if (!(opt = vconfig_getopt(tree, path))) return 0;
+        switch (v->type) {
+        case VC_TAPE_INTEGER:
+            if (opt->type != VC_INTEGER || *(int *)opt->value != v->v.i) return 0;
+            break;
+        case VC_TAPE_STRING:
+            if (opt->type != VC_STRING || strcmp((char *)opt->value, VC_TAPE_STR(tape, v))) return 0;
+            break;
+        case VC_TAPE_SECTION:
+            strcat(path, ".");
+            if (opt->type != VC_SECTION || !same_as_tree(tape, i + 1, tree, path)) return 0;
+            break;
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void) {
+    vc_tape *tape;
+    vconfig *tree;
+    size_t i, v;
+    long n, total;
+    int failed, ok;
+
+    test_begin("tape");
+
+    /* The example of vctape.h, entry for entry */
+    tape = tape_of("port = 80\n[server]\n    hosts = [\"a\", \"b\"]\n[/server]\n", 0);
+    RESULT("layout", tape && tape->length == 11 && entry(tape, 0, VC_TAPE_SECTION, 11) && key(tape, 1, "port") &&
+                     entry(tape, 2, VC_TAPE_INTEGER, 0) && tape->entries[2].v.i == 80 && key(tape, 3, "server") &&
+                     entry(tape, 4, VC_TAPE_SECTION, 10) && key(tape, 5, "hosts") &&
+                     entry(tape, 6, VC_TAPE_ARRAY, 9) && tape->entries[6].length == 2 &&
+                     entry(tape, 7, VC_TAPE_STRING, 0) && !strcmp(VC_TAPE_STR(tape, &tape->entries[8]), "b") &&
+                     entry(tape, 9, VC_TAPE_END, 4) && entry(tape, 10, VC_TAPE_END, 0));
+    vconfig_tape_free(tape);
+
+    /* Each type of value, directives called without a section, and
+     * includes recorded but not loaded */
+    tape = tape_of(types, 0);
+    if (!tape) {
+        fprintf(stderr, "Couldn't parse the tape\n");
+        return 2;
+    }
+    RESULT("types", tape->entries[vc_tape_lookup(tape, 0, "on")].type == VC_TAPE_BOOLEAN &&
+                    tape->entries[vc_tape_lookup(tape, 0, "port")].v.i == 80 &&
+                    tape->entries[vc_tape_lookup(tape, 0, "ratio")].v.f == 0.25 &&
+                    !strcmp(VC_TAPE_STR(tape, &tape->entries[vc_tape_lookup(tape, 0, "name")]), "edge") &&
+                    tape->entries[vc_tape_lookup(tape, 0, "name")].length == 4 &&
+                    tape->entries[vc_tape_lookup(tape, 0, "timeout")].type == VC_TAPE_DURATION &&
+                    tape->entries[vc_tape_lookup(tape, 0, "timeout")].v.i == 1500000000 &&
+                    tape->entries[vc_tape_lookup(tape, 0, "buffer")].type == VC_TAPE_SIZE &&
+                    tape->entries[vc_tape_lookup(tape, 0, "buffer")].v.i == 4096 &&
+                    tape->entries[vc_tape_lookup(tape, 0, "load")].type == VC_TAPE_RATIO &&
+                    tape->entries[vc_tape_lookup(tape, 0, "load")].v.f == 0.75);
+    v = vc_tape_lookup(tape, 0, "floats");
+    i = vc_tape_lookup(tape, 0, "names");
+    RESULT("arrays", v && tape->entries[v].length == 2 && tape->entries[v + 2].type == VC_TAPE_FLOAT &&
+                     tape->entries[v + 2].v.f == 1.5 && VC_TAPE_NEXT(tape, v) == v + 3 &&
+                     i && !strcmp(VC_TAPE_STR(tape, &tape->entries[i + 2]), "bc"));
+    for (ok = 0, i = 0; i < tape->length; i++) {
+        if (tape->entries[i].type == VC_TAPE_INCLUDE) {
+            ok = !strcmp(VC_TAPE_STR(tape, &tape->entries[i]), "other/*.cfg");
+        }
+    }
+    RESULT("include", ok && directive_sect == 0);
+
+    /* Lookups skip subtrees, find the last definition, and start from
+     * any section */
+    v = vc_tape_lookup(tape, 0, "srv");
+    RESULT("lookup", v && tape->entries[vc_tape_lookup(tape, 0, "srv.port")].v.i == 8443 &&
+                     tape->entries[vc_tape_lookup(tape, 0, "srv.tls.level")].v.i == 2 &&
+                     tape->entries[vc_tape_lookup(tape, v, "after")].v.i == 1 &&
+                     tape->entries[vc_tape_lookup(tape, v, "tls.level")].v.i == 2 &&
+                     !vc_tape_lookup(tape, 0, "missing") && !vc_tape_lookup(tape, 0, "after") &&
+                     !vc_tape_lookup(tape, 0, "port.x") && !vc_tape_lookup(tape, v, "srv.port"));
+    vconfig_tape_free(tape);
+
+    /* The tape holds what the hash tree holds */
+    {
+        const char *text = "a = 1\nb = \"two\"\n[s]\nc = 3\n[u]\nd = \"four\"\n[/u]\ne = 5\n[/s]\ng = 6\n";
+        tape = tape_of(text, 0);
+        tree = test_parse(text, 0);
+        RESULT("same as tree", tape && tree && same_as_tree(tape, 0, tree, ""));
+        vconfig_tape_free(tape);
+        vconfig_close(tree);
+    }
+
+    /* Files are read the same way, and bad ones fail */
+    {
+        char path[PATH_MAX];
+        vc_params p = {test_path(path, sizeof(path), "conf.cfg"), 0, 0, &test_errors, 0};
+        test_write("conf.cfg", "port = 80\n[a]\nb = 2\n[/a]\n");
+        tape = vconfig_tape_open(&p);
+        RESULT("open", tape && tape->entries[vc_tape_lookup(tape, 0, "a.b")].v.i == 2);
+        vconfig_tape_free(tape);
+    }
+    RESULT("errors", !tape_of("[a]\nb = 1\n[/c]\n", 0) && test_error.type == VC_ERROR_SECT_MISMATCH &&
+                     !tape_of("a = \n", 0) && !tape_of("[a]\nb = 1\n", 0));
+
+    /* One allocation per tape; a parse that runs out of memory anywhere
+     * fails and frees everything */
+    armed = 1000000;
+    tape = tape_of(types, &counting);
+    total = 1000000 - armed;
+    armed = -1;
+    RESULT("one allocation", tape && live == 1 && tape->alloc == &counting);
+    vconfig_tape_free(tape);
+    RESULT("freed", live == 0);
+    for (failed = 0, ok = 1, n = 0; n < total; n++) {
+        armed = n;
+        tape = tape_of(types, &counting);
+        armed = -1;
+        if (tape) ok = 0;
+        else failed++;
+        vconfig_tape_free(tape);
+        if (live) {
+            printf("\t\tallocation %ld: %ld leaked\n", n, live);
+            ok = 0;
+            live = 0;
+        }
+    }
+    RESULT("out of memory", ok && failed == total && total > 2);
+
+    return test_end();
+}
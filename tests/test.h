@@ -0,0 +1,115 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: test.h
+ *
+ * Helpers shared by the behavior tests.  Each test is a program built
+ * against the module by "make test", which prints a result per check and
+ * exits nonzero if any failed.  Files a test needs are written to a
+ * directory of its own under /tmp, removed when it ends.
+ */
+
+#ifndef __TEST_H
+#define __TEST_H
+
+/**********************************************************************/
+/**** Begin Includes **************************************************/
+/**********************************************************************/
+#include <limits.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+#include "vcdirect.h"
+
+/**********************************************************************/
+/**** Begin Definitions/Static Declarations ***************************/
+/**********************************************************************/
+
+/* The check is evaluated once, so it may have side effects */
+#define RESULT(name, ok) {                      \
+    int passed__ = (ok);                        \
+    printf("\t%s\t Result: [%s]\n",             \
+            name, passed__ ? "PASS" : "FAIL");  \
+    if (!passed__) failures++;                  \
+}
+
+static int failures;
+static char test_dir[64];
+
+/* Errors the code under test reports, recorded rather than printed */
+static vc_load_error test_error;
+static vc_errsink test_errors = {vc_error_record, &test_error};
+
+/**********************************************************************/
+/**** Begin Function Definitions **************************************/
+/**********************************************************************/
+
+/* Make the test's directory */
+static inline void test_begin(const char *name) {
+    snprintf(test_dir, sizeof(test_dir), "/tmp/vctest-%s-XXXXXX", name);
+    if (!mkdtemp(test_dir)) {
+        perror("mkdtemp");
+        exit(2);
+    }
+    printf("Testing %s:\n", name);
+}
+
+/* Remove the test's directory, and give the exit status */
+static inline int test_end(void) {
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", test_dir);
+    if (system(cmd)) fprintf(stderr, "Couldn't remove %s\n", test_dir);
+    printf("%d failed\n", failures);
+    return failures != 0;
+}
+
+/* Path of a file in the test's directory, in a buffer of the caller's */
+static inline char *test_path(char *buf, size_t size, const char *name) {
+    snprintf(buf, size, "%s/%s", test_dir, name);
+    return buf;
+}
+
+/* Write a file in the test's directory.  Returns zero on failure. */
+static inline int test_write(const char *name, const char *text) {
+    char path[PATH_MAX];
+    FILE *fp = fopen(test_path(path, sizeof(path), name), "w");
+    int ok;
+
+    if (!fp) return 0;
+    ok = fputs(text, fp) >= 0;
+    return !fclose(fp) && ok;
+}
+
+/* Open a file of the test's directory, with errors recorded */
+static inline vconfig *test_open(const char *name, int flags, vc_directive *directives) {
+    char path[PATH_MAX];
+    vc_params p = {test_path(path, sizeof(path), name), directives, flags, &test_errors, 0};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_open(&p);
+}
+
+/* Parse a config from a string, with errors recorded */
+static inline vconfig *test_parse(const char *text, int flags) {
+    vc_params p = {0, 0, flags, &test_errors, 0};
+    test_error.type = VC_ERROR_SUCCESS;
+    return vconfig_parse_buffer(text, strlen(text), &p);
+}
+
+/* Integer at a path, or a value no test uses if there isn't one */
+static inline int test_int(vconfig *vcfg, char *optpath) {
+    int *value = vcfg ? vconfig_getint(vcfg, optpath) : 0;
+    return value ? *value : -12345;
+}
+
+/* String at a path, or "" */
+static inline const char *test_str(vconfig *vcfg, char *optpath) {
+    char *value = vcfg ? vconfig_getstr(vcfg, optpath) : 0;
+    return value ? value : "";
+}
+
+#endif /* #ifndef __TEST_H */
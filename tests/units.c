@@ -0,0 +1,120 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: units.c
+ *
+ * Durations, sizes and ratios: parsing each unit, fractions, values out
+ * of range, formatting back to what parses to the same value, and the
+ * typed getters on a loaded config.
+ */
+
+#include "test.h"
+
+#define NS_S    1000000000LL
+
+/* A value as written, and what it should parse to */
+typedef struct unit_case {
+    const char *text;
+    vc_type type;
+    int64_t i;
+    double f;
+} unit_case;
+
+static const unit_case cases[] = {
+    {"30s",         VC_DURATION, 30 * NS_S, 0},
+    {"2h30m",       VC_DURATION, 9000 * NS_S, 0},
+    {"1.5ms",       VC_DURATION, 1500000, 0},
+    {"-10m",        VC_DURATION, -600 * NS_S, 0},
+    {"1d",          VC_DURATION, 86400 * NS_S, 0},
+    {"250us",       VC_DURATION, 250000, 0},
+    {"7ns",         VC_DURATION, 7, 0},
+    {"1.5ns",       VC_DURATION, 1, 0},
+    {"100B",        VC_SIZE, 100, 0},
+    {"4KB",         VC_SIZE, 4000, 0},
+    {"4kB",         VC_SIZE, 4000, 0},
+    {"512MiB",      VC_SIZE, 512LL << 20, 0},
+    {"1.5GiB",      VC_SIZE, 3LL << 29, 0},
+    {"2TB",         VC_SIZE, 2000000000000LL, 0},
+    {"1PiB",        VC_SIZE, 1LL << 50, 0},
+    {"50%",         VC_RATIO, 0, 0.5},
+    {"12.5%",       VC_RATIO, 0, 0.125},
+    {"0%",          VC_RATIO, 0, 0},
+    {"30",          VC_ERROR, 0, 0},
+    {"30x",         VC_ERROR, 0, 0},
+    {"s",           VC_ERROR, 0, 0},
+    {"5MIB",        VC_ERROR, 0, 0},
+    {"10GB5MB",     VC_ERROR, 0, 0},
+    {"1e3s",        VC_ERROR, 0, 0},
+    {"99999999999999999999ns", VC_ERROR, 0, 0},
+    {"10000000000000d", VC_ERROR, 0, 0},
+    {"9000PiB",     VC_ERROR, 0, 0}
+};
+#define NCASES (sizeof(cases) / sizeof(cases[0]))
+
+int main(void) {
+    vc_unit_value value, back;
+    char buf[64];
+    vc_type type;
+    vconfig *vcfg;
+    int64_t *ns, *bytes;
+    double *ratio;
+    size_t i;
+    int ok;
+
+    test_begin("units");
+
+    for (ok = 1, i = 0; i < NCASES; i++) {
+        const unit_case *c = &(cases[i]);
+        type = vc_unit_parse(c->text, strlen(c->text), &value);
+        if (type != c->type || (type == VC_RATIO && value.f != c->f) ||
+            ((type == VC_DURATION || type == VC_SIZE) && value.i != c->i)) {
+            printf("\t\t%s\n", c->text);
+            ok = 0;
+        }
+    }
+    RESULT("parse", ok);
+
+    /* Only the given length is parsed */
+    RESULT("length", vc_unit_parse("30s5", 3, &value) == VC_DURATION && value.i == 30 * NS_S);
+
+    /* Formatted values parse back to themselves */
+    for (ok = 1, i = 0; i < NCASES; i++) {
+        const unit_case *c = &(cases[i]);
+        int n;
+
+        if (c->type == VC_ERROR) continue;
+        vc_unit_parse(c->text, strlen(c->text), &value);
+        n = vc_unit_format(buf, sizeof(buf), c->type, &value);
+        if (n <= 0 || vc_unit_parse(buf, n, &back) != c->type ||
+            (c->type == VC_RATIO ? back.f != value.f : back.i != value.i)) {
+            printf("\t\t%s -> %s\n", c->text, buf);
+            ok = 0;
+        }
+    }
+    RESULT("format", ok);
+    value.i = 9000 * NS_S;
+    vc_unit_format(buf, sizeof(buf), VC_DURATION, &value);
+    RESULT("largest unit", !strcmp(buf, "2h30m"));
+
+    /* In a config, through the typed getters */
+    vcfg = test_parse("timeout = 2h30m\nheap = 512MiB\nload = 75%\n[srv]\nidle = 90s\n[/srv]\n", 0);
+    ns = vcfg ? vconfig_getduration_ns(vcfg, "timeout") : 0;
+    bytes = vcfg ? vconfig_getbytes(vcfg, "heap") : 0;
+    ratio = vcfg ? vconfig_getratio(vcfg, "load") : 0;
+    RESULT("getters", ns && *ns == 9000 * NS_S && bytes && *bytes == 512LL << 20 &&
+                      ratio && *ratio == 0.75 && vconfig_getduration_ns(vcfg, "srv.idle") &&
+                      *vconfig_getduration_ns(vcfg, "srv.idle") == 90 * NS_S);
+    RESULT("wrong type", vcfg && !vconfig_getbytes(vcfg, "timeout") && !vconfig_getratio(vcfg, "heap") &&
+                         !vconfig_getint(vcfg, "load"));
+    vconfig_close(vcfg);
+
+    vcfg = test_parse("timeout = 30parsecs\n", 0);
+    RESULT("unknown unit", !vcfg && test_error.type != VC_ERROR_SUCCESS);
+    vconfig_close(vcfg);
+    vcfg = test_parse("heap = 9000PiB\n", 0);
+    RESULT("out of range", !vcfg && test_error.type != VC_ERROR_SUCCESS);
+    vconfig_close(vcfg);
+
+    return test_end();
+}
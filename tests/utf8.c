@@ -0,0 +1,116 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: utf8.c
+ *
+ * UTF-8 validation: each implementation against known sequences, at every
+ * position across vector blocks, and strings in configs parsed with and
+ * without VC_PARAM_VALIDATE_UTF8, escapes included.
+ */
+
+#include "test.h"
+#include "vcutf8.h"
+
+#define BUF_SIZE 160
+
+/* A sequence, and where the first invalid one starts (its length if
+ * none) */
+typedef struct utf8_case {
+    const char *name;
+    const char *data;
+    size_t bad;
+} utf8_case;
+
+static const utf8_case cases[] = {
+    {"ascii",          "plain text",            10},
+    {"two bytes",      "caf\xc3\xa9",           5},
+    {"three bytes",    "\xe2\x82\xac",          3},
+    {"four bytes",     "\xf0\x9f\x98\x80",      4},
+    {"max",            "\xf4\x8f\xbf\xbf",      4},
+    {"overlong 2",     "a\xc0\x80",             1},
+    {"overlong 3",     "ab\xe0\x80\xaf",        2},
+    {"overlong 4",     "\xf0\x80\x80\xaf",      0},
+    {"surrogate",      "x\xed\xa0\x80",         1},
+    {"too large",      "\xf4\x90\x80\x80",      0},
+    {"bad lead",       "ok\xf5\x80\x80\x80",    2},
+    {"continuation",   "\x80",                  0},
+    {"truncated",      "abc\xe2\x82",           3},
+    {"interrupted",    "\xe2\x82" "a",          0}
+};
+#define NCASES (sizeof(cases) / sizeof(cases[0]))
+
+static const vc_utf8_impl impls[] = {VC_UTF8_SCALAR, VC_UTF8_SSE41, VC_UTF8_AVX2};
+static const char *impl_names[] = {"scalar", "sse4.1", "avx2"};
+
+/* Parse one string option, and say whether it loaded */
+static int parses(const char *value, int flags) {
+    char text[256];
+    vconfig *vcfg;
+
+    snprintf(text, sizeof(text), "name = \"%s\"\n", value);
+    vcfg = test_parse(text, flags);
+    vconfig_close(vcfg);
+    return vcfg != 0;
+}
+
+int main(void) {
+    char buf[BUF_SIZE], name[64];
+    size_t i, at, len;
+    int m, ok;
+
+    test_begin("utf8");
+    printf("\tBest: %s\n", impl_names[vc_utf8_get_impl()]);
+
+    /* Each sequence alone */
+    for (m = 0; m < 3; m++) {
+        for (ok = 1, i = 0; i < NCASES; i++) {
+            if (vc_utf8_check_impl(cases[i].data, strlen(cases[i].data), impls[m]) != cases[i].bad) {
+                printf("\t\t%s: %s\n", impl_names[m], cases[i].name);
+                ok = 0;
+            }
+        }
+        snprintf(name, sizeof(name), "sequences (%s)", impl_names[m]);
+        RESULT(name, ok);
+    }
+
+    /* Each sequence at every position of a longer run of valid text, so
+     * it falls at every place within a block, and across two */
+    for (m = 0; m < 3; m++) {
+        for (ok = 1, i = 0; i < NCASES; i++) {
+            len = strlen(cases[i].data);
+            for (at = 0; at + len <= BUF_SIZE; at++) {
+                size_t j, expected = cases[i].bad == len ? BUF_SIZE : at + cases[i].bad;
+
+                /* Valid text before it mixes two-byte characters with ASCII */
+                for (j = 0; j < at; ) {
+                    if (j % 3 == 0 && j + 2 <= at) {
+                        buf[j++] = '\xc3';
+                        buf[j++] = '\xa9';
+                    } else {
+                        buf[j++] = 'a';
+                    }
+                }
+                memcpy(buf + at, cases[i].data, len);
+                for (j = at + len; j < BUF_SIZE; j++) buf[j] = 'z';
+                if (vc_utf8_check_impl(buf, BUF_SIZE, impls[m]) != expected) {
+                    if (ok) printf("\t\t%s: %s at %zu\n", impl_names[m], cases[i].name, at);
+                    ok = 0;
+                }
+            }
+        }
+        snprintf(name, sizeof(name), "positions (%s)", impl_names[m]);
+        RESULT(name, ok);
+    }
+
+    /* Strings in configs */
+    RESULT("valid", parses("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", VC_PARAM_VALIDATE_UTF8));
+    RESULT("invalid", !parses("bad \xc0\x80 here", VC_PARAM_VALIDATE_UTF8) &&
+                      test_error.type == VC_ERROR_INVALID_UTF8 && strstr(test_error.msg, "byte 12"));
+    RESULT("unchecked", parses("bad \xc0\x80 here", 0));
+    RESULT("escapes", parses("\\u00e9 \\x41", VC_PARAM_VALIDATE_UTF8) &&
+                      !parses("\\xff", VC_PARAM_VALIDATE_UTF8) &&
+                      !parses("\\ud800", VC_PARAM_VALIDATE_UTF8));
+
+    return test_end();
+}
@@ -0,0 +1,88 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: view.c
+ *
+ * Layered views: lookups falling through layers, misses forgotten when a
+ * layer is edited, including while other threads are looking up, and the
+ * bound on the misses kept.
+ */
+
+#include <pthread.h>
+
+#include "test.h"
+
+#define THREADS 4
+#define ROUNDS  2000
+
+static vc_view *view;
+static vconfig *top;
+static volatile int done;
+
+/* Look up a section path the top layer may not have yet */
+static void *reader(void *arg) {
+    (void)arg;
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        vconfig_read_begin(top);
+        vconfig_view_getint(view, "srv.port");
+        vconfig_read_end(top);
+    }
+    return 0;
+}
+
+int main(void) {
+    pthread_t threads[THREADS];
+    vconfig *base;
+    char path[32];
+    int i, ok, *port;
+
+    test_begin("view");
+    base = test_parse("name = \"base\"\n[srv]\nport = 80\nhost = \"a\"\n[/srv]\n", 0);
+    top = test_parse("name = \"top\"\n[log]\nlevel = 2\n[/log]\n", 0);
+    view = vconfig_view_create();
+    if (!base || !top || !view || !vconfig_layer_push(view, base) || !vconfig_layer_push(view, top)) {
+        fprintf(stderr, "Couldn't build the view\n");
+        return 2;
+    }
+
+    RESULT("fall through", !strcmp(vconfig_view_getstr(view, "name"), "top") &&
+                           *vconfig_view_getint(view, "srv.port") == 80 &&
+                           *vconfig_view_getint(view, "log.level") == 2);
+
+    /* The top layer's miss of srv is remembered, until it gains srv */
+    vconfig_set_int(top, "srv.port", 443);
+    port = vconfig_view_getint(view, "srv.port");
+    RESULT("edit seen", port && *port == 443 && !strcmp(vconfig_view_getstr(view, "srv.host"), "a"));
+    vconfig_delete(top, "srv");
+    port = vconfig_view_getint(view, "srv.port");
+    RESULT("delete seen", port && *port == 80);
+
+    /* Edits racing lookups: once they stop, lookups see the last one */
+    for (i = 0; i < THREADS; i++) pthread_create(&(threads[i]), 0, reader, 0);
+    for (i = 0; i < ROUNDS; i++) {
+        if (i % 2) vconfig_delete(top, "srv");
+        else vconfig_set_int(top, "srv.port", 8000 + i);
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < THREADS; i++) pthread_join(threads[i], 0);
+    port = vconfig_view_getint(view, "srv.port");
+    RESULT("racing edits", port && *port == 80);
+    vconfig_set_int(top, "srv.port", 9000);
+    port = vconfig_view_getint(view, "srv.port");
+    RESULT("after race", port && *port == 9000);
+
+    /* Misses of many section paths are kept only up to the bound, and
+     * lookups past it are still answered */
+    for (ok = 1, i = 0; i < VC_VIEW_MAX_MISSES * 2; i++) {
+        snprintf(path, sizeof(path), "s%d.x", i);
+        if (vconfig_view_getint(view, path)) ok = 0;
+    }
+    RESULT("bounded", ok && view->misses->count <= VC_VIEW_MAX_MISSES &&
+                      *vconfig_view_getint(view, "log.level") == 2);
+
+    vconfig_view_destroy(view);
+    vconfig_close(top);
+    vconfig_close(base);
+    return test_end();
+}
@@ -0,0 +1,159 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: wrapper.cpp
+ *
+ * The C++ wrapper: get<T> finds each type and nothing of another, paths
+ * may be unterminated string_views or compile-time vc::Path literals,
+ * vc::Config is move-only and closes what it owns exactly once, and
+ * sections iterate their own options.
+ */
+
+#include <map>
+#include <string>
+#include <type_traits>
+
+#include "test.h"
+#include "vconfig.hpp"
+
+/* Allocations not yet freed, by configs parsed with the allocator below */
+static long live;
+
+static void *count_alloc(void *, size_t size) {
+    void *p = malloc(size);
+    if (p) live++;
+    return p;
+}
+
+static void *count_realloc(void *, void *ptr, size_t size) {
+    void *p = realloc(ptr, size);
+    if (p && !ptr) live++;
+    return p;
+}
+
+static void count_free(void *, void *ptr) {
+    live--;
+    free(ptr);
+}
+
+static const vc_allocator counting = {count_alloc, count_realloc, count_free, nullptr};
+
+static vc::Config counted(const char *text) {
+    vc_params p = {nullptr, nullptr, 0, &test_errors, &counting};
+    return vc::Config(vconfig_parse_buffer(text, strlen(text), &p));
+}
+
+/* Copying would close the config twice */
+static_assert(!std::is_copy_constructible_v<vc::Config>);
+static_assert(!std::is_copy_assignable_v<vc::Config>);
+static_assert(std::is_nothrow_move_constructible_v<vc::Config>);
+static_assert(std::is_nothrow_move_assignable_v<vc::Config>);
+
+/* Paths are split and hashed by the compiler */
+static constexpr vc::Path srv_port{"srv.port"};
+static constexpr vc::Path tls_level{"srv.tls.level"};
+static_assert(srv_port.str() == "srv.port");
+static_assert(srv_port.keypath().nsegs == 2 && srv_port.keypath().segs[1].length == 4);
+static_assert(tls_level.keypath().nsegs == 3 && tls_level.keypath().segs[2].hash == vc::djb2("level", 5));
+
+static const char *text =
+    "port = 80\n"
+    "name = \"edge\"\n"
+    "on = true\n"
+    "ratio = 0.25\n"
+    "timeout = 1.5s\n"
+    "buffer = 4KiB\n"
+    "load = 75%\n"
+    "ports = [80, 443]\n"
+    "[srv]\n"
+    "port = 443\n"
+    "host = \"example.org\"\n"
+    "[tls]\n"
+    "level = 2\n"
+    "[/tls]\n"
+    "[/srv]\n";
+
+int main(void) {
+    test_begin("wrapper");
+
+    vc::Config conf = vc::Config::parse(text);
+    if (!conf) {
+        fprintf(stderr, "Couldn't parse the config\n");
+        return 2;
+    }
+
+    /* Each type, by the type of value it holds */
+    const vc_array *ports = conf.get<const vc_array *>("ports").value_or(nullptr);
+    RESULT("types", conf.get<int>("port") == 80 && conf.get<std::string_view>("name") == "edge" &&
+                    conf.get<bool>("on") == true && conf.get<double>("ratio") == 0.25 &&
+                    conf.get<std::chrono::nanoseconds>("timeout") == std::chrono::milliseconds(1500) &&
+                    conf.get<vc::Bytes>("buffer").value_or(vc::Bytes{0}).count == 4096 &&
+                    conf.get<vc::Ratio>("load").value_or(vc::Ratio{0}).value == 0.75 &&
+                    ports && ports->length == 2 && ports->v.ints[1] == 443);
+
+    /* Missing options, and those of another type, are empty */
+    RESULT("empty", !conf.get<int>("missing") && !conf.get<int>("name") && !conf.get<std::string_view>("port") &&
+                    !conf.get<vc::Section>("port") && !conf.get<double>("load") && !conf.get<int>("srv.missing"));
+
+    /* A path is read only as far as its view goes */
+    std::string_view longer("srv.portable", 8);
+    RESULT("views", conf.get<int>(longer) == 443 && !conf.get<int>(std::string_view("srv.port", 3)));
+
+    /* Path literals find what strings do, in sections too */
+    vc::Section srv = conf.section("srv");
+    static constexpr vc::Path level{"tls.level"};
+    RESULT("path literals", conf.get<int>(srv_port) == 443 && conf.get<int>(tls_level) == 2 &&
+                            srv.get<int>(level) == 2 && !srv.get<int>(srv_port));
+
+    /* Iterating a section visits each of its own options once */
+    std::map<std::string, vc_type> seen;
+    for (vc::Option opt : srv) seen[std::string(opt.key())] = opt.type();
+    RESULT("iterate", seen.size() == 3 && seen["port"] == VC_INTEGER && seen["host"] == VC_STRING &&
+                      seen["tls"] == VC_SECTION);
+
+    /* Options deleted leave their buckets empty, which are skipped */
+    int n = 0;
+    char host[] = "srv.host", port[] = "srv.port";
+    vconfig_delete(conf.handle(), host);
+    vconfig_delete(conf.handle(), port);
+    for (vc::Option opt : srv) n += opt.get<vc::Section>().has_value();
+    RESULT("iterate deleted", n == 1 && std::distance(srv.begin(), srv.end()) == 1);
+
+    /* A section that isn't there is an empty range */
+    n = 0;
+    for (vc::Option opt : conf.section("missing")) n += opt.key().size() > 0;
+    for (vc::Option opt : conf.section("port")) n += opt.key().size() > 0;
+    RESULT("iterate missing", n == 0 && !conf.section("missing"));
+
+    /* Moving hands over the config, leaving the source empty */
+    vc::Config moved(std::move(conf));
+    RESULT("move", moved && !conf && moved.get<int>("port") == 80 && !conf.get<int>("port"));
+
+    /* Each config is closed once: when its owner goes, or is assigned */
+    {
+        vc::Config a = counted("a = 1\n[s]\nb = \"two\"\n[/s]\n");
+        vc::Config b = counted("c = 3\n");
+        long both = live;
+        a = std::move(b);
+        RESULT("move assign", both > 0 && live > 0 && live < both && a.get<int>("c") == 3 && !b);
+        a = std::move(a);
+        RESULT("self assign", a.get<int>("c") == 3);
+    }
+    RESULT("destroyed", live == 0);
+
+    /* Released configs are the caller's to close */
+    vc::Config owner = counted("a = 1\n");
+    vconfig *raw = owner.release();
+    RESULT("release", raw && !owner && live > 0);
+    vconfig_close(raw);
+    RESULT("released closed", live == 0);
+
+    /* Opening a file, and failing to */
+    char path[PATH_MAX];
+    test_write("conf.cfg", "port = 8080\n");
+    vc::Config file = vc::Config::open(std::string(test_path(path, sizeof(path), "conf.cfg")));
+    RESULT("open", file.get<int>("port") == 8080 && !vc::Config::open(test_path(path, sizeof(path), "none.cfg")));
+
+    return test_end();
+}
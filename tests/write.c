@@ -0,0 +1,115 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: write.c
+ *
+ * Config writer: output that parses back to the same config, include
+ * statements written as they were written, and floats the format can't
+ * express.
+ */
+
+#include <errno.h>
+#include <math.h>
+
+#include "test.h"
+
+static const char *text =
+    "count = 42\n"
+    "neg = -7\n"
+    "pi = 3.14159\n"
+    "tiny = 0.1\n"
+    "huge = 123456789.125\n"
+    "on = true\n"
+    "name = \"quote \\\" back \\\\ tab \\t end\"\n"
+    "ports = [80, 443, 8080]\n"
+    "weights = [0.5, 1.25]\n"
+    "hosts = [\"a\", \"b c\"]\n"
+    "timeout = 2h30m\n"
+    "heap = 512MiB\n"
+    "load = 75%\n"
+    "[server]\n"
+    "port = 443\n"
+    "[tls]\n"
+    "ciphers = \"HIGH\"\n"
+    "[/tls]\n"
+    "[/server]\n";
+
+/* Write a config, parse the output, and write that */
+static int round_trip(vconfig *vcfg, char **first, char **second) {
+    size_t length;
+    vconfig *again;
+
+    *first = *second = 0;
+    if (!(*first = vconfig_write_buffer(vcfg, 0, &length))) return 0;
+    if (!(again = test_parse(*first, 0))) return 0;
+    *second = vconfig_write_buffer(again, 0, &length);
+    vconfig_close(again);
+    return *second != 0;
+}
+
+int main(void) {
+    char path[PATH_MAX], *first = 0, *second = 0, *out, *p;
+    vconfig *vcfg, *back;
+    int64_t *heap;
+    size_t length;
+    int ok, includes;
+
+    test_begin("write");
+
+    /* Values of each type, written, parsed and written again */
+    vcfg = test_parse(text, 0);
+    ok = vcfg && round_trip(vcfg, &first, &second);
+    RESULT("round trip", ok && !strcmp(first, second));
+    back = ok ? test_parse(first, 0) : 0;
+    heap = back ? vconfig_getbytes(back, "heap") : 0;
+    RESULT("values", back && test_int(back, "count") == 42 && test_int(back, "server.port") == 443 &&
+                     *(double *)vconfig_getval(back, "tiny") == 0.1 &&
+                     *(double *)vconfig_getval(back, "huge") == 123456789.125 &&
+                     !strcmp(test_str(back, "name"), "quote \" back \\ tab \t end") &&
+                     !strcmp(test_str(back, "server.tls.ciphers"), "HIGH") &&
+                     heap && *heap == 512LL * 1024 * 1024);
+    vconfig_close(back);
+    free(first);
+    free(second);
+
+    /* Floats with no text form fail the write */
+    vconfig_set_float(vcfg, "bad", NAN);
+    errno = 0;
+    out = vconfig_write_buffer(vcfg, 0, &length);
+    RESULT("nan", !out && errno == EDOM);
+    free(out);
+    vconfig_set_float(vcfg, "bad", INFINITY);
+    out = vconfig_write_buffer(vcfg, 0, &length);
+    RESULT("inf", !out && errno == EDOM);
+    free(out);
+    vconfig_delete(vcfg, "bad");
+    vconfig_set_ratio(vcfg, "load", -INFINITY);
+    out = vconfig_write_buffer(vcfg, 0, &length);
+    RESULT("inf ratio", !out && errno == EDOM);
+    free(out);
+    vconfig_close(vcfg);
+
+    /* Includes come out as written: relative, and a glob once */
+    if (mkdir(test_path(path, sizeof(path), "parts"), 0755) ||
+        !test_write("common.cfg", "shared = 7\n") ||
+        !test_write("parts/a.cfg", "a = 1\n") ||
+        !test_write("parts/b.cfg", "b = 2\n") ||
+        !test_write("root.cfg", "include \"common.cfg\"\ninclude \"parts/*.cfg\"\nport = 80\n")) {
+        perror("write");
+        return 2;
+    }
+    vcfg = test_open("root.cfg", 0, 0);
+    out = vcfg ? vconfig_write_buffer(vcfg, 0, &length) : 0;
+    for (includes = 0, p = out; p && (p = strstr(p, "include ")); p++) includes++;
+    RESULT("include spelling", out && includes == 2 && strstr(out, "include \"common.cfg\"\n") &&
+                               strstr(out, "include \"parts/*.cfg\"\n"));
+    back = out && test_write("copy.cfg", out) ? test_open("copy.cfg", 0, 0) : 0;
+    RESULT("include round trip", test_int(back, "shared") == 7 && test_int(back, "a") == 1 &&
+                                 test_int(back, "b") == 2 && test_int(back, "port") == 80);
+    vconfig_close(back);
+    vconfig_close(vcfg);
+    free(out);
+
+    return test_end();
+}
@@ -0,0 +1,280 @@
+/*
+ * Project: VConfig
+ *  Author: Kurt Sassenrath
+ *    Date: 19-Oct-2026
+ *    File: vconfig-gen.c
+ *
+ * Accessor generator.  Reads a reference config, and writes a C header
+ * with one typed accessor per option it holds, including options from
+ * the files it includes.  Each accessor looks its option up by a path
+ * whose segment hashes and lengths are constants, so no key is hashed at
+ * runtime, and a misspelled option is a compile error rather than a NULL
+ * return.
+ *
+ * Usage: vconfig-gen [-p prefix] [-o header] <reference config>
+ */
+
+/**********************************************************************/
+/**** Includes ********************************************************/
+/**********************************************************************/
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "vconfig.h"
+#include "vcinclude.h"
+
+/**********************************************************************/
+/**** Macro/Static Definitions ****************************************/
+/**********************************************************************/
+#define DEFAULT_PREFIX  "vcgen"
+
+/* An option found in the reference config */
+typedef struct gen_entry {
+    char *path;                 /* Option path */
+    vc_type type;               /* Option type */
+} gen_entry;
+
+typedef struct gen_state {
+    gen_entry *entries;         /* Options found so far */
+    size_t n, cap;
+    fasthash_table *seen;       /* Paths found so far */
+    int error;
+} gen_state;
+
+/* C type returned by the accessor of each option type */
+static const char *gen_ctypes[] = {
+    [VC_BOOLEAN] = "int *",
+    [VC_INTEGER] = "int *",
+    [VC_FLOAT]   = "double *",
+    [VC_STRING]  = "char *",
+    [VC_SECTION] = "vconfig *",
+    [VC_ARRAY]   = "vc_array *",
+    [VC_DURATION] = "int64_t *",
+    [VC_SIZE]    = "int64_t *",
+    [VC_RATIO]   = "double *",
+};
+
+static const char *gen_typenames[] = {
+    #define XX(name) "VC_" #name,
+    VC_OPT_TYPES(XX)
+    #undef XX
+};
+
+/**********************************************************************/
+/**** Static Function Prototypes **************************************/
+/**********************************************************************/
+static void gen_collect(gen_state *g, vc_sect *sect, char *prefix);
+static void gen_add(gen_state *g, char *path, vc_type type);
+static int gen_entrycmp(const void *a, const void *b);
+static char *gen_ident(char *prefix, char *path);
+static void gen_cstring(FILE *out, char *str, size_t length);
+static int gen_header(FILE *out, char *file, char *prefix, gen_entry *entries, size_t n);
+
+/**********************************************************************/
+/**** Function Definitions ********************************************/
+/**********************************************************************/
+
+int main(int argc, char **argv) {
+    char *prefix = DEFAULT_PREFIX, *output = 0;
+    vc_params p = {0, 0, 0, 0, 0};
+    gen_state g = {0, 0, 0, 0, 0};
+    vconfig *conf;
+    FILE *out = stdout;
+    size_t i;
+    int c, ok;
+
+    while ((c = getopt(argc, argv, "p:o:")) != -1) {
+        switch (c) {
+            case 'p': prefix = optarg; break;
+            case 'o': output = optarg; break;
+            default: optind = argc + 1;
+        }
+    }
+    for (c = 0; prefix[c] && (isalnum((unsigned char)prefix[c]) || prefix[c] == '_'); c++);
+    if (optind != argc - 1 || !c || prefix[c] || isdigit((unsigned char)*prefix)) {
+        fprintf(stderr, "Usage: %s [-p prefix] [-o header] <reference config>\n", argv[0]);
+        return 1;
+    }
+
+    /* The tool is linked without vconfig.o, whose main is the standalone
+     * test program, so it parses with the lower-level calls. */
+    p.file = argv[optind];
+    if (!(conf = vc_parse_file(&p))) return 1;
+
+    if (!(g.seen = fasthash_init(256, 0, 0, 0, 0))) g.error = 1;
+    if (!g.error) gen_collect(&g, conf, "");
+    qsort(g.entries, g.n, sizeof(gen_entry), gen_entrycmp);
+
+    if (!g.error && output && !(out = fopen(output, "w"))) {
+        perror(output);
+        g.error = 1;
+    }
+    ok = !g.error && gen_header(out, p.file, prefix, g.entries, g.n);
+    if (out != stdout && out) {
+        if (fclose(out)) ok = 0;
+        if (!ok) unlink(output);
+    }
+
+    for (i = 0; i < g.n; i++) free(g.entries[i].path);
+    free(g.entries);
+    fasthash_cleanup(g.seen);
+    vc_sect_destroy(conf);
+    return ok ? 0 : 1;
+}
+
+/* Gather the options of a section, then those of the files it includes.
+ * Lookups try a section before its includes, so the first type found
+ * for a path is the one an accessor will see. */
+static void gen_collect(gen_state *g, vc_sect *sect, char *prefix) {
+    index_node *in;
+    fasthash_node *node;
+    vc_include *inc;
+
+    for (in = sect->ht->index_list; in && !g->error; in = in->next) {
+        for (node = sect->ht->entries[in->index]; node; node = node->next) {
+            vc_opt *opt = (vc_opt *)node->data;
+            size_t length = strlen(prefix) + strlen(node->key) + 2;
+            char *path = (char *)malloc(length);
+
+            if (!path) {
+                g->error = 1;
+                return;
+            }
+            snprintf(path, length, "%s%s%s", prefix, *prefix ? "." : "", node->key);
+            gen_add(g, path, opt->type);
+            if (opt->type == VC_SECTION) gen_collect(g, (vc_sect *)opt->value, path);
+        }
+    }
+    for (inc = sect->includes; inc && !g->error; inc = inc->next) {
+        if (inc->frag->sect) gen_collect(g, inc->frag->sect, prefix);
+    }
+}
+
+/* Record a path, unless it was already found.  Takes the path. */
+static void gen_add(gen_state *g, char *path, vc_type type) {
+    if (fasthash_lookup(g->seen, path)) {
+        free(path);
+        return;
+    }
+    if (g->n == g->cap) {
+        size_t cap = g->cap ? g->cap * 2 : 64;
+        gen_entry *grown = (gen_entry *)realloc(g->entries, cap * sizeof(gen_entry));
+        if (!grown) {
+            free(path);
+            g->error = 1;
+            return;
+        }
+        g->entries = grown;
+        g->cap = cap;
+    }
+    if (fasthash_insert(g->seen, path, 0) >= g->seen->size) {
+        free(path);
+        g->error = 1;
+        return;
+    }
+    g->entries[g->n].path = path;
+    g->entries[g->n].type = type;
+    g->n++;
+}
+
+static int gen_entrycmp(const void *a, const void *b) {
+    return strcmp(((gen_entry *)a)->path, ((gen_entry *)b)->path);
+}
+
+/* C identifier for an option path: the prefix, then the path with each
+ * character that can't appear in an identifier replaced by '_' */
+static char *gen_ident(char *prefix, char *path) {
+    size_t plen = strlen(prefix), length = plen + 1 + strlen(path);
+    char *ident = (char *)malloc(length + 1);
+    char *c;
+
+    if (!ident) return 0;
+    snprintf(ident, length + 1, "%s_%s", prefix, path);
+    for (c = ident + plen + 1; *c; c++) {
+        if (!isalnum((unsigned char)*c)) *c = '_';
+    }
+    return ident;
+}
+
+static void gen_cstring(FILE *out, char *str, size_t length) {
+    size_t i;
+
+    fputc('"', out);
+    for (i = 0; i < length; i++) {
+        if (str[i] == '\\' || str[i] == '"') fputc('\\', out);
+        fputc(str[i], out);
+    }
+    fputc('"', out);
+}
+
+static int gen_header(FILE *out, char *file, char *prefix, gen_entry *entries, size_t n) {
+    fasthash_table *idents = fasthash_init(256, 0, fasthash_free_data, 0, 0);
+    char *guard, *c;
+    size_t i;
+    int ok = idents != 0;
+
+    if (!ok || !(guard = gen_ident("__VCGEN", prefix))) {
+        fasthash_cleanup(idents);
+        return 0;
+    }
+    for (c = guard; *c; c++) *c = toupper((unsigned char)*c);
+
+    fprintf(out, "/*\n * Generated by vconfig-gen from %s.  Do not edit.\n *\n", file);
+    fprintf(out, " * Each accessor returns its option's value, or NULL if the config it\n");
+    fprintf(out, " * is given lacks the option or holds another type there.\n */\n\n");
+    fprintf(out, "#ifndef %s_H\n#define %s_H\n\n#include \"vconfig.h\"\n", guard, guard);
+
+    for (i = 0; i < n && ok; i++) {
+        char *path = entries[i].path, *seg, *end;
+        char *ident = gen_ident(prefix, path);
+        fasthash_node *clash;
+        uint32_t nsegs = 0;
+        char *copy;
+
+        if (!ident) {
+            ok = 0;
+            break;
+        }
+        if ((clash = fasthash_lookup(idents, ident))) {
+            fprintf(stderr, "vconfig-gen: '%s' and '%s' both map to %s\n",
+                    (char *)clash->data, path, ident);
+            free(ident);
+            ok = 0;
+            break;
+        }
+        if (!(copy = strdup(path)) || fasthash_insert(idents, ident, copy) >= idents->size) {
+            fprintf(stderr, "vconfig-gen: Out of memory\n");
+            free(copy);
+            free(ident);
+            ok = 0;
+            break;
+        }
+
+        fprintf(out, "\n/* %s */\n", path);
+        fprintf(out, "static const vc_key %s_segs_[] = {\n", ident);
+        for (seg = path; seg; seg = *end ? end + 1 : 0, nsegs++) {
+            for (end = seg; *end && *end != '.'; end++);
+            fprintf(out, "    {");
+            gen_cstring(out, seg, end - seg);
+            fprintf(out, ", %u, 0x%08xu},\n", (unsigned)(end - seg),
+                    hashn_djb2((unsigned char *)seg, end - seg));
+        }
+        fprintf(out, "};\n");
+        fprintf(out, "static const vc_keypath %s_path_ = {\n    {", ident);
+        gen_cstring(out, path, strlen(path));
+        fprintf(out, ", %u, 0x%08xu}, %s_segs_, %u\n};\n", (unsigned)strlen(path),
+                hashn_djb2((unsigned char *)path, strlen(path)), ident, nsegs);
+        fprintf(out, "static inline %s%s(vconfig *vcfg) {\n", gen_ctypes[entries[i].type], ident);
+        fprintf(out, "    return (%s)vconfig_getval_key(vcfg, &%s_path_, %s);\n}\n",
+                gen_ctypes[entries[i].type], ident, gen_typenames[entries[i].type]);
+        free(ident);
+    }
+
+    fprintf(out, "\n#endif /* #ifndef %s_H */\n", guard);
+    free(guard);
+    fasthash_cleanup(idents);
+    return ok && !ferror(out);
+}